@@ -4,13 +4,12 @@
 #include "Rendering/DiffuseFlatMaterial.hpp"
 #include "Rendering/DiffuseTexturedMaterial.hpp"
 #include "Rendering/PBRTexturedMaterial.hpp"
-#include <numbers>
 #include <imgui.h>
 #include <random>
 
 
-float gaussian(float x, float y, float s, float sigma, glm::vec2 mu) {
-	return (s / (sigma * std::sqrt(2 * std::numbers::pi))) * std::exp((-1 / (2 * std::pow(sigma, 2))) * (std::pow((x - mu[0]), 2) + std::pow((y - mu[1]), 2)));
+Mona::GaussianMixtureHeightSource::Gaussian gaussian(float s, float sigma, glm::vec2 mu) {
+	return { mu, s, sigma };
 }
 
 void AddDirectionalLight(Mona::World& world, const glm::vec3& axis, float angle, float lightIntensity)
@@ -33,28 +32,24 @@ Mona::GameObjectHandle<Mona::GameObject> AddTerrain(Mona::World& world) {
 	glm::vec2 maxXY(100, 100);
 	int numInnerVerticesWidth = 100;
 	int numInnerVerticesHeight = 100;
-	auto heighFunc = [](float x, float y) -> float {
-		float result = 0;
-		int funcNum = 250;
-		glm::vec2 minXY(-100, -100);
-		glm::vec2 maxXY(100, 100);
-		float minHeight = -15;
-		float maxHeight = 80;
-		float minSigma = 3;
-		float maxSigma = 15;
-		std::srand(130);
-		for (int i = 0; i < funcNum; i++) {
-			float randMax = RAND_MAX;
-			result += gaussian(x, y, Mona::funcUtils::lerp(minHeight, maxHeight, std::rand() / randMax),
-				Mona::funcUtils::lerp(minSigma, maxSigma, std::rand() / randMax),
-				{ Mona::funcUtils::lerp(minXY[0], maxXY[0], std::rand() / randMax),
-				Mona::funcUtils::lerp(minXY[1], maxXY[1], std::rand() / randMax) });
-		}
-		return result;
-	};
+	std::vector<Mona::GaussianMixtureHeightSource::Gaussian> gaussians;
+	int funcNum = 250;
+	float minHeight = -15;
+	float maxHeight = 80;
+	float minSigma = 3;
+	float maxSigma = 15;
+	std::srand(130);
+	for (int i = 0; i < funcNum; i++) {
+		float randMax = RAND_MAX;
+		gaussians.push_back(gaussian(Mona::funcUtils::lerp(minHeight, maxHeight, std::rand() / randMax),
+			Mona::funcUtils::lerp(minSigma, maxSigma, std::rand() / randMax),
+			{ Mona::funcUtils::lerp(minXY[0], maxXY[0], std::rand() / randMax),
+			Mona::funcUtils::lerp(minXY[1], maxXY[1], std::rand() / randMax) }));
+	}
+	auto heightSource = std::make_shared<Mona::GaussianMixtureHeightSource>(gaussians);
 
 	world.AddComponent<Mona::StaticMeshComponent>(terrain, meshManager.GenerateTerrain(minXY, maxXY, numInnerVerticesWidth,
-		numInnerVerticesHeight, heighFunc), materialPtr);
+		numInnerVerticesHeight, heightSource), materialPtr);
 	return terrain;
 }
 
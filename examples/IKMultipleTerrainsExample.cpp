@@ -4,13 +4,12 @@
 #include "Rendering/DiffuseFlatMaterial.hpp"
 #include "Rendering/DiffuseTexturedMaterial.hpp"
 #include "Rendering/PBRTexturedMaterial.hpp"
-#include <numbers>
 #include <imgui.h>
 #include <random>
 
 
-float gaussian(float x, float y, float s, float sigma, glm::vec2 mu) {
-	return (s / (sigma * std::sqrt(2 * std::numbers::pi))) * std::exp((-1 / (2 * std::pow(sigma, 2))) * (std::pow((x - mu[0]), 2) + std::pow((y - mu[1]), 2)));
+Mona::GaussianMixtureHeightSource::Gaussian gaussian(float s, float sigma, glm::vec2 mu) {
+	return { mu, s, sigma };
 }
 
 void AddDirectionalLight(Mona::World& world, const glm::vec3& axis, float angle, float lightIntensity)
@@ -33,28 +32,24 @@ Mona::GameObjectHandle<Mona::GameObject> AddTerrain1(Mona::World& world) {
 	glm::vec2 maxXY(50, 50);
 	int numInnerVerticesWidth = 100;
 	int numInnerVerticesHeight = 100;
-	auto heighFunc = [](float x, float y) -> float {
-		float result = 0;
-		int funcNum = 100;
-		glm::vec2 minXY(-50, -50);
-		glm::vec2 maxXY(50, 50);
-		float minHeight = -15;
-		float maxHeight = 60;
-		float minSigma = 3;
-		float maxSigma = 20;
-		std::srand(5);
-		for (int i = 0; i < funcNum; i++) {
-			float randMax = RAND_MAX;
-			result += gaussian(x, y, Mona::funcUtils::lerp(minHeight, maxHeight, std::rand() / randMax),
-				Mona::funcUtils::lerp(minSigma, maxSigma, std::rand() / randMax),
-				{ Mona::funcUtils::lerp(minXY[0], maxXY[0], std::rand() / randMax),
-				Mona::funcUtils::lerp(minXY[1], maxXY[1], std::rand() / randMax) });
-		}
-		return result;
-	};
+	std::vector<Mona::GaussianMixtureHeightSource::Gaussian> gaussians;
+	int funcNum = 100;
+	float minHeight = -15;
+	float maxHeight = 60;
+	float minSigma = 3;
+	float maxSigma = 20;
+	std::srand(5);
+	for (int i = 0; i < funcNum; i++) {
+		float randMax = RAND_MAX;
+		gaussians.push_back(gaussian(Mona::funcUtils::lerp(minHeight, maxHeight, std::rand() / randMax),
+			Mona::funcUtils::lerp(minSigma, maxSigma, std::rand() / randMax),
+			{ Mona::funcUtils::lerp(minXY[0], maxXY[0], std::rand() / randMax),
+			Mona::funcUtils::lerp(minXY[1], maxXY[1], std::rand() / randMax) }));
+	}
+	auto heightSource = std::make_shared<Mona::GaussianMixtureHeightSource>(gaussians);
 
 	world.AddComponent<Mona::StaticMeshComponent>(terrain, meshManager.GenerateTerrain(minXY, maxXY, numInnerVerticesWidth,
-		numInnerVerticesHeight, heighFunc), materialPtr);
+		numInnerVerticesHeight, heightSource), materialPtr);
 	return terrain;
 }
 Mona::GameObjectHandle<Mona::GameObject> AddTerrain2(Mona::World& world) {
@@ -68,28 +63,24 @@ Mona::GameObjectHandle<Mona::GameObject> AddTerrain2(Mona::World& world) {
 	glm::vec2 maxXY(50, 50);
 	int numInnerVerticesWidth = 100;
 	int numInnerVerticesHeight = 100;
-	auto heighFunc = [](float x, float y) -> float {
-		float result = 0;
-		int funcNum = 200;
-		glm::vec2 minXY(-50, -50);
-		glm::vec2 maxXY(50, 50);
-		float minHeight = -20;
-		float maxHeight = 55;
-		float minSigma = 3;
-		float maxSigma = 20;
-		std::srand(10);
-		for (int i = 0; i < funcNum; i++) {
-			float randMax = RAND_MAX;
-			result += gaussian(x, y, Mona::funcUtils::lerp(minHeight, maxHeight, std::rand() / randMax),
-				Mona::funcUtils::lerp(minSigma, maxSigma, std::rand() / randMax),
-				{ Mona::funcUtils::lerp(minXY[0], maxXY[0], std::rand() / randMax),
-				Mona::funcUtils::lerp(minXY[1], maxXY[1], std::rand() / randMax) });
-		}
-		return result;
-	};
+	std::vector<Mona::GaussianMixtureHeightSource::Gaussian> gaussians;
+	int funcNum = 200;
+	float minHeight = -20;
+	float maxHeight = 55;
+	float minSigma = 3;
+	float maxSigma = 20;
+	std::srand(10);
+	for (int i = 0; i < funcNum; i++) {
+		float randMax = RAND_MAX;
+		gaussians.push_back(gaussian(Mona::funcUtils::lerp(minHeight, maxHeight, std::rand() / randMax),
+			Mona::funcUtils::lerp(minSigma, maxSigma, std::rand() / randMax),
+			{ Mona::funcUtils::lerp(minXY[0], maxXY[0], std::rand() / randMax),
+			Mona::funcUtils::lerp(minXY[1], maxXY[1], std::rand() / randMax) }));
+	}
+	auto heightSource = std::make_shared<Mona::GaussianMixtureHeightSource>(gaussians);
 
 	world.AddComponent<Mona::StaticMeshComponent>(terrain, meshManager.GenerateTerrain(minXY, maxXY, numInnerVerticesWidth,
-		numInnerVerticesHeight, heighFunc), materialPtr);
+		numInnerVerticesHeight, heightSource), materialPtr);
 	return terrain;
 }
 Mona::GameObjectHandle<Mona::GameObject> AddTerrain3(Mona::World& world) {
@@ -104,28 +95,24 @@ Mona::GameObjectHandle<Mona::GameObject> AddTerrain3(Mona::World& world) {
 	glm::vec2 maxXY(50, 50);
 	int numInnerVerticesWidth = 50;
 	int numInnerVerticesHeight = 50;
-	auto heighFunc = [](float x, float y) -> float {
-		float result = 0;
-		int funcNum = 100;
-		glm::vec2 minXY(-50, -50);
-		glm::vec2 maxXY(50, 50);
-		float minHeight = -25;
-		float maxHeight = 45;
-		float minSigma = 5;
-		float maxSigma = 15;
-		std::srand(20);
-		for (int i = 0; i < funcNum; i++) {
-			float randMax = RAND_MAX;
-			result += gaussian(x, y, Mona::funcUtils::lerp(minHeight, maxHeight, std::rand() / randMax),
-				Mona::funcUtils::lerp(minSigma, maxSigma, std::rand() / randMax),
-				{ Mona::funcUtils::lerp(minXY[0], maxXY[0], std::rand() / randMax),
-				Mona::funcUtils::lerp(minXY[1], maxXY[1], std::rand() / randMax) });
-		}
-		return result;
-	};
+	std::vector<Mona::GaussianMixtureHeightSource::Gaussian> gaussians;
+	int funcNum = 100;
+	float minHeight = -25;
+	float maxHeight = 45;
+	float minSigma = 5;
+	float maxSigma = 15;
+	std::srand(20);
+	for (int i = 0; i < funcNum; i++) {
+		float randMax = RAND_MAX;
+		gaussians.push_back(gaussian(Mona::funcUtils::lerp(minHeight, maxHeight, std::rand() / randMax),
+			Mona::funcUtils::lerp(minSigma, maxSigma, std::rand() / randMax),
+			{ Mona::funcUtils::lerp(minXY[0], maxXY[0], std::rand() / randMax),
+			Mona::funcUtils::lerp(minXY[1], maxXY[1], std::rand() / randMax) }));
+	}
+	auto heightSource = std::make_shared<Mona::GaussianMixtureHeightSource>(gaussians);
 
 	world.AddComponent<Mona::StaticMeshComponent>(terrain, meshManager.GenerateTerrain(minXY, maxXY, numInnerVerticesWidth,
-		numInnerVerticesHeight, heighFunc), materialPtr);
+		numInnerVerticesHeight, heightSource), materialPtr);
 	return terrain;
 }
 
@@ -70,8 +70,18 @@ namespace Mona {
 		if (removeRootMotion) {
 			RemoveRootMotion();
 		}
+		UpdateMemoryUsage();
+	}
 
-		
+	AnimationClip::AnimationClip(const AnimationClip& other) :
+		m_animationTracks(other.m_animationTracks),
+		m_trackJointNames(other.m_trackJointNames),
+		m_trackJointIndices(other.m_trackJointIndices),
+		m_skeletonPtr(other.m_skeletonPtr),
+		m_duration(other.m_duration),
+		m_animationName(other.m_animationName)
+	{
+		UpdateMemoryUsage();
 	}
 
 	float AnimationClip::Sample(std::vector<JointPose>& outPose, float time, bool isLooping) {
@@ -335,6 +345,21 @@ namespace Mona {
 				conditions[i] = currentTimeIndexes[i] < m_animationTracks[i].rotationTimeStamps.size();
 			}
 		}
+		UpdateMemoryUsage();
+	}
+
+	void AnimationClip::UpdateMemoryUsage() noexcept {
+		std::size_t bytes = m_animationTracks.capacity() * sizeof(AnimationTrack);
+		for (const auto& track : m_animationTracks) {
+			bytes += track.positions.capacity() * sizeof(glm::vec3) + track.scales.capacity() * sizeof(glm::vec3);
+			bytes += track.rotations.capacity() * sizeof(glm::fquat);
+			bytes += (track.positionTimeStamps.capacity() + track.rotationTimeStamps.capacity() + track.scaleTimeStamps.capacity()) * sizeof(float);
+		}
+		for (const auto& jointName : m_trackJointNames) {
+			bytes += sizeof(std::string) + jointName.capacity();
+		}
+		bytes += m_trackJointIndices.capacity() * sizeof(JointIndex);
+		m_memoryAccount.Set(bytes, 0);
 	}
 
 
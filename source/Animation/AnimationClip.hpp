@@ -7,6 +7,7 @@
 #include <utility>
 #include <glm/glm.hpp>
 #include "JointPose.hpp"
+#include "../Core/MemoryTracker.hpp"
 namespace Mona {
 	class Skeleton;
 	class AnimationClip {
@@ -44,11 +45,14 @@ namespace Mona {
 		AnimationClip(const std::string& filePath,
 			std::shared_ptr<Skeleton> skeleton,
 			bool removeRootMotion = true);
+		// Copia independiente de los tracks, para modificar una animacion sin afectar al clip compartido por el manager
+		AnimationClip(const AnimationClip& other);
 		void RemoveRootMotion();
 		void RemoveJointTranslation(int jointIndex);
 		void RemoveJointRotation(int jointIndex);
 		void RemoveJointScaling(int jointIndex);
 		void DecompressRotations();
+		void UpdateMemoryUsage() noexcept;
 
 		float GetSamplingTime(float time, bool isLooping) const;
 		std::pair<uint32_t, float> GetTimeFraction(const std::vector<float>& timeStamps, float time) const;
@@ -64,6 +68,7 @@ namespace Mona {
 		std::shared_ptr<Skeleton> m_skeletonPtr;
 		float m_duration = 1.0f;
 		std::string m_animationName;
+		MemoryAccount m_memoryAccount{ MemoryTag::AnimationClips };
 	};
 }
 #endif
\ No newline at end of file
@@ -6,6 +6,7 @@ namespace Mona {
 		std::shared_ptr<Skeleton> skeleton,
 		bool removeRootMotion) noexcept
 	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 		const std::string& stringPath = filePath.string();
 		//En caso de que ya exista una entrada en el mapa de animaciones con el mismo path, 
 		// entonces se retorna inmediatamente dicha animacin.
@@ -19,7 +20,37 @@ namespace Mona {
 		m_animationClipMap.insert({ stringPath, sharedPtr });
 		return sharedPtr;
 	}
+	AssetFuture<AnimationClip> AnimationClipManager::LoadAnimationClipAsync(const std::filesystem::path& filePath,
+		std::shared_ptr<Skeleton> skeleton,
+		bool removeRootMotion) noexcept
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const std::string stringPath = filePath.string();
+		auto it = m_animationClipMap.find(stringPath);
+		if (it != m_animationClipMap.end()) {
+			return AssetFuture<AnimationClip>(it->second);
+		}
+		auto pendingIt = m_pendingAnimationClips.find(stringPath);
+		if (pendingIt != m_pendingAnimationClips.end() && !pendingIt->second.IsReady()) {
+			return pendingIt->second;
+		}
+		//El clip no usa recursos de GPU, por lo que se construye completo en el worker
+		auto future = AssetLoader::GetInstance().Load<AnimationClip>([this, stringPath, skeleton, removeRootMotion](AssetLoader::UploadTask& outUpload) {
+			std::shared_ptr<AnimationClip> animation = std::shared_ptr<AnimationClip>(new AnimationClip(stringPath, skeleton, removeRootMotion));
+			outUpload = [this, stringPath, animation]() {
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pendingAnimationClips.erase(stringPath);
+				m_animationClipMap.insert({ stringPath, animation });
+			};
+			return animation;
+		});
+		AssetFuture<AnimationClip> result(future, nullptr);
+		m_pendingAnimationClips.insert_or_assign(stringPath, result);
+		return result;
+	}
+
 	void AnimationClipManager::CleanUnusedAnimationClips() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		/*
 		* Elimina todos los punteros del mapa cuyo conteo de referencias es igual a uno,
 		* es decir, que el puntero del mapa es el unico que apunta a esa memoria.
@@ -36,8 +67,10 @@ namespace Mona {
 	}
 
 	void AnimationClipManager::ShutDown() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		//Al cerrar el motor se llama esta funcin donde se limpia el mapa de animaciones
 		m_animationClipMap.clear();
+		m_pendingAnimationClips.clear();
 	}
 
 	
@@ -3,7 +3,9 @@
 #define ANIMATIONCLIPMANAGER_HPP
 #include <memory>
 #include <filesystem>
+#include <mutex>
 #include <unordered_map>
+#include "../Core/AssetLoader.hpp"
 namespace Mona {
 	class AnimationClip;
 	class Skeleton;
@@ -16,6 +18,13 @@ namespace Mona {
 		std::shared_ptr<AnimationClip> LoadAnimationClip(const std::filesystem::path& filePath,
 			std::shared_ptr<Skeleton> skeleton,
 			bool removeRootMotion = true) noexcept;
+		/*
+		* Igual que LoadAnimationClip, pero el archivo se lee en un worker. El clip solo se entrega una vez listo y skeleton
+		* ya debe estar cargado, por ejemplo esperando el resultado de SkeletonManager::LoadSkeletonAsync.
+		*/
+		AssetFuture<AnimationClip> LoadAnimationClipAsync(const std::filesystem::path& filePath,
+			std::shared_ptr<Skeleton> skeleton,
+			bool removeRootMotion = true) noexcept;
 		void CleanUnusedAnimationClips() noexcept;
 		static AnimationClipManager& GetInstance() noexcept {
 			static AnimationClipManager manager;
@@ -24,7 +33,11 @@ namespace Mona {
 	private:
 		AnimationClipManager() = default;
 		void ShutDown() noexcept;
+		// Las cargas y limpiezas pueden llamarse desde varios mundos en hilos distintos
+		std::mutex m_mutex;
 		AnimationClipMap m_animationClipMap;
+		// Cargas asincronas en curso, para no leer dos veces el mismo archivo
+		std::unordered_map<std::string, AssetFuture<AnimationClip>> m_pendingAnimationClips;
 	};
 }
 #endif
\ No newline at end of file
@@ -64,6 +64,32 @@ namespace Mona {
 		m_crossfadeTarget.Clear();
 	}
 
+	void AnimationController::SetSampledClip(std::shared_ptr<AnimationClip> clip, std::shared_ptr<AnimationClip> sampledClip) noexcept {
+		for (auto it = m_sampledClips.begin(); it != m_sampledClips.end(); ++it) {
+			if (it->first == clip) {
+				if (sampledClip == nullptr) {
+					m_sampledClips.erase(it);
+				}
+				else {
+					it->second = sampledClip;
+				}
+				return;
+			}
+		}
+		if (sampledClip != nullptr) {
+			m_sampledClips.push_back({ clip, sampledClip });
+		}
+	}
+
+	AnimationClip* AnimationController::GetSampledClip(const std::shared_ptr<AnimationClip>& clip) const noexcept {
+		for (const auto& sampledClip : m_sampledClips) {
+			if (sampledClip.first == clip) {
+				return sampledClip.second.get();
+			}
+		}
+		return clip.get();
+	}
+
 	void AnimationController::UpdateCurrentPose(float timeStep) noexcept {
 		//Se avanza el tiempo pasado en la animacin objetivo
 		//Si ya ha transcurrido el tiempo dado de reproduccion de la animacion objetivo, esta pasa a ser la principal.
@@ -104,14 +130,14 @@ namespace Mona {
 			}
 
 			//Muestreo de la animacin principal
-			m_sampleTime = m_animationClipPtr->Sample(m_currentPose,
+			m_sampleTime = GetSampledClip(m_animationClipPtr)->Sample(m_currentPose,
 				m_sampleTime + timeStep * m_playRate * playbackFactorClip,
 				m_isLooping);
 
 			auto& targetPose = m_crossfadeTarget.m_currentPose;
 			std::fill(targetPose.begin(), targetPose.end(), JointPose());
 			//Muestreo de la animacin objetivo
-			m_crossfadeTarget.m_sampleTime = m_crossfadeTarget.m_targetClip->Sample(targetPose,
+			m_crossfadeTarget.m_sampleTime = GetSampledClip(m_crossfadeTarget.m_targetClip)->Sample(targetPose,
 				m_crossfadeTarget.m_sampleTime + timeStep * m_playRate * playbackFactorTarget,
 				m_crossfadeTarget.m_isLooping);
 			//Interpolacion entre ambas poses
@@ -119,7 +145,7 @@ namespace Mona {
 		}
 		else
 		{
-			m_sampleTime = m_animationClipPtr->Sample(m_currentPose, m_sampleTime + timeStep * m_playRate, m_isLooping);
+			m_sampleTime = GetSampledClip(m_animationClipPtr)->Sample(m_currentPose, m_sampleTime + timeStep * m_playRate, m_isLooping);
 		}
 
 
@@ -132,6 +158,12 @@ namespace Mona {
 	}
 
 	void AnimationController::GetMatrixPalette(std::vector<glm::mat4>& outMatrixPalette) const
+	{
+		outMatrixPalette.resize(m_animationClipPtr->GetSkeleton()->JointCount());
+		GetMatrixPalette(outMatrixPalette.data());
+	}
+
+	void AnimationController::GetMatrixPalette(glm::mat4* outMatrixPalette) const
 	{
 		
 		auto skeleton = m_animationClipPtr->GetSkeleton();
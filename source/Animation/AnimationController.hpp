@@ -3,6 +3,7 @@
 #define ANIMATIONCONTROLLER_HPP
 #include <vector>
 #include <memory>
+#include <utility>
 #include "CrossFadeTarget.hpp"
 #include "JointPose.hpp"
 namespace Mona {
@@ -24,9 +25,18 @@ namespace Mona {
 		void SetPlayRate(float playrate) { m_playRate = playrate; }
 		float GetPlayRate() const { return m_playRate; }
 		void GetMatrixPalette(std::vector<glm::mat4>& outMatrixPalette) const;
+		// Escribe JointCount() matrices a partir de outMatrixPalette, por ejemplo dentro del buffer de paletas de un frame
+		void GetMatrixPalette(glm::mat4* outMatrixPalette) const;
 		std::shared_ptr<AnimationClip> GetCurrentAnimation() const { return m_animationClipPtr;  }
 		JointPose GetJointModelPose(uint32_t jointIndex) const;
+		/*
+		* Hace que al pedir clip se muestree sampledClip, sin cambiar la animacion que reporta el controlador.
+		* Un sampledClip nulo quita el reemplazo.
+		*/
+		void SetSampledClip(std::shared_ptr<AnimationClip> clip, std::shared_ptr<AnimationClip> sampledClip) noexcept;
+		void ClearSampledClips() noexcept { m_sampledClips.clear(); }
 	private:
+		AnimationClip* GetSampledClip(const std::shared_ptr<AnimationClip>& clip) const noexcept;
 		void UpdateCurrentPose(float timeStep) noexcept;
 		float m_sampleTime = 0.0f;
 		float m_playRate = 1.0f;
@@ -34,6 +44,8 @@ namespace Mona {
 		std::vector<JointPose> m_currentPose;
 		CrossFadeTarget m_crossfadeTarget;
 		std::shared_ptr<AnimationClip> m_animationClipPtr;
+		// Pares de clip pedido y clip muestreado, como la copia de cada animacion que corrige un IKRig
+		std::vector<std::pair<std::shared_ptr<AnimationClip>, std::shared_ptr<AnimationClip>>> m_sampledClips;
 	};
 }
 #endif
\ No newline at end of file
@@ -1,13 +1,22 @@
 #include "AnimationSystem.hpp"
 #include "../World/ComponentManager.hpp"
+#include "../World/GameObject.hpp"
+#include "../Core/JobSystem.hpp"
+#define ANIMATION_SYSTEM_BATCH_SIZE 8
 namespace Mona {
 	void AnimationSystem::UpdateAllPoses(ComponentManager<SkeletalMeshComponent>& skeletalMeshDataManager, float timeStep) noexcept {
 		//Se itera sobre todas las componentes de animacin, los animation controller son los responsables de la logica de
 		//actualizacin.
-		for (uint32_t i = 0; i < skeletalMeshDataManager.GetCount(); i++) {
-			SkeletalMeshComponent& skeletalMesh = skeletalMeshDataManager[i];
-			auto& animationController = skeletalMesh.GetAnimationController();
-			animationController.UpdateCurrentPose(timeStep);
-		}
+		JobSystem::GetInstance().ParallelFor(skeletalMeshDataManager.GetCount(), ANIMATION_SYSTEM_BATCH_SIZE,
+			[&skeletalMeshDataManager, timeStep](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; i++) {
+					if (skeletalMeshDataManager.GetOwnerByIndex(i)->GetState() == GameObject::EState::Inactive) {
+						continue;
+					}
+					SkeletalMeshComponent& skeletalMesh = skeletalMeshDataManager[i];
+					auto& animationController = skeletalMesh.GetAnimationController();
+					animationController.UpdateCurrentPose(timeStep);
+				}
+			});
 	}
 }
\ No newline at end of file
@@ -65,6 +65,8 @@ namespace Mona {
 		std::shared_ptr<SkinnedMesh> m_skinnedMeshPtr;
 		std::shared_ptr<Material> m_materialPtr;
 		AnimationController m_animationController;
+		// Nivel de detalle elegido en el ultimo frame, para la histeresis al cambiar de nivel
+		uint32_t m_lodLevel = 0;
 	};
 }
 #endif
\ No newline at end of file
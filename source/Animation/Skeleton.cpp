@@ -1,6 +1,5 @@
 #include "Skeleton.hpp"
 #include <stack>
-#include "../Rendering/Renderer.hpp"
 #include "../Core/Log.hpp"
 #include "../Core/AssimpTransformations.hpp"
 #include <assimp/Importer.hpp>
@@ -34,16 +33,6 @@ namespace Mona {
 
 		}
 
-		//Chequeo del tamao del esqueleto a importar
-		if (Renderer::NUM_MAX_BONES < boneInfo.size())
-		{
-			MONA_LOG_ERROR("Skeleton Error: Skeleton at {0} has {1} bones while the engine can only support {2}",
-				filePath,
-				boneInfo.size(),
-				Renderer::NUM_MAX_BONES);
-			return;
-		}
-
 		//Se reserva la memoria necesaria
 		m_invBindPoseMatrices.reserve(boneInfo.size());
 		m_jointNames.reserve(boneInfo.size());
@@ -97,6 +86,13 @@ namespace Mona {
 		size_t pos = filePath.find_last_of("/\\");
 		std::string fileName = pos != std::string::npos ? filePath.substr(pos + 1): filePath;
 		m_modelName = funcUtils::splitString(fileName, '.')[0];
+		std::size_t bytes = (m_invBindPoseMatrices.capacity() + m_offsets.capacity()) * sizeof(glm::mat4);
+		bytes += m_parentIndices.capacity() * sizeof(std::int32_t);
+		for (const auto& jointName : m_jointNames) {
+			bytes += sizeof(std::string) + jointName.capacity();
+		}
+		bytes += m_jointMap.size() * (sizeof(std::string) + sizeof(uint32_t));
+		m_memoryAccount.Set(bytes, 0);
 	}
 	
 }
@@ -6,6 +6,7 @@
 #include <vector>
 #include <unordered_map>
 #include <glm/glm.hpp>
+#include "../Core/MemoryTracker.hpp"
 namespace Mona {
 
 
@@ -70,6 +71,7 @@ namespace Mona {
 		std::vector<std::int32_t> m_parentIndices;
 		std::vector<glm::mat4> m_offsets;
 		std::string m_modelName;
+		MemoryAccount m_memoryAccount{ MemoryTag::Skeletons };
 	};
 }
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Skeleton.hpp"
 namespace Mona {
 	std::shared_ptr<Skeleton> SkeletonManager::LoadSkeleton(const std::filesystem::path& filePath) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		const std::string& stringPath = filePath.string();
 		//En caso de que ya exista una entrada en el mapa de esqueletos con el mismo path, 
 		// entonces se retorna inmediatamente dicho esqueleto.
@@ -16,7 +17,34 @@ namespace Mona {
 		return skeletonSharedPtr;
 	}
 
+	AssetFuture<Skeleton> SkeletonManager::LoadSkeletonAsync(const std::filesystem::path& filePath) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const std::string stringPath = filePath.string();
+		auto it = m_skeletonMap.find(stringPath);
+		if (it != m_skeletonMap.end()) {
+			return AssetFuture<Skeleton>(it->second);
+		}
+		auto pendingIt = m_pendingSkeletons.find(stringPath);
+		if (pendingIt != m_pendingSkeletons.end() && !pendingIt->second.IsReady()) {
+			return pendingIt->second;
+		}
+		//El esqueleto no usa recursos de GPU, por lo que se construye completo en el worker
+		auto future = AssetLoader::GetInstance().Load<Skeleton>([this, stringPath](AssetLoader::UploadTask& outUpload) {
+			std::shared_ptr<Skeleton> skeleton = std::shared_ptr<Skeleton>(new Skeleton(stringPath));
+			outUpload = [this, stringPath, skeleton]() {
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pendingSkeletons.erase(stringPath);
+				m_skeletonMap.insert({ stringPath, skeleton });
+			};
+			return skeleton;
+		});
+		AssetFuture<Skeleton> result(future, nullptr);
+		m_pendingSkeletons.insert_or_assign(stringPath, result);
+		return result;
+	}
+
 	void SkeletonManager::CleanUnusedSkeletons() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		/*
 		* Elimina todos los punteros del mapa cuyo conteo de referencias es igual a uno,
 		* es decir, que el puntero del mapa es el unico que apunta a esa memoria.
@@ -33,7 +61,9 @@ namespace Mona {
 	}
 
 	void SkeletonManager::ShutDown() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		//Al cerrar el motor se llama esta funcin donde se limpia el mapa de equeletos
 		m_skeletonMap.clear();
+		m_pendingSkeletons.clear();
 	}
 }
\ No newline at end of file
@@ -4,7 +4,9 @@
 #include <memory>
 #include <string>
 #include <filesystem>
+#include <mutex>
 #include <unordered_map>
+#include "../Core/AssetLoader.hpp"
 namespace Mona {
 	class Skeleton;
 	class SkeletonManager {
@@ -14,6 +16,8 @@ namespace Mona {
 		SkeletonManager(SkeletonManager const&) = delete;
 		SkeletonManager& operator=(SkeletonManager const&) = delete;
 		std::shared_ptr<Skeleton> LoadSkeleton(const std::filesystem::path& filePath) noexcept;
+		// Igual que LoadSkeleton, pero el archivo se lee en un worker. El esqueleto solo se entrega una vez listo
+		AssetFuture<Skeleton> LoadSkeletonAsync(const std::filesystem::path& filePath) noexcept;
 		void CleanUnusedSkeletons() noexcept;
 		static SkeletonManager& GetInstance() noexcept {
 			static SkeletonManager manager;
@@ -22,7 +26,11 @@ namespace Mona {
 	private:
 		SkeletonManager() = default;
 		void ShutDown() noexcept;
+		// Las cargas y limpiezas pueden llamarse desde varios mundos en hilos distintos
+		std::mutex m_mutex;
 		SkeletonMap m_skeletonMap;
+		// Cargas asincronas en curso, para no leer dos veces el mismo archivo
+		std::unordered_map<std::string, AssetFuture<Skeleton>> m_pendingSkeletons;
 	};
 }
 #endif
\ No newline at end of file
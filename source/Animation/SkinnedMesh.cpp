@@ -1,7 +1,10 @@
 #include "SkinnedMesh.hpp"
 
 #include "../Core/Log.hpp"
+#include "../Platform/Window.hpp"
 #include "../Core/AssimpTransformations.hpp"
+#include "../Core/Config.hpp"
+#include "../Rendering/MeshOptimizer.hpp"
 #include <glm/glm.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -36,6 +39,7 @@ namespace Mona {
 		glDeleteBuffers(1, &m_indexBufferID);
 		glDeleteVertexArrays(1, &m_vertexArrayID);
 		m_vertexArrayID = 0;
+		m_memoryAccount.Reset();
 	}
 
 	SkinnedMesh::SkinnedMesh(std::shared_ptr<Skeleton> skeleton,
@@ -227,17 +231,78 @@ namespace Mona {
 
 			}
 		}
+		//Se unen los vertices repetidos y se reordenan triangulos y vertices para la cache de la GPU y para reducir overdraw
+		OptimizeMesh(vertices, faces);
+		if (!vertices.empty()) {
+			//Solo se colapsan vertices con el mismo hueso dominante, para no deformar la piel alrededor de las articulaciones
+			std::vector<uint32_t> dominantBones(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++) {
+				const glm::vec4& boneWeights = vertices[i].boneWeights;
+				int dominant = 0;
+				for (int k = 1; k < 4; k++) {
+					if (boneWeights[k] > boneWeights[dominant])
+						dominant = k;
+				}
+				dominantBones[i] = static_cast<uint32_t>(vertices[i].boneIds[dominant]);
+			}
+			//Los indices de los niveles de detalle quedan a continuacion de los del nivel 0
+			ComputeBoundingSphere(&vertices[0].position.x, sizeof(SkeletalMeshVertex), vertices.size(), m_boundingSphereCenter, m_boundingSphereRadius);
+			m_lods = GenerateMeshLODChain(faces, &vertices[0].position.x, sizeof(SkeletalMeshVertex), vertices.size(), dominantBones);
+		}
+		//Los vertices comprimidos guardan los indices de hueso en 8 bits, esqueletos mas grandes usan vertices sin comprimir
+		bool compressVertices = Config::GetInstance().getValueOrDefault<int>("compress_mesh_vertices", 0) != 0 &&
+			skeleton->JointCount() <= SKINNED_COMPRESSED_MAX_JOINTS;
+
 		//Comienza el paso de los datos en CPU a GPU usando OpenGL
-		m_indexBufferCount = static_cast<uint32_t>(faces.size());
+		m_indexBufferCount = m_lods.empty() ? static_cast<uint32_t>(faces.size()) : m_lods[0].indexCount;
+		//Sin contexto grafico (mundos sin ventana) la malla solo conserva su esqueleto
+		if (!Window::IsGraphicsContextCurrent())
+			return;
 		glGenVertexArrays(1, &m_vertexArrayID);
 		glBindVertexArray(m_vertexArrayID);
 
 		glGenBuffers(1, &m_vertexBufferID);
 		glGenBuffers(1, &m_indexBufferID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferID);
-		glBufferData(GL_ARRAY_BUFFER, static_cast<unsigned int>(vertices.size()) * sizeof(SkeletalMeshVertex), vertices.data(), GL_STATIC_DRAW);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBufferID);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<unsigned int>(faces.size()) * sizeof(unsigned int), faces.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferID);
+		std::vector<CompressedSkinnedMeshVertex> compressedVertices;
+		if (compressVertices && !vertices.empty()) {
+			m_positionQuantization = ComputePositionQuantization(&vertices[0].position.x, sizeof(SkeletalMeshVertex), vertices.size());
+			compressedVertices.resize(vertices.size());
+			for (size_t i = 0; compressVertices && i < vertices.size(); i++) {
+				const SkeletalMeshVertex& vertex = vertices[i];
+				compressVertices = CompressVertex(vertex.position, vertex.normal, vertex.uv, vertex.tangent, vertex.bitangent, vertex.boneIds,
+					vertex.boneWeights, m_positionQuantization, compressedVertices[i]);
+			}
+			//Un indice de hueso invalido en el archivo no se puede representar, la malla se sube sin comprimir
+			if (!compressVertices) {
+				MONA_LOG_WARNING("SkinnedMesh Warning: Bone indices do not fit in 8 bits, using uncompressed vertices.");
+				compressedVertices.clear();
+				m_positionQuantization = PositionQuantization();
+			}
+		}
+		if (compressVertices && !vertices.empty()) {
+			m_compressedVertices = true;
+			glBufferData(GL_ARRAY_BUFFER, static_cast<unsigned int>(compressedVertices.size()) * sizeof(CompressedSkinnedMeshVertex), compressedVertices.data(), GL_STATIC_DRAW);
+			m_memoryAccount.Set(0, compressedVertices.size() * sizeof(CompressedSkinnedMeshVertex) + faces.size() * sizeof(unsigned int));
+			//Los indices de hueso se leen como floats sin normalizar y los pesos como bytes normalizados, igual que en el formato sin comprimir
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, sizeof(CompressedSkinnedMeshVertex), (void*)offsetof(CompressedSkinnedMeshVertex, position));
+			glEnableVertexAttribArray(1);
+			glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(CompressedSkinnedMeshVertex), (void*)offsetof(CompressedSkinnedMeshVertex, normal));
+			glEnableVertexAttribArray(2);
+			glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompressedSkinnedMeshVertex), (void*)offsetof(CompressedSkinnedMeshVertex, uv));
+			glEnableVertexAttribArray(3);
+			glVertexAttribPointer(3, 3, GL_SHORT, GL_TRUE, sizeof(CompressedSkinnedMeshVertex), (void*)offsetof(CompressedSkinnedMeshVertex, tangent));
+			glEnableVertexAttribArray(5);
+			glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(CompressedSkinnedMeshVertex), (void*)offsetof(CompressedSkinnedMeshVertex, boneIds));
+			glEnableVertexAttribArray(6);
+			glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CompressedSkinnedMeshVertex), (void*)offsetof(CompressedSkinnedMeshVertex, boneWeights));
+			return;
+		}
+		glBufferData(GL_ARRAY_BUFFER, static_cast<unsigned int>(vertices.size()) * sizeof(SkeletalMeshVertex), vertices.data(), GL_STATIC_DRAW);
+		m_memoryAccount.Set(0, vertices.size() * sizeof(SkeletalMeshVertex) + faces.size() * sizeof(unsigned int));
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkeletalMeshVertex), (void*)offsetof(SkeletalMeshVertex, position));
 		glEnableVertexAttribArray(1);
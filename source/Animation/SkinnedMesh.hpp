@@ -4,6 +4,10 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
+#include "../Core/MemoryTracker.hpp"
+#include "../Rendering/VertexCompression.hpp"
+#include "../Rendering/MeshLOD.hpp"
 namespace Mona {
 	class Skeleton;
 	class SkinnedMesh {
@@ -13,6 +17,14 @@ namespace Mona {
 		uint32_t GetVertexArrayID() const noexcept { return m_vertexArrayID; }
 		uint32_t GetIndexBufferCount() const noexcept { return m_indexBufferCount; }
 		std::shared_ptr<Skeleton> GetSkeleton() const noexcept{ return m_skeletonPtr; }
+		// Verdadero si los vertices usan CompressedSkinnedMeshVertex, activado con compress_mesh_vertices en config.cfg
+		bool HasCompressedVertices() const noexcept { return m_compressedVertices; }
+		const PositionQuantization& GetPositionQuantization() const noexcept { return m_positionQuantization; }
+		// Niveles de detalle de la malla. Todos comparten los vertices
+		const std::vector<MeshLOD>& GetLODs() const noexcept { return m_lods; }
+		// Esfera que contiene la malla en espacio local, usada para medir su tamano en pantalla
+		const glm::vec3& GetBoundingSphereCenter() const noexcept { return m_boundingSphereCenter; }
+		float GetBoundingSphereRadius() const noexcept { return m_boundingSphereRadius; }
 	private:
 		SkinnedMesh(std::shared_ptr<Skeleton> skeleton,
 			const std::string& filePath,
@@ -23,6 +35,12 @@ namespace Mona {
 		uint32_t m_vertexBufferID;
 		uint32_t m_indexBufferID;
 		uint32_t m_indexBufferCount;
+		bool m_compressedVertices = false;
+		PositionQuantization m_positionQuantization;
+		std::vector<MeshLOD> m_lods;
+		glm::vec3 m_boundingSphereCenter = glm::vec3(0.0f);
+		float m_boundingSphereRadius = 0.0f;
+		MemoryAccount m_memoryAccount{ MemoryTag::Meshes };
 	};
 }
 #endif
\ No newline at end of file
@@ -1,9 +1,11 @@
 #pragma once
 #ifndef AUDIOCLIP_HPP
 #define AUDIOCLIP_HPP
+#include <memory>
 #include <string>
 #include <AL/al.h>
 #include <AL/alc.h>
+#include "../Core/MemoryTracker.hpp"
 namespace Mona {
 
 	/*
@@ -52,6 +54,13 @@ namespace Mona {
 		* con los datos de audio (EJ: "C:/Home/Desktop/Music.wav") . De momento el nico formato soporta es wav.
 		*/
 		AudioClip(const std::string& audioFilePath);
+		AudioClip();
+
+		// Muestras decodificadas en CPU, listas para pasarse a OpenAL
+		struct WavData;
+		// Solo usa CPU, por lo que puede llamarse desde cualquier hilo. Devuelve nullptr si el archivo no se pudo leer
+		static std::shared_ptr<WavData> ReadFile(const std::string& audioFilePath) noexcept;
+		void Upload(const WavData& audioData) noexcept;
 
 		/*
 		* Metodo que libera los recursos de OpenAL asociados a esta instancia. Esta funcin es llamada al momento
@@ -63,6 +72,7 @@ namespace Mona {
 		float m_totalTime;
 		ALuint m_alBufferID;
 		uint8_t m_channels;
+		MemoryAccount m_memoryAccount{ MemoryTag::AudioClips };
 	};
 }
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "../Core/Log.hpp"
 namespace Mona {
 	std::shared_ptr<AudioClip> AudioClipManager::LoadAudioClip(const std::filesystem::path& filePath) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		const std::string stringPath = filePath.string();
 		//Primero se chequea si ya hay una instancia en el mapa de AudioClip con la misma direccin recien entregada
 		auto it = m_audioClipMap.find(stringPath);
@@ -15,7 +16,36 @@ namespace Mona {
 
 	}
 
+	AssetFuture<AudioClip> AudioClipManager::LoadAudioClipAsync(const std::filesystem::path& filePath) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const std::string stringPath = filePath.string();
+		auto it = m_audioClipMap.find(stringPath);
+		if (it != m_audioClipMap.end())
+			return AssetFuture<AudioClip>(it->second);
+		//Una carga pendiente ya completa no se subio porque su mundo se cerro antes, por lo que se vuelve a cargar
+		auto pendingIt = m_pendingAudioClips.find(stringPath);
+		if (pendingIt != m_pendingAudioClips.end() && !pendingIt->second.IsReady())
+			return pendingIt->second;
+		std::shared_ptr<AudioClip> audioClip = std::shared_ptr<AudioClip>(new AudioClip());
+		auto future = AssetLoader::GetInstance().Load<AudioClip>([this, audioClip, stringPath](AssetLoader::UploadTask& outUpload) {
+			std::shared_ptr<AudioClip::WavData> audioData = AudioClip::ReadFile(stringPath);
+			outUpload = [this, audioClip, stringPath, audioData]() {
+				if (audioData) {
+					audioClip->Upload(*audioData);
+				}
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pendingAudioClips.erase(stringPath);
+				m_audioClipMap.insert({ stringPath, audioClip });
+			};
+			return audioClip;
+		});
+		AssetFuture<AudioClip> result(future, audioClip);
+		m_pendingAudioClips.insert_or_assign(stringPath, result);
+		return result;
+	}
+
 	void AudioClipManager::CleanUnusedAudioClips() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		//Se recorre el mapa de AudioClips revisando los punteros compartidos que tienen un conteo de referencias igual a uno,
 		//es decir, que solo es este mapa quien los referencia.
 		for(auto i = m_audioClipMap.begin(), last = m_audioClipMap.end(); i!= last;){
@@ -30,9 +60,11 @@ namespace Mona {
 	}
 
 	void AudioClipManager::ShutDown() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		for (auto& entry : m_audioClipMap) {
 			(entry.second)->DeleteOpenALBuffer();
 		}
 		m_audioClipMap.clear();
+		m_pendingAudioClips.clear();
 	}
 }
\ No newline at end of file
@@ -2,10 +2,12 @@
 #ifndef AUDIOCLIPMANAGER_HPP
 #define AUDIOCLIPMANAGER_HPP
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <filesystem>
 #include <string>
 #include "AudioClip.hpp"
+#include "../Core/AssetLoader.hpp"
 namespace Mona {
 	/*
 	* Clase responsable de la creacin y administracin de instancias de AudioClips
@@ -23,6 +25,11 @@ namespace Mona {
 		*/
 		std::shared_ptr<AudioClip> LoadAudioClip(const std::filesystem::path& filePath) noexcept;
 		/*
+		* Igual que LoadAudioClip, pero el archivo se decodifica en un worker y se pasa a OpenAL en un frame posterior.
+		* Hasta entonces el clip entregado dura cero segundos, por lo que una fuente que lo reproduzca no suena.
+		*/
+		AssetFuture<AudioClip> LoadAudioClipAsync(const std::filesystem::path& filePath) noexcept;
+		/*
 		* Limpia o elimina las instancias de AudioCLips que solo estan siendo referenciadas por esta clase
 		*/
 		void CleanUnusedAudioClips() noexcept;
@@ -39,7 +46,11 @@ namespace Mona {
 		* liberar todos los recursos de OpenAL asoaciados a cada una de las instancias de AudioClip cargadas.
 		*/
 		void ShutDown() noexcept;
+		// Las cargas y limpiezas pueden llamarse desde varios mundos en hilos distintos
+		std::mutex m_mutex;
 		AudioClipMap m_audioClipMap;
+		// Cargas asincronas en curso, para no leer dos veces el mismo archivo
+		std::unordered_map<std::string, AssetFuture<AudioClip>> m_pendingAudioClips;
 	};
 }
 #endif
\ No newline at end of file
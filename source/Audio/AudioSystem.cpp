@@ -57,9 +57,9 @@ namespace Mona {
 		glm::vec3 listenerPosition = glm::vec3(0.0f);
 		if (transformDataManager.IsValid(audioListenerTransformHandle)) {
 			const TransformComponent* listenerTransform = transformDataManager.GetComponentPointer(audioListenerTransformHandle);
-			listenerPosition = listenerTransform->GetLocalTranslation();
-			glm::vec3 frontVector = glm::rotate(audioListenerOffsetRotation, listenerTransform->GetFrontVector());
-			glm::vec3 upVector = glm::rotate(audioListenerOffsetRotation, listenerTransform->GetUpVector());
+			listenerPosition = listenerTransform->GetWorldTranslation();
+			glm::vec3 frontVector = glm::rotate(audioListenerOffsetRotation, listenerTransform->GetWorldFrontVector());
+			glm::vec3 upVector = glm::rotate(audioListenerOffsetRotation, listenerTransform->GetWorldUpVector());
 			UpdateListener(listenerPosition, frontVector, upVector);
 		}
 		else {
@@ -71,16 +71,19 @@ namespace Mona {
 		//Se remueven las fuentes libres que ya terminaron de reproducir su clip de audio
 		RemoveCompletedFreeAudioSources();
 
+		//Las componentes cuyo dueno esta inactivo quedan al final, sin fuente de OpenAL y con su timer detenido
+		const uint32_t activeComponentCount = PartitionAndRemoveOpenALSourceFromInactiveAudioSourceComponents(audioDataManager);
+
 		//Ambos tipos de fuentes avanzan sus timers en timeStep segundos
 		UpdateFreeAudioSourcesTimers(timeStep);
-		UpdateAudioSourceComponentsTimers(timeStep, audioDataManager);
+		UpdateAudioSourceComponentsTimers(timeStep, audioDataManager, activeComponentCount);
 
 		//Comienza la asignacin de fuentes de OpenAL a las fuentes del motor.
-		if (m_freeAudioSources.size() + audioDataManager.GetCount() <= m_openALSources.size()) {
+		if (m_freeAudioSources.size() + activeComponentCount <= m_openALSources.size()) {
 			//Si la suma de fuentes libres y fuentes ligadas a GameObjects es menor que la cantidad de fuentes de OpenAL disponibles
 			//Asignamos recursos a todas.
 			AssignOpenALSourceToFreeAudioSources(m_freeAudioSources.begin(), m_freeAudioSources.end());
-			AssignOpenALSourceToAudioSourceComponents(audioDataManager, transformDataManager, 0, audioDataManager.GetCount());
+			AssignOpenALSourceToAudioSourceComponents(audioDataManager, transformDataManager, 0, activeComponentCount);
 		}
 		else {
 
@@ -89,7 +92,7 @@ namespace Mona {
 			//Remover recursos de OpenAL de fuentes 3D fuera de rango o que terminaron de reproducir su audio clip
 			// y obtener iterador a la primera que quedo fuera
 			uint32_t firstOutAudioComponent = PartitionAndRemoveOpenALSourceFromAudioSourceComponents(audioDataManager, 
-				transformDataManager, listenerPosition);
+				transformDataManager, listenerPosition, activeComponentCount);
 
 
 			if (std::distance(m_freeAudioSources.begin(), firstOutFreeSource) + firstOutAudioComponent <= m_openALSources.size()) {
@@ -125,7 +128,7 @@ namespace Mona {
 
 				}
 				RemoveOpenALSourceFromFreeAudioSources(m_freeAudioSources.begin() + firstToRemoveFreeSource, m_freeAudioSources.end());
-				RemoveOpenALSourceFromAudioSourceComponents(audioDataManager, firstToRemoveSourceComponent, audioDataManager.GetCount());
+				RemoveOpenALSourceFromAudioSourceComponents(audioDataManager, firstToRemoveSourceComponent, activeComponentCount);
 				AssignOpenALSourceToFreeAudioSources(m_freeAudioSources.begin(), m_freeAudioSources.begin() + firstToRemoveFreeSource);
 				AssignOpenALSourceToAudioSourceComponents(audioDataManager, transformDataManager, 0, firstToRemoveSourceComponent);
 
@@ -226,11 +229,25 @@ namespace Mona {
 		}
 	}
 
-	void AudioSystem::UpdateAudioSourceComponentsTimers(float timeStep, ComponentManager<AudioSourceComponent>& audioDataManager)
+	uint32_t AudioSystem::PartitionAndRemoveOpenALSourceFromInactiveAudioSourceComponents(ComponentManager<AudioSourceComponent>& audioDataManager)
+	{
+		uint32_t activeCount = 0;
+		for (uint32_t i = 0; i < audioDataManager.GetCount(); i++) {
+			if (audioDataManager.GetOwnerByIndex(i)->GetState() != GameObject::EState::Inactive) {
+				if (i != activeCount)
+					audioDataManager.SwapComponents(i, activeCount);
+				activeCount++;
+			}
+		}
+		RemoveOpenALSourceFromAudioSourceComponents(audioDataManager, activeCount, audioDataManager.GetCount());
+		return activeCount;
+	}
+
+	void AudioSystem::UpdateAudioSourceComponentsTimers(float timeStep, ComponentManager<AudioSourceComponent>& audioDataManager, uint32_t lastIndex)
 	{
 		//El proceso de actualizar las fuentes de audio usadas como componentes es un poco mas complejo.
 		//Ya que estas pueden estar en repeticin, en pausa o detenidas.
-		for (uint32_t i = 0; i < audioDataManager.GetCount(); i++) {
+		for (uint32_t i = 0; i < lastIndex; i++) {
 			auto& audioComponent = audioDataManager[i];
 			if (audioComponent.m_sourceState == AudioSourceState::Paused || audioComponent.m_sourceState == AudioSourceState::Stopped) continue;
 			if (audioComponent.m_timeLeft < 0) audioComponent.m_sourceState = AudioSourceState::Stopped;
@@ -266,14 +283,14 @@ namespace Mona {
 	}
 
 	uint32_t AudioSystem::PartitionAndRemoveOpenALSourceFromAudioSourceComponents(ComponentManager<AudioSourceComponent>& audioDataManager,
-		const ComponentManager<TransformComponent>& transformDataManager, const glm::vec3& listenerPosition)
+		const ComponentManager<TransformComponent>& transformDataManager, const glm::vec3& listenerPosition, uint32_t lastIndex)
 	{
 		uint32_t currentIndex = 0;
-		uint32_t backIndex = audioDataManager.GetCount() - 1;
-		while (currentIndex <= backIndex) {
+		uint32_t endIndex = lastIndex;
+		while (currentIndex < endIndex) {
 			AudioSourceComponent& audioSource = audioDataManager[currentIndex];
 			const TransformComponent* transform = transformDataManager.GetComponentPointer(audioSource.m_transformHandle);
-			const glm::vec3& position = transform->GetLocalTranslation();
+			const glm::vec3 position = transform->GetWorldTranslation();
 			float squareRadius = audioSource.m_radius * audioSource.m_radius;
 			float squareDistance = glm::distance2(position, listenerPosition);
 			if (audioSource.m_sourceState == AudioSourceState::Playing &&
@@ -281,11 +298,11 @@ namespace Mona {
 				currentIndex++;
 			}
 			else {
-				audioDataManager.SwapComponents(currentIndex, backIndex);
-				backIndex--;
+				audioDataManager.SwapComponents(currentIndex, endIndex - 1);
+				endIndex--;
 			}
 		}
-		for (uint32_t i = currentIndex; i < audioDataManager.GetCount(); i++) {
+		for (uint32_t i = currentIndex; i < lastIndex; i++) {
 			AudioSourceComponent& audioSource = audioDataManager[i];
 			if (audioSource.m_openALsource) {
 				AudioSource::OpenALSource openALSource = audioSource.m_openALsource.value();
@@ -366,7 +383,7 @@ namespace Mona {
 			{
 				//Si la fuente es 3D se actualizan las posiciones
 				const TransformComponent* transform = transformDataManager.GetComponentPointer(audioSource.m_transformHandle);
-				const glm::vec3& position = transform->GetLocalTranslation();
+				const glm::vec3 position = transform->GetWorldTranslation();
 				ALCALL(alSource3f(audioSource.m_openALsource.value().m_sourceID, AL_POSITION, position.x, position.y, position.z));
 			}
 		}
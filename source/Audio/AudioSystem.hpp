@@ -85,11 +85,13 @@ namespace Mona {
 		void UpdateListener(const glm::vec3& position, const glm::vec3& frontVector, const glm::vec3& upVector);
 		void RemoveCompletedFreeAudioSources();
 		void UpdateFreeAudioSourcesTimers(float timeStep);
-		void UpdateAudioSourceComponentsTimers(float timeStep, ComponentManager<AudioSourceComponent>& audioDataManager);
+		uint32_t PartitionAndRemoveOpenALSourceFromInactiveAudioSourceComponents(ComponentManager<AudioSourceComponent>& audioDataManager);
+		void UpdateAudioSourceComponentsTimers(float timeStep, ComponentManager<AudioSourceComponent>& audioDataManager, uint32_t lastIndex);
 		std::vector<FreeAudioSource>::iterator PartitionAndRemoveOpenALSourceFromFreeAudioSources(const glm::vec3& listenerPosition);
 		uint32_t PartitionAndRemoveOpenALSourceFromAudioSourceComponents(ComponentManager<AudioSourceComponent>& audioDataManager,
 			const ComponentManager<TransformComponent>& transformDataManager,
-			const glm::vec3& listenerPosition);
+			const glm::vec3& listenerPosition,
+			uint32_t lastIndex);
 		void AssignOpenALSourceToFreeAudioSources(std::vector<FreeAudioSource>::iterator begin,
 			std::vector<FreeAudioSource>::iterator end);
 		void AssignOpenALSourceToAudioSourceComponents(ComponentManager<AudioSourceComponent>& audioDataManager,
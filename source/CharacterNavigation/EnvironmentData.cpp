@@ -25,6 +25,19 @@ namespace Mona{
         }
     }
 
+    void EnvironmentData::prepareTerrains(ComponentManager<StaticMeshComponent>& staticMeshManager) {
+        for (int i = 0; i < m_terrains.size(); i++) {
+            InnerComponentHandle meshInnerHandle = m_terrains[i].m_meshHandle;
+            if (!staticMeshManager.IsValid(meshInnerHandle)) {
+                continue;
+            }
+            StaticMeshComponent* staticMesh = staticMeshManager.GetComponentPointer(meshInnerHandle);
+            if (!staticMesh->GetHeightMap()->isValid()) {
+                staticMesh->GetTerrainShape();
+            }
+        }
+    }
+
     bool EnvironmentData::withinGlobalBoundaries(glm::vec2 xyPoint, HeightMap* heightMap, glm::mat4 globalTerrainTransform) {
         glm::vec2 globalMin = globalTerrainTransform * glm::vec4(heightMap->getMinXY(), 0, 1);
         glm::vec2 globalMax = globalTerrainTransform * glm::vec4(heightMap->getMaxXY(), 0, 1);
@@ -44,6 +57,9 @@ namespace Mona{
             }
             const StaticMeshComponent* staticMesh = staticMeshManager.GetComponentPointer(m_terrains[i].m_meshHandle);
             HeightMap* heigtMap = staticMesh->GetHeightMap();
+            if (!heigtMap->isValid()) {
+                continue;
+            }
             TransformComponent* staticMeshTransform = transformManager.GetComponentPointer(m_terrains[i].m_transformHandle);
             MONA_ASSERT(staticMeshTransform->GetLocalRotation() == glm::identity<glm::fquat>(), "EnvironmentData: Terrains cannot be rotated.");
             glm::mat4 glblTransform = staticMeshTransform->GetModelMatrix();
@@ -53,6 +69,7 @@ namespace Mona{
 
                 glm::vec3 localPoint = glm::inverse(glblTransform) * glm::vec4(xyPoint, 0, 1);
                 float localHeight = heigtMap->getHeight(localPoint[0], localPoint[1]);
+                if (localHeight == std::numeric_limits<float>::lowest()) { continue; }
                 localPoint[2] = localHeight;
                 glm::vec4 glblPoint = glblTransform * glm::vec4(localPoint, 1);
                 float result = glblPoint[2];
@@ -63,6 +80,79 @@ namespace Mona{
         return maxHeight;
     }
 
+    glm::vec3 EnvironmentData::getTerrainNormal(glm::vec2 xyPoint, ComponentManager<TransformComponent>& transformManager,
+        ComponentManager<StaticMeshComponent>& staticMeshManager) {
+        // la normal es la del terreno mas alto en el punto, igual que la altura
+        float maxHeight = std::numeric_limits<float>::lowest();
+        glm::vec3 normal(0, 0, 1);
+        for (int i = 0; i < m_terrains.size(); i++) {
+            if (!staticMeshManager.IsValid(m_terrains[i].m_meshHandle)) {
+                continue;
+            }
+            const StaticMeshComponent* staticMesh = staticMeshManager.GetComponentPointer(m_terrains[i].m_meshHandle);
+            HeightMap* heigtMap = staticMesh->GetHeightMap();
+            if (!heigtMap->isValid()) {
+                continue;
+            }
+            TransformComponent* staticMeshTransform = transformManager.GetComponentPointer(m_terrains[i].m_transformHandle);
+            MONA_ASSERT(staticMeshTransform->GetLocalRotation() == glm::identity<glm::fquat>(), "EnvironmentData: Terrains cannot be rotated.");
+            glm::mat4 glblTransform = staticMeshTransform->GetModelMatrix();
+            if (withinGlobalBoundaries(xyPoint, heigtMap, glblTransform)) {
+                glm::vec3 localPoint = glm::inverse(glblTransform) * glm::vec4(xyPoint, 0, 1);
+                float localHeight = heigtMap->getHeight(localPoint[0], localPoint[1]);
+                if (localHeight == std::numeric_limits<float>::lowest()) { continue; }
+                localPoint[2] = localHeight;
+                float result = (glblTransform * glm::vec4(localPoint, 1))[2];
+                if (result > maxHeight) {
+                    maxHeight = result;
+                    // sin rotacion la normal solo se corrige por la escala del terreno
+                    glm::vec3 localNormal = heigtMap->getNormal(localPoint[0], localPoint[1]);
+                    normal = glm::normalize(glm::transpose(glm::inverse(glm::mat3(glblTransform))) * localNormal);
+                }
+            }
+        }
+        return normal;
+    }
+
+    void EnvironmentData::getTerrainHeights(const std::vector<glm::vec2>& xyPoints, std::vector<float>& outHeights,
+        ComponentManager<TransformComponent>& transformManager, ComponentManager<StaticMeshComponent>& staticMeshManager) {
+        outHeights.assign(xyPoints.size(), std::numeric_limits<float>::lowest());
+        std::vector<glm::vec2> localPoints;
+        std::vector<size_t> pointIndices;
+        std::vector<float> localHeights;
+        for (int i = 0; i < m_terrains.size(); i++) {
+            if (!staticMeshManager.IsValid(m_terrains[i].m_meshHandle)) {
+                continue;
+            }
+            const StaticMeshComponent* staticMesh = staticMeshManager.GetComponentPointer(m_terrains[i].m_meshHandle);
+            HeightMap* heigtMap = staticMesh->GetHeightMap();
+            if (!heigtMap->isValid()) {
+                continue;
+            }
+            TransformComponent* staticMeshTransform = transformManager.GetComponentPointer(m_terrains[i].m_transformHandle);
+            MONA_ASSERT(staticMeshTransform->GetLocalRotation() == glm::identity<glm::fquat>(), "EnvironmentData: Terrains cannot be rotated.");
+            glm::mat4 glblTransform = staticMeshTransform->GetModelMatrix();
+            glm::mat4 invTransform = glm::inverse(glblTransform);
+            localPoints.clear();
+            pointIndices.clear();
+            for (size_t j = 0; j < xyPoints.size(); j++) {
+                if (withinGlobalBoundaries(xyPoints[j], heigtMap, glblTransform)) {
+                    localPoints.push_back(invTransform * glm::vec4(xyPoints[j], 0, 1));
+                    pointIndices.push_back(j);
+                }
+            }
+            localHeights.resize(localPoints.size());
+            heigtMap->getHeights(localPoints.data(), localPoints.size(), localHeights.data());
+            for (size_t j = 0; j < localPoints.size(); j++) {
+                if (localHeights[j] == std::numeric_limits<float>::lowest()) {
+                    continue;
+                }
+                float result = (glblTransform * glm::vec4(localPoints[j], localHeights[j], 1))[2];
+                outHeights[pointIndices[j]] = std::max(outHeights[pointIndices[j]], result);
+            }
+        }
+    }
+
     void EnvironmentData::addTerrain(const GameObjectHandle<GameObject>& staticMeshObject) {
         Terrain terrain(staticMeshObject);
         m_terrains.push_back(terrain);  
@@ -27,6 +27,13 @@ namespace Mona {
 			void addTerrain(const GameObjectHandle<GameObject>& staticMeshObject);
 			int removeTerrain(const GameObjectHandle<GameObject>& staticMeshObject);
 			void validateTerrains(ComponentManager<StaticMeshComponent>& staticMeshManager);
+			// crea las formas de colision de los terrenos cargados desde archivo, antes de que los rigs las consulten en paralelo
+			void prepareTerrains(ComponentManager<StaticMeshComponent>& staticMeshManager);
+			glm::vec3 getTerrainNormal(glm::vec2 xyPoint, ComponentManager<TransformComponent>& transformManager,
+				ComponentManager<StaticMeshComponent>& staticMeshManager);
+			// version por lotes de getTerrainHeight, que recorre cada terreno una sola vez para todos los puntos
+			void getTerrainHeights(const std::vector<glm::vec2>& xyPoints, std::vector<float>& outHeights,
+				ComponentManager<TransformComponent>& transformManager, ComponentManager<StaticMeshComponent>& staticMeshManager);
 	};
 
 }
@@ -2,147 +2,347 @@
 #ifndef GRADIENTDESCENT_HPP
 #define GRADIENTDESCENT_HPP
 
+#include <array>
 #include <vector>
-#include <functional>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <limits>
 #include "../Core/Log.hpp"
 #include "../Core/FuncUtils.hpp"
 
 namespace Mona {
 
-	template <typename dataT>
-	class FunctionTerm { // representa un termino de la funcion objetivo
-		template <typename dataT>
-		friend class GradientDescent;
-		dataT* m_dataPtr;
-		float m_weight = 1.0f;
-		// funcion que calcula el valor del termino dado un vector con los valores de las variables
-		std::function<float(const std::vector<float>&, dataT*)> m_termFunction;
-		// funcion que calcula el valor de la derivada del termino,
-		// dado un vector con los valores de las variables y el indice de la variable
-		// respecto a la cual se deriva
-		std::function<float(const std::vector<float>&, int, dataT*)> m_termPartialDerivativeFunction;
-		float calcTerm(const std::vector<float>& args) {
-			return m_termFunction(args, m_dataPtr);
-		}
-		float calcTermPartialDerivative(const std::vector<float>& args, int varIndex) {
-			return m_termPartialDerivativeFunction(args, varIndex, m_dataPtr);
-		}
+	// Valores de las variables del descenso. Hasta InlineArgNum valores se guardan en un arreglo fijo, lo que evita
+	// asignaciones dinamicas en cada iteracion. Con mas valores se usa memoria dinamica.
+	template <int InlineArgNum>
+	class DescentArgs {
+		std::array<float, InlineArgNum> m_inlineValues;
+		std::vector<float> m_heapValues;
+		int m_size = 0;
 	public:
-		FunctionTerm(std::function<float(const std::vector<float>&, dataT*)> termFunction,
-			std::function<float(const std::vector<float>&, int, dataT*)> termPartialDerivativeFunction) :
-			m_termFunction(termFunction), m_termPartialDerivativeFunction(termPartialDerivativeFunction) {
+		DescentArgs() = default;
+		DescentArgs(int size, float value = 0.0f) { resize(size, value); }
+		void resize(int size, float value = 0.0f) {
+			MONA_ASSERT(0 <= size, "DescentArgs: size must be non negative.");
+			m_size = size;
+			if (isInline()) {
+				m_heapValues.clear();
+				std::fill(m_inlineValues.begin(), m_inlineValues.begin() + m_size, value);
+			}
+			else {
+				m_heapValues.assign(m_size, value);
+			}
 		}
+		int size() const { return m_size; }
+		bool isInline() const { return m_size <= InlineArgNum; }
+		static constexpr int inlineCapacity() { return InlineArgNum; }
+		float& operator[](int index) { return isInline() ? m_inlineValues[index] : m_heapValues[index]; }
+		float operator[](int index) const { return isInline() ? m_inlineValues[index] : m_heapValues[index]; }
 	};
-	
+
 	enum class DescentType {
 		REGULAR,
-		MOMENTUM
+		MOMENTUM,
+		RMSPROP,
+		ADAM
+	};
+
+	enum class DescentTermination {
+		NONE,
+		MAX_ITERATIONS,
+		ARG_DELTA,
+		GRADIENT_NORM,
+		RELATIVE_IMPROVEMENT,
+		LINE_SEARCH
+	};
+
+	struct DescentSettings {
+		DescentType descentType = DescentType::REGULAR;
+		float descentRate = 0.01f;
+		int maxIterations = 100;
+		// se detiene si ninguna variable cambia mas que este valor en un paso
+		float targetArgDelta = 0.0f;
+		// se detiene si la norma del gradiente es menor o igual a este valor
+		float targetGradientNorm = 0.0f;
+		// se detiene si la mejora relativa del valor de la funcion es menor a este valor (0 lo desactiva)
+		float targetRelativeImprovement = 0.0f;
+		// limita el crecimiento de un paso a 10 veces el paso anterior (solo REGULAR y MOMENTUM)
+		bool softenSteps = true;
+		// busqueda lineal con retroceso sobre la tasa de descenso
+		bool lineSearch = false;
+		int maxLineSearchSteps = 6;
+		float lineSearchShrink = 0.5f;
+		// decaimiento del primer momento (MOMENTUM y ADAM)
+		float momentumDecay = 0.8f;
+		// decaimiento del segundo momento (RMSPROP y ADAM)
+		float squaredGradientDecay = 0.999f;
+		float epsilon = 1e-8f;
 	};
-	template <typename dataT>
+
+	struct DescentStatistics {
+		int iterations = 0;
+		int functionEvaluations = 0;
+		// los valores de la funcion solo se calculan si la busqueda lineal o
+		// el criterio de mejora relativa estan activos
+		float initialValue = 0.0f;
+		float finalValue = 0.0f;
+		float finalGradientNorm = 0.0f;
+		DescentTermination termination = DescentTermination::NONE;
+	};
+
+	struct AccumulatedDescentStatistics {
+		int solveCount = 0;
+		long long totalIterations = 0;
+		int earlyTerminations = 0;
+		float averageIterations() const { return solveCount == 0 ? 0.0f : (float)totalIterations / solveCount; }
+		void add(const DescentStatistics& stats) {
+			solveCount += 1;
+			totalIterations += stats.iterations;
+			if (stats.termination != DescentTermination::MAX_ITERATIONS) {
+				earlyTerminations += 1;
+			}
+		}
+	};
+
+	// Cada tipo de termino TermT debe proveer las funciones estaticas:
+	//   static float value(const DescentArgs<InlineArgNum>& args, dataT* dataPtr);
+	//   static float partialDerivative(const DescentArgs<InlineArgNum>& args, int varIndex, dataT* dataPtr);
+	// La lista de terminos se compone en tiempo de compilacion, por lo que no hay indirecciones por termino.
+	template <typename dataT, int InlineArgNum, typename... TermTs>
 	class GradientDescent {
-		std::vector<FunctionTerm<dataT>> m_terms;
-		int m_argNum;
-		dataT* m_dataPtr;
-		std::function<void(std::vector<float>&, dataT*, std::vector<float>&)>  m_postDescentStepCustomBehaviour;
+	public:
+		using ArgsType = DescentArgs<InlineArgNum>;
+		using PostDescentStepFunction = void(*)(ArgsType& args, dataT* dataPtr, ArgsType& argsRawDelta);
+		static constexpr int s_termNum = sizeof...(TermTs);
+	private:
+		static_assert(0 < sizeof...(TermTs), "GradientDescent: Must provide at least one function term");
+		std::array<float, sizeof...(TermTs)> m_weights;
+		int m_argNum = 0;
+		dataT* m_dataPtr = nullptr;
+		PostDescentStepFunction m_postDescentStepCustomBehaviour = nullptr;
+		DescentStatistics m_lastStatistics;
+		AccumulatedDescentStatistics m_accumulatedStatistics;
+
+		template <std::size_t... Is>
+		float functionValue(const ArgsType& args, std::index_sequence<Is...>) {
+			float value = 0;
+			((value += m_weights[Is] != 0 ? m_weights[Is] * TermTs::value(args, m_dataPtr) : 0.0f), ...);
+			return value;
+		}
+
+		template <std::size_t... Is>
+		void accumulateGradient(const ArgsType& args, ArgsType& gradient, std::index_sequence<Is...>) {
+			(accumulateTermGradient<TermTs>(m_weights[Is], args, gradient), ...);
+		}
+
+		template <typename TermT>
+		void accumulateTermGradient(float weight, const ArgsType& args, ArgsType& gradient) {
+			if (weight == 0) {
+				return;
+			}
+			for (int j = 0; j < m_argNum; j++) {
+				gradient[j] += weight * TermT::partialDerivative(args, j, m_dataPtr);
+			}
+		}
+
+		void postDescentStep(ArgsType& args, ArgsType& argsRawDelta) {
+			if (m_postDescentStepCustomBehaviour != nullptr) {
+				m_postDescentStepCustomBehaviour(args, m_dataPtr, argsRawDelta);
+			}
+		}
+
 	public:
 		GradientDescent() = default;
-		GradientDescent(std::vector<FunctionTerm<dataT>> terms, int argNum, dataT* dataPtr,
-			std::function<void(std::vector<float>&, dataT*, std::vector<float>&)>  postDescentStepCustomBehaviour) {
-			MONA_ASSERT(terms.size() > 0, "Must provide at least one function term");
+		GradientDescent(int argNum, dataT* dataPtr, PostDescentStepFunction postDescentStepCustomBehaviour) {
 			m_argNum = argNum;
-			m_terms = terms;
-			m_postDescentStepCustomBehaviour = postDescentStepCustomBehaviour;
 			m_dataPtr = dataPtr;
-			for (int i = 0; i < m_terms.size(); i++) {
-				m_terms[i].m_dataPtr = dataPtr;
-			}
+			m_postDescentStepCustomBehaviour = postDescentStepCustomBehaviour;
+			m_weights.fill(1.0f);
 		};
 
-
-		std::vector<float> computeGradient(const std::vector<float>& args) {
+		ArgsType computeGradient(const ArgsType& args) {
 			MONA_ASSERT(args.size() == m_argNum, "GradientDescent: number of args does not match argNum value");
-			std::vector<float> gradient(m_argNum, 0.0f);
-			for (int i = 0; i < m_terms.size(); i++) {
-				for (int j = 0; j < m_argNum; j++) {
-					if (m_terms[i].m_weight != 0) {
-						gradient[j] += m_terms[i].m_weight * m_terms[i].calcTermPartialDerivative(args, j);
-					}					
-				}
-			}
+			ArgsType gradient(m_argNum, 0.0f);
+			accumulateGradient(args, gradient, std::index_sequence_for<TermTs...>{});
 			return gradient;
 		}
 
-		std::vector<float> computeArgsMin(float descentRate, int maxIterations, float targetArgDelta,
-			const std::vector<float>& initialArgs, DescentType descentType=DescentType::REGULAR, bool softenSteps = true) {
+		float computeFunctionValue(const ArgsType& args) {
+			MONA_ASSERT(args.size() == m_argNum, "GradientDescent: number of args does not match argNum value");
+			return functionValue(args, std::index_sequence_for<TermTs...>{});
+		};
+
+		ArgsType computeArgsMin(const DescentSettings& settings, const ArgsType& initialArgs) {
 			MONA_ASSERT(initialArgs.size() == m_argNum, "GradientDescent: number of args does not match argNum value");
-			std::vector<float> args = initialArgs;
-			std::vector<float> gradient;
-			std::vector<float> argsRawDelta(args.size());
-			std::vector<bool> continueDescent(args.size(), true);
-			int stepNum = 0;
-			// primer computo
-			gradient = computeGradient(args);
-			for (int i = 0; i < args.size(); i++) {
-				argsRawDelta[i] = gradient[i];
-				float argDelta = descentRate * argsRawDelta[i];
-				args[i] -= argDelta;
+			DescentStatistics stats;
+			bool trackValue = settings.lineSearch || 0 < settings.targetRelativeImprovement;
+			ArgsType args = initialArgs;
+			ArgsType argsRawDelta(m_argNum, 0.0f);
+			ArgsType firstMoment(m_argNum, 0.0f);
+			ArgsType secondMoment(m_argNum, 0.0f);
+			ArgsType candidateArgs;
+			ArgsType candidateRawDelta;
+			float currentValue = 0;
+			if (trackValue) {
+				currentValue = computeFunctionValue(args);
+				stats.functionEvaluations += 1;
 			}
-			m_postDescentStepCustomBehaviour(args, m_dataPtr, argsRawDelta);		
-			while (stepNum < maxIterations && funcUtils::conditionVector_OR(continueDescent)) {
-				gradient = computeGradient(args);
-				for (int i = 0; i < args.size(); i++) {
-					if (softenSteps) {
-						if (gradient[i] != 0 && argsRawDelta[i]!=0 && abs(argsRawDelta[i]*10) < abs(gradient[i])) {
-							float sign = gradient[i] / abs(gradient[i]);
-							gradient[i] = abs(argsRawDelta[i] * 10)*sign;
+			stats.initialValue = currentValue;
+			float beta1Power = 1.0f;
+			float beta2Power = 1.0f;
+			bool momentsReset = false;
+			stats.termination = DescentTermination::MAX_ITERATIONS;
+			while (stats.iterations <= settings.maxIterations) {
+				ArgsType gradient = computeGradient(args);
+				float gradientNorm = 0;
+				for (int i = 0; i < m_argNum; i++) {
+					gradientNorm += gradient[i] * gradient[i];
+				}
+				gradientNorm = std::sqrt(gradientNorm);
+				stats.finalGradientNorm = gradientNorm;
+				if (gradientNorm <= settings.targetGradientNorm) {
+					stats.termination = DescentTermination::GRADIENT_NORM;
+					break;
+				}
+				beta1Power *= settings.momentumDecay;
+				beta2Power *= settings.squaredGradientDecay;
+				for (int i = 0; i < m_argNum; i++) {
+					float g = gradient[i];
+					switch (settings.descentType) {
+					case DescentType::REGULAR:
+					case DescentType::MOMENTUM:
+						if (settings.softenSteps && g != 0 && argsRawDelta[i] != 0 && std::abs(argsRawDelta[i] * 10) < std::abs(g)) {
+							g = std::abs(argsRawDelta[i] * 10) * funcUtils::getSign(g);
+						}
+						if (settings.descentType == DescentType::MOMENTUM && 0 < stats.iterations) {
+							argsRawDelta[i] = settings.momentumDecay * argsRawDelta[i] + (1 - settings.momentumDecay) * g;
+						}
+						else {
+							argsRawDelta[i] = g;
 						}
+						break;
+					case DescentType::RMSPROP:
+						secondMoment[i] = settings.squaredGradientDecay * secondMoment[i] + (1 - settings.squaredGradientDecay) * g * g;
+						argsRawDelta[i] = g / (std::sqrt(secondMoment[i]) + settings.epsilon);
+						break;
+					case DescentType::ADAM:
+						firstMoment[i] = settings.momentumDecay * firstMoment[i] + (1 - settings.momentumDecay) * g;
+						secondMoment[i] = settings.squaredGradientDecay * secondMoment[i] + (1 - settings.squaredGradientDecay) * g * g;
+						argsRawDelta[i] = (firstMoment[i] / (1 - beta1Power)) / (std::sqrt(secondMoment[i] / (1 - beta2Power)) + settings.epsilon);
+						break;
 					}
-					if (descentType == DescentType::REGULAR) {
-						argsRawDelta[i] = gradient[i];
+				}
+
+				float descentRate = settings.descentRate;
+				float newValue = currentValue;
+				if (settings.lineSearch) {
+					// retroceso: se reduce la tasa hasta que el valor de la funcion no aumente
+					bool accepted = false;
+					for (int k = 0; k <= settings.maxLineSearchSteps; k++) {
+						candidateArgs = args;
+						candidateRawDelta = argsRawDelta;
+						for (int i = 0; i < m_argNum; i++) {
+							candidateArgs[i] -= descentRate * candidateRawDelta[i];
+						}
+						postDescentStep(candidateArgs, candidateRawDelta);
+						newValue = computeFunctionValue(candidateArgs);
+						stats.functionEvaluations += 1;
+						if (newValue <= currentValue) {
+							accepted = true;
+							break;
+						}
+						descentRate *= settings.lineSearchShrink;
 					}
-					else if(descentType == DescentType::MOMENTUM){
-						argsRawDelta[i] = 0.8 * argsRawDelta[i] + 0.2 * gradient[i];
+					if (!accepted) {
+						// se restaura el estado asociado a los argumentos vigentes
+						ArgsType zeroDelta(m_argNum, 0.0f);
+						postDescentStep(args, zeroDelta);
+						if (settings.descentType != DescentType::REGULAR && !momentsReset) {
+							// la direccion acumulada puede no ser de descenso, se reinician los momentos
+							// y se reintenta en la direccion del gradiente
+							argsRawDelta = zeroDelta;
+							firstMoment = zeroDelta;
+							secondMoment = zeroDelta;
+							beta1Power = 1.0f;
+							beta2Power = 1.0f;
+							momentsReset = true;
+							stats.iterations += 1;
+							continue;
+						}
+						stats.termination = DescentTermination::LINE_SEARCH;
+						break;
 					}
-					float argDelta = descentRate * argsRawDelta[i];
-					args[i] -= argDelta;
+					momentsReset = false;
+					args = candidateArgs;
+					argsRawDelta = candidateRawDelta;
 				}
-				m_postDescentStepCustomBehaviour(args, m_dataPtr, argsRawDelta);
-				for (int i = 0; i < args.size(); i++) {
-					continueDescent[i] = targetArgDelta < abs(descentRate*argsRawDelta[i]);
+				else {
+					for (int i = 0; i < m_argNum; i++) {
+						args[i] -= descentRate * argsRawDelta[i];
+					}
+					postDescentStep(args, argsRawDelta);
+					if (trackValue) {
+						newValue = computeFunctionValue(args);
+						stats.functionEvaluations += 1;
+					}
 				}
-				stepNum += 1;
-			}
-			return args;
-		};
+				stats.iterations += 1;
 
-
-		float computeFunctionValue(const std::vector<float>& args) {
-			MONA_ASSERT(args.size() == m_argNum, "GradientDescent: number of args does not match argNum value");
-			float functionValue = 0;
-			for (int i = 0; i < m_terms.size(); i++) {
-				if (m_terms[i].m_weight != 0) {
-					functionValue += m_terms[i].m_weight * m_terms[i].calcTerm(args);
-				}				
+				bool argsChanged = false;
+				for (int i = 0; i < m_argNum; i++) {
+					if (settings.targetArgDelta < std::abs(descentRate * argsRawDelta[i])) {
+						argsChanged = true;
+						break;
+					}
+				}
+				if (!argsChanged) {
+					currentValue = newValue;
+					stats.termination = DescentTermination::ARG_DELTA;
+					break;
+				}
+				if (0 < settings.targetRelativeImprovement) {
+					float improvement = currentValue - newValue;
+					float scale = std::max(std::abs(currentValue), std::numeric_limits<float>::epsilon());
+					currentValue = newValue;
+					if (0 <= improvement && improvement / scale < settings.targetRelativeImprovement) {
+						stats.termination = DescentTermination::RELATIVE_IMPROVEMENT;
+						break;
+					}
+				}
+				else {
+					currentValue = newValue;
+				}
 			}
-			return functionValue;
+			stats.finalValue = currentValue;
+			m_lastStatistics = stats;
+			m_accumulatedStatistics.add(stats);
+			return args;
 		};
 
-		void  setArgNum(int argNum) {
+		void setArgNum(int argNum) {
+			MONA_ASSERT(0 <= argNum, "GradientDescent: argNum must be non negative.");
 			m_argNum = argNum;
 		};
 
-		int getTermNum() {
-			return m_terms.size();
-		}
+		int getArgNum() const { return m_argNum; }
 
-		void setTermWeight(int termIndex, float weight){
-			MONA_ASSERT(0 <= termIndex && termIndex < m_terms.size(), "GradientDescent: input termIndex was out of bounds.");
-			m_terms[termIndex].m_weight = weight;
+		static constexpr int getInlineArgNum() { return InlineArgNum; }
+
+		constexpr int getTermNum() const { return s_termNum; }
+
+		void setTermWeight(int termIndex, float weight) {
+			MONA_ASSERT(0 <= termIndex && termIndex < s_termNum, "GradientDescent: input termIndex was out of bounds.");
+			m_weights[termIndex] = weight;
 		}
-	};	
+
+		const DescentStatistics& getLastStatistics() const { return m_lastStatistics; }
+		const AccumulatedDescentStatistics& getAccumulatedStatistics() const { return m_accumulatedStatistics; }
+		void resetAccumulatedStatistics() { m_accumulatedStatistics = AccumulatedDescentStatistics(); }
+	};
 };
 
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -3,15 +3,29 @@
 #include <algorithm>
 #include "../Core/Log.hpp"
 #include "../Core/FuncUtils.hpp"
+#include "../PhysicsCollision/TerrainShape.hpp"
+//Paso de las diferencias centrales de la normal, relativo al tamano del terreno
+#define HEIGHTMAP_NORMAL_STEP 0.001f
 
 namespace Mona{
 
-    HeightMap::HeightMap(const glm::vec2& bottomLeft, const glm::vec2& topRight, float (*heightFunc)(float, float)) {
+    HeightMap::HeightMap(const glm::vec2& bottomLeft, const glm::vec2& topRight, float (*heightFunc)(float, float)) :
+        HeightMap(bottomLeft, topRight, std::make_shared<FunctionHeightSource>(heightFunc)) {}
+
+    HeightMap::HeightMap(const glm::vec2& bottomLeft, const glm::vec2& topRight, std::shared_ptr<HeightSource> heightSource) {
         m_minX = bottomLeft[0];
 		m_minY = bottomLeft[1];
 		m_maxX = topRight[0];
         m_maxY = topRight[1];
-		m_heightFunc = heightFunc;
+		m_heightSource = heightSource;
+    }
+
+    HeightMap::HeightMap(std::shared_ptr<TerrainShape> terrainShape) {
+        m_minX = terrainShape->GetMinBounds()[0];
+        m_minY = terrainShape->GetMinBounds()[1];
+        m_maxX = terrainShape->GetMaxBounds()[0];
+        m_maxY = terrainShape->GetMaxBounds()[1];
+        m_terrainShape = terrainShape;
     }
 
     bool HeightMap::withinBoundaries(float x, float y) {
@@ -24,7 +38,58 @@ namespace Mona{
             return std::numeric_limits<float>::lowest();
         }
 
-        return m_heightFunc(x, y);
+        if (m_heightSource != nullptr) {
+            return m_heightSource->evaluateHeight(x, y);
+        }
+        // los puntos sobre agujeros de la malla no tienen altura
+        TerrainRayHit hit = m_terrainShape->RaycastDown(glm::vec2(x, y));
+        return hit.hit ? hit.height : std::numeric_limits<float>::lowest();
+    }
+
+    glm::vec3 HeightMap::getNormal(float x, float y) {
+        if (!withinBoundaries(x, y)) {
+            MONA_LOG_WARNING("HeightMap: Point is out of bounds");
+            return glm::vec3(0, 0, 1);
+        }
+        if (m_heightSource == nullptr) {
+            return m_terrainShape->RaycastDown(glm::vec2(x, y)).normal;
+        }
+        float step = HEIGHTMAP_NORMAL_STEP * std::max(m_maxX - m_minX, m_maxY - m_minY);
+        float left = std::max(x - step, m_minX);
+        float right = std::min(x + step, m_maxX);
+        float down = std::max(y - step, m_minY);
+        float up = std::min(y + step, m_maxY);
+        // los cuatro vecinos se evaluan en una sola llamada
+        float xs[4] = { right, left, x, x };
+        float ys[4] = { y, y, up, down };
+        float heights[4];
+        m_heightSource->evaluateHeights(xs, ys, 4, heights);
+        float dzdx = (heights[0] - heights[1]) / (right - left);
+        float dzdy = (heights[2] - heights[3]) / (up - down);
+        return glm::normalize(glm::vec3(-dzdx, -dzdy, 1));
+    }
+
+    void HeightMap::getHeights(const glm::vec2* xyPoints, size_t count, float* outHeights) {
+        if (m_heightSource != nullptr) {
+            std::vector<float> xs(count);
+            std::vector<float> ys(count);
+            for (size_t i = 0; i < count; i++) {
+                xs[i] = xyPoints[i][0];
+                ys[i] = xyPoints[i][1];
+            }
+            m_heightSource->evaluateHeights(xs.data(), ys.data(), count, outHeights);
+            for (size_t i = 0; i < count; i++) {
+                if (!withinBoundaries(xs[i], ys[i])) {
+                    outHeights[i] = std::numeric_limits<float>::lowest();
+                }
+            }
+            return;
+        }
+        std::vector<TerrainRayHit> hits(count);
+        m_terrainShape->RaycastDown(xyPoints, count, hits.data());
+        for (size_t i = 0; i < count; i++) {
+            outHeights[i] = hits[i].hit ? hits[i].height : std::numeric_limits<float>::lowest();
+        }
     }
 
 }
\ No newline at end of file
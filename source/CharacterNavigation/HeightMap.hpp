@@ -3,10 +3,13 @@
 #define HEIGHTMAP_HPP
 
 #include <vector>
+#include <memory>
 #include <glm/glm.hpp>
 #include <unordered_map>
+#include "HeightSource.hpp"
 
 namespace Mona {
+	class TerrainShape;
 
 	class HeightMap{
 		friend class EnvironmentData;
@@ -15,16 +18,25 @@ namespace Mona {
 			float m_minY;
 			float m_maxX;
 			float m_maxY;
-			float (*m_heightFunc)(float, float) = nullptr;
+			std::shared_ptr<HeightSource> m_heightSource;
+			// fuente de alturas de terrenos sin fuente procedural, consultada con rayos hacia abajo
+			std::shared_ptr<TerrainShape> m_terrainShape;
 
 		public:
 			HeightMap() = default;
 			HeightMap(const glm::vec2& bottomLeft, const glm::vec2& topRight, float (*heightFunc)(float, float));
+			HeightMap(const glm::vec2& bottomLeft, const glm::vec2& topRight, std::shared_ptr<HeightSource> heightSource);
+			HeightMap(std::shared_ptr<TerrainShape> terrainShape);
 			bool withinBoundaries(float x, float y);
 			glm::vec2 getMinXY() { return glm::vec2( m_minX, m_minY ); }
 			glm::vec2 getMaxXY() { return glm::vec2(m_maxX, m_maxY); }
 			float getHeight(float x, float y);
-			bool isValid() { return m_heightFunc != nullptr; }
+			// normal unitaria de la superficie en (x, y), apuntando hacia z positivo
+			glm::vec3 getNormal(float x, float y);
+			// alturas de varios puntos en una sola llamada, los puntos fuera del terreno quedan con el menor float
+			void getHeights(const glm::vec2* xyPoints, size_t count, float* outHeights);
+			std::shared_ptr<HeightSource> getHeightSource() { return m_heightSource; }
+			bool isValid() { return m_heightSource != nullptr || m_terrainShape != nullptr; }
 	};
 
 }
@@ -0,0 +1,235 @@
+#include "HeightSource.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include "../Core/Log.hpp"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MONA_HEIGHT_SOURCE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Mona {
+
+	// 2^f con f en [-0.5, 0.5], serie de Taylor de grado 6 (error relativo cercano a 1e-7)
+	static const float exp2Coefficients[6] = { 0.693147181f, 0.240226507f, 0.0555041087f, 0.00961812911f, 0.00133335581f, 0.000154035304f };
+
+	// exp(x) para x <= 0. Por debajo de 2^-126 el resultado se satura en ese valor, que es despreciable como altura
+	static inline float fastExpNonPositive(float x) {
+		float t = std::max(x * std::numbers::log2e_v<float>, -126.0f);
+		float n = std::nearbyint(t);
+		float f = t - n;
+		float p = exp2Coefficients[5];
+		for (int i = 4; i >= 0; i--) {
+			p = p * f + exp2Coefficients[i];
+		}
+		p = p * f + 1.0f;
+		return std::ldexp(p, static_cast<int>(n));
+	}
+
+#ifdef MONA_HEIGHT_SOURCE_SSE2
+	static inline __m128 fastExpNonPositive(__m128 x) {
+		__m128 t = _mm_max_ps(_mm_mul_ps(x, _mm_set1_ps(std::numbers::log2e_v<float>)), _mm_set1_ps(-126.0f));
+		__m128i n = _mm_cvtps_epi32(t);
+		__m128 f = _mm_sub_ps(t, _mm_cvtepi32_ps(n));
+		__m128 p = _mm_set1_ps(exp2Coefficients[5]);
+		for (int i = 4; i >= 0; i--) {
+			p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2Coefficients[i]));
+		}
+		p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.0f));
+		// 2^n se arma directamente en los bits del exponente
+		__m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+		return _mm_mul_ps(p, scale);
+	}
+#endif
+
+	float HeightSource::evaluateHeight(float x, float y) const {
+		float height;
+		evaluateHeights(&x, &y, 1, &height);
+		return height;
+	}
+
+	void FunctionHeightSource::evaluateHeights(const float* xs, const float* ys, size_t count, float* outHeights) const {
+		for (size_t i = 0; i < count; i++) {
+			outHeights[i] = m_heightFunc(xs[i], ys[i]);
+		}
+	}
+
+	GaussianMixtureHeightSource::GaussianMixtureHeightSource(const std::vector<Gaussian>& gaussians) {
+		// parametros precalculados y radio fuera del cual cada gaussiana aporta menos que GAUSSIAN_HEIGHT_EPSILON
+		std::vector<GaussianBlock> singles;
+		std::vector<float> radii;
+		glm::vec2 minBound(std::numeric_limits<float>::max());
+		glm::vec2 maxBound(std::numeric_limits<float>::lowest());
+		float radiusSum = 0;
+		for (const Gaussian& gaussian : gaussians) {
+			MONA_ASSERT(0 < gaussian.sigma, "GaussianMixtureHeightSource: sigma must be positive.");
+			float coefficient = gaussian.weight / (gaussian.sigma * std::sqrt(2 * std::numbers::pi_v<float>));
+			if (std::abs(coefficient) <= GAUSSIAN_HEIGHT_EPSILON) {
+				continue;
+			}
+			float radius = gaussian.sigma * std::sqrt(2 * std::log(std::abs(coefficient) / GAUSSIAN_HEIGHT_EPSILON));
+			GaussianBlock single = {};
+			single.centerX[0] = gaussian.center[0];
+			single.centerY[0] = gaussian.center[1];
+			single.coefficient[0] = coefficient;
+			single.exponentScale[0] = -1 / (2 * gaussian.sigma * gaussian.sigma);
+			singles.push_back(single);
+			radii.push_back(radius);
+			minBound = glm::min(minBound, gaussian.center - radius);
+			maxBound = glm::max(maxBound, gaussian.center + radius);
+			radiusSum += radius;
+		}
+		if (singles.empty()) {
+			m_cellBlockOffsets = { 0, 0 };
+			m_cellsX = 1;
+			m_cellsY = 1;
+			return;
+		}
+
+		// celdas del tamano del radio medio, de modo que cada una vea pocas gaussianas pequenas
+		float cellSize = radiusSum / singles.size();
+		glm::vec2 extent = maxBound - minBound;
+		m_cellsX = std::clamp(static_cast<int>(std::ceil(extent[0] / cellSize)), 1, GAUSSIAN_GRID_MAX_CELLS);
+		m_cellsY = std::clamp(static_cast<int>(std::ceil(extent[1] / cellSize)), 1, GAUSSIAN_GRID_MAX_CELLS);
+		m_gridMin = minBound;
+		glm::vec2 cellDimensions = extent / glm::vec2(m_cellsX, m_cellsY);
+		m_inverseCellSize = 1.0f / cellDimensions;
+
+		std::vector<std::vector<uint32_t>> cellGaussians(m_cellsX * m_cellsY);
+		for (uint32_t g = 0; g < singles.size(); g++) {
+			glm::vec2 center(singles[g].centerX[0], singles[g].centerY[0]);
+			float radius = radii[g];
+			int minCellX = std::clamp(static_cast<int>((center[0] - radius - m_gridMin[0]) * m_inverseCellSize[0]), 0, m_cellsX - 1);
+			int maxCellX = std::clamp(static_cast<int>((center[0] + radius - m_gridMin[0]) * m_inverseCellSize[0]), 0, m_cellsX - 1);
+			int minCellY = std::clamp(static_cast<int>((center[1] - radius - m_gridMin[1]) * m_inverseCellSize[1]), 0, m_cellsY - 1);
+			int maxCellY = std::clamp(static_cast<int>((center[1] + radius - m_gridMin[1]) * m_inverseCellSize[1]), 0, m_cellsY - 1);
+			for (int cx = minCellX; cx <= maxCellX; cx++) {
+				for (int cy = minCellY; cy <= maxCellY; cy++) {
+					glm::vec2 cellMin = m_gridMin + cellDimensions * glm::vec2(cx, cy);
+					glm::vec2 closest = glm::clamp(center, cellMin, cellMin + cellDimensions);
+					glm::vec2 diff = closest - center;
+					if (glm::dot(diff, diff) <= radius * radius) {
+						cellGaussians[cy * m_cellsX + cx].push_back(g);
+					}
+				}
+			}
+		}
+
+		// cada celda copia sus gaussianas en bloques contiguos, rellenando el ultimo con aportes nulos
+		m_cellBlockOffsets.resize(cellGaussians.size() + 1);
+		m_cellBlockOffsets[0] = 0;
+		for (size_t c = 0; c < cellGaussians.size(); c++) {
+			const std::vector<uint32_t>& indices = cellGaussians[c];
+			for (size_t i = 0; i < indices.size(); i += 4) {
+				GaussianBlock block = {};
+				for (size_t lane = 0; lane < 4 && i + lane < indices.size(); lane++) {
+					const GaussianBlock& single = singles[indices[i + lane]];
+					block.centerX[lane] = single.centerX[0];
+					block.centerY[lane] = single.centerY[0];
+					block.coefficient[lane] = single.coefficient[0];
+					block.exponentScale[lane] = single.exponentScale[0];
+				}
+				m_blocks.push_back(block);
+			}
+			m_cellBlockOffsets[c + 1] = static_cast<uint32_t>(m_blocks.size());
+		}
+	}
+
+	void GaussianMixtureHeightSource::evaluateHeights(const float* xs, const float* ys, size_t count, float* outHeights) const {
+		for (size_t i = 0; i < count; i++) {
+			float x = xs[i];
+			float y = ys[i];
+			float cellX = (x - m_gridMin[0]) * m_inverseCellSize[0];
+			float cellY = (y - m_gridMin[1]) * m_inverseCellSize[1];
+			// fuera de la grilla ninguna gaussiana aporta
+			if (!(0 <= cellX && cellX <= m_cellsX && 0 <= cellY && cellY <= m_cellsY)) {
+				outHeights[i] = 0;
+				continue;
+			}
+			int cell = std::min(static_cast<int>(cellY), m_cellsY - 1) * m_cellsX + std::min(static_cast<int>(cellX), m_cellsX - 1);
+			const GaussianBlock* block = m_blocks.data() + m_cellBlockOffsets[cell];
+			const GaussianBlock* blockEnd = m_blocks.data() + m_cellBlockOffsets[cell + 1];
+#ifdef MONA_HEIGHT_SOURCE_SSE2
+			__m128 px = _mm_set1_ps(x);
+			__m128 py = _mm_set1_ps(y);
+			__m128 sum = _mm_setzero_ps();
+			for (; block != blockEnd; block++) {
+				__m128 dx = _mm_sub_ps(_mm_load_ps(block->centerX), px);
+				__m128 dy = _mm_sub_ps(_mm_load_ps(block->centerY), py);
+				__m128 squaredDistance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+				__m128 exponent = _mm_mul_ps(squaredDistance, _mm_load_ps(block->exponentScale));
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(block->coefficient), fastExpNonPositive(exponent)));
+			}
+			alignas(16) float lanes[4];
+			_mm_store_ps(lanes, sum);
+#else
+			float lanes[4] = { 0, 0, 0, 0 };
+			for (; block != blockEnd; block++) {
+				for (int lane = 0; lane < 4; lane++) {
+					float dx = block->centerX[lane] - x;
+					float dy = block->centerY[lane] - y;
+					float exponent = (dx * dx + dy * dy) * block->exponentScale[lane];
+					lanes[lane] += block->coefficient[lane] * fastExpNonPositive(exponent);
+				}
+			}
+#endif
+			outHeights[i] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		}
+	}
+
+	// valor pseudoaleatorio en [0, 1] para cada vertice de la grilla de ruido
+	static inline float latticeValue(int32_t x, int32_t y, uint32_t seed) {
+		uint32_t h = static_cast<uint32_t>(x) * 0x8da6b343u ^ static_cast<uint32_t>(y) * 0xd8163841u ^ seed * 0xcb1ab31fu;
+		h ^= h >> 13;
+		h *= 0x85ebca6bu;
+		h ^= h >> 16;
+		return static_cast<float>(h) * (1.0f / 4294967295.0f);
+	}
+
+	NoiseHeightSource::NoiseHeightSource(uint32_t seed, float amplitude, float frequency, int octaves, float lacunarity,
+		float gain, float baseHeight) : m_seed(seed), m_baseHeight(baseHeight), m_amplitude(amplitude), m_frequency(frequency),
+		m_octaves(octaves), m_lacunarity(lacunarity), m_gain(gain) {
+		MONA_ASSERT(0 < octaves, "NoiseHeightSource: at least one octave is needed.");
+		// la suma de amplitudes de las octavas se normaliza a 1
+		float amplitudeSum = 0;
+		float octaveAmplitude = 1;
+		for (int o = 0; o < m_octaves; o++) {
+			amplitudeSum += octaveAmplitude;
+			octaveAmplitude *= m_gain;
+		}
+		m_normalization = amplitudeSum != 0 ? 1 / amplitudeSum : 0;
+	}
+
+	void NoiseHeightSource::evaluateHeights(const float* xs, const float* ys, size_t count, float* outHeights) const {
+		for (size_t i = 0; i < count; i++) {
+			float sum = 0;
+			float frequency = m_frequency;
+			float octaveAmplitude = 1;
+			for (int o = 0; o < m_octaves; o++) {
+				float x = xs[i] * frequency;
+				float y = ys[i] * frequency;
+				float floorX = std::floor(x);
+				float floorY = std::floor(y);
+				int32_t ix = static_cast<int32_t>(floorX);
+				int32_t iy = static_cast<int32_t>(floorY);
+				// interpolacion con suavizado quintico para que la normal sea continua entre celdas
+				float fx = x - floorX;
+				float fy = y - floorY;
+				float ux = fx * fx * fx * (fx * (fx * 6 - 15) + 10);
+				float uy = fy * fy * fy * (fy * (fy * 6 - 15) + 10);
+				uint32_t octaveSeed = m_seed + static_cast<uint32_t>(o) * 0x9e3779b9u;
+				float v00 = latticeValue(ix, iy, octaveSeed);
+				float v10 = latticeValue(ix + 1, iy, octaveSeed);
+				float v01 = latticeValue(ix, iy + 1, octaveSeed);
+				float v11 = latticeValue(ix + 1, iy + 1, octaveSeed);
+				float value = (v00 + (v10 - v00) * ux) + ((v01 + (v11 - v01) * ux) - (v00 + (v10 - v00) * ux)) * uy;
+				sum += octaveAmplitude * (2 * value - 1);
+				frequency *= m_lacunarity;
+				octaveAmplitude *= m_gain;
+			}
+			outHeights[i] = m_baseHeight + m_amplitude * m_normalization * sum;
+		}
+	}
+
+}
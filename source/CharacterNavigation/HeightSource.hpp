@@ -0,0 +1,90 @@
+#pragma once
+#ifndef HEIGHTSOURCE_HPP
+#define HEIGHTSOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+//Aporte de altura bajo el cual una gaussiana se ignora en las consultas
+#define GAUSSIAN_HEIGHT_EPSILON 0.0001f
+//Celdas maximas por lado de la grilla que agrupa las gaussianas que aportan en cada zona
+#define GAUSSIAN_GRID_MAX_CELLS 64
+
+namespace Mona {
+
+	/*
+	* Fuente procedural de alturas sobre el plano xy, usada por HeightMap y por MeshManager::GenerateTerrain.
+	* Evaluar no modifica la fuente, por lo que puede hacerse desde varios hilos a la vez.
+	*/
+	class HeightSource {
+		public:
+			virtual ~HeightSource() = default;
+			// alturas de los puntos (xs[i], ys[i]) en una sola llamada
+			virtual void evaluateHeights(const float* xs, const float* ys, size_t count, float* outHeights) const = 0;
+			float evaluateHeight(float x, float y) const;
+	};
+
+	// adapta una funcion de altura de C, que debe poder llamarse desde varios hilos
+	class FunctionHeightSource : public HeightSource {
+		private:
+			float (*m_heightFunc)(float, float);
+		public:
+			FunctionHeightSource(float (*heightFunc)(float, float)) : m_heightFunc(heightFunc) {}
+			void evaluateHeights(const float* xs, const float* ys, size_t count, float* outHeights) const override;
+	};
+
+	/*
+	* Suma de gaussianas h(x, y) = sum weight / (sigma * sqrt(2 pi)) * exp(-|(x, y) - center|^2 / (2 sigma^2)).
+	* Los parametros se precalculan una sola vez. Una grilla uniforme guarda en cada celda solo las gaussianas que aportan
+	* mas de GAUSSIAN_HEIGHT_EPSILON dentro de ella, en bloques de cuatro que se evaluan juntos con SIMD.
+	*/
+	class GaussianMixtureHeightSource : public HeightSource {
+		public:
+			struct Gaussian {
+				glm::vec2 center;
+				float weight;
+				float sigma;
+			};
+			GaussianMixtureHeightSource(const std::vector<Gaussian>& gaussians);
+			void evaluateHeights(const float* xs, const float* ys, size_t count, float* outHeights) const override;
+		private:
+			struct alignas(16) GaussianBlock {
+				float centerX[4];
+				float centerY[4];
+				float coefficient[4];
+				float exponentScale[4];
+			};
+			std::vector<GaussianBlock> m_blocks;
+			// bloques de cada celda, desde m_cellBlockOffsets[c] hasta m_cellBlockOffsets[c + 1]
+			std::vector<uint32_t> m_cellBlockOffsets;
+			glm::vec2 m_gridMin = glm::vec2(0);
+			glm::vec2 m_inverseCellSize = glm::vec2(0);
+			int m_cellsX = 0;
+			int m_cellsY = 0;
+	};
+
+	/*
+	* Ruido de valor en octavas. Cada octava multiplica la frecuencia por lacunarity y la amplitud por gain, y el resultado
+	* queda entre baseHeight - amplitude y baseHeight + amplitude aproximadamente.
+	*/
+	class NoiseHeightSource : public HeightSource {
+		private:
+			uint32_t m_seed;
+			float m_baseHeight;
+			float m_amplitude;
+			float m_frequency;
+			int m_octaves;
+			float m_lacunarity;
+			float m_gain;
+			float m_normalization;
+		public:
+			NoiseHeightSource(uint32_t seed, float amplitude, float frequency, int octaves, float lacunarity = 2.0f,
+				float gain = 0.5f, float baseHeight = 0.0f);
+			void evaluateHeights(const float* xs, const float* ys, size_t count, float* outHeights) const override;
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,182 @@
+#include "IKAnimationCache.hpp"
+#include "../Core/Config.hpp"
+#include "../Core/Log.hpp"
+#include "../Core/RootDirectory.hpp"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+namespace Mona {
+
+	static const char ikCacheMagic[4] = { 'M', 'I', 'K', 'C' };
+
+	template <typename T>
+	void writeValue(std::ofstream& out, const T& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool readValue(std::ifstream& in, T& value) {
+		in.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return in.good();
+	}
+
+	IKAnimationCache::IKAnimationCache() {
+		//El tracker se crea antes que la cache para que siga vivo cuando la cuenta se descuente al destruirla
+		MemoryTracker::GetInstance();
+		auto& config = Config::GetInstance();
+		m_enabled = config.getValueOrDefault<int>("enable_ik_animation_cache", 1) != 0;
+		std::string directory = config.getValueOrDefault<std::string>("ik_animation_cache_directory", "IKCache");
+		//Los archivos son datos generados, por lo que se guardan en el directorio de compilacion y no junto al codigo
+		m_directory = std::filesystem::path(directory).is_absolute() ? std::filesystem::path(directory) : SourceDirectoryData::BuildPath(directory);
+	}
+
+	std::filesystem::path IKAnimationCache::getFilePath(uint64_t key) const {
+		std::ostringstream fileName;
+		fileName << std::hex << std::setw(16) << std::setfill('0') << key << ".ikc";
+		return m_directory / fileName.str();
+	}
+
+	bool IKAnimationCache::load(uint64_t key, int frameNum, int chainNum, IKAnimationPreprocessData& outData) {
+		if (!m_enabled) {
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_entries.find(key);
+		if (it == m_entries.end()) {
+			IKAnimationPreprocessData fileData;
+			if (!readFile(key, frameNum, chainNum, fileData)) {
+				return false;
+			}
+			it = m_entries.insert({ key, fileData }).first;
+			updateMemoryAccount();
+		}
+		// validacion de dimensiones
+		const IKAnimationPreprocessData& data = it->second;
+		bool valid = data.hipGlobalPositions.size() == frameNum && data.supportFramesPerChain.size() == chainNum &&
+			data.globalPositionsPerChain.size() == chainNum;
+		for (int i = 0; valid && i < chainNum; i++) {
+			valid = data.supportFramesPerChain[i].size() == frameNum && data.globalPositionsPerChain[i].size() == frameNum;
+		}
+		if (!valid) {
+			MONA_LOG_WARNING("IKAnimationCache: Entry {0} does not match the animation, it will be recomputed.", getFilePath(key).filename().string());
+			m_entries.erase(it);
+			updateMemoryAccount();
+			return false;
+		}
+		outData = data;
+		return true;
+	}
+
+	size_t IKAnimationCache::getMemoryUsage() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return computeMemoryUsage();
+	}
+
+	size_t IKAnimationCache::computeMemoryUsage() const {
+		size_t usage = 0;
+		for (const auto& entry : m_entries) {
+			const IKAnimationPreprocessData& data = entry.second;
+			usage += sizeof(entry) + data.hipGlobalPositions.capacity() * sizeof(glm::vec3);
+			for (const auto& supportFrames : data.supportFramesPerChain) {
+				usage += sizeof(supportFrames) + supportFrames.capacity() / 8;
+			}
+			for (const auto& globalPositions : data.globalPositionsPerChain) {
+				usage += sizeof(globalPositions) + globalPositions.capacity() * sizeof(glm::vec3);
+			}
+		}
+		return usage;
+	}
+
+	void IKAnimationCache::save(uint64_t key, const IKAnimationPreprocessData& data) {
+		if (!m_enabled) {
+			return;
+		}
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_entries[key] = data;
+		updateMemoryAccount();
+		writeFile(key, data);
+	}
+
+	void IKAnimationCache::clear() {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_entries.clear();
+		updateMemoryAccount();
+	}
+
+	bool IKAnimationCache::readFile(uint64_t key, int expectedFrameNum, int expectedChainNum, IKAnimationPreprocessData& outData) const {
+		std::ifstream in(getFilePath(key), std::ios::binary);
+		if (!in.is_open()) {
+			return false;
+		}
+		char magic[4];
+		uint32_t version;
+		uint64_t fileKey;
+		uint32_t frameNum;
+		uint32_t chainNum;
+		in.read(magic, 4);
+		if (!in.good() || std::memcmp(magic, ikCacheMagic, 4) != 0 || !readValue(in, version) || version != IK_ANIMATION_CACHE_VERSION ||
+			!readValue(in, fileKey) || fileKey != key || !readValue(in, frameNum) || !readValue(in, chainNum)) {
+			MONA_LOG_WARNING("IKAnimationCache: Ignoring invalid or outdated cache file {0}.", getFilePath(key).filename().string());
+			return false;
+		}
+		//Las dimensiones se validan antes de reservar memoria, un archivo corrupto no puede pedir tamanos arbitrarios
+		if (expectedFrameNum < 0 || expectedChainNum < 0 || frameNum != static_cast<uint32_t>(expectedFrameNum) ||
+			chainNum != static_cast<uint32_t>(expectedChainNum)) {
+			MONA_LOG_WARNING("IKAnimationCache: Cache file {0} does not match the animation, it will be recomputed.", getFilePath(key).filename().string());
+			return false;
+		}
+		const uint64_t headerSize = sizeof(ikCacheMagic) + sizeof(version) + sizeof(fileKey) + sizeof(frameNum) + sizeof(chainNum);
+		const uint64_t expectedSize = headerSize + frameNum * sizeof(glm::vec3) +
+			uint64_t(chainNum) * frameNum * (sizeof(uint8_t) + sizeof(glm::vec3));
+		std::error_code errorCode;
+		const uint64_t fileSize = std::filesystem::file_size(getFilePath(key), errorCode);
+		if (errorCode || fileSize != expectedSize) {
+			MONA_LOG_WARNING("IKAnimationCache: Cache file {0} has the wrong size.", getFilePath(key).filename().string());
+			return false;
+		}
+		outData.hipGlobalPositions.resize(frameNum);
+		in.read(reinterpret_cast<char*>(outData.hipGlobalPositions.data()), frameNum * sizeof(glm::vec3));
+		outData.supportFramesPerChain = std::vector<std::vector<bool>>(chainNum, std::vector<bool>(frameNum));
+		outData.globalPositionsPerChain = std::vector<std::vector<glm::vec3>>(chainNum, std::vector<glm::vec3>(frameNum));
+		for (uint32_t i = 0; i < chainNum; i++) {
+			for (uint32_t j = 0; j < frameNum; j++) {
+				uint8_t supportFrame;
+				readValue(in, supportFrame);
+				outData.supportFramesPerChain[i][j] = supportFrame != 0;
+			}
+			in.read(reinterpret_cast<char*>(outData.globalPositionsPerChain[i].data()), frameNum * sizeof(glm::vec3));
+		}
+		if (!in.good()) {
+			MONA_LOG_WARNING("IKAnimationCache: Cache file {0} is truncated.", getFilePath(key).filename().string());
+			return false;
+		}
+		return true;
+	}
+
+	void IKAnimationCache::writeFile(uint64_t key, const IKAnimationPreprocessData& data) const {
+		std::error_code errorCode;
+		std::filesystem::create_directories(m_directory, errorCode);
+		std::ofstream out(getFilePath(key), std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			MONA_LOG_WARNING("IKAnimationCache: Could not write cache file {0}.", getFilePath(key).string());
+			return;
+		}
+		uint32_t frameNum = data.hipGlobalPositions.size();
+		uint32_t chainNum = data.supportFramesPerChain.size();
+		out.write(ikCacheMagic, 4);
+		writeValue(out, (uint32_t)IK_ANIMATION_CACHE_VERSION);
+		writeValue(out, key);
+		writeValue(out, frameNum);
+		writeValue(out, chainNum);
+		out.write(reinterpret_cast<const char*>(data.hipGlobalPositions.data()), frameNum * sizeof(glm::vec3));
+		for (uint32_t i = 0; i < chainNum; i++) {
+			for (uint32_t j = 0; j < frameNum; j++) {
+				writeValue(out, (uint8_t)data.supportFramesPerChain[i][j]);
+			}
+			out.write(reinterpret_cast<const char*>(data.globalPositionsPerChain[i].data()), frameNum * sizeof(glm::vec3));
+		}
+	}
+
+}
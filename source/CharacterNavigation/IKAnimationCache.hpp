@@ -0,0 +1,90 @@
+#pragma once
+#ifndef IKANIMATIONCACHE_HPP
+#define IKANIMATIONCACHE_HPP
+
+#include <mutex>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include "../Core/MemoryTracker.hpp"
+
+#define IK_ANIMATION_CACHE_VERSION 1
+
+namespace Mona {
+
+	// Datos derivados del muestreo de una animacion en IKRigController::addAnimation
+	struct IKAnimationPreprocessData {
+		// posiciones globales de la cadera por frame (ajustadas al piso)
+		std::vector<glm::vec3> hipGlobalPositions;
+		// frames de soporte por cadena, ya ajustados entre cadenas opuestas
+		std::vector<std::vector<bool>> supportFramesPerChain;
+		// posiciones globales de los ee por cadena y frame (ajustadas al piso)
+		std::vector<std::vector<glm::vec3>> globalPositionsPerChain;
+	};
+
+	// Hash FNV-1a incremental para identificar una animacion junto a la configuracion del rig
+	class IKAnimationCacheKey {
+		uint64_t m_hash = 14695981039346656037ull;
+	public:
+		IKAnimationCacheKey() { add(IK_ANIMATION_CACHE_VERSION); }
+		void addBytes(const void* data, size_t size) {
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; i++) {
+				m_hash ^= bytes[i];
+				m_hash *= 1099511628211ull;
+			}
+		}
+		template <typename T>
+		void add(const T& value) { addBytes(&value, sizeof(T)); }
+		template <typename T>
+		void add(const std::vector<T>& values) {
+			add(values.size());
+			if (0 < values.size()) {
+				addBytes(values.data(), values.size() * sizeof(T));
+			}
+		}
+		uint64_t getHash() const { return m_hash; }
+	};
+
+	/*
+	* Cache de preprocesamiento de animaciones ik, en memoria y en archivos binarios versionados. Es unica en el proceso, por
+	* lo que su memoria se contabiliza en su propia cuenta y no en la de cada mundo.
+	*/
+	class IKAnimationCache {
+	public:
+		IKAnimationCache(IKAnimationCache const&) = delete;
+		IKAnimationCache& operator=(IKAnimationCache const&) = delete;
+		static IKAnimationCache& GetInstance() {
+			static IKAnimationCache instance;
+			return instance;
+		}
+		bool load(uint64_t key, int frameNum, int chainNum, IKAnimationPreprocessData& outData);
+		void save(uint64_t key, const IKAnimationPreprocessData& data);
+		void clear();
+		size_t getMemoryUsage() const;
+		void enable(bool enableCache) { m_enabled = enableCache; }
+		bool isEnabled() const { return m_enabled; }
+		// Por defecto ik_animation_cache_directory dentro del directorio de compilacion
+		void setDirectory(const std::filesystem::path& directory) { m_directory = directory; }
+		const std::filesystem::path& getDirectory() const { return m_directory; }
+	private:
+		IKAnimationCache();
+		std::filesystem::path getFilePath(uint64_t key) const;
+		bool readFile(uint64_t key, int expectedFrameNum, int expectedChainNum, IKAnimationPreprocessData& outData) const;
+		void writeFile(uint64_t key, const IKAnimationPreprocessData& data) const;
+		// Requiere m_mutex tomado
+		size_t computeMemoryUsage() const;
+		void updateMemoryAccount() { m_memoryAccount.Set(computeMemoryUsage(), 0); }
+		// La cache se comparte entre mundos que pueden correr en hilos distintos
+		mutable std::mutex m_mutex;
+		std::unordered_map<uint64_t, IKAnimationPreprocessData> m_entries;
+		std::filesystem::path m_directory;
+		bool m_enabled = true;
+		MemoryAccount m_memoryAccount{ MemoryTag::IKNavigation };
+	};
+
+}
+
+#endif
@@ -36,6 +36,10 @@ namespace Mona {
 				m_ikRigController.enableIK(enableIK);
 			}
 
+			void EnableIKSolveSkipping(bool enableSolveSkipping) {
+				m_ikRigController.m_ikRig.m_inverseKinematics.enableSolveSkipping(enableSolveSkipping);
+			}
+
 			int RemoveAnimation(std::shared_ptr<AnimationClip> animationClip) {
 				return m_ikRigController.removeAnimation(animationClip);
 			}
@@ -49,6 +53,7 @@ namespace Mona {
 				m_ikRigController.setAngularSpeed(angularSpeed);
 			}
 			IKRigController& GetIKRigController() { return m_ikRigController; }
+			size_t GetMemoryUsage() const { return m_ikRigController.m_ikRig.getMemoryUsage(); }
 		private:
 			RigData m_rigData;
 			IKRigController m_ikRigController;
@@ -23,6 +23,11 @@ namespace Mona {
 			ikNav.m_ikRigController.init();
 		}
 		void OnRemoveComponent(GameObject* gameObjectPtr, IKNavigationComponent& ikNav, const InnerComponentHandle& handle) noexcept {
+			// sin el rig, el controlador vuelve a muestrear los clips originales
+			InnerComponentHandle skeletalMeshHandle = gameObjectPtr->GetInnerComponentHandle<SkeletalMeshComponent>();
+			if (m_skeletalMeshManagerPtr->IsValid(skeletalMeshHandle)) {
+				m_skeletalMeshManagerPtr->GetComponentPointer(skeletalMeshHandle)->GetAnimationController().ClearSampledClips();
+			}
 		}
 	private:
 		ComponentManager<TransformComponent>* m_transformManagerPtr = nullptr;
@@ -1,19 +1,101 @@
 #include "IKNavigationSystem.hpp"
 #include "../World/ComponentManager.hpp"
+#include "../Core/Log.hpp"
+#include "../Core/JobSystem.hpp"
 #include "IKNavigationLifetimePolicy.hpp"
 
 namespace Mona {
 
+	bool sphereInFrustum(const glm::mat4& viewProjection, glm::vec3 center, float radius) {
+		glm::mat4 vpT = glm::transpose(viewProjection);
+		glm::vec4 planes[6] = { vpT[3] + vpT[0], vpT[3] - vpT[0], vpT[3] + vpT[1],
+			vpT[3] - vpT[1], vpT[3] + vpT[2], vpT[3] - vpT[2] };
+		for (int i = 0; i < 6; i++) {
+			float normalLength = glm::length(glm::vec3(planes[i]));
+			if (glm::dot(glm::vec3(planes[i]), center) + planes[i][3] < -radius * normalLength) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	int IKNavigationSystem::selectLODTier(float cameraDistance, float screenSize, bool visible) {
+		int lastTier = m_lodTiers.size() - 1;
+		if (!visible) {
+			return lastTier;
+		}
+		for (int i = 0; i < lastTier; i++) {
+			if (cameraDistance <= m_lodTiers[i].maxCameraDistance && m_lodTiers[i].minScreenSize <= screenSize) {
+				return i;
+			}
+		}
+		return lastTier;
+	}
+
+	void IKNavigationSystem::SetLODTiers(const std::vector<IKNavigationLODTier>& lodTiers) {
+		MONA_ASSERT(0 < lodTiers.size(), "IKNavigationSystem: at least one lod tier must be provided.");
+		for (int i = 0; i < lodTiers.size(); i++) {
+			MONA_ASSERT(0 < lodTiers[i].ikFramePeriod, "IKNavigationSystem: ik frame period must be positive.");
+		}
+		m_lodTiers = lodTiers;
+	}
+
 	void IKNavigationSystem::UpdateAllRigs(ComponentManager<IKNavigationComponent>& ikNavigationManager,
 		ComponentManager<TransformComponent>& transformManager,
 		ComponentManager<StaticMeshComponent>& staticMeshManager, 
-		ComponentManager<SkeletalMeshComponent>& skeletalMeshManager, float timeStep) {
+		ComponentManager<SkeletalMeshComponent>& skeletalMeshManager,
+		ComponentManager<CameraComponent>& cameraManager,
+		const InnerComponentHandle& cameraHandle, float timeStep) {
+
+		bool useLOD = m_lodEnabled && cameraManager.IsValid(cameraHandle);
+		glm::vec3 cameraPosition(0);
+		glm::mat4 viewProjection(1);
+		float screenHeightFactor = 1;
+		if (useLOD) {
+			const CameraComponent* camera = cameraManager.GetComponentPointer(cameraHandle);
+			GameObject* cameraOwner = cameraManager.GetOwner(cameraHandle);
+			TransformComponent* cameraTransform = transformManager.GetComponentPointer(cameraOwner->GetInnerComponentHandle<TransformComponent>());
+			cameraPosition = cameraTransform->GetWorldTranslation();
+			viewProjection = camera->GetProjectionMatrix() * cameraTransform->GetWorldViewMatrix();
+			screenHeightFactor = 2 * glm::tan(glm::radians(camera->GetFieldOfView()) / 2);
+		}
 			
+		// los rigs cuyo dueno esta inactivo no se actualizan
+		m_activeRigs.resize(ikNavigationManager.GetCount());
 		for (uint32_t i = 0; i < ikNavigationManager.GetCount(); i++) {
-			IKNavigationComponent& ikNav = ikNavigationManager[i];
-			IKRigController& ikRigController = ikNav.GetIKRigController();
-			ikRigController.updateIKRig(timeStep, transformManager, staticMeshManager, skeletalMeshManager);
+			m_activeRigs[i] = ikNavigationManager.GetOwnerByIndex(i)->GetState() != GameObject::EState::Inactive;
+		}
+		// las formas de colision de terrenos cargados desde archivo se construyen una vez, antes de los trabajos
+		for (uint32_t i = 0; i < ikNavigationManager.GetCount(); i++) {
+			if (m_activeRigs[i]) {
+				ikNavigationManager[i].GetIKRigController().prepareTerrains(staticMeshManager);
+			}
 		}
+		// cada rig modifica solo su propia copia de las animaciones, por lo que los rigs se actualizan en paralelo
+		JobSystem::GetInstance().ParallelFor(ikNavigationManager.GetCount(), 1, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++) {
+				if (!m_activeRigs[i]) {
+					continue;
+				}
+				IKNavigationComponent& ikNav = ikNavigationManager[i];
+				IKRigController& ikRigController = ikNav.GetIKRigController();
+				if (useLOD) {
+					IKRig& ikRig = ikRigController.m_ikRig;
+					glm::vec3 rigPosition = transformManager.GetComponentPointer(ikRig.getTransformHandle())->GetWorldTranslation();
+					float rigHeight = ikRig.getRigHeight() * ikRig.getRigScale();
+					float cameraDistance = glm::distance(cameraPosition, rigPosition);
+					float screenSize = rigHeight / (std::max(cameraDistance, rigHeight / 100) * screenHeightFactor);
+					const IKNavigationLODTier& tier = m_lodTiers[selectLODTier(cameraDistance, screenSize,
+						sphereInFrustum(viewProjection, rigPosition, rigHeight))];
+					// la fase desfasa los frames con ik de distintos rigs
+					ikRigController.setLOD(tier.lod, tier.ikFramePeriod, i);
+				}
+				else {
+					ikRigController.setLOD(IKNavigationLOD::FULL_IK, 1, 0);
+				}
+				ikRigController.updateIKRig(timeStep, transformManager, staticMeshManager, skeletalMeshManager);
+			}
+		});
 
 		#if NDEBUG
 		#else
@@ -2,22 +2,52 @@
 #ifndef IKNAVIGATIONSYSTEM_HPP
 #define IKNAVIGATIONSYSTEM_HPP
 
+#include <limits>
+#include <vector>
 #include "../World/TransformComponent.hpp"
 #include "../Rendering/StaticMeshComponent.hpp"
+#include "../Rendering/CameraComponent.hpp"
 #include "../Animation/SkeletalMeshComponent.hpp"
 #include "IKNavigationComponent.hpp"
 
 namespace Mona {
+	// Nivel de detalle aplicado mientras el rig este a menos de maxCameraDistance de la camara
+	// y ocupe al menos minScreenSize de la altura de la pantalla
+	struct IKNavigationLODTier {
+		IKNavigationLOD lod = IKNavigationLOD::FULL_IK;
+		float maxCameraDistance = std::numeric_limits<float>::max();
+		float minScreenSize = 0;
+		// solo para PERIODIC_IK, cada cuantos frames de la animacion se calcula ik
+		int ikFramePeriod = 1;
+	};
+
 	class IKRigController;
 	class IKNavigationSystem {
 		std::vector<IKRigController*> m_controllersDebug;
+		// tabla de niveles de detalle, del mas al menos detallado. Los rigs fuera de camara usan el ultimo.
+		std::vector<IKNavigationLODTier> m_lodTiers = {
+			{IKNavigationLOD::FULL_IK, std::numeric_limits<float>::max(), 0.25f, 1},
+			{IKNavigationLOD::PERIODIC_IK, std::numeric_limits<float>::max(), 0.1f, 3},
+			{IKNavigationLOD::TRAJECTORIES_ONLY, std::numeric_limits<float>::max(), 0.03f, 1},
+			{IKNavigationLOD::ANIMATION_ONLY, std::numeric_limits<float>::max(), 0, 1}
+		};
+		// desactivado por defecto, se activa con EnableLOD o con enable_ik_navigation_lod en la configuracion
+		bool m_lodEnabled = false;
+		// por cada rig, si su dueno estaba activo al comenzar el frame
+		std::vector<bool> m_activeRigs;
+		int selectLODTier(float cameraDistance, float screenSize, bool visible);
 	public:
 		IKNavigationSystem() = default;
 		void UpdateAllRigs(ComponentManager<IKNavigationComponent>& ikNavigationManager,
 			ComponentManager<TransformComponent>& transformManager,
 			ComponentManager<StaticMeshComponent>& staticMeshManager,
-			ComponentManager<SkeletalMeshComponent>& skeletalMeshManager, float timeStep);
+			ComponentManager<SkeletalMeshComponent>& skeletalMeshManager,
+			ComponentManager<CameraComponent>& cameraManager,
+			const InnerComponentHandle& cameraHandle, float timeStep);
+		void SetLODTiers(const std::vector<IKNavigationLODTier>& lodTiers);
+		const std::vector<IKNavigationLODTier>& GetLODTiers() const { return m_lodTiers; }
+		void EnableLOD(bool enableLOD) { m_lodEnabled = enableLOD; }
 		std::vector<IKRigController*> getControllersDebug() { return m_controllersDebug; }
 	};
 }
-#endif
\ No newline at end of file
+#endif
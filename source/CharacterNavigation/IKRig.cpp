@@ -65,6 +65,14 @@ namespace Mona {
 		m_ikAnimations.reserve(MAX_EXPECTED_NUMBER_OF_ANIMATIONS_PER_IKRIG);
 	}
 
+	size_t IKRig::getMemoryUsage() const {
+		size_t usage = m_ikAnimations.capacity() * sizeof(IKAnimation) + m_ikChains.capacity() * sizeof(IKChain);
+		for (const auto& ikAnimation : m_ikAnimations) {
+			usage += ikAnimation.getMemoryUsage();
+		}
+		return usage;
+	}
+
 	const std::vector<int>& IKRig::getTopology() const { 
 		return m_skeleton->m_parentIndices; 
 	};
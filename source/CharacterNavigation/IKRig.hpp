@@ -22,6 +22,7 @@ namespace Mona{
             IKRig() = default;
             IKRig(std::shared_ptr<Skeleton> skeleton, RigData rigData, InnerComponentHandle transformHandle);
             IKAnimation* getIKAnimation(AnimationIndex animIndex) { return &m_ikAnimations[animIndex]; };
+            int getAnimationNum() { return m_ikAnimations.size(); }
             const std::vector<int>& getTopology() const;
             const std::vector<std::string>& getJointNames() const;
             IKChain* getIKChain(ChainIndex chainIndex) { return &m_ikChains[chainIndex]; };
@@ -36,10 +37,13 @@ namespace Mona{
             void setAngularSpeed(float angularSpeed) { m_angularSpeed = angularSpeed; }
             float getAngularSpeed() { return m_angularSpeed; }
             InnerComponentHandle getTransformHandle() { return m_transformHandle; }
+            const InverseKinematics& getInverseKinematics() const { return m_inverseKinematics; }
+            const TrajectoryGenerator& getTrajectoryGenerator() const { return m_trajectoryGenerator; }
             void init();
             void fixAnimation(IKAnimation* ikAnim, FrameIndex fixedFrame);
             void resetAnimation(IKAnimation* ikAnim);
             void resetAnimation(AnimationIndex animIndex);
+            size_t getMemoryUsage() const;
         private:
             // Informacion de configuracion del IKRig por cada animacion
             std::vector<IKAnimation> m_ikAnimations;
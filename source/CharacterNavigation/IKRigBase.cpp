@@ -155,6 +155,23 @@ namespace Mona{
 		}
 	}
 
+	size_t IKAnimation::getMemoryUsage() const {
+		size_t usage = m_jointIndices.capacity() * sizeof(JointIndex) + m_variableJointRotations.capacity() * sizeof(JointRotation);
+		usage += m_originalJointRotations.capacity() * sizeof(std::vector<JointRotation>);
+		for (const auto& frameRotations : m_originalJointRotations) {
+			usage += frameRotations.capacity() * sizeof(JointRotation);
+		}
+		usage += m_savedAngles.capacity() * sizeof(LIC<1>);
+		for (const auto& savedAngles : m_savedAngles) {
+			usage += savedAngles.getMemoryUsage();
+		}
+		usage += m_eeTrajectoryData.capacity() * sizeof(EEGlobalTrajectoryData);
+		for (const auto& trajectoryData : m_eeTrajectoryData) {
+			usage += trajectoryData.getMemoryUsage();
+		}
+		return usage + m_hipTrajectoryData.getMemoryUsage();
+	}
+
 
 	JointRotation::JointRotation() {
 		setRotation(glm::identity<glm::fquat>());
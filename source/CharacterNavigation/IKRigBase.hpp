@@ -47,8 +47,10 @@ namespace Mona {
         AnimationIndex m_animationIndex = -1;
         // Indica si la animacion asociada esta activa
         bool m_active = false;
-        // Clip de animacion asociado a esta configuracion
+        // Copia propia del clip de animacion, que el ik modifica
         std::shared_ptr<AnimationClip> m_animationClip;
+        // Clip entregado por el usuario y compartido por AnimationClipManager, que no se modifica
+        std::shared_ptr<AnimationClip> m_sourceAnimationClip;
         // Indices de las articulaciones presentes en la animacion. Ordenados de acuerdo a la toplogia.
         std::vector<JointIndex> m_jointIndices;
         // Rotaciones para cada joint de la animacion base para cada frame 
@@ -73,11 +75,14 @@ namespace Mona {
         // Tipo de la animacion
         AnimationType m_animationType;
         FrameIndex m_fixedMovementFrame = -1;
+        // Transformacion global objetivo usada para llevar los objetivos de los ee a model space
+        glm::mat4 m_ikTargetGlobalTransform = glm::identity<glm::mat4>();
         void refreshSavedAngles(JointIndex jointIndex);
     public:
         IKAnimation(std::shared_ptr<AnimationClip> animationClip, AnimationType animationType, 
             AnimationIndex animIndex, ForwardKinematics* fk);
         AnimationIndex getAnimationIndex() { return m_animationIndex; }
+        const std::shared_ptr<AnimationClip>& getAnimationClip() const { return m_animationClip; }
         const std::vector<JointRotation>& getOriginalJointRotations(FrameIndex frame) const { return m_originalJointRotations[frame]; }
         std::vector<JointRotation>* getVariableJointRotations() { return &m_variableJointRotations; }
         const glm::vec3& getJointScale(JointIndex joint) const;
@@ -106,9 +111,12 @@ namespace Mona {
         bool isActive() { return m_active; }
         bool isMovementFixed();
         FrameIndex getFixedMovementFrame() { return m_fixedMovementFrame; }
+        const glm::mat4& getIKTargetGlobalTransform() const { return m_ikTargetGlobalTransform; }
         LIC<1>const& getSavedAngles(JointIndex jointIndex) { return m_savedAngles[jointIndex]; }
         void setVariableJointRotations(FrameIndex frame);
         void refresh();
+        // Estimacion de la memoria de los datos precalculados y del historial de la animacion
+        size_t getMemoryUsage() const;
     };
     struct ChainEnds {
         // Nombre de la articulacion base de la cadena
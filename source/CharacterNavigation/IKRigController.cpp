@@ -1,4 +1,5 @@
 #include "IKRigController.hpp"
+#include "IKAnimationCache.hpp"
 #include "../Core/FuncUtils.hpp"
 #include "../Core/GlmUtils.hpp"
 #include "glm/gtx/rotate_vector.hpp"
@@ -29,13 +30,17 @@ namespace Mona {
 		m_ikRig.m_trajectoryGenerator.m_environmentData.validateTerrains(staticMeshManager);
 	}
 
-	void IKRigController::addAnimation(std::shared_ptr<AnimationClip> animationClip, glm::vec3 originalUpVector, 
+	void IKRigController::prepareTerrains(ComponentManager<StaticMeshComponent>& staticMeshManager) {
+		m_ikRig.m_trajectoryGenerator.m_environmentData.prepareTerrains(staticMeshManager);
+	}
+
+	void IKRigController::addAnimation(std::shared_ptr<AnimationClip> sourceClip, glm::vec3 originalUpVector, 
 		glm::vec3 originalFrontVector, AnimationType animationType, float supportFrameDistanceFactor) {
 		
-		m_animationValidator.checkTransforms(animationClip);
+		m_animationValidator.checkTransforms(sourceClip);
 
-		// Transformacion base
-		glm::mat4 baseGlobalTransform = glmUtils::translationToMat4(m_ikRig.m_initialPosition)*glmUtils::scaleToMat4(glm::vec3(m_ikRig.m_rigScale));
+		// El clip del manager puede estar compartido con otros rigs y mundos, por lo que el rig trabaja sobre su propia copia
+		std::shared_ptr<AnimationClip> animationClip = std::shared_ptr<AnimationClip>(new AnimationClip(*sourceClip));
 
 		// Descomprimimos las rotaciones de la animacion, repitiendo valores para que todas las articulaciones 
 		// tengan el mismo numero de rotaciones
@@ -50,9 +55,50 @@ namespace Mona {
 		AnimationIndex newIndex = m_ikRig.m_ikAnimations.size();
 		m_ikRig.m_ikAnimations.push_back(IKAnimation(animationClip, animationType, newIndex, &m_ikRig.m_forwardKinematics));
 		IKAnimation* currentIKAnim = m_ikRig.getIKAnimation(newIndex);
+		currentIKAnim->m_sourceAnimationClip = sourceClip;
 		currentIKAnim->m_eeTrajectoryData = std::vector<EEGlobalTrajectoryData>(m_ikRig.m_ikChains.size());
 		// numero de rotaciones por joint con la animaciond descomprimida
 		int frameNum = animationClip->m_animationTracks[0].rotationTimeStamps.size();
+		int chainNum = m_ikRig.getChainNum();
+
+		// el muestreo de la animacion se reutiliza desde el cache si la animacion y el rig no cambiaron
+		uint64_t cacheKey = getPreprocessingCacheKey(animationClip, animationType, supportFrameDistanceFactor);
+		IKAnimationCache& ikAnimationCache = IKAnimationCache::GetInstance();
+		IKAnimationPreprocessData preprocessData;
+		if (!ikAnimationCache.load(cacheKey, frameNum, chainNum, preprocessData)) {
+			preprocessData = preprocessAnimation(currentIKAnim, supportFrameDistanceFactor);
+			ikAnimationCache.save(cacheKey, preprocessData);
+		}
+
+		// Guardamos la informacion de traslacion y rotacion de la cadera, antes de eliminarla
+		TrajectoryGenerator::buildHipTrajectory(currentIKAnim, preprocessData.hipGlobalPositions);
+
+		// dividimos cada trayectoria global (por ee) en sub trayectorias dinamicas y estaticas.
+		std::vector<ChainIndex> oppositePerChain;
+		for (ChainIndex i = 0; i < chainNum; i++) {
+			ChainIndex opposite = m_ikRig.getIKChain(i)->getOpposite();
+			oppositePerChain.push_back(opposite);
+		}
+		TrajectoryGenerator::buildEETrajectories(currentIKAnim, preprocessData.supportFramesPerChain, 
+			preprocessData.globalPositionsPerChain, oppositePerChain);
+
+		// Se remueve el movimiento de las caderas
+		animationClip->RemoveJointTranslation(m_ikRig.m_hipJoint);
+
+		// expandir los arreglos de objetivos de las cadenas
+		for (int i = 0; i < m_ikRig.m_ikChains.size(); i++) {
+			m_ikRig.m_ikChains[i].m_currentEETargets.push_back(glm::vec3(0));
+		}
+		// asignar indice a la IKAnimation
+		currentIKAnim->m_animationIndex = m_ikRig.m_ikAnimations.size() - 1;
+	}
+
+	IKAnimationPreprocessData IKRigController::preprocessAnimation(IKAnimation* ikAnim, float supportFrameDistanceFactor) {
+		std::shared_ptr<AnimationClip> animationClip = ikAnim->m_animationClip;
+		// Transformacion base
+		glm::mat4 baseGlobalTransform = glmUtils::translationToMat4(m_ikRig.m_initialPosition)*glmUtils::scaleToMat4(glm::vec3(m_ikRig.m_rigScale));
+		// numero de rotaciones por joint con la animaciond descomprimida
+		int frameNum = animationClip->m_animationTracks[0].rotationTimeStamps.size();
 		int chainNum = m_ikRig.getChainNum();		
 
 		// Guardamos las trayectorias originales de los ee y definimos sus frames de soporte
@@ -73,9 +119,9 @@ namespace Mona {
 		for (FrameIndex i = 0; i < frameNum; i++) {
 			// calculo de las transformaciones
 			float timeStamp = rotTimeStamps[i];
-			while (currentIKAnim->getAnimationDuration() <= timeStamp) { timeStamp -= 0.000001; }
-			for (int j = 0; j < currentIKAnim->getJointIndices().size(); j++) {
-				JointIndex jIndex = currentIKAnim->getJointIndices()[j];
+			while (ikAnim->getAnimationDuration() <= timeStamp) { timeStamp -= 0.000001; }
+			for (int j = 0; j < ikAnim->getJointIndices().size(); j++) {
+				JointIndex jIndex = ikAnim->getJointIndices()[j];
 				glm::mat4 baseTransform = j == 0 ? baseGlobalTransform : glblTransforms[m_ikRig.getTopology()[jIndex]];
 				glblTransforms[jIndex] = baseTransform *
 					glmUtils::translationToMat4(animationClip->GetPosition(timeStamp, jIndex, true)) *
@@ -96,8 +142,8 @@ namespace Mona {
 				supportFramesPerChain[j][i] = isSupportFrame;
 				glblPositionsPerChain[j][i] = glm::vec4(glblPositions[eeIndex], 1);
 			}
-			for (int j = 0; j < currentIKAnim->getJointIndices().size(); j++) {
-				JointIndex jIndex = currentIKAnim->getJointIndices()[j];
+			for (int j = 0; j < ikAnim->getJointIndices().size(); j++) {
+				JointIndex jIndex = ikAnim->getJointIndices()[j];
 				if (glblPositions[jIndex][2] < floorZ) {
 					floorZ = glblPositions[jIndex][2];
 				}
@@ -114,9 +160,6 @@ namespace Mona {
 			hipGlblPositions[i][2] -= floorZ;
 		}
 
-		// Guardamos la informacion de traslacion y rotacion de la cadera, antes de eliminarla
-		TrajectoryGenerator::buildHipTrajectory(currentIKAnim, hipGlblPositions);
-		
 		// si hay un frame que no es de soporte entre dos frames que si lo son, se setea como de soporte
 		// si el penultimo es de soporte, tambien se setea el ultimo como de soporte
 		// a los valores de soporte del primer frame les asignamos el valor del ultimo asumiento circularidad
@@ -148,30 +191,50 @@ namespace Mona {
 			}
 		}
 
-		// dividimos cada trayectoria global (por ee) en sub trayectorias dinamicas y estaticas.
-		std::vector<ChainIndex> oppositePerChain;
-		for (ChainIndex i = 0; i < chainNum; i++) {
-			ChainIndex opposite = m_ikRig.getIKChain(i)->getOpposite();
-			oppositePerChain.push_back(opposite);
-		}
-		TrajectoryGenerator::buildEETrajectories(currentIKAnim, supportFramesPerChain, glblPositionsPerChain, oppositePerChain);
-
-		// Se remueve el movimiento de las caderas
-		animationClip->RemoveJointTranslation(m_ikRig.m_hipJoint);
+		IKAnimationPreprocessData preprocessData;
+		preprocessData.hipGlobalPositions = hipGlblPositions;
+		preprocessData.supportFramesPerChain = supportFramesPerChain;
+		preprocessData.globalPositionsPerChain = glblPositionsPerChain;
+		return preprocessData;
+	}
 
-		// expandir los arreglos de objetivos de las cadenas
-		for (int i = 0; i < m_ikRig.m_ikChains.size(); i++) {
-			m_ikRig.m_ikChains[i].m_currentEETargets.push_back(glm::vec3(0));
+	uint64_t IKRigController::getPreprocessingCacheKey(std::shared_ptr<AnimationClip> animationClip, AnimationType animationType, 
+		float supportFrameDistanceFactor) {
+		IKAnimationCacheKey cacheKey;
+		// contenido de la animacion
+		cacheKey.add(animationClip->m_duration);
+		cacheKey.add(animationClip->m_trackJointIndices);
+		for (int i = 0; i < animationClip->m_animationTracks.size(); i++) {
+			const AnimationClip::AnimationTrack& track = animationClip->m_animationTracks[i];
+			cacheKey.add(track.positions);
+			cacheKey.add(track.rotations);
+			cacheKey.add(track.scales);
+			cacheKey.add(track.positionTimeStamps);
+			cacheKey.add(track.rotationTimeStamps);
+			cacheKey.add(track.scaleTimeStamps);
 		}
-		// asignar indice a la IKAnimation
-		currentIKAnim->m_animationIndex = m_ikRig.m_ikAnimations.size() - 1;
+		// configuracion del rig
+		cacheKey.add(m_ikRig.getTopology());
+		cacheKey.add(m_ikRig.m_hipJoint);
+		cacheKey.add(m_ikRig.m_rigHeight);
+		cacheKey.add(m_ikRig.m_rigScale);
+		cacheKey.add(m_ikRig.m_initialPosition);
+		for (ChainIndex i = 0; i < m_ikRig.m_ikChains.size(); i++) {
+			cacheKey.add(m_ikRig.m_ikChains[i].m_joints);
+			cacheKey.add(m_ikRig.m_ikChains[i].m_opposite);
+		}
+		cacheKey.add(animationType);
+		cacheKey.add(supportFrameDistanceFactor);
+		return cacheKey.getHash();
 	}
 
 	AnimationIndex IKRigController::removeAnimation(std::shared_ptr<AnimationClip> animationClip) {
 		for (int i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
-			if (m_ikRig.m_ikAnimations[i].m_animationClip == animationClip) {
+			if (m_ikRig.m_ikAnimations[i].m_sourceAnimationClip == animationClip) {
 				m_ikRig.resetAnimation(i);
 				m_ikRig.m_ikAnimations.erase(m_ikRig.m_ikAnimations.begin() + i);
+				// los indices de las animaciones siguientes cambian
+				m_ikRig.m_inverseKinematics.invalidateSolveCaches();
 				return i;
 			}
 		}
@@ -294,6 +357,7 @@ namespace Mona {
 			glm::mat4 nextGlblTransform = glmUtils::translationToMat4(hipTrData->getTargetPositions().evalCurve(targetTimeNext)) *
 				glmUtils::rotationToMat4(glm::angleAxis(m_ikRig.m_rotationAngle + m_ikRig.m_angularSpeed*deltaT, m_ikRig.getUpVector())) *
 				glmUtils::scaleToMat4(glm::vec3(m_ikRig.m_rigScale));
+			ikAnim.m_ikTargetGlobalTransform = nextGlblTransform;
 			glm::mat4 toModelSpace = glm::inverse(nextGlblTransform);
 			for (ChainIndex i = 0; i < m_ikRig.getChainNum(); i++) {
 				IKChain* ikChain = m_ikRig.getIKChain(i);
@@ -357,8 +421,10 @@ namespace Mona {
 				}
 			}
 
-			// calcular nuevas rotaciones para la animacion con ik
-			std::vector<std::pair<JointIndex, float>> calculatedAngles = m_ikRig.calculateRotationAngles(animIndex);
+			// calcular nuevas rotaciones para la animacion con ik, o propagar la ultima correccion si el lod lo permite
+			bool solveIK = m_lod != IKNavigationLOD::PERIODIC_IK || (currentFrame + m_ikFramePhase) % m_ikFramePeriod == 0;
+			std::vector<std::pair<JointIndex, float>> calculatedAngles = solveIK ? 
+				m_ikRig.calculateRotationAngles(animIndex) : propagateRotationAngles(animIndex);
 			std::shared_ptr<AnimationClip> animClip = ikAnim.m_animationClip;
 			for (int i = 0; i < calculatedAngles.size(); i++) {
 				JointIndex jIndex = calculatedAngles[i].first;
@@ -385,10 +451,10 @@ namespace Mona {
 		std::shared_ptr<AnimationClip> animClip = ikAnim.m_animationClip;
 		float prevSamplingTime = animClip->GetSamplingTime(m_reproductionTime - animationTimeStep, true);
 		float samplingTimeOffset = 0.0f;
-		if (animController.m_animationClipPtr == animClip) {
+		if (animController.m_animationClipPtr == ikAnim.m_sourceAnimationClip) {
 			samplingTimeOffset = animController.m_sampleTime - prevSamplingTime;
 		}
-		else if (animController.m_crossfadeTarget.GetAnimationClip() == animClip) {
+		else if (animController.m_crossfadeTarget.GetAnimationClip() == ikAnim.m_sourceAnimationClip) {
 			samplingTimeOffset = animController.m_crossfadeTarget.m_sampleTime - prevSamplingTime;
 		}
 		if ( samplingTimeOffset + avgFrameDuration / 10.0f < 0) {
@@ -413,12 +479,20 @@ namespace Mona {
 		IKAnimation& ikAnim = m_ikRig.m_ikAnimations[animIndex];
 		ikAnim.refresh();
 		m_ikRig.resetAnimation(animIndex);
+		m_ikRig.m_inverseKinematics.invalidateSolveCache(animIndex);
 	}
 
 	void IKRigController::updateIKRig(float timeStep, ComponentManager<TransformComponent>& transformManager,
 		ComponentManager<StaticMeshComponent>& staticMeshManager, ComponentManager<SkeletalMeshComponent>& skeletalMeshManager) {
 		validateTerrains(staticMeshManager);
 		AnimationController& animController = skeletalMeshManager.GetComponentPointer(m_skeletalMeshHandle)->GetAnimationController();
+		// el controlador pide los clips compartidos pero muestrea las copias que corrige el ik
+		if (animController.m_sampledClips.size() != m_ikRig.m_ikAnimations.size()) {
+			animController.ClearSampledClips();
+		}
+		for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
+			animController.SetSampledClip(m_ikRig.m_ikAnimations[i].m_sourceAnimationClip, m_ikRig.m_ikAnimations[i].m_animationClip);
+		}
 		float animTimeStep = timeStep * animController.GetPlayRate();
 		m_reproductionTime += animTimeStep;
 		for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
@@ -428,8 +502,8 @@ namespace Mona {
 		int activeAnimations = 0;
 		for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
 			IKAnimation& ikAnim = m_ikRig.m_ikAnimations[i];
-			if (animController.m_animationClipPtr == ikAnim.m_animationClip ||
-				animController.m_crossfadeTarget.GetAnimationClip() == ikAnim.m_animationClip) {
+			if (animController.m_animationClipPtr == ikAnim.m_sourceAnimationClip ||
+				animController.m_crossfadeTarget.GetAnimationClip() == ikAnim.m_sourceAnimationClip) {
 				ikAnim.m_active = true;
 				activeAnimations += 1;
 			}
@@ -439,13 +513,20 @@ namespace Mona {
 			}
 		}
 		m_transitioning = activeAnimations == 2;
+		if (m_lod == IKNavigationLOD::ANIMATION_ONLY) {
+			updatePlaybackTransform(animTimeStep, transformManager, staticMeshManager);
+			for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
+				m_ikRig.m_ikAnimations[i].m_onNewFrame = false;
+			}
+			return;
+		}
 		for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
 			if (m_ikRig.m_ikAnimations[i].isActive()) {
 				updateTrajectories(i, transformManager, staticMeshManager);			
 			}
 		}
 		updateGlobalTransform(transformManager);
-		if (m_ikEnabled) {
+		if (m_ikEnabled && lodUsesIK(m_lod)) {
 			for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
 				IKAnimation& ikAnim = m_ikRig.m_ikAnimations[i];
 				if (ikAnim.isActive()) {
@@ -468,11 +549,88 @@ namespace Mona {
 
 	}
 
+	std::vector<std::pair<JointIndex, float>> IKRigController::propagateRotationAngles(AnimationIndex animIndex) {
+		IKAnimation& ikAnim = m_ikRig.m_ikAnimations[animIndex];
+		FrameIndex currentFrame = ikAnim.getCurrentFrameIndex();
+		FrameIndex nextFrame = ikAnim.getNextFrameIndex();
+		float currentFrameRepTime = ikAnim.getReproductionTime(currentFrame);
+		std::vector<std::pair<JointIndex, float>> propagatedAngles;
+		for (int i = 0; i < m_ikRig.getChainNum(); i++) {
+			for (int j = 0; j < m_ikRig.getIKChain(i)->getJoints().size() - 1; j++) {
+				JointIndex jIndex = m_ikRig.getIKChain(i)->getJoints()[j];
+				// se mantiene la diferencia entre el angulo calculado y el original del frame actual
+				float angleOffset = ikAnim.getSavedAngles(jIndex).evalCurve(currentFrameRepTime)[0] -
+					ikAnim.m_originalJointRotations[currentFrame][jIndex].getRotationAngle();
+				float nextFrameAngle = ikAnim.m_originalJointRotations[nextFrame][jIndex].getRotationAngle() + angleOffset;
+				propagatedAngles.push_back({ jIndex, nextFrameAngle });
+			}
+		}
+		return propagatedAngles;
+	}
+
+	void IKRigController::updatePlaybackTransform(float timeStep, ComponentManager<TransformComponent>& transformManager,
+		ComponentManager<StaticMeshComponent>& staticMeshManager) {
+		glm::fquat updatedRotation = glm::angleAxis(m_ikRig.m_rotationAngle, m_ikRig.getUpVector());
+		TransformComponent* transform = transformManager.GetComponentPointer(m_ikRig.getTransformHandle());
+		transform->SetRotation(updatedRotation);
+
+		// velocidad promedio de la cadera en las animaciones activas
+		glm::vec3 averageVelocity(0);
+		int activeConfigs = 0;
+		for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
+			IKAnimation& ikAnim = m_ikRig.m_ikAnimations[i];
+			if (ikAnim.isActive()) {
+				if (ikAnim.getAnimationType() == AnimationType::WALKING) {
+					LIC<3>& originalPositions = ikAnim.getHipTrajectoryData()->m_originalPositions;
+					glm::vec3 displacement = originalPositions.getEnd() - originalPositions.getStart();
+					averageVelocity += displacement / (originalPositions.getTRange()[1] - originalPositions.getTRange()[0]);
+				}
+				activeConfigs += 1;
+			}
+		}
+		if (activeConfigs == 0) {
+			return;
+		}
+		averageVelocity /= activeConfigs;
+		glm::vec3 horizontalVelocity = averageVelocity - glm::dot(averageVelocity, m_ikRig.getUpVector())*m_ikRig.getUpVector();
+		glm::vec3 globalPosition = transform->GetLocalTranslation();
+		glm::vec3 newGlobalPosition = globalPosition + updatedRotation * horizontalVelocity * timeStep;
+		// se mantiene la altura sobre el terreno
+		EnvironmentData& environmentData = m_ikRig.m_trajectoryGenerator.m_environmentData;
+		float terrainOffset = globalPosition[2] - environmentData.getTerrainHeight(glm::vec2(globalPosition), transformManager, staticMeshManager);
+		newGlobalPosition[2] = environmentData.getTerrainHeight(glm::vec2(newGlobalPosition), transformManager, staticMeshManager) + terrainOffset;
+		transform->SetTranslation(newGlobalPosition);
+	}
+
+	void IKRigController::setLOD(IKNavigationLOD lod, int ikFramePeriod, int ikFramePhase) {
+		MONA_ASSERT(0 < ikFramePeriod, "IKRigController: ik frame period must be positive.");
+		m_ikFramePeriod = ikFramePeriod;
+		m_ikFramePhase = ikFramePhase % ikFramePeriod;
+		if (lod == m_lod) {
+			return;
+		}
+		if (m_ikEnabled && lodUsesIK(m_lod) && !lodUsesIK(lod)) {
+			// se vuelve a la animacion original
+			for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
+				m_ikRig.resetAnimation(i);
+			}
+			m_ikRig.m_inverseKinematics.invalidateSolveCaches();
+		}
+		if (m_lod == IKNavigationLOD::ANIMATION_ONLY) {
+			// las trayectorias guardadas quedaron desactualizadas
+			for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
+				refreshIKAnimation(i);
+			}
+		}
+		m_lod = lod;
+	}
+
 	void IKRigController::enableIK(bool enableIK) {
 		if (!enableIK) {
 			for (AnimationIndex i = 0; i < m_ikRig.m_ikAnimations.size(); i++) {
 				m_ikRig.resetAnimation(i);
 			}
+			m_ikRig.m_inverseKinematics.invalidateSolveCaches();
 		}
 		m_ikEnabled = enableIK;		
 	}
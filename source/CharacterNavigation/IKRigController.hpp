@@ -9,21 +9,46 @@
 
 namespace Mona {
 
+	// Niveles de detalle de actualizacion de un rig
+	enum class IKNavigationLOD {
+		// ik en cada frame de la animacion
+		FULL_IK,
+		// ik cada cierta cantidad de frames, propagando la ultima correccion en los demas
+		PERIODIC_IK,
+		// solo generacion de trayectorias y transformacion global
+		TRAJECTORIES_ONLY,
+		// reproduccion de la animacion original, desplazando el rig a su velocidad promedio
+		ANIMATION_ONLY
+	};
+
 	class AnimationController;
+	struct IKAnimationPreprocessData;
 	class IKRigController {
 		friend class IKNavigationComponent;
 		friend class DebugDrawingSystem_ikNav;
+		friend class IKNavigationSystem;
 		IKRig m_ikRig;
 		InnerComponentHandle m_skeletalMeshHandle;
 		AnimationValidator m_animationValidator;
 		float m_reproductionTime = 0;
 		bool m_ikEnabled;
 		bool m_transitioning;
+		IKNavigationLOD m_lod = IKNavigationLOD::FULL_IK;
+		int m_ikFramePeriod = 1;
+		int m_ikFramePhase = 0;
+		bool lodUsesIK(IKNavigationLOD lod) { return lod == IKNavigationLOD::FULL_IK || lod == IKNavigationLOD::PERIODIC_IK; }
+		std::vector<std::pair<JointIndex, float>> propagateRotationAngles(AnimationIndex animIndex);
+		IKAnimationPreprocessData preprocessAnimation(IKAnimation* ikAnim, float supportFrameDistanceFactor);
+		uint64_t getPreprocessingCacheKey(std::shared_ptr<AnimationClip> animationClip, AnimationType animationType,
+			float supportFrameDistanceFactor);
+		void updatePlaybackTransform(float timeStep, ComponentManager<TransformComponent>& transformManager,
+			ComponentManager<StaticMeshComponent>& staticMeshManager);
 	public:
 		IKRigController() = default;
 		IKRigController(std::shared_ptr<Skeleton> skeleton, RigData rigData, InnerComponentHandle transformHandle,
 			InnerComponentHandle skeletalMeshHandle, ComponentManager<TransformComponent>* transformManagerPtr);
 		void validateTerrains(ComponentManager<StaticMeshComponent>& staticMeshManager);
+		void prepareTerrains(ComponentManager<StaticMeshComponent>& staticMeshManager);
 		void addAnimation(std::shared_ptr<AnimationClip> animationClip, glm::vec3 originalUpVector,
 			glm::vec3 originalFrontVector, AnimationType animationType, float supportFrameDistanceFactor);
 		void setAngularSpeed(float angularSpeed) { m_ikRig.setAngularSpeed(angularSpeed); }
@@ -38,6 +63,8 @@ namespace Mona {
 		void updateMovementDirection(float timeStep);
 		void refreshIKAnimation(AnimationIndex animIndex);
 		void enableIK(bool enableIK);
+		void setLOD(IKNavigationLOD lod, int ikFramePeriod, int ikFramePhase);
+		IKNavigationLOD getLOD() const { return m_lod; }
 		void init();
 	};
 
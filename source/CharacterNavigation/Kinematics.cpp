@@ -1,6 +1,7 @@
 #include "Kinematics.hpp"
 #include "../Core/GlmUtils.hpp"
 #include "../Core/FuncUtils.hpp"
+#include "../Core/FrameAllocator.hpp"
 #include <glm/gtx/matrix_decompose.hpp>
 #include "IKRig.hpp"
 
@@ -24,104 +25,102 @@ namespace Mona {
 	// terminos para el descenso de gradiente
 	
 	// termino 1 (seguir la curva deseada para el end effector)
-	std::function<float(const std::vector<float>&, IKData*)> term1Function =
-		[](const std::vector<float>& varAngles, IKData* dataPtr)->float {
-		float result = 0;
-		int eeIndex;
-		glm::vec4 baseVec(0, 0, 0, 1);
-		glm::vec3 eePos;
-		std::vector<JointIndex> endEffectors;
-		for (int c = 0; c < dataPtr->ikChains.size(); c++) {
-			endEffectors.push_back(dataPtr->ikChains[c]->getEndEffector());
-		}
-		std::vector<glm::mat4> forwardModelSpaceTransforms = dataPtr->ikAnimation->getEEListModelSpaceVariableTransforms(endEffectors);
-		for (int c = 0; c < dataPtr->ikChains.size(); c++) {
-			eeIndex = endEffectors[c];
-			eePos = glm::vec3(forwardModelSpaceTransforms[eeIndex] * baseVec);
-			result += glm::length2(eePos - dataPtr->ikChains[c]->getCurrentEETarget(dataPtr->ikAnimation->getAnimationIndex()));
+	struct IKTerm_EETargets {
+		static float value(const IKArgs& varAngles, IKData* dataPtr) {
+			float result = 0;
+			int eeIndex;
+			glm::vec4 baseVec(0, 0, 0, 1);
+			glm::vec3 eePos;
+			std::vector<JointIndex> endEffectors;
+			for (int c = 0; c < dataPtr->ikChains.size(); c++) {
+				endEffectors.push_back(dataPtr->ikChains[c]->getEndEffector());
+			}
+			std::vector<glm::mat4> forwardModelSpaceTransforms = dataPtr->ikAnimation->getEEListModelSpaceVariableTransforms(endEffectors);
+			for (int c = 0; c < dataPtr->ikChains.size(); c++) {
+				eeIndex = endEffectors[c];
+				eePos = glm::vec3(forwardModelSpaceTransforms[eeIndex] * baseVec);
+				result += glm::length2(eePos - dataPtr->ikChains[c]->getCurrentEETarget(dataPtr->ikAnimation->getAnimationIndex()));
+			}
+			return result;
 		}
-		return result;
-	};
 
-	std::function<float(const std::vector<float>&, int, IKData*)> term1PartialDerivativeFunction =
-		[](const std::vector<float>& varAngles, int varIndex, IKData* dataPtr)->float {
-		float result = 0;
-		glm::mat4 TA; glm::mat4 TB; glm::vec3 TvarScl; glm::fquat TvarQuat;	glm::vec3 TvarTr;
-		glm::vec3 skew;	glm::vec4 perspective;
-		JointIndex varJoint = dataPtr->jointIndexes[varIndex];
-
-		for (int c = 0; c < dataPtr->ikChains.size(); c++) {
-			// chequeamos si la articulacion pertenece a la cadena actual
-			IKChain* chain = dataPtr->ikChains[c];
-			int ind = funcUtils::findIndex(chain->getJoints(), varJoint);
-			if (ind != -1) {
-				// matriz de trnasformacion de la joint actual
-				glm::mat4 TvarRaw = dataPtr->jointSpaceTransforms[varJoint];
-				glm::decompose(TvarRaw, TvarScl, TvarQuat, TvarTr, skew, perspective);
-				JointIndex chainParent = chain->getParentJoint();
-				glm::mat4 chainBaseTransform = chainParent == -1 ? glm::identity<glm::mat4>() : dataPtr->forwardModelSpaceTransforms[chainParent];
-				// matriz que va a la izquierda de la matriz de rotacion de la joint actual en el calculo de la posicion con FK
-				TA = (0 < ind ? dataPtr->forwardModelSpaceTransforms[chain->getJoints()[ind - 1]] :
-					chainBaseTransform) * glmUtils::translationToMat4(TvarTr);
-
-				// matriz que va a la  derecha de la matriz de rotacion de la joint actual en el calculo de la posicion con FK
-				TB = glmUtils::scaleToMat4(TvarScl) * (ind < chain->getJoints().size() - 1 ?
-					dataPtr->backwardModelSpaceTransformsPerChain[c][chain->getJoints()[ind + 1]] : glm::identity<glm::mat4>());
-				glm::vec4 b = TB * glm::vec4(0, 0, 0, 1);
-				glm::mat4 Tvar = glmUtils::rotationToMat4(TvarQuat);
-				glm::mat4 dTvar = rotationMatrixDerivative_dAngle(varAngles[varIndex], dataPtr->rotationAxes[varIndex]);
-				glm::vec4 eeT = glm::vec4(chain->getCurrentEETarget(dataPtr->ikAnimation->getAnimationIndex()), 1);
-				for (int k = 0; k <= 3; k++) {
-					float mult1 = 0;
-					for (int j = 0; j <= 3; j++) {
-						for (int i = 0; i <= 3; i++) {
-							mult1 += b[j] * TA[i][k] * Tvar[j][i] - eeT[k] / 16;
+		static float partialDerivative(const IKArgs& varAngles, int varIndex, IKData* dataPtr) {
+			float result = 0;
+			glm::mat4 TA; glm::mat4 TB; glm::vec3 TvarScl; glm::fquat TvarQuat;	glm::vec3 TvarTr;
+			glm::vec3 skew;	glm::vec4 perspective;
+			JointIndex varJoint = dataPtr->jointIndexes[varIndex];
+
+			for (int c = 0; c < dataPtr->ikChains.size(); c++) {
+				// chequeamos si la articulacion pertenece a la cadena actual
+				IKChain* chain = dataPtr->ikChains[c];
+				int ind = funcUtils::findIndex(chain->getJoints(), varJoint);
+				if (ind != -1) {
+					// matriz de trnasformacion de la joint actual
+					glm::mat4 TvarRaw = dataPtr->jointSpaceTransforms[varJoint];
+					glm::decompose(TvarRaw, TvarScl, TvarQuat, TvarTr, skew, perspective);
+					JointIndex chainParent = chain->getParentJoint();
+					glm::mat4 chainBaseTransform = chainParent == -1 ? glm::identity<glm::mat4>() : dataPtr->forwardModelSpaceTransforms[chainParent];
+					// matriz que va a la izquierda de la matriz de rotacion de la joint actual en el calculo de la posicion con FK
+					TA = (0 < ind ? dataPtr->forwardModelSpaceTransforms[chain->getJoints()[ind - 1]] :
+						chainBaseTransform) * glmUtils::translationToMat4(TvarTr);
+
+					// matriz que va a la  derecha de la matriz de rotacion de la joint actual en el calculo de la posicion con FK
+					TB = glmUtils::scaleToMat4(TvarScl) * (ind < chain->getJoints().size() - 1 ?
+						dataPtr->backwardModelSpaceTransformsPerChain[c][chain->getJoints()[ind + 1]] : glm::identity<glm::mat4>());
+					glm::vec4 b = TB * glm::vec4(0, 0, 0, 1);
+					glm::mat4 Tvar = glmUtils::rotationToMat4(TvarQuat);
+					glm::mat4 dTvar = rotationMatrixDerivative_dAngle(varAngles[varIndex], dataPtr->rotationAxes[varIndex]);
+					glm::vec4 eeT = glm::vec4(chain->getCurrentEETarget(dataPtr->ikAnimation->getAnimationIndex()), 1);
+					for (int k = 0; k <= 3; k++) {
+						float mult1 = 0;
+						for (int j = 0; j <= 3; j++) {
+							for (int i = 0; i <= 3; i++) {
+								mult1 += b[j] * TA[i][k] * Tvar[j][i] - eeT[k] / 16;
+							}
 						}
-					}
-					float mult2 = 0;
-					for (int j = 0; j <= 3; j++) {
-						for (int i = 0; i <= 3; i++) {
-							mult2 += b[j] * TA[i][k] * dTvar[j][i];
+						float mult2 = 0;
+						for (int j = 0; j <= 3; j++) {
+							for (int i = 0; i <= 3; i++) {
+								mult2 += b[j] * TA[i][k] * dTvar[j][i];
+							}
 						}
+						result += mult1 * mult2;
 					}
-					result += mult1 * mult2;
 				}
+
 			}
-			
+			return 2 * result;
 		}
-		return 2 * result;
 	};
 
 	// termino 2 (acercar la animacion creada a la animacion original)
-	std::function<float(const std::vector<float>&, IKData*)> term2Function =
-		[](const std::vector<float>& varAngles, IKData* dataPtr)->float {
-		float result = 0;
-		for (int i = 0; i < varAngles.size(); i++) {
-			result += pow(varAngles[i] - dataPtr->baseAngles[i], 2);
+	struct IKTerm_BaseAngles {
+		static float value(const IKArgs& varAngles, IKData* dataPtr) {
+			float result = 0;
+			for (int i = 0; i < varAngles.size(); i++) {
+				result += pow(varAngles[i] - dataPtr->baseAngles[i], 2);
+			}
+			return result;
 		}
-		return result;
-	};
 
-	std::function<float(const std::vector<float>&, int, IKData*)> term2PartialDerivativeFunction =
-		[](const std::vector<float>& varAngles, int varIndex, IKData* dataPtr)->float {
-		return 2 * (varAngles[varIndex] - dataPtr->baseAngles[varIndex]);
+		static float partialDerivative(const IKArgs& varAngles, int varIndex, IKData* dataPtr) {
+			return 2 * (varAngles[varIndex] - dataPtr->baseAngles[varIndex]);
+		}
 	};
 
-	
-
 	// termino 3 (acercar los valores actuales a los del frame anterior)
-	std::function<float(const std::vector<float>&, IKData*)> term3Function =
-		[](const std::vector<float>& varAngles, IKData* dataPtr)->float {
-		float result = 0;
-		for (int i = 0; i < varAngles.size(); i++) {
-			result += pow(varAngles[i] - dataPtr->previousAngles[i], 2);
+	struct IKTerm_PreviousAngles {
+		static float value(const IKArgs& varAngles, IKData* dataPtr) {
+			float result = 0;
+			for (int i = 0; i < varAngles.size(); i++) {
+				result += pow(varAngles[i] - dataPtr->previousAngles[i], 2);
+			}
+			return result;
 		}
-		return result;
-	};
 
-	std::function<float(const std::vector<float>&, int, IKData*)> term3PartialDerivativeFunction =
-		[](const std::vector<float>& varAngles, int varIndex, IKData* dataPtr)->float {
-		return 2 * (varAngles[varIndex] - dataPtr->previousAngles[varIndex]);
+		static float partialDerivative(const IKArgs& varAngles, int varIndex, IKData* dataPtr) {
+			return 2 * (varAngles[varIndex] - dataPtr->previousAngles[varIndex]);
+		}
 	};
 
 	void setDescentTransformArrays(IKData* dataPtr) {
@@ -145,8 +144,7 @@ namespace Mona {
 
 	}
 
-	std::function<void(std::vector<float>&, IKData*, std::vector<float>&)>  postDescentStepCustomBehaviour =
-		[](std::vector<float>& args, IKData* dataPtr, std::vector<float>& argsRawDelta)->void {
+	void postDescentStepCustomBehaviour(IKArgs& args, IKData* dataPtr, IKArgs& argsRawDelta) {
 		// setear nuevos angulos
 		std::vector<JointRotation>* varRots = dataPtr->ikAnimation->getVariableJointRotations();
 		for (int i = 0; i < args.size(); i++) {
@@ -155,25 +153,29 @@ namespace Mona {
 		}
 		// setear arreglos de transformaciones
 		setDescentTransformArrays(dataPtr);
-	};
+	}
 
 	InverseKinematics::InverseKinematics(IKRig* ikRig) {
 		m_ikRig = ikRig;
 	}
 
 	void InverseKinematics::init() {
-		FunctionTerm<IKData> term1(term1Function, term1PartialDerivativeFunction);
-		FunctionTerm<IKData> term2(term2Function, term2PartialDerivativeFunction);
-		FunctionTerm<IKData> term3(term3Function, term3PartialDerivativeFunction);
-		auto terms = std::vector<FunctionTerm<IKData>>({ term1,term2, term3 });
-		m_gradientDescent = GradientDescent<IKData>(terms, 0, &m_ikData, postDescentStepCustomBehaviour);
-		m_ikData.descentRate = 0.01f;
-		m_ikData.maxIterations = 300;
-		m_ikData.targetAngleDelta = 1 / pow(10, 3);
+		m_gradientDescent = IKGradientDescent(0, &m_ikData, postDescentStepCustomBehaviour);
+		DescentSettings& settings = m_ikData.descentSettings;
+		settings.descentType = DescentType::REGULAR;
+		settings.descentRate = 0.01f;
+		settings.maxIterations = 300;
+		settings.targetArgDelta = 1 / pow(10, 3);
+		// con un gradiente de esta norma ningun angulo cambiaria mas que targetArgDelta,
+		// por lo que se evita el calculo del ultimo paso
+		settings.targetGradientNorm = settings.targetArgDelta / settings.descentRate;
 		float avgDeltaDist = m_ikRig->getRigHeight() / 200;
 		m_gradientDescent.setTermWeight(0, 1 / (avgDeltaDist*m_ikRig->getRigHeight()));
 		m_gradientDescent.setTermWeight(1, 2);		
 		m_gradientDescent.setTermWeight(2, 4);
+		m_skipPositionTolerance = m_ikRig->getRigHeight() / 2000;
+		// diferencias menores que la precision del propio descenso no cambian el resultado
+		m_skipAngleTolerance = settings.targetArgDelta;
 		setIKChains();
 	}
 
@@ -190,10 +192,73 @@ namespace Mona {
 			jointIndexes.insert(jointIndexes.end(), chainPtrs[c]->getJoints().begin(), chainPtrs[c]->getJoints().end()-1);
 		}
 		funcUtils::removeDuplicates(jointIndexes);
+		if (IK_DESCENT_INLINE_ARGS < jointIndexes.size()) {
+			MONA_LOG_WARNING("InverseKinematics: IK chains have {0} variable joints, more than {1}. The descent will use heap memory.",
+				jointIndexes.size(), IK_DESCENT_INLINE_ARGS);
+		}
 		m_ikData.jointIndexes = jointIndexes;
 		m_gradientDescent.setArgNum(m_ikData.jointIndexes.size());
 		m_ikData.rotationAxes.resize(m_ikData.jointIndexes.size());
 		m_ikData.baseAngles.resize(m_ikData.jointIndexes.size());
+		m_ikData.previousAngles.resize(m_ikData.jointIndexes.size());
+	}
+
+	float maxAxisScale(const glm::mat4& transform) {
+		return std::max(glm::length(glm::vec3(transform[0])), std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+	}
+
+	// compara la traslacion con translationTolerance y los ejes con angleTolerance escalada por la escala mayor
+	bool transformsMatch(const glm::mat4& cached, const glm::mat4& current, float translationTolerance, float angleTolerance) {
+		if (translationTolerance < glm::distance(glm::vec3(cached[3]), glm::vec3(current[3]))) {
+			return false;
+		}
+		float maxScale = maxAxisScale(current);
+		for (int i = 0; i < 3; i++) {
+			if (angleTolerance * maxScale < glm::length(glm::vec3(cached[i] - current[i]))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool IKSolveInputsMatch(const IKSolveInputs& cached, const IKSolveInputs& current, float positionTolerance, float angleTolerance) {
+		if (cached.eeTargets.size() != current.eeTargets.size() || cached.baseAngles.size() != current.baseAngles.size() ||
+			cached.chainBaseTransforms.size() != current.chainBaseTransforms.size()) {
+			return false;
+		}
+		for (int c = 0; c < current.eeTargets.size(); c++) {
+			if (positionTolerance < glm::distance(cached.eeTargets[c], current.eeTargets[c])) {
+				return false;
+			}
+		}
+		for (int i = 0; i < current.baseAngles.size(); i++) {
+			if (angleTolerance < std::abs(cached.baseAngles[i] - current.baseAngles[i]) ||
+				angleTolerance < std::abs(cached.previousAngles[i] - current.previousAngles[i]) ||
+				angleTolerance < glm::distance(cached.rotationAxes[i], current.rotationAxes[i])) {
+				return false;
+			}
+		}
+		// la base de cada cadena esta en model space, igual que los objetivos de los ee
+		for (int c = 0; c < current.chainBaseTransforms.size(); c++) {
+			if (!transformsMatch(cached.chainBaseTransforms[c], current.chainBaseTransforms[c], positionTolerance, angleTolerance)) {
+				return false;
+			}
+		}
+		// la transformacion global se compara escalada al espacio del modelo
+		const glm::mat4& currentTransform = current.targetGlobalTransform;
+		return transformsMatch(cached.targetGlobalTransform, currentTransform, positionTolerance * maxAxisScale(currentTransform), angleTolerance);
+	}
+
+	void InverseKinematics::invalidateSolveCache(AnimationIndex animationIndex) {
+		if (0 <= animationIndex && animationIndex < m_solveCaches.size()) {
+			m_solveCaches[animationIndex].valid = false;
+		}
+	}
+
+	void InverseKinematics::invalidateSolveCaches() {
+		for (int i = 0; i < m_solveCaches.size(); i++) {
+			m_solveCaches[i].valid = false;
+		}
 	}
 
 	std::vector<std::pair<JointIndex, float>> InverseKinematics::solveIKChains(AnimationIndex animationIndex) {
@@ -202,14 +267,18 @@ namespace Mona {
 		FrameIndex nextFrame = m_ikData.ikAnimation->getNextFrameIndex();
 		FrameIndex currentFrame = m_ikData.ikAnimation->getCurrentFrameIndex();
 		float currentFrameRepTime = m_ikData.ikAnimation->getReproductionTime(currentFrame);
+		if (m_solveCaches.size() <= animationIndex) {
+			m_solveCaches.resize(animationIndex + 1);
+		}
+		IKSolveCache& cache = m_solveCaches[animationIndex];
+		m_solveStatistics.requestedSolves += 1;
 
 		// recuperamos los angulos previamente usados de la animacion
-		m_ikData.previousAngles.resize(m_ikData.jointIndexes.size());
 		for (int i = 0; i < m_ikData.jointIndexes.size(); i++) {
 			JointIndex jIndex = m_ikData.jointIndexes[i];
 			m_ikData.previousAngles[i] = m_ikData.ikAnimation->getSavedAngles(jIndex).evalCurve(currentFrameRepTime)[0];
 		}
-		std::vector<float> initialArgs = m_ikData.previousAngles;
+		IKArgs initialArgs = m_ikData.previousAngles;
 
 		std::vector<JointRotation>const& baseRotations_target = m_ikData.ikAnimation->getOriginalJointRotations(nextFrame);
 		for (int i = 0; i < m_ikData.jointIndexes.size(); i++) {
@@ -218,18 +287,52 @@ namespace Mona {
 		}
 		// setear rotaciones variables a los valores base de frame objetivo
 		m_ikData.ikAnimation->setVariableJointRotations(nextFrame);
-		// ajustamos las rotaciones varaibles a los argumentos iniciales
 		std::vector<JointRotation>* variableRotations = m_ikData.ikAnimation->getVariableJointRotations();
-		for (int i = 0; i < m_ikData.jointIndexes.size(); i++) {
-			JointIndex jIndex = m_ikData.jointIndexes[i];
-			(*variableRotations)[jIndex].setRotationAngle(initialArgs[i]);
+
+		AnimationIndex animIndex = m_ikData.ikAnimation->getAnimationIndex();
+		m_solveInputs.eeTargets.resize(m_ikData.ikChains.size());
+		for (int c = 0; c < m_ikData.ikChains.size(); c++) {
+			m_solveInputs.eeTargets[c] = m_ikData.ikChains[c]->getCurrentEETarget(animIndex);
 		}
-		// setear arreglos de transformaciones
-		setDescentTransformArrays(&m_ikData);
-		std::vector<float> computedAngles = m_gradientDescent.computeArgsMin(m_ikData.descentRate, 
-			m_ikData.maxIterations, m_ikData.targetAngleDelta, initialArgs);
+		m_solveInputs.baseAngles = m_ikData.baseAngles;
+		m_solveInputs.previousAngles = m_ikData.previousAngles;
+		m_solveInputs.rotationAxes = m_ikData.rotationAxes;
+		// la pose de la cadera o raiz en el frame objetivo no aparece en los angulos variables, pero mueve las cadenas
+		std::vector<JointIndex> chainParents;
+		for (int c = 0; c < m_ikData.ikChains.size(); c++) {
+			if (m_ikData.ikChains[c]->getParentJoint() != -1) {
+				chainParents.push_back(m_ikData.ikChains[c]->getParentJoint());
+			}
+		}
+		std::vector<glm::mat4> parentTransforms = m_ikData.ikAnimation->getEEListModelSpaceVariableTransforms(chainParents);
+		m_solveInputs.chainBaseTransforms.resize(m_ikData.ikChains.size());
+		for (int c = 0; c < m_ikData.ikChains.size(); c++) {
+			JointIndex chainParent = m_ikData.ikChains[c]->getParentJoint();
+			m_solveInputs.chainBaseTransforms[c] = chainParent == -1 ? glm::identity<glm::mat4>() : parentTransforms[chainParent];
+		}
+		m_solveInputs.targetGlobalTransform = m_ikData.ikAnimation->getIKTargetGlobalTransform();
+
+		IKArgs computedAngles;
+		if (m_solveSkippingEnabled && cache.valid && IKSolveInputsMatch(cache.inputs, m_solveInputs, m_skipPositionTolerance, m_skipAngleTolerance)) {
+			// las entradas no cambiaron, se reutiliza el resultado anterior
+			computedAngles = cache.solvedAngles;
+			m_solveStatistics.skippedSolves += 1;
+		}
+		else {
+			// ajustamos las rotaciones varaibles a los argumentos iniciales
+			for (int i = 0; i < m_ikData.jointIndexes.size(); i++) {
+				JointIndex jIndex = m_ikData.jointIndexes[i];
+				(*variableRotations)[jIndex].setRotationAngle(initialArgs[i]);
+			}
+			// setear arreglos de transformaciones
+			setDescentTransformArrays(&m_ikData);
+			computedAngles = m_gradientDescent.computeArgsMin(m_ikData.descentSettings, initialArgs);
+			cache.valid = true;
+			cache.inputs = m_solveInputs;
+			cache.solvedAngles = computedAngles;
+		}
+
 		std::vector<std::pair<JointIndex, float>> result(computedAngles.size());
-		
 		for (int i = 0; i < m_ikData.jointIndexes.size(); i++) {
 			JointIndex jIndex = m_ikData.jointIndexes[i];
 			(*variableRotations)[jIndex].setRotationAngle(computedAngles[i]);
@@ -249,27 +352,31 @@ namespace Mona {
 			(*outEEListJointSpaceTransforms) = std::vector<glm::mat4>(m_ikRig->getTopology().size(), glm::identity<glm::mat4>());
 		}
 		funcUtils::sortUnique(eeList);
-		std::vector<JointIndex> calcJoints;
+		// memoria temporal del frame, se marcan las articulaciones ya calculadas en lugar de buscarlas en una lista
+		FrameVector<bool> calcJoints(m_ikRig->getTopology().size(), false);
+		FrameVector<JointIndex> currJointHierarchy;
+		currJointHierarchy.reserve(m_ikRig->getTopology().size());
 		while (0 < eeList.size()) {
 			JointIndex currJoint = eeList.back();
 			eeList.pop_back();
-			if (funcUtils::findIndex(calcJoints, currJoint) == -1) {
-				std::vector<JointIndex> currJointHierarchy;
-				glm::mat4 customSpaceTr = glm::identity<glm::mat4>();
-				// recolectar jointSpaceTransforms
+			if (!calcJoints[currJoint]) {
+				currJointHierarchy.clear();
+				// recolectar jointSpaceTransforms, desde el efector hasta la raiz
 				while (currJoint != -1) {
 					eeListCustomSpaceTr[currJoint] = JointSpaceTransform(ikAnim, currJoint, reproductionTime);
 					if (outEEListJointSpaceTransforms != nullptr) {
 						(*outEEListJointSpaceTransforms)[currJoint] = eeListCustomSpaceTr[currJoint];
 					}
-					currJointHierarchy.insert(currJointHierarchy.begin(), currJoint);
+					currJointHierarchy.push_back(currJoint);
 					currJoint = m_ikRig->getTopology()[currJoint];
 				}
-				// calcular customSpaceTransforms
-				for (int i = 0; i < currJointHierarchy.size(); i++) {
-					glm::mat4 _baseTransform = i == 0 ? baseTransform : eeListCustomSpaceTr[currJointHierarchy[i - 1]];
+				// calcular customSpaceTransforms, desde la raiz hacia el efector
+				int rootIndex = static_cast<int>(currJointHierarchy.size()) - 1;
+				for (int i = rootIndex; 0 <= i; i--) {
+					bool isRoot = i == rootIndex;
+					glm::mat4 _baseTransform = isRoot ? baseTransform : eeListCustomSpaceTr[currJointHierarchy[i + 1]];
 					eeListCustomSpaceTr[currJointHierarchy[i]] = _baseTransform * eeListCustomSpaceTr[currJointHierarchy[i]];
-					calcJoints.push_back(currJointHierarchy[i]);
+					calcJoints[currJointHierarchy[i]] = true;
 				}
 			}
 		}
@@ -283,27 +390,31 @@ namespace Mona {
 			(*outEEListJointSpaceTransforms) = std::vector<glm::mat4>(m_ikRig->getTopology().size(), glm::identity<glm::mat4>());
 		}
 		funcUtils::sortUnique(eeList);
-		std::vector<JointIndex> calcJoints;
+		// memoria temporal del frame, se marcan las articulaciones ya calculadas en lugar de buscarlas en una lista
+		FrameVector<bool> calcJoints(m_ikRig->getTopology().size(), false);
+		FrameVector<JointIndex> currJointHierarchy;
+		currJointHierarchy.reserve(m_ikRig->getTopology().size());
 		while (0 < eeList.size()) {
 			JointIndex currJoint = eeList.back();
 			eeList.pop_back();
-			if (funcUtils::findIndex(calcJoints, currJoint) == -1) {
-				std::vector<JointIndex> currJointHierarchy;
-				glm::mat4 customSpaceTr = glm::identity<glm::mat4>();
-				// recolectar jointSpaceTransforms
+			if (!calcJoints[currJoint]) {
+				currJointHierarchy.clear();
+				// recolectar jointSpaceTransforms, desde el efector hasta la raiz
 				while (currJoint != -1) {
 					eeListCustomSpaceTr[currJoint] = JointSpaceVariableTransform(ikAnim, currJoint);
 					if (outEEListJointSpaceTransforms != nullptr) {
 						(*outEEListJointSpaceTransforms)[currJoint] = eeListCustomSpaceTr[currJoint];
 					}
-					currJointHierarchy.insert(currJointHierarchy.begin(), currJoint);
+					currJointHierarchy.push_back(currJoint);
 					currJoint = m_ikRig->getTopology()[currJoint];
 				}
-				// calcular customSpaceTransforms
-				for (int i = 0; i < currJointHierarchy.size(); i++) {
-					glm::mat4 _baseTransform = i == 0 ? baseTransform : eeListCustomSpaceTr[currJointHierarchy[i - 1]];
+				// calcular customSpaceTransforms, desde la raiz hacia el efector
+				int rootIndex = static_cast<int>(currJointHierarchy.size()) - 1;
+				for (int i = rootIndex; 0 <= i; i--) {
+					bool isRoot = i == rootIndex;
+					glm::mat4 _baseTransform = isRoot ? baseTransform : eeListCustomSpaceTr[currJointHierarchy[i + 1]];
 					eeListCustomSpaceTr[currJointHierarchy[i]] = _baseTransform * eeListCustomSpaceTr[currJointHierarchy[i]];
-					calcJoints.push_back(currJointHierarchy[i]);
+					calcJoints[currJointHierarchy[i]] = true;
 				}
 			}
 		}
@@ -7,6 +7,9 @@
 #include "GradientDescent.hpp"
 #include "glm/glm.hpp"
 
+// angulos variables del descenso (articulaciones de todas las cadenas, sin los ee) que se guardan sin memoria dinamica
+#define IK_DESCENT_INLINE_ARGS 16
+
 namespace Mona {
 	typedef int AnimationIndex;
 	typedef int JointIndex;
@@ -32,9 +35,11 @@ namespace Mona {
 
 	};
 
+	typedef DescentArgs<IK_DESCENT_INLINE_ARGS> IKArgs;
+
 	struct IKData {
 		// constants data
-		std::vector<float> baseAngles;
+		IKArgs baseAngles;
 		// variables data
 		std::vector<JointIndex> jointIndexes;
 		std::vector<glm::vec3> rotationAxes;
@@ -47,22 +52,75 @@ namespace Mona {
 		std::vector<std::vector<glm::mat4>> backwardModelSpaceTransformsPerChain;
 		// other data
 		IKAnimation* ikAnimation;
-		std::vector<float> previousAngles;
-		float descentRate;
-		float targetAngleDelta;
-		int maxIterations;
+		IKArgs previousAngles;
+		DescentSettings descentSettings;
+	};
+
+	// terminos de la funcion objetivo del IK (definidos en Kinematics.cpp)
+	struct IKTerm_EETargets;
+	struct IKTerm_BaseAngles;
+	struct IKTerm_PreviousAngles;
+	typedef GradientDescent<IKData, IK_DESCENT_INLINE_ARGS, IKTerm_EETargets, IKTerm_BaseAngles, IKTerm_PreviousAngles> IKGradientDescent;
+
+	// Entradas de una resolucion de IK, que determinan su resultado
+	struct IKSolveInputs {
+		std::vector<glm::vec3> eeTargets;
+		IKArgs baseAngles;
+		IKArgs previousAngles;
+		std::vector<glm::vec3> rotationAxes;
+		// model space del padre de cada cadena en el frame objetivo (cadera o raiz), que mueve la base de la cadena
+		std::vector<glm::mat4> chainBaseTransforms;
+		glm::mat4 targetGlobalTransform = glm::mat4(1.0f);
+	};
+
+	/*
+	* Verdadero si current difiere de cached menos que las tolerancias (posiciones en model space, angulos en radianes).
+	* No depende del frame de la animacion, por lo que una pose que se repite o se mantiene reutiliza la resolucion anterior.
+	*/
+	bool IKSolveInputsMatch(const IKSolveInputs& cached, const IKSolveInputs& current, float positionTolerance, float angleTolerance);
+
+	// Resultado de la ultima resolucion de IK para una animacion, junto a las entradas que lo produjeron
+	struct IKSolveCache {
+		bool valid = false;
+		IKSolveInputs inputs;
+		IKArgs solvedAngles;
+	};
+
+	struct IKSolveStatistics {
+		int requestedSolves = 0;
+		int skippedSolves = 0;
+		float skipRate() const { return requestedSolves == 0 ? 0.0f : (float)skippedSolves / requestedSolves; }
 	};
 
 	class InverseKinematics {
 		IKRig* m_ikRig;
-		GradientDescent<IKData> m_gradientDescent;
+		IKGradientDescent m_gradientDescent;
 		IKData m_ikData;
+		// cache de resultados por animacion
+		std::vector<IKSolveCache> m_solveCaches;
+		// entradas de la resolucion en curso, se reutiliza para no asignar memoria en cada frame
+		IKSolveInputs m_solveInputs;
+		IKSolveStatistics m_solveStatistics;
+		bool m_solveSkippingEnabled = true;
+		// tolerancias para reutilizar un resultado (posiciones en model space, angulos en radianes)
+		float m_skipPositionTolerance = 0;
+		float m_skipAngleTolerance = 0;
 		void setIKChains();
 	public:
 		InverseKinematics() = default;
 		InverseKinematics(IKRig* ikRig);
 		void init();
 		std::vector<std::pair<JointIndex, float>> solveIKChains(AnimationIndex animationIndex);
+		void invalidateSolveCache(AnimationIndex animationIndex);
+		void invalidateSolveCaches();
+		void enableSolveSkipping(bool enableSolveSkipping) { m_solveSkippingEnabled = enableSolveSkipping; }
+		void setSolveSkippingTolerances(float positionTolerance, float angleTolerance) {
+			m_skipPositionTolerance = positionTolerance;
+			m_skipAngleTolerance = angleTolerance;
+		}
+		const IKSolveStatistics& getSolveStatistics() const { return m_solveStatistics; }
+		const DescentStatistics& getLastDescentStatistics() const { return m_gradientDescent.getLastStatistics(); }
+		const AccumulatedDescentStatistics& getAccumulatedDescentStatistics() const { return m_gradientDescent.getAccumulatedStatistics(); }
 	};
 
 	
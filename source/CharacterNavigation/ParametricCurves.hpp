@@ -43,16 +43,17 @@ namespace Mona{
         float getTEpsilon() const { return m_tEpsilon; }
         glm::vec<D, float> getStart() { return m_curvePoints[0]; }
         glm::vec<D, float> getEnd() { return m_curvePoints.back(); }
+        size_t getMemoryUsage() const { return m_curvePoints.capacity() * sizeof(glm::vec<D, float>) + m_tValues.capacity() * sizeof(float); }
         LIC() = default;
         LIC(std::vector<glm::vec<D, float>> curvePoints, std::vector<float> tValues, float tEpsilon = 0.0001) {
             MONA_ASSERT(1 < curvePoints.size(), "LIC: must provide at least two points.");
             MONA_ASSERT(curvePoints.size() == tValues.size(), "LIC: there must be exactly one tValue per spline point.");
             MONA_ASSERT(0 < tEpsilon, "LIC: tEpsilon must be greater than 0.");
             m_tEpsilon = tEpsilon;
-            m_tValues = tValues;
+            m_tValues = std::move(tValues);
             // chequeamos que los tValues vengan correctamente ordenados
             MONA_ASSERT(tValuesAreValid(), "LIC: tValues must come in a strictly ascending order and differ in more than 2*tEpsilon.");
-            m_curvePoints = curvePoints;
+            m_curvePoints = std::move(curvePoints);
             m_dimension = D;
         }
 
@@ -159,7 +160,7 @@ namespace Mona{
                 samplePoints = { evalCurve(minT), evalCurve(maxT) };
                 sampleTValues = { minT, maxT };
             }
-            return LIC(samplePoints, sampleTValues, m_tEpsilon);
+            return LIC(std::move(samplePoints), std::move(sampleTValues), m_tEpsilon);
         }
 
         void scale(glm::vec<D, float> scaling) {
@@ -205,7 +206,7 @@ namespace Mona{
 					break;
 				}
 			}
-			return LIC(jointCurvePoints, jointTValues, epsilon);
+			return LIC(std::move(jointCurvePoints), std::move(jointTValues), epsilon);
             
         }
 
@@ -239,7 +240,7 @@ namespace Mona{
                 transitionTValues.push_back(extraTValue);
                 transitionCurvePoints.push_back(transitionCurvePoints[0]);
             }           
-            return LIC(transitionCurvePoints, transitionTValues, epsilon);
+            return LIC(std::move(transitionCurvePoints), std::move(transitionTValues), epsilon);
         }
 
         // Transicion suave de una curva a otra. Se pasa de los valores de curve1 a curve2 a lo largo del periodo de tiempo transitionT2 - transitionT1
@@ -286,7 +287,7 @@ namespace Mona{
                 transitionTValues.push_back(extraTValue);
                 transitionCurvePoints.push_back(transitionCurvePoints[0]);
             }
-            return LIC(transitionCurvePoints, transitionTValues, epsilon);
+            return LIC(std::move(transitionCurvePoints), std::move(transitionTValues), epsilon);
         }
 
         float getTValue(int pointIndex) const {
@@ -335,7 +336,7 @@ namespace Mona{
                     connectedCurvePoints.insert(connectedCurvePoints.begin(), curve2.m_curvePoints[i]);
                 }
             }
-            return LIC<D>(connectedCurvePoints, connectedTValues);
+            return LIC<D>(std::move(connectedCurvePoints), std::move(connectedTValues));
             
             
         }
@@ -347,17 +347,21 @@ namespace Mona{
 		ComponentManager<TransformComponent>& transformManager,
 		ComponentManager<StaticMeshComponent>& staticMeshManager) {
 		int stepNum = 20;
+		// las alturas se consultan en un solo lote, con el punto de referencia al final
+		std::vector<glm::vec2> testPoints(stepNum + 1);
+		for (int i = 1; i <= stepNum; i++) {
+			testPoints[i - 1] = xyReferencePoint - targetDirection * targetDistance * ((float)i / stepNum);
+		}
+		testPoints[stepNum] = xyReferencePoint;
+		std::vector<float> testHeights;
+		m_environmentData.getTerrainHeights(testPoints, testHeights, transformManager, staticMeshManager);
 		std::vector<glm::vec3> collectedPoints;
 		collectedPoints.reserve(stepNum);
-		for (int i = 1; i <= stepNum; i++) {
-			glm::vec2 testPoint = xyReferencePoint - targetDirection * targetDistance * ((float)i / stepNum);
-			float calcHeight = m_environmentData.getTerrainHeight(testPoint,
-				transformManager, staticMeshManager);
-			collectedPoints.push_back(glm::vec3(testPoint, calcHeight));
+		for (int i = 0; i < stepNum; i++) {
+			collectedPoints.push_back(glm::vec3(testPoints[i], testHeights[i]));
 		}
 		float minDistDiff = std::numeric_limits<float>::max();
-		glm::vec3 floorReferencePoint = glm::vec3(xyReferencePoint, m_environmentData.getTerrainHeight(xyReferencePoint,
-			transformManager, staticMeshManager));
+		glm::vec3 floorReferencePoint = glm::vec3(xyReferencePoint, testHeights[stepNum]);
 		glm::vec3 selectedStartPoint(std::numeric_limits<float>::max());
 		for (int i = 0; i < collectedPoints.size(); i++) {
 			float distDiff = std::abs(glm::distance(floorReferencePoint, collectedPoints[i]) - targetDistance);
@@ -381,13 +385,17 @@ namespace Mona{
 		EETrajectory baseEETr = baseTrajectoryData->getSubTrajectoryByID(baseTrajecoryID);
 		float supportHeightStart = baseEETr.getEECurve().getStart()[2];
 		float supportHeightEnd = baseEETr.getEECurve().getEnd()[2];
+		std::vector<glm::vec2> testPoints(stepNum);
+		for (int i = 1; i <= stepNum; i++) {
+			testPoints[i - 1] = glm::vec2(startingPoint) + targetDirection * targetDistance * ((float)i / stepNum);
+		}
+		std::vector<float> testHeights;
+		m_environmentData.getTerrainHeights(testPoints, testHeights, transformManager, staticMeshManager);
 		std::vector<glm::vec3> collectedPoints;
 		collectedPoints.reserve(stepNum);
 		for (int i = 1; i <= stepNum; i++) {
-			glm::vec2 testPoint = glm::vec2(startingPoint) + targetDirection * targetDistance * ((float)i / stepNum);
 			float supportHeight = funcUtils::lerp(supportHeightStart, supportHeightEnd, (float)i / stepNum);
-			float calcHeight = supportHeight + m_environmentData.getTerrainHeight(testPoint, transformManager, staticMeshManager);
-			collectedPoints.push_back(glm::vec3(testPoint, calcHeight));
+			collectedPoints.push_back(glm::vec3(testPoints[i - 1], supportHeight + testHeights[i - 1]));
 		}
 		float minDistDiff = std::numeric_limits<float>::max();
 		glm::vec3 selectedFinalPoint(std::numeric_limits<float>::max());
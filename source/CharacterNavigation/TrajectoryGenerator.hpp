@@ -60,6 +60,7 @@ namespace Mona{
             ComponentManager<StaticMeshComponent>& staticMeshManager);
         void enableStrideValidation(bool enableStrideValidation) { m_strideValidationEnabled = enableStrideValidation; }
         void enableStrideCorrection(bool enableStrideCorrection) { m_strideCorrectionEnabled = enableStrideCorrection; }
+        const StrideCorrector& getStrideCorrector() const { return m_strideCorrector; }
     };
 
     
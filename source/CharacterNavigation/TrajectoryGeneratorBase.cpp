@@ -98,39 +98,46 @@ namespace Mona{
 		m_savedPositions = LIC<3>();
 	}
 
+	size_t EEGlobalTrajectoryData::getMemoryUsage() const {
+		size_t usage = m_originalSubTrajectories.capacity() * sizeof(EETrajectory) + m_supportHeights.capacity() * sizeof(float);
+		for (const auto& subTrajectory : m_originalSubTrajectories) {
+			usage += subTrajectory.m_curve.getMemoryUsage();
+		}
+		return usage + m_targetTrajectory.m_curve.getMemoryUsage() + m_savedPositions.getMemoryUsage();
+	}
+
 
 	// primer termino: acercar los modulos de las velocidades
-	std::function<float(const std::vector<float>&, TGData*)> term1Function =
-		[](const std::vector<float>& varPCoord, TGData* dataPtr)->float {
-		float result = 0;
-		for (int i = 0; i < dataPtr->pointIndexes.size(); i++) {
-			int pIndex = dataPtr->pointIndexes[i];
-			result += glm::distance2(dataPtr->varCurve->getPointVelocity(pIndex), dataPtr->baseCurve.getPointVelocity(pIndex));
-			result += glm::distance2(dataPtr->varCurve->getPointVelocity(pIndex, true), dataPtr->baseCurve.getPointVelocity(pIndex, true));
+	struct TGTerm_Velocities {
+		static float value(const TGArgs& varPCoord, TGData* dataPtr) {
+			float result = 0;
+			for (int i = 0; i < dataPtr->pointIndexes.size(); i++) {
+				int pIndex = dataPtr->pointIndexes[i];
+				result += glm::distance2(dataPtr->varCurve->getPointVelocity(pIndex), dataPtr->baseCurve.getPointVelocity(pIndex));
+				result += glm::distance2(dataPtr->varCurve->getPointVelocity(pIndex, true), dataPtr->baseCurve.getPointVelocity(pIndex, true));
+			}
+			return result;
 		}
-		return result;
-	};
 
-	std::function<float(const std::vector<float>&, int, TGData*)> term1PartialDerivativeFunction =
-		[](const std::vector<float>& varPCoord, int varIndex, TGData* dataPtr)->float {
-		int D = 3;
-		int pIndex = dataPtr->pointIndexes[varIndex / D];
-		int coordIndex = varIndex % D;
-		float t_kPrev = dataPtr->varCurve->getTValue(pIndex - 1);
-		float t_kCurr = dataPtr->varCurve->getTValue(pIndex);
-		float t_kNext = dataPtr->varCurve->getTValue(pIndex + 1);
-		glm::vec3 lVel = dataPtr->varCurve->getPointVelocity(pIndex);
-		glm::vec3 rVel = dataPtr->varCurve->getPointVelocity(pIndex, true);
-		glm::vec3 baseLVel = dataPtr->baseCurve.getPointVelocity(pIndex);
-		glm::vec3 baseRVel = dataPtr->baseCurve.getPointVelocity(pIndex, true);
-		float result = 0;
-		result += 2 * (lVel[coordIndex] - baseLVel[coordIndex]) * (1 / (t_kCurr - t_kPrev));
-		result += 2 * (rVel[coordIndex] - baseRVel[coordIndex]) * (-1 / (t_kNext - t_kCurr));
-		return result;
+		static float partialDerivative(const TGArgs& varPCoord, int varIndex, TGData* dataPtr) {
+			int D = 3;
+			int pIndex = dataPtr->pointIndexes[varIndex / D];
+			int coordIndex = varIndex % D;
+			float t_kPrev = dataPtr->varCurve->getTValue(pIndex - 1);
+			float t_kCurr = dataPtr->varCurve->getTValue(pIndex);
+			float t_kNext = dataPtr->varCurve->getTValue(pIndex + 1);
+			glm::vec3 lVel = dataPtr->varCurve->getPointVelocity(pIndex);
+			glm::vec3 rVel = dataPtr->varCurve->getPointVelocity(pIndex, true);
+			glm::vec3 baseLVel = dataPtr->baseCurve.getPointVelocity(pIndex);
+			glm::vec3 baseRVel = dataPtr->baseCurve.getPointVelocity(pIndex, true);
+			float result = 0;
+			result += 2 * (lVel[coordIndex] - baseLVel[coordIndex]) * (1 / (t_kCurr - t_kPrev));
+			result += 2 * (rVel[coordIndex] - baseRVel[coordIndex]) * (-1 / (t_kNext - t_kCurr));
+			return result;
+		}
 	};
 
-	std::function<void(std::vector<float>&, TGData*, std::vector<float>&)>  postDescentStepCustomBehaviour =
-		[](std::vector<float>& varPCoord, TGData* dataPtr, std::vector<float>& argsRawDelta)->void {
+	void postDescentStepCustomBehaviour(TGArgs& varPCoord, TGData* dataPtr, TGArgs& argsRawDelta) {
 		glm::vec3 newPos;
 		int D = 3;
 		for (int i = 0; i < dataPtr->pointIndexes.size(); i++) {
@@ -144,15 +151,131 @@ namespace Mona{
 			int pIndex = dataPtr->pointIndexes[i];
 			dataPtr->varCurve->setCurvePoint(pIndex, newPos);
 		}
-	};
+	}
 
 
+	// El objetivo del descenso es cuadratico y separable por coordenada: cada velocidad de segmento interior
+	// aparece dos veces y las de los extremos una. Se resuelve un sistema tridiagonal por coordenada,
+	// manejando las cotas inferiores en z con un conjunto activo. Retorna false si no converge.
+	bool StrideCorrector::correctStrideDirect(LIC<3>& targetCurve) {
+		int n = m_tgData.pointIndexes.size();
+		const LIC<3>& baseCurve = m_tgData.baseCurve;
+		float tolerance = m_tgData.descentSettings.targetArgDelta;
+		// los arreglos del corrector se reutilizan entre llamadas, por lo que solo crecen con la curva mas larga vista
+		DirectSolveBuffers& buffers = m_directSolveBuffers;
+		buffers.segWeights.resize(n + 1);
+		buffers.baseDeltas.resize(n + 1);
+		buffers.values.resize(n + 2);
+		buffers.lower.resize(n + 2);
+		buffers.diag.resize(n + 2);
+		buffers.upper.resize(n + 2);
+		buffers.rhs.resize(n + 2);
+		buffers.active.resize(n + 2);
+		buffers.solvedPoints.resize(n);
+		std::vector<float>& segWeights = buffers.segWeights;
+		std::vector<float>& baseDeltas = buffers.baseDeltas;
+		std::vector<float>& values = buffers.values;
+		std::vector<float>& lower = buffers.lower;
+		std::vector<float>& diag = buffers.diag;
+		std::vector<float>& upper = buffers.upper;
+		std::vector<float>& rhs = buffers.rhs;
+		std::vector<char>& active = buffers.active;
+		std::vector<glm::vec3>& solvedPoints = buffers.solvedPoints;
+		for (int j = 0; j <= n; j++) {
+			float h = targetCurve.getTValue(j + 1) - targetCurve.getTValue(j);
+			float weight = (j == 0 || j == n) ? 1.0f : 2.0f;
+			segWeights[j] = weight / (h * h);
+		}
+		for (int c = 0; c < 3; c++) {
+			for (int j = 0; j <= n; j++) {
+				baseDeltas[j] = baseCurve.getCurvePoint(j + 1)[c] - baseCurve.getCurvePoint(j)[c];
+			}
+			values[0] = targetCurve.getStart()[c];
+			values[n + 1] = targetCurve.getEnd()[c];
+			std::fill(active.begin(), active.end(), false);
+			bool solved = false;
+			for (int iter = 0; iter <= 2 * n + 1 && !solved; iter++) {
+				// las filas de puntos activos fijan el valor en su cota
+				for (int k = 1; k <= n; k++) {
+					if (active[k]) {
+						diag[k] = 1;
+						lower[k] = 0;
+						upper[k] = 0;
+						rhs[k] = m_tgData.minValues[(k - 1) * 3 + c];
+						continue;
+					}
+					diag[k] = segWeights[k - 1] + segWeights[k];
+					lower[k] = -segWeights[k - 1];
+					upper[k] = -segWeights[k];
+					rhs[k] = segWeights[k - 1] * baseDeltas[k - 1] - segWeights[k] * baseDeltas[k];
+					if (k == 1) {
+						rhs[k] += segWeights[0] * values[0];
+						lower[k] = 0;
+					}
+					if (k == n) {
+						rhs[k] += segWeights[n] * values[n + 1];
+						upper[k] = 0;
+					}
+				}
+				// algoritmo de thomas
+				for (int k = 2; k <= n; k++) {
+					float factor = lower[k] / diag[k - 1];
+					diag[k] -= factor * upper[k - 1];
+					rhs[k] -= factor * rhs[k - 1];
+				}
+				values[n] = rhs[n] / diag[n];
+				for (int k = n - 1; 1 <= k; k--) {
+					values[k] = (rhs[k] - upper[k] * values[k + 1]) / diag[k];
+				}
+				bool changed = false;
+				for (int k = 1; k <= n; k++) {
+					if (!active[k] && values[k] < m_tgData.minValues[(k - 1) * 3 + c] - tolerance) {
+						active[k] = true;
+						changed = true;
+					}
+				}
+				if (!changed) {
+					// se liberan los puntos activos que el objetivo empuja hacia arriba
+					for (int k = 1; k <= n; k++) {
+						if (active[k]) {
+							float diagWeight = segWeights[k - 1] + segWeights[k];
+							float gradient = diagWeight * values[k] - segWeights[k - 1] * values[k - 1] - segWeights[k] * values[k + 1]
+								- segWeights[k - 1] * baseDeltas[k - 1] + segWeights[k] * baseDeltas[k];
+							if (gradient < -tolerance * diagWeight) {
+								active[k] = false;
+								changed = true;
+							}
+						}
+					}
+				}
+				solved = !changed;
+			}
+			if (!solved) {
+				return false;
+			}
+			for (int k = 1; k <= n; k++) {
+				if (!std::isfinite(values[k])) {
+					return false;
+				}
+				solvedPoints[k - 1][c] = values[k];
+			}
+		}
+		for (int k = 1; k <= n; k++) {
+			targetCurve.setCurvePoint(k, solvedPoints[k - 1]);
+		}
+		return true;
+	}
+
 	void StrideCorrector::init(float rigGlobalHeight) {
-		FunctionTerm<TGData> term1(term1Function, term1PartialDerivativeFunction);
-		m_gradientDescent = GradientDescent<TGData>({ term1 }, 0, &m_tgData, postDescentStepCustomBehaviour);
-		m_tgData.descentRate = 1 / pow(10, 3);
-		m_tgData.maxIterations = 600;
-		m_tgData.targetPosDelta = rigGlobalHeight / pow(10, 5);
+		m_gradientDescent = TGGradientDescent(0, &m_tgData, postDescentStepCustomBehaviour);
+		DescentSettings& settings = m_tgData.descentSettings;
+		settings.descentType = DescentType::MOMENTUM;
+		settings.descentRate = 1 / pow(10, 3);
+		settings.maxIterations = 600;
+		settings.targetArgDelta = rigGlobalHeight / pow(10, 5);
+		// las curvas ya suaves no necesitan iterar hasta el limite
+		settings.targetGradientNorm = settings.targetArgDelta / settings.descentRate;
+		settings.targetRelativeImprovement = 1 / pow(10, 4);
 		m_gradientDescent.setTermWeight(0, 1.0f);
 	}
 
@@ -176,21 +299,22 @@ namespace Mona{
 		targetCurve.setCurvePoint(targetCurve.getNumberOfPoints() - 1, adjustedEndPoint);
 
 
+		int innerPointNum = targetCurve.getNumberOfPoints() - 2;
 		m_tgData.pointIndexes.clear();
-		m_tgData.minValues.clear();
+		m_tgData.minValues.resize(innerPointNum * 3);
 		for (int i = 1; i < targetCurve.getNumberOfPoints() - 1; i++) {
 			m_tgData.pointIndexes.push_back(i);
 			glm::vec3 currPoint = targetCurve.getCurvePoint(i);
 			float fraction = funcUtils::getFraction(0, targetCurve.getNumberOfPoints() - 1, i);
 			float currSupportHeight = funcUtils::lerp(startSupportHeight, endSupportHeight, fraction);
 			float minZ = environmentData.getTerrainHeight(glm::vec2(currPoint), transformManager, staticMeshManager) + currSupportHeight;
-			m_tgData.minValues.push_back(std::numeric_limits<float>::lowest());
-			m_tgData.minValues.push_back(std::numeric_limits<float>::lowest());
-			m_tgData.minValues.push_back(minZ);
+			m_tgData.minValues[(i - 1) * 3] = std::numeric_limits<float>::lowest();
+			m_tgData.minValues[(i - 1) * 3 + 1] = std::numeric_limits<float>::lowest();
+			m_tgData.minValues[(i - 1) * 3 + 2] = minZ;
 		}
 
 		// valores iniciales y curva base
-		std::vector<float> initialArgs(m_tgData.pointIndexes.size() * 3);
+		TGArgs initialArgs(m_tgData.pointIndexes.size() * 3);
 		for (int i = 0; i < m_tgData.pointIndexes.size(); i++) {
 			int pIndex = m_tgData.pointIndexes[i];
 			for (int j = 0; j < 3; j++) {
@@ -200,8 +324,13 @@ namespace Mona{
 		m_tgData.baseCurve = baseCurve;
 		m_tgData.varCurve = &targetCurve;
 
+		if (m_directSolveEnabled && correctStrideDirect(targetCurve)) {
+			m_correctionStatistics.directSolves += 1;
+			return;
+		}
+		m_correctionStatistics.fallbackSolves += 1;
 		m_gradientDescent.setArgNum(initialArgs.size());
-		m_gradientDescent.computeArgsMin(m_tgData.descentRate, m_tgData.maxIterations, m_tgData.targetPosDelta, initialArgs, DescentType::MOMENTUM);
+		m_gradientDescent.computeArgsMin(m_tgData.descentSettings, initialArgs);
 	}
 
 
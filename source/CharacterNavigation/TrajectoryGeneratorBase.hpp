@@ -6,6 +6,9 @@
 #include "GradientDescent.hpp"
 #include "EnvironmentData.hpp"
 
+// puntos interiores de una curva cuyos argumentos del corrector de pasos se guardan sin memoria dinamica
+#define MAX_STRIDE_CORRECTOR_POINTS 48
+
 namespace Mona{
 
     typedef int ChainIndex;
@@ -37,6 +40,9 @@ namespace Mona{
         bool motionInitialized() { return m_motionInitialized; }
         LIC<3> getTargetPositions() { return m_targetPositions; }
         void setTargetPositions(LIC<3> targetPositions) { m_targetPositions = targetPositions; }
+        size_t getMemoryUsage() const {
+            return m_originalPositions.getMemoryUsage() + m_targetPositions.getMemoryUsage() + m_savedPositions.getMemoryUsage();
+        }
         void init(IKAnimation* ikAnim);
         void refresh();
     };
@@ -88,22 +94,45 @@ namespace Mona{
         void init(IKAnimation* ikAnim, EEGlobalTrajectoryData* opposite);
         EEGlobalTrajectoryData* getOppositeTrajectoryData();
         bool isTargetFixed() { return m_fixedTarget; }
+        size_t getMemoryUsage() const;
         void refresh();
     };
 
 
+    typedef DescentArgs<MAX_STRIDE_CORRECTOR_POINTS * 3> TGArgs;
     struct TGData {
         LIC<3>* varCurve;
         LIC<3> baseCurve;
         std::vector<int> pointIndexes;
-        std::vector<float> minValues; // tamano D*pointIndexes.size()
-        float descentRate;
-        float targetPosDelta;
-        int maxIterations;
+        TGArgs minValues; // tamano D*pointIndexes.size()
+        DescentSettings descentSettings;
+    };
+    // termino de la funcion objetivo del corrector (definido en TrajectoryGeneratorBase.cpp)
+    struct TGTerm_Velocities;
+    typedef GradientDescent<TGData, MAX_STRIDE_CORRECTOR_POINTS * 3, TGTerm_Velocities> TGGradientDescent;
+    struct StrideCorrectionStatistics {
+        int directSolves = 0;
+        int fallbackSolves = 0;
     };
     class StrideCorrector {
-        GradientDescent<TGData> m_gradientDescent;
+        TGGradientDescent m_gradientDescent;
         TGData m_tgData;
+        StrideCorrectionStatistics m_correctionStatistics;
+        bool m_directSolveEnabled = true;
+        // memoria de trabajo de correctStrideDirect, reutilizada entre llamadas
+        struct DirectSolveBuffers {
+            std::vector<float> segWeights;
+            std::vector<float> baseDeltas;
+            std::vector<float> values;
+            std::vector<float> lower;
+            std::vector<float> diag;
+            std::vector<float> upper;
+            std::vector<float> rhs;
+            std::vector<char> active;
+            std::vector<glm::vec3> solvedPoints;
+        };
+        DirectSolveBuffers m_directSolveBuffers;
+        bool correctStrideDirect(LIC<3>& targetCurve);
     public:
         StrideCorrector() = default;
         void init(float rigGlobalHeight);
@@ -111,7 +140,10 @@ namespace Mona{
             EnvironmentData& environmentData,
             ComponentManager<TransformComponent>& transformManager,
             ComponentManager<StaticMeshComponent>& staticMeshManager);
-
+        const DescentStatistics& getLastDescentStatistics() const { return m_gradientDescent.getLastStatistics(); }
+        const AccumulatedDescentStatistics& getAccumulatedDescentStatistics() const { return m_gradientDescent.getAccumulatedStatistics(); }
+        const StrideCorrectionStatistics& getCorrectionStatistics() const { return m_correctionStatistics; }
+        void enableDirectSolve(bool directSolveEnabled) { m_directSolveEnabled = directSolveEnabled; }
     };
     
 }
@@ -0,0 +1,100 @@
+#include "AssetLoader.hpp"
+#include "JobSystem.hpp"
+namespace Mona {
+
+	void AssetLoader::Schedule(std::function<PendingUpload()> decode) noexcept {
+		const std::thread::id owner = std::this_thread::get_id();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_uploadQueues[owner].decodingCount++;
+		}
+		JobSystem::GetInstance().SubmitBackground([this, owner, decode = std::move(decode)]() {
+			PendingUpload pending = decode();
+			std::lock_guard<std::mutex> lock(m_mutex);
+			UploadQueue& queue = m_uploadQueues[owner];
+			queue.decodingCount--;
+			queue.uploads.push_back(std::move(pending));
+		});
+	}
+
+	uint32_t AssetLoader::ProcessUploads(uint32_t maxUploads, bool waitForDecoding) noexcept {
+		const std::thread::id owner = std::this_thread::get_id();
+		JobSystem& jobSystem = JobSystem::GetInstance();
+		uint32_t processedCount = 0;
+		while (processedCount < maxUploads) {
+			PendingUpload pending;
+			bool decoding = false;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto it = m_uploadQueues.find(owner);
+				if (it == m_uploadQueues.end()) {
+					break;
+				}
+				UploadQueue& queue = it->second;
+				if (!queue.uploads.empty()) {
+					pending = std::move(queue.uploads.front());
+					queue.uploads.pop_front();
+				}
+				else if (queue.decodingCount == 0) {
+					m_uploadQueues.erase(it);
+					break;
+				}
+				else {
+					decoding = true;
+				}
+			}
+			if (decoding) {
+				//Sin workers nadie mas ejecuta las lecturas, por lo que avanzan aqui dentro del mismo presupuesto
+				if (jobSystem.GetWorkerCount() == 0) {
+					if (!jobSystem.RunBackgroundJob()) {
+						break;
+					}
+				}
+				else if (!waitForDecoding) {
+					break;
+				}
+				else if (!jobSystem.RunBackgroundJob()) {
+					std::this_thread::yield();
+				}
+				continue;
+			}
+			if (pending.upload) {
+				pending.upload();
+			}
+			pending.complete();
+			processedCount++;
+		}
+		return processedCount;
+	}
+
+	void AssetLoader::ProcessPendingWork() noexcept {
+		if (ProcessUploads(1) == 0 && !JobSystem::GetInstance().RunBackgroundJob()) {
+			std::this_thread::yield();
+		}
+	}
+
+	void AssetLoader::DiscardUploads() noexcept {
+		const std::thread::id owner = std::this_thread::get_id();
+		std::deque<PendingUpload> discarded;
+		while (true) {
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto it = m_uploadQueues.find(owner);
+				if (it == m_uploadQueues.end()) {
+					break;
+				}
+				if (it->second.decodingCount == 0) {
+					discarded = std::move(it->second.uploads);
+					m_uploadQueues.erase(it);
+					break;
+				}
+			}
+			if (!JobSystem::GetInstance().RunBackgroundJob()) {
+				std::this_thread::yield();
+			}
+		}
+		for (auto& pending : discarded) {
+			pending.complete();
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef ASSETLOADER_HPP
+#define ASSETLOADER_HPP
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+//Subidas a GPU y OpenAL de assets cargados en segundo plano que cada mundo ejecuta por defecto en un frame
+#define ASSET_UPLOAD_DEFAULT_COUNT 4
+
+namespace Mona {
+	/*
+	* Carga de assets en dos etapas. La lectura y decodificacion del archivo corre como trabajo de fondo del JobSystem y la
+	* subida a GPU u OpenAL corre despues en el hilo que pidio la carga, que es el que tiene el contexto grafico, repartida
+	* entre frames segun el presupuesto de ProcessUploads. Los managers de assets la usan para sus variantes Async.
+	* Una lectura larga ocupa su worker hasta terminar, por lo que mientras tanto los trabajos del frame tienen uno menos.
+	*/
+	class AssetLoader {
+	public:
+		friend class World;
+		// Trabajo que se ejecuta en el hilo dueno de la carga. Puede estar vacio si el asset no tiene nada que subir
+		using UploadTask = std::function<void()>;
+		AssetLoader(AssetLoader const&) = delete;
+		AssetLoader& operator=(AssetLoader const&) = delete;
+		static AssetLoader& GetInstance() noexcept {
+			static AssetLoader instance;
+			return instance;
+		}
+
+		/*
+		* Ejecuta decode en un worker. decode devuelve el asset y deja en outUpload su subida, que se ejecuta en este hilo
+		* durante un ProcessUploads posterior. El futuro se completa recien despues de la subida.
+		*/
+		template <typename AssetType>
+		std::shared_future<std::shared_ptr<AssetType>> Load(std::function<std::shared_ptr<AssetType>(UploadTask& outUpload)> decode) noexcept {
+			auto promise = std::make_shared<std::promise<std::shared_ptr<AssetType>>>();
+			std::shared_future<std::shared_ptr<AssetType>> future = promise->get_future().share();
+			Schedule([decode = std::move(decode), promise]() {
+				UploadTask upload;
+				std::shared_ptr<AssetType> asset = decode(upload);
+				return PendingUpload{ std::move(upload), [promise, asset]() { promise->set_value(asset); } };
+			});
+			return future;
+		}
+
+		/*
+		* Ejecuta hasta maxUploads subidas pendientes de este hilo y devuelve la cantidad ejecutada. El presupuesto es una cantidad
+		* y no un tiempo para que no dependa de la carga de la maquina. Con waitForDecoding espera ademas las lecturas en curso
+		* y sube todo, de modo que un asset pedido en un frame siempre queda listo en el siguiente, como necesita la
+		* reproduccion de input.
+		*/
+		uint32_t ProcessUploads(uint32_t maxUploads, bool waitForDecoding = false) noexcept;
+
+		// Bloquea hasta que future se complete. Mientras espera procesa las subidas de este hilo, por lo que no se traba
+		// al llamarse desde el hilo dueno de la carga
+		template <typename AssetType>
+		std::shared_ptr<AssetType> Wait(const std::shared_future<std::shared_ptr<AssetType>>& future) noexcept {
+			while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				ProcessPendingWork();
+			}
+			return future.get();
+		}
+
+	private:
+		struct PendingUpload {
+			UploadTask upload;
+			UploadTask complete;
+		};
+		struct UploadQueue {
+			std::deque<PendingUpload> uploads;
+			uint32_t decodingCount = 0;
+		};
+		AssetLoader() = default;
+		void Schedule(std::function<PendingUpload()> decode) noexcept;
+		void ProcessPendingWork() noexcept;
+		/*
+		* Espera las lecturas pedidas desde este hilo y descarta sus subidas, ya que su contexto grafico esta por cerrarse.
+		* Los futuros se completan igual, con assets que quedan vacios.
+		*/
+		void DiscardUploads() noexcept;
+		// Los mundos pueden cargar assets desde hilos distintos, cada uno con su propia cola de subidas
+		std::mutex m_mutex;
+		std::unordered_map<std::thread::id, UploadQueue> m_uploadQueues;
+	};
+
+	/*
+	* Resultado de una carga asincrona. Mallas, texturas y clips de audio existen desde que se pide la carga y se completan
+	* en el mismo objeto, por lo que GetAsset puede asignarse de inmediato a componentes: mientras no esten listos las
+	* mallas no se dibujan, las texturas muestran un placeholder blanco y los clips no suenan. Esqueletos y clips de
+	* animacion no tienen placeholder y GetAsset devuelve nullptr hasta que esten listos.
+	*/
+	template <typename AssetType>
+	class AssetFuture {
+	public:
+		AssetFuture() = default;
+		// Carga ya terminada, como cuando el asset estaba en el cache del manager
+		explicit AssetFuture(std::shared_ptr<AssetType> asset) : m_placeholder(asset) {
+			std::promise<std::shared_ptr<AssetType>> promise;
+			m_future = promise.get_future().share();
+			promise.set_value(std::move(asset));
+		}
+		AssetFuture(std::shared_future<std::shared_ptr<AssetType>> future, std::shared_ptr<AssetType> placeholder) :
+			m_future(std::move(future)), m_placeholder(std::move(placeholder)) {}
+		bool IsReady() const noexcept {
+			return m_future.valid() && m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+		std::shared_ptr<AssetType> GetAsset() const noexcept { return IsReady() ? m_future.get() : m_placeholder; }
+		std::shared_ptr<AssetType> Wait() const noexcept { return AssetLoader::GetInstance().Wait(m_future); }
+		const std::shared_future<std::shared_ptr<AssetType>>& GetFuture() const noexcept { return m_future; }
+	private:
+		std::shared_future<std::shared_ptr<AssetType>> m_future;
+		std::shared_ptr<AssetType> m_placeholder;
+	};
+}
+#endif
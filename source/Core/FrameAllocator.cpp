@@ -0,0 +1,145 @@
+#include "FrameAllocator.hpp"
+#include <algorithm>
+#include "Log.hpp"
+namespace Mona {
+
+	thread_local FrameAllocator::ThreadArenas FrameAllocator::s_threadArenas;
+	thread_local FrameAllocator* FrameAllocator::s_threadAllocator = nullptr;
+	static std::atomic<uint64_t> s_nextFrameAllocatorID = 0;
+
+	FrameAllocator::ThreadArenas::~ThreadArenas() {
+		for (auto& entry : arenas) {
+			entry.second->owned.store(false, std::memory_order_release);
+		}
+	}
+
+	FrameAllocator::FrameAllocator() noexcept :
+		m_allocatorID(s_nextFrameAllocatorID.fetch_add(1, std::memory_order_relaxed))
+	{}
+
+	FrameAllocator& FrameAllocator::GetCurrent() noexcept {
+		if (s_threadAllocator != nullptr) {
+			return *s_threadAllocator;
+		}
+		static FrameAllocator globalAllocator;
+		return globalAllocator;
+	}
+
+	void FrameAllocator::StartUp(std::size_t arenaSize) noexcept {
+		std::lock_guard<std::mutex> lock(m_arenasMutex);
+		m_arenaSize = std::max<std::size_t>(arenaSize, 1024);
+	}
+
+	void* FrameAllocator::Allocate(std::size_t size, std::size_t alignment) noexcept {
+		Arena& arena = GetThreadArena();
+		void* result = AlignedBump(arena.block.get(), arena.capacity, arena.offset, size, alignment);
+		if (result != nullptr) {
+			return result;
+		}
+		result = arena.overflowBlocks.empty() ? nullptr :
+			AlignedBump(arena.overflowBlocks.back().get(), arena.overflowCapacity, arena.overflowOffset, size, alignment);
+		if (result != nullptr) {
+			return result;
+		}
+		//La arena se quedo sin espacio: se agrega un bloque que se fusiona con el principal en el siguiente reinicio
+		arena.overflowBytes += arena.overflowOffset;
+		arena.overflowCapacity = std::max(size + alignment, arena.capacity);
+		arena.overflowOffset = 0;
+		arena.overflowReserved += arena.overflowCapacity;
+		arena.overflowBlocks.emplace_back(new std::byte[arena.overflowCapacity]);
+		return AlignedBump(arena.overflowBlocks.back().get(), arena.overflowCapacity, arena.overflowOffset, size, alignment);
+	}
+
+	void FrameAllocator::Deallocate(void* pointer, std::size_t size) noexcept {
+		Arena* arena = FindThreadArena();
+		if (arena == nullptr || pointer == nullptr) {
+			return;
+		}
+		std::byte* bytePointer = static_cast<std::byte*>(pointer);
+		if (arena->overflowBlocks.empty()) {
+			if (bytePointer + size == arena->block.get() + arena->offset) {
+				arena->offset -= size;
+			}
+		}
+		else if (bytePointer + size == arena->overflowBlocks.back().get() + arena->overflowOffset) {
+			arena->overflowOffset -= size;
+		}
+	}
+
+	void FrameAllocator::ResetFrame() noexcept {
+		std::lock_guard<std::mutex> lock(m_arenasMutex);
+		Statistics statistics;
+		statistics.highWaterMark = m_statistics.highWaterMark;
+		for (auto& arena : m_arenas) {
+			std::size_t overflowUsed = arena->overflowBytes + arena->overflowOffset;
+			statistics.frameBytes += arena->offset + overflowUsed;
+			statistics.overflowBlocks += static_cast<uint32_t>(arena->overflowBlocks.size());
+			if (!arena->overflowBlocks.empty()) {
+				//Se crece el bloque principal para que el siguiente frame no necesite reservar memoria
+				std::size_t newCapacity = arena->capacity + arena->overflowReserved;
+				arena->block.reset(new std::byte[newCapacity]);
+				arena->capacity = newCapacity;
+				arena->overflowBlocks.clear();
+			}
+			arena->offset = 0;
+			arena->overflowCapacity = 0;
+			arena->overflowOffset = 0;
+			arena->overflowBytes = 0;
+			arena->overflowReserved = 0;
+			statistics.capacity += arena->capacity;
+		}
+		statistics.highWaterMark = std::max(statistics.highWaterMark, statistics.frameBytes);
+		statistics.arenaCount = static_cast<uint32_t>(m_arenas.size());
+		m_statistics = statistics;
+	}
+
+	FrameAllocator::Statistics FrameAllocator::GetStatistics() const noexcept {
+		std::lock_guard<std::mutex> lock(m_arenasMutex);
+		return m_statistics;
+	}
+
+	FrameAllocator::Arena* FrameAllocator::FindThreadArena() const noexcept {
+		for (const auto& entry : s_threadArenas.arenas) {
+			if (entry.first == m_allocatorID) {
+				return entry.second.get();
+			}
+		}
+		return nullptr;
+	}
+
+	FrameAllocator::Arena& FrameAllocator::GetThreadArena() noexcept {
+		Arena* threadArena = FindThreadArena();
+		if (threadArena != nullptr) {
+			return *threadArena;
+		}
+		//Si el hilo es el unico que referencia una arena, su allocator ya fue destruido
+		auto& threadArenas = s_threadArenas.arenas;
+		threadArenas.erase(std::remove_if(threadArenas.begin(), threadArenas.end(),
+			[](const std::pair<uint64_t, std::shared_ptr<Arena>>& entry) { return entry.second.use_count() == 1; }), threadArenas.end());
+		std::lock_guard<std::mutex> lock(m_arenasMutex);
+		auto freeArena = std::find_if(m_arenas.begin(), m_arenas.end(),
+			[](const std::shared_ptr<Arena>& arena) { return !arena->owned.load(std::memory_order_acquire); });
+		if (freeArena == m_arenas.end()) {
+			m_arenas.emplace_back(new Arena());
+			freeArena = m_arenas.end() - 1;
+			(*freeArena)->capacity = m_arenaSize;
+			(*freeArena)->block.reset(new std::byte[m_arenaSize]);
+		}
+		(*freeArena)->owned.store(true, std::memory_order_relaxed);
+		threadArenas.emplace_back(m_allocatorID, *freeArena);
+		return **freeArena;
+	}
+
+	void* FrameAllocator::AlignedBump(std::byte* block, std::size_t capacity, std::size_t& offset, std::size_t size, std::size_t alignment) noexcept {
+		if (block == nullptr) {
+			return nullptr;
+		}
+		std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block + offset);
+		std::size_t padding = (alignment - address % alignment) % alignment;
+		if (capacity < offset + padding + size) {
+			return nullptr;
+		}
+		offset += padding + size;
+		return block + offset - size;
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+#ifndef FRAMEALLOCATOR_HPP
+#define FRAMEALLOCATOR_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+namespace Mona {
+
+	/*
+	* Allocator lineal para memoria temporal que vive a lo mas un frame. Cada hilo tiene su propia arena, por lo que
+	* reservar no requiere sincronizacion. Cada World tiene su propio allocator y World::Update reinicia sus arenas al
+	* comienzo de cada frame, momento en que ningun otro hilo puede estar usando esta memoria. No debe usarse para datos
+	* que sobreviven al frame ni desde trabajos que se extienden por varios frames.
+	*/
+	class FrameAllocator {
+	public:
+		struct Statistics {
+			// Bytes usados por todas las arenas en el ultimo frame
+			std::size_t frameBytes = 0;
+			// Maximo de bytes usados en un frame desde el inicio
+			std::size_t highWaterMark = 0;
+			// Capacidad reservada entre todas las arenas
+			std::size_t capacity = 0;
+			// Bloques adicionales que se tuvieron que reservar en el ultimo frame por falta de espacio
+			uint32_t overflowBlocks = 0;
+			uint32_t arenaCount = 0;
+		};
+		// Fija el allocator que usa el hilo actual mientras el scope existe
+		class Scope {
+		public:
+			explicit Scope(FrameAllocator* allocator) noexcept : m_previous(s_threadAllocator) { s_threadAllocator = allocator; }
+			~Scope() { s_threadAllocator = m_previous; }
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		private:
+			FrameAllocator* m_previous;
+		};
+		FrameAllocator() noexcept;
+		~FrameAllocator() = default;
+		FrameAllocator(FrameAllocator const&) = delete;
+		FrameAllocator& operator=(FrameAllocator const&) = delete;
+		// Retorna el allocator del World que esta usando el hilo actual, o uno global si no hay ninguno
+		static FrameAllocator& GetCurrent() noexcept;
+		static FrameAllocator* GetThreadAllocator() noexcept { return s_threadAllocator; }
+		void StartUp(std::size_t arenaSize) noexcept;
+		void* Allocate(std::size_t size, std::size_t alignment) noexcept;
+		// Solo recupera memoria si es la ultima reserva de la arena del hilo actual
+		void Deallocate(void* pointer, std::size_t size) noexcept;
+		void ResetFrame() noexcept;
+		Statistics GetStatistics() const noexcept;
+	private:
+		struct Arena {
+			std::unique_ptr<std::byte[]> block;
+			std::size_t capacity = 0;
+			std::size_t offset = 0;
+			std::vector<std::unique_ptr<std::byte[]>> overflowBlocks;
+			std::size_t overflowCapacity = 0;
+			std::size_t overflowOffset = 0;
+			std::size_t overflowBytes = 0;
+			std::size_t overflowReserved = 0;
+			std::atomic<bool> owned = false;
+		};
+		// Arenas que usa un hilo, una por allocator. Las libera cuando el hilo termina para que otro hilo las reutilice.
+		struct ThreadArenas {
+			std::vector<std::pair<uint64_t, std::shared_ptr<Arena>>> arenas;
+			~ThreadArenas();
+		};
+		Arena* FindThreadArena() const noexcept;
+		Arena& GetThreadArena() noexcept;
+		static void* AlignedBump(std::byte* block, std::size_t capacity, std::size_t& offset, std::size_t size, std::size_t alignment) noexcept;
+
+		uint64_t m_allocatorID;
+		std::size_t m_arenaSize = 1 << 20;
+		mutable std::mutex m_arenasMutex;
+		std::vector<std::shared_ptr<Arena>> m_arenas;
+		Statistics m_statistics;
+		static thread_local ThreadArenas s_threadArenas;
+		static thread_local FrameAllocator* s_threadAllocator;
+	};
+
+	template <typename T>
+	class FrameStlAllocator {
+	public:
+		using value_type = T;
+		FrameStlAllocator() noexcept = default;
+		template <typename U>
+		FrameStlAllocator(const FrameStlAllocator<U>& other) noexcept {}
+		T* allocate(std::size_t count) {
+			return static_cast<T*>(FrameAllocator::GetCurrent().Allocate(count * sizeof(T), alignof(T)));
+		}
+		void deallocate(T* pointer, std::size_t count) noexcept {
+			FrameAllocator::GetCurrent().Deallocate(pointer, count * sizeof(T));
+		}
+		template <typename U>
+		bool operator==(const FrameStlAllocator<U>& other) const noexcept { return true; }
+		template <typename U>
+		bool operator!=(const FrameStlAllocator<U>& other) const noexcept { return false; }
+	};
+
+	template <typename T>
+	using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+}
+#endif
@@ -0,0 +1,174 @@
+#include "JobSystem.hpp"
+#include "Log.hpp"
+#include <algorithm>
+#include <chrono>
+namespace Mona {
+
+	thread_local uint32_t JobSystem::s_queueIndex = 0;
+
+	void JobSystem::StartUp(int workerCount) noexcept {
+		MONA_ASSERT(!m_running, "JobSystem: Already started.");
+		if (workerCount < 0) {
+			workerCount = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+		}
+		m_queues.clear();
+		for (int i = 0; i <= workerCount; i++) {
+			m_queues.emplace_back(new JobQueue());
+		}
+		m_running = true;
+		for (int i = 0; i < workerCount; i++) {
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+		}
+		MONA_LOG_INFO("JobSystem: Started with {0} worker threads.", workerCount);
+	}
+
+	void JobSystem::ShutDown() noexcept {
+		if (!m_running) {
+			return;
+		}
+		while (RunPendingJob() || RunBackgroundJob()) {}
+		m_running = false;
+		m_sleepCondition.notify_all();
+		for (auto& worker : m_workers) {
+			worker.join();
+		}
+		m_workers.clear();
+		m_queues.clear();
+	}
+
+	void JobSystem::Submit(Job job, JobCounter* counter) noexcept {
+		if (counter != nullptr) {
+			counter->m_pendingJobs.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (!m_running) {
+			JobEntry entry{ std::move(job), counter, FrameAllocator::GetThreadAllocator() };
+			Execute(entry);
+			return;
+		}
+		JobQueue& queue = *m_queues[s_queueIndex];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(JobEntry{ std::move(job), counter, FrameAllocator::GetThreadAllocator() });
+		}
+		m_queuedJobs.fetch_add(1, std::memory_order_release);
+		m_sleepCondition.notify_one();
+	}
+
+	void JobSystem::SubmitBackground(Job job) noexcept {
+		if (!m_running) {
+			FrameAllocator::Scope frameAllocatorScope(nullptr);
+			job();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_backgroundMutex);
+			m_backgroundJobs.push_back(std::move(job));
+		}
+		m_queuedBackgroundJobs.fetch_add(1, std::memory_order_release);
+		m_sleepCondition.notify_one();
+	}
+
+	bool JobSystem::RunBackgroundJob() noexcept {
+		Job job;
+		{
+			std::lock_guard<std::mutex> lock(m_backgroundMutex);
+			if (m_backgroundJobs.empty()) {
+				return false;
+			}
+			job = std::move(m_backgroundJobs.front());
+			m_backgroundJobs.pop_front();
+		}
+		m_queuedBackgroundJobs.fetch_sub(1, std::memory_order_relaxed);
+		//Un trabajo de fondo puede durar varios frames, por lo que no usa la memoria temporal de ningun mundo
+		FrameAllocator::Scope frameAllocatorScope(nullptr);
+		job();
+		return true;
+	}
+
+	void JobSystem::Wait(const JobCounter& counter) noexcept {
+		while (!counter.IsDone()) {
+			if (!RunPendingJob()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobSystem::RunPendingJob() noexcept {
+		if (!m_running) {
+			return false;
+		}
+		JobEntry entry;
+		if (PopJob(s_queueIndex, entry) || StealJob(s_queueIndex, entry)) {
+			Execute(entry);
+			return true;
+		}
+		return false;
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job) noexcept {
+		batchSize = std::max(batchSize, 1u);
+		if (count <= batchSize || GetWorkerCount() == 0) {
+			if (0 < count) {
+				job(0, count);
+			}
+			return;
+		}
+		JobCounter counter;
+		for (uint32_t begin = batchSize; begin < count; begin += batchSize) {
+			uint32_t end = std::min(begin + batchSize, count);
+			Submit([&job, begin, end]() { job(begin, end); }, &counter);
+		}
+		job(0, batchSize);
+		Wait(counter);
+	}
+
+	void JobSystem::WorkerLoop(uint32_t queueIndex) noexcept {
+		s_queueIndex = queueIndex;
+		while (m_running) {
+			if (RunPendingJob() || RunBackgroundJob()) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepCondition.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+				return !m_running || 0 < m_queuedJobs.load(std::memory_order_acquire) ||
+					0 < m_queuedBackgroundJobs.load(std::memory_order_acquire);
+			});
+		}
+	}
+
+	bool JobSystem::PopJob(uint32_t queueIndex, JobEntry& outEntry) noexcept {
+		JobQueue& queue = *m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty()) {
+			return false;
+		}
+		outEntry = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool JobSystem::StealJob(uint32_t thiefIndex, JobEntry& outEntry) noexcept {
+		uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+		for (uint32_t i = 1; i < queueCount; i++) {
+			JobQueue& queue = *m_queues[(thiefIndex + i) % queueCount];
+			std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+			if (!lock.owns_lock() || queue.jobs.empty()) {
+				continue;
+			}
+			outEntry = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	void JobSystem::Execute(JobEntry& entry) noexcept {
+		FrameAllocator::Scope frameAllocatorScope(entry.frameAllocator);
+		entry.job();
+		if (entry.counter != nullptr) {
+			entry.counter->m_pendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+		}
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef JOBSYSTEM_HPP
+#define JOBSYSTEM_HPP
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "FrameAllocator.hpp"
+namespace Mona {
+
+	class JobCounter {
+	public:
+		friend class JobSystem;
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+		bool IsDone() const noexcept { return m_pendingJobs.load(std::memory_order_acquire) == 0; }
+	private:
+		std::atomic<int> m_pendingJobs = 0;
+	};
+
+	class JobSystem {
+	public:
+		using Job = std::function<void()>;
+		using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+		JobSystem(JobSystem const&) = delete;
+		JobSystem& operator=(JobSystem const&) = delete;
+		static JobSystem& GetInstance() noexcept {
+			static JobSystem instance;
+			return instance;
+		}
+		void StartUp(int workerCount) noexcept;
+		void ShutDown() noexcept;
+		void Submit(Job job, JobCounter* counter = nullptr) noexcept;
+		void Wait(const JobCounter& counter) noexcept;
+		bool RunPendingJob() noexcept;
+		void ParallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job) noexcept;
+		// Trabajo largo, como la lectura de assets. Lo ejecutan los workers cuando no tienen otro trabajo y nunca un Wait, pero
+		// una vez empezado ocupa su worker hasta terminar y los trabajos de los sistemas cuentan con uno menos mientras tanto
+		void SubmitBackground(Job job) noexcept;
+		// Ejecuta un trabajo de fondo en el hilo actual. Permite avanzar la cola de fondo cuando no hay workers
+		bool RunBackgroundJob() noexcept;
+		uint32_t GetWorkerCount() const noexcept { return static_cast<uint32_t>(m_workers.size()); }
+		// Cola del hilo actual: i en el worker i y 0 en el hilo principal y en hilos externos al sistema
+		static uint32_t GetCurrentQueueIndex() noexcept { return s_queueIndex; }
+	private:
+		struct JobEntry {
+			Job job;
+			JobCounter* counter;
+			// Allocator temporal del World que envio el trabajo
+			FrameAllocator* frameAllocator;
+		};
+		struct JobQueue {
+			std::mutex mutex;
+			std::deque<JobEntry> jobs;
+		};
+		JobSystem() noexcept = default;
+		void WorkerLoop(uint32_t queueIndex) noexcept;
+		bool PopJob(uint32_t queueIndex, JobEntry& outEntry) noexcept;
+		bool StealJob(uint32_t thiefIndex, JobEntry& outEntry) noexcept;
+		void Execute(JobEntry& entry) noexcept;
+
+		// La cola 0 pertenece al hilo principal y a hilos externos al sistema
+		std::vector<std::unique_ptr<JobQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+		std::atomic<bool> m_running = false;
+		std::atomic<int> m_queuedJobs = 0;
+		std::mutex m_backgroundMutex;
+		std::deque<Job> m_backgroundJobs;
+		std::atomic<int> m_queuedBackgroundJobs = 0;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCondition;
+		static thread_local uint32_t s_queueIndex;
+	};
+}
+#endif
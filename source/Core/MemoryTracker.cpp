@@ -0,0 +1,76 @@
+#include "MemoryTracker.hpp"
+#include <string>
+#include "Config.hpp"
+#include "Log.hpp"
+namespace Mona {
+
+	void MemoryTracker::StartUp() noexcept {
+		auto& config = Config::GetInstance();
+		for (uint8_t i = 0; i < GetMemoryTagCount(); i++) {
+			MemoryTag tag = static_cast<MemoryTag>(i);
+			std::string key = "memory_budget_" + std::string(GetTagName(tag)) + "_mb";
+			int budgetMB = config.getValueOrDefault<int>(key, 0);
+			SetBudget(tag, budgetMB > 0 ? static_cast<std::size_t>(budgetMB) << 20 : 0);
+		}
+	}
+
+	void MemoryTracker::SetBudget(MemoryTag tag, std::size_t budgetBytes) noexcept {
+		TagCounters& counters = m_counters[static_cast<uint8_t>(tag)];
+		counters.budgetBytes.store(static_cast<int64_t>(budgetBytes), std::memory_order_relaxed);
+		counters.overBudget.store(false, std::memory_order_relaxed);
+		CheckBudget(tag, counters.cpuBytes.load(std::memory_order_relaxed) + counters.gpuBytes.load(std::memory_order_relaxed));
+	}
+
+	void MemoryTracker::Add(MemoryTag tag, int64_t cpuBytes, int64_t gpuBytes) noexcept {
+		if (cpuBytes == 0 && gpuBytes == 0) {
+			return;
+		}
+		TagCounters& counters = m_counters[static_cast<uint8_t>(tag)];
+		int64_t cpuTotal = counters.cpuBytes.fetch_add(cpuBytes, std::memory_order_relaxed) + cpuBytes;
+		int64_t gpuTotal = counters.gpuBytes.fetch_add(gpuBytes, std::memory_order_relaxed) + gpuBytes;
+		int64_t total = cpuTotal + gpuTotal;
+		int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+		while (peak < total && !counters.peakBytes.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {}
+		CheckBudget(tag, total);
+	}
+
+	void MemoryTracker::CheckBudget(MemoryTag tag, int64_t totalBytes) noexcept {
+		TagCounters& counters = m_counters[static_cast<uint8_t>(tag)];
+		int64_t budget = counters.budgetBytes.load(std::memory_order_relaxed);
+		bool overBudget = 0 < budget && budget < totalBytes;
+		//Se advierte solo al cruzar el presupuesto, no en cada reserva posterior
+		if (counters.overBudget.exchange(overBudget, std::memory_order_relaxed) != overBudget && overBudget) {
+			MONA_LOG_WARNING("MemoryTracker: {0} is over budget ({1:.2f} MB used, {2:.2f} MB budget).", GetTagName(tag),
+				static_cast<double>(totalBytes) / (1 << 20), static_cast<double>(budget) / (1 << 20));
+		}
+	}
+
+	MemoryTracker::Snapshot MemoryTracker::GetSnapshot() const noexcept {
+		Snapshot snapshot;
+		for (uint8_t i = 0; i < GetMemoryTagCount(); i++) {
+			const TagCounters& counters = m_counters[i];
+			TagUsage& usage = snapshot[i];
+			usage.name = GetTagName(static_cast<MemoryTag>(i));
+			usage.cpuBytes = static_cast<std::size_t>(counters.cpuBytes.load(std::memory_order_relaxed));
+			usage.gpuBytes = static_cast<std::size_t>(counters.gpuBytes.load(std::memory_order_relaxed));
+			usage.peakBytes = static_cast<std::size_t>(counters.peakBytes.load(std::memory_order_relaxed));
+			usage.budgetBytes = static_cast<std::size_t>(counters.budgetBytes.load(std::memory_order_relaxed));
+			usage.overBudget = counters.overBudget.load(std::memory_order_relaxed);
+		}
+		return snapshot;
+	}
+
+	const char* MemoryTracker::GetTagName(MemoryTag tag) noexcept {
+		switch (tag) {
+		case MemoryTag::Meshes: return "meshes";
+		case MemoryTag::Textures: return "textures";
+		case MemoryTag::Skeletons: return "skeletons";
+		case MemoryTag::AnimationClips: return "animation_clips";
+		case MemoryTag::AudioClips: return "audio_clips";
+		case MemoryTag::Components: return "components";
+		case MemoryTag::IKNavigation: return "ik_navigation";
+		case MemoryTag::FrameScratch: return "frame_scratch";
+		default: return "unknown";
+		}
+	}
+}
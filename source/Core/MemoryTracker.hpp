@@ -0,0 +1,94 @@
+#pragma once
+#ifndef MEMORYTRACKER_HPP
+#define MEMORYTRACKER_HPP
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+namespace Mona {
+
+	enum class MemoryTag : uint8_t {
+		Meshes,
+		Textures,
+		Skeletons,
+		AnimationClips,
+		AudioClips,
+		Components,
+		IKNavigation,
+		FrameScratch,
+		TagCount
+	};
+
+	constexpr uint8_t GetMemoryTagCount() {
+		return static_cast<uint8_t>(MemoryTag::TagCount);
+	}
+
+	/*
+	* Contabilidad de memoria por subsistema. Los contadores son atomicos y solo se modifican al crear o liberar
+	* recursos, por lo que el costo es despreciable incluso en builds de release. La memoria de GPU es una estimacion
+	* a partir de los tamanos enviados a OpenGL.
+	*/
+	class MemoryTracker {
+	public:
+		struct TagUsage {
+			const char* name = "";
+			std::size_t cpuBytes = 0;
+			std::size_t gpuBytes = 0;
+			std::size_t peakBytes = 0;
+			// 0 indica que no hay presupuesto para el tag
+			std::size_t budgetBytes = 0;
+			bool overBudget = false;
+		};
+		using Snapshot = std::array<TagUsage, GetMemoryTagCount()>;
+		MemoryTracker(MemoryTracker const&) = delete;
+		MemoryTracker& operator=(MemoryTracker const&) = delete;
+		static MemoryTracker& GetInstance() noexcept {
+			static MemoryTracker instance;
+			return instance;
+		}
+		// Lee los presupuestos memory_budget_<tag>_mb de config.cfg
+		void StartUp() noexcept;
+		void SetBudget(MemoryTag tag, std::size_t budgetBytes) noexcept;
+		void Add(MemoryTag tag, int64_t cpuBytes, int64_t gpuBytes) noexcept;
+		Snapshot GetSnapshot() const noexcept;
+		static const char* GetTagName(MemoryTag tag) noexcept;
+	private:
+		struct TagCounters {
+			std::atomic<int64_t> cpuBytes = 0;
+			std::atomic<int64_t> gpuBytes = 0;
+			std::atomic<int64_t> peakBytes = 0;
+			std::atomic<int64_t> budgetBytes = 0;
+			std::atomic<bool> overBudget = false;
+		};
+		MemoryTracker() noexcept = default;
+		void CheckBudget(MemoryTag tag, int64_t totalBytes) noexcept;
+		std::array<TagCounters, GetMemoryTagCount()> m_counters;
+	};
+
+	/*
+	* Cuenta asociada a un recurso. Reemplaza lo contabilizado previamente en cada llamada a Set y lo descuenta
+	* al destruirse.
+	*/
+	class MemoryAccount {
+	public:
+		explicit MemoryAccount(MemoryTag tag) noexcept : m_tag(tag) {}
+		MemoryAccount(const MemoryAccount&) = delete;
+		MemoryAccount& operator=(const MemoryAccount&) = delete;
+		~MemoryAccount() { Reset(); }
+		void Set(std::size_t cpuBytes, std::size_t gpuBytes) noexcept {
+			MemoryTracker::GetInstance().Add(m_tag,
+				static_cast<int64_t>(cpuBytes) - static_cast<int64_t>(m_cpuBytes),
+				static_cast<int64_t>(gpuBytes) - static_cast<int64_t>(m_gpuBytes));
+			m_cpuBytes = cpuBytes;
+			m_gpuBytes = gpuBytes;
+		}
+		void Reset() noexcept { Set(0, 0); }
+		std::size_t GetCPUBytes() const noexcept { return m_cpuBytes; }
+		std::size_t GetGPUBytes() const noexcept { return m_gpuBytes; }
+	private:
+		MemoryTag m_tag;
+		std::size_t m_cpuBytes = 0;
+		std::size_t m_gpuBytes = 0;
+	};
+}
+#endif
@@ -5,6 +5,7 @@
 #include <filesystem>
 namespace Mona{
 	std::string source_directory = "D:/Universidad/2022-1/Trabajo_de_Titulo/codigo/MonaEngine_IK/";
+	std::string build_directory = "D:/Universidad/2022-1/Trabajo_de_Titulo/codigo/MonaEngine_IK/build/";
 	void SourceDirectoryData::SetSourceDirectory(std::string newSourceDirectory){
 		if(newSourceDirectory.back() != '/' && newSourceDirectory.back() != '\\') {
 			newSourceDirectory.append("/");
@@ -14,5 +15,8 @@ namespace Mona{
 	std::filesystem::path SourceDirectoryData::SourcePath(const std::string &relative_path){
 		return source_directory + relative_path;
 	}
+	std::filesystem::path SourceDirectoryData::BuildPath(const std::string &relative_path){
+		return build_directory + relative_path;
+	}
 	
 }
@@ -12,6 +12,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "../PhysicsCollision/PhysicsCollisionSystem.hpp"
 #include "../Core/RootDirectory.hpp"
+#include "../Core/MemoryTracker.hpp"
 void GLAPIENTRY MessageCallback(GLenum source,
 	GLenum type,
 	GLuint id,
@@ -26,6 +27,22 @@ void GLAPIENTRY MessageCallback(GLenum source,
 
 namespace Mona {
 
+	static void DrawMemoryStatistics() noexcept {
+		ImGui::Separator();
+		ImGui::Text("Memory (MB):");
+		for (const auto& usage : MemoryTracker::GetInstance().GetSnapshot()) {
+			constexpr float bytesPerMB = 1024.0f * 1024.0f;
+			ImVec4 color = usage.overBudget ? ImVec4(1.0f, 0.3f, 0.3f, 1.0f) : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+			if (usage.budgetBytes != 0) {
+				ImGui::TextColored(color, "%s: cpu %.2f, gpu %.2f, peak %.2f, budget %.2f", usage.name, usage.cpuBytes / bytesPerMB,
+					usage.gpuBytes / bytesPerMB, usage.peakBytes / bytesPerMB, usage.budgetBytes / bytesPerMB);
+			}
+			else {
+				ImGui::TextColored(color, "%s: cpu %.2f, gpu %.2f, peak %.2f", usage.name, usage.cpuBytes / bytesPerMB,
+					usage.gpuBytes / bytesPerMB, usage.peakBytes / bytesPerMB);
+			}
+		}
+	}
 
 	void DebugDrawingSystem_physics::Draw(EventManager& eventManager, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) noexcept {
 
@@ -47,6 +64,7 @@ namespace Mona {
 			ImGui::Checkbox("Draw Wireframe", &(m_bulletDebugDrawPtr->m_bDrawWireframe));
 			ImGui::Checkbox("Draw ContactPoints", &(m_bulletDebugDrawPtr->m_bDrawContactsPoints));
 			ImGui::Checkbox("Draw AABB", &(m_bulletDebugDrawPtr->m_bDrawAABB));
+			DrawMemoryStatistics();
 			ImGui::End();
 		}
 		eventManager.Publish(DebugGUIEvent());
@@ -112,6 +130,26 @@ namespace Mona {
 			ImGui::Checkbox("Draw EndEffector Target Curves", &(m_ikNavDebugDrawPtr->m_drawEETargetCurves));
 			ImGui::Checkbox("Draw EndEffector Real Curves", &(m_ikNavDebugDrawPtr->m_drawEERealCurves));
 			ImGui::Checkbox("Draw Hip Target Curves", &(m_ikNavDebugDrawPtr->m_drawHipTargetCurve));
+			ImGui::Separator();
+			ImGui::Text("IK Navigation Solver Statistics:");
+			std::vector<IKRigController*> statControllers = m_ikNavSystemPtr->getControllersDebug();
+			for (int i = 0; i < statControllers.size(); i++) {
+				const IKRig& ikRig = statControllers[i]->m_ikRig;
+				const AccumulatedDescentStatistics& ikStats = ikRig.getInverseKinematics().getAccumulatedDescentStatistics();
+				const AccumulatedDescentStatistics& strideStats = ikRig.getTrajectoryGenerator().getStrideCorrector().getAccumulatedDescentStatistics();
+				ImGui::Text("Rig %d: IK %d solves (%.1f avg iterations, %d early), strides %d solves (%.1f avg iterations)", i,
+					ikStats.solveCount, ikStats.averageIterations(), ikStats.earlyTerminations,
+					strideStats.solveCount, strideStats.averageIterations());
+				const StrideCorrectionStatistics& correctionStats = ikRig.getTrajectoryGenerator().getStrideCorrector().getCorrectionStatistics();
+				ImGui::Text("Rig %d: strides corrected directly %d, with descent fallback %d", i,
+					correctionStats.directSolves, correctionStats.fallbackSolves);
+				const IKSolveStatistics& solveStats = ikRig.getInverseKinematics().getSolveStatistics();
+				ImGui::Text("Rig %d: IK requests %d, skipped %d (%.1f%%)", i,
+					solveStats.requestedSolves, solveStats.skippedSolves, 100.0f * solveStats.skipRate());
+				const char* lodNames[] = { "full ik", "periodic ik", "trajectories only", "animation only" };
+				ImGui::Text("Rig %d: LOD %s", i, lodNames[(int)statControllers[i]->getLOD()]);
+			}
+			DrawMemoryStatistics();
 			ImGui::End();
 		}
 		eventManager.Publish(DebugGUIEvent());
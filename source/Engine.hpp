@@ -8,7 +8,7 @@ namespace Mona {
 	class Engine
 	{
 	public:
-		Engine(Application& app) : m_world(app) {}
+		Engine(Application& app, WorldMode mode = WorldMode::Windowed) : m_world(app, mode) {}
 		~Engine() = default;
 		Engine(const Engine&) = delete;
 		Engine& operator=(const Engine&) = delete;
@@ -18,6 +18,22 @@ namespace Mona {
 		void StartMainLoop() noexcept {
 			m_world.StartMainLoop();
 		}
+
+		/*
+		* Avanza el mundo un paso de timeStep segundos. Permite controlar la simulacion desde afuera, por ejemplo
+		* para correr simulaciones headless en lote, cada una en su propio hilo. Si se esta reproduciendo una grabacion
+		* de input se usa el paso de tiempo grabado.
+		*/
+		void Update(float timeStep) noexcept {
+			m_world.Update(timeStep);
+		}
+
+		/*
+		* Verdadero cuando la aplicacion pidio terminar, por ejemplo al acabar la reproduccion de una grabacion de input.
+		*/
+		bool ShouldClose() const noexcept {
+			return m_world.m_shouldClose;
+		}
 	private:
 		World m_world;
 	};
@@ -1,4 +1,6 @@
 #include "EventManager.hpp"
+#include "../Core/JobSystem.hpp"
+#include <algorithm>
 namespace Mona
 {
 	SubscriptionHandle::~SubscriptionHandle() {
@@ -12,12 +14,112 @@ namespace Mona
 		m_lastFreeIndex(s_maxEntries),
 		m_freeIndicesCount(0)
 	{}
+
+	static std::atomic<uint64_t> s_nextEventManagerID = 0;
+
+	EventManager::EventManager() :
+		m_dispatchThreadID(std::this_thread::get_id()),
+		m_managerID(s_nextEventManagerID.fetch_add(1, std::memory_order_relaxed))
+	{
+	}
+	EventManager::~EventManager()
+	{
+	}
 	void EventManager::ShutDown() noexcept
 	{
+		//Los eventos pendientes se descartan sin entregarse
+		{
+			std::lock_guard<std::mutex> lock(m_producerQueuesMutex);
+			for (auto& queue : m_producerQueues)
+				queue->Consume([](QueuedEvent&&) {});
+		}
+		m_pendingEvents.clear();
 		for (auto& observerList : m_observerLists)
 			observerList.ShutDown();
 	}
 
+	namespace {
+		//Colas que el hilo usa en cada EventManager. Al terminar el hilo sus colas se marcan como abandonadas para que
+		//el EventManager las libere una vez entregados sus eventos.
+		struct ThreadQueueList {
+			struct Entry {
+				uint64_t managerID;
+				ProducerEventQueue* queue;
+				std::weak_ptr<ProducerEventQueue> owner;
+			};
+			std::vector<Entry> entries;
+			~ThreadQueueList() {
+				for (auto& entry : entries) {
+					if (auto queue = entry.owner.lock())
+						queue->Abandon();
+				}
+			}
+		};
+	}
+
+	ProducerEventQueue& EventManager::GetThreadQueue() noexcept
+	{
+		//Los identificadores de EventManager nunca se reutilizan, por lo que una entrada que coincide pertenece a este
+		//EventManager y su cola sigue viva mientras el hilo no termine
+		thread_local ThreadQueueList threadQueues;
+		for (const auto& entry : threadQueues.entries)
+		{
+			if (entry.managerID == m_managerID)
+				return *entry.queue;
+		}
+		//Se descartan las entradas de EventManagers ya destruidos
+		threadQueues.entries.erase(std::remove_if(threadQueues.entries.begin(), threadQueues.entries.end(),
+			[](const ThreadQueueList::Entry& entry) { return entry.owner.expired(); }), threadQueues.entries.end());
+		std::shared_ptr<ProducerEventQueue> queue;
+		{
+			std::lock_guard<std::mutex> lock(m_producerQueuesMutex);
+			//El indice de productor depende del hilo y no del orden en que los hilos encolan por primera vez
+			uint32_t producerIndex = JobSystem::GetCurrentQueueIndex();
+			if (producerIndex == 0 && std::this_thread::get_id() != m_dispatchThreadID)
+				producerIndex = s_externalProducerIndexBase + m_externalProducerCount++;
+			queue = std::make_shared<ProducerEventQueue>(producerIndex);
+			m_producerQueues.push_back(queue);
+		}
+		threadQueues.entries.push_back({ m_managerID, queue.get(), queue });
+		return *queue;
+	}
+	void EventManager::DispatchQueuedEvents() noexcept
+	{
+		MONA_ASSERT(std::this_thread::get_id() == m_dispatchThreadID, "EventManager Error: Queued events must be dispatched from the thread that owns the EventManager");
+		{
+			std::lock_guard<std::mutex> lock(m_producerQueuesMutex);
+			for (auto it = m_producerQueues.begin(); it != m_producerQueues.end();)
+			{
+				//Si el hilo ya termino, todos sus eventos estan publicados antes de leer la marca
+				bool abandoned = (*it)->IsAbandoned();
+				(*it)->Consume([this](QueuedEvent&& queuedEvent) {
+					m_pendingEvents.push_back(std::move(queuedEvent));
+				});
+				if (abandoned)
+					it = m_producerQueues.erase(it);
+				else
+					++it;
+			}
+		}
+		if (m_pendingEvents.empty())
+			return;
+		std::sort(m_pendingEvents.begin(), m_pendingEvents.end(), [](const QueuedEvent& a, const QueuedEvent& b) {
+			if (a.sortKey != b.sortKey)
+				return a.sortKey < b.sortKey;
+			if (a.producerIndex != b.producerIndex)
+				return a.producerIndex < b.producerIndex;
+			return a.sequence < b.sequence;
+		});
+		//Los handlers pueden encolar nuevos eventos, que quedan en las colas hasta la siguiente llamada
+		std::vector<QueuedEvent> events = std::move(m_pendingEvents);
+		m_pendingEvents.clear();
+		for (auto& queuedEvent : events)
+			queuedEvent.dispatch(*this);
+		//Se conserva la capacidad del vector para el siguiente frame
+		events.clear();
+		m_pendingEvents = std::move(events);
+	}
+
 
 	void ObserverList::Unsubscribe(const SubscriptionHandle& handle) noexcept
 	{
@@ -25,11 +127,24 @@ namespace Mona
 		MONA_ASSERT(index < m_handleEntries.size(), "EventManager Error: handle index out of bounds");
 		MONA_ASSERT(handle.m_generation == m_handleEntries[index].generation, "EventManager Error: Trying to destroy from invalid handle");
 		MONA_ASSERT(m_handleEntries[index].active == true, "EventManager Error: Trying to destroy from inactive handle");
+		if (m_dispatchDepth > 0)
+		{
+			//Durante una entrega no se mueven los handlers, solo se desactivan hasta que esta termine
+			m_handleEntries[index].active = false;
+			m_pendingRemovals.push_back(index);
+			return;
+		}
+		RemoveEntry(index);
+	}
+
+	void ObserverList::RemoveEntry(uint32_t index) noexcept
+	{
 		auto& handleEntry = m_handleEntries[index];
 		if (handleEntry.index < m_eventHandlers.size() - 1)
 		{
 			auto handleEntryIndex = m_handleEntryIndices.back();
 			m_eventHandlers[handleEntry.index] = std::move(m_eventHandlers.back());
+			m_handleEntryIndices[handleEntry.index] = handleEntryIndex;
 			m_handleEntries[handleEntryIndex].index = handleEntry.index;
 		}
 
@@ -50,9 +165,20 @@ namespace Mona
 
 	void ObserverList::Publish(const Event& e) noexcept
 	{
-		for (const auto& eventHandler : m_eventHandlers)
+		//Se recorre por indice y solo hasta los handlers existentes al comenzar, ya que un handler puede suscribir
+		//o desuscribir observadores de este mismo evento
+		++m_dispatchDepth;
+		const std::size_t handlerCount = m_eventHandlers.size();
+		for (std::size_t i = 0; i < handlerCount; i++)
+		{
+			if (m_handleEntries[m_handleEntryIndices[i]].active)
+				m_eventHandlers[i](e);
+		}
+		if (--m_dispatchDepth == 0 && !m_pendingRemovals.empty())
 		{
-			eventHandler(e);
+			for (uint32_t index : m_pendingRemovals)
+				RemoveEntry(index);
+			m_pendingRemovals.clear();
 		}
 	}
 
@@ -64,6 +190,7 @@ namespace Mona
 		m_firstFreeIndex = s_maxEntries;
 		m_lastFreeIndex = s_maxEntries;
 		m_freeIndicesCount = 0;
+		m_pendingRemovals.clear();
 	}
 
 }
@@ -3,7 +3,13 @@
 #define EVENTMANAGER_HPP
 #include "../Core/Log.hpp"
 #include "Events.hpp"
+#include "EventQueue.hpp"
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #include <typeindex>
@@ -64,7 +70,7 @@ namespace Mona
 				handle.m_index = handleIndex;
 				handle.m_generation = handleEntry.generation;
 				handle.m_typeIndex = typeIndex;
-				m_eventHandlers.push_back(handler);
+				m_eventHandlers.push_back(std::move(handler));
 				m_handleEntryIndices.emplace_back(handleIndex);
 				//return resultHandle;
 			}
@@ -75,7 +81,7 @@ namespace Mona
 				handle.m_index = static_cast<uint32_t>(m_handleEntries.size() - 1);
 				handle.m_generation = 0;
 				handle.m_typeIndex = typeIndex;
-				m_eventHandlers.push_back(handler);
+				m_eventHandlers.push_back(std::move(handler));
 				m_handleEntryIndices.emplace_back(static_cast<uint32_t>(m_handleEntries.size() - 1));
 				//return resultHandle;
 			}
@@ -95,7 +101,7 @@ namespace Mona
 		void Publish(const Event& e) noexcept;
 		void ShutDown() noexcept;
 	private:
-
+		void RemoveEntry(uint32_t index) noexcept;
 
 		struct HandleEntry {
 			HandleEntry(uint32_t i, uint32_t p, uint32_t g) : index(i), prevIndex(p), generation(g), active(true) {}
@@ -106,10 +112,14 @@ namespace Mona
 		};
 		std::vector<HandleEntry> m_handleEntries;
 		std::vector<uint32_t> m_handleEntryIndices;
-		std::vector<EventHandler> m_eventHandlers;
+		// deque para que suscribirse desde un handler no mueva al handler que se esta ejecutando
+		std::deque<EventHandler> m_eventHandlers;
 		uint32_t m_firstFreeIndex;
 		uint32_t m_lastFreeIndex;
 		uint32_t m_freeIndicesCount;
+		// Las desuscripciones hechas durante una entrega se aplican al terminar esta
+		uint32_t m_dispatchDepth = 0;
+		std::vector<uint32_t> m_pendingRemovals;
 		
 	};
 
@@ -134,12 +144,43 @@ namespace Mona
 			return;
 		}
 
+		// Entrega el evento inmediatamente. Desde otros hilos el evento se encola y se entrega en DispatchQueuedEvents.
 		template <typename EventType>
 		void Publish(const EventType& e)
 		{
 			static_assert(is_event<EventType>, "Template parameter is not an event");
+			if (std::this_thread::get_id() != m_dispatchThreadID) {
+				Enqueue(e);
+				return;
+			}
 			m_observerLists[EventType::eventIndex].Publish(e);
 		}
+
+		// Encola el evento desde cualquier hilo, incluido el principal, para entregarlo en DispatchQueuedEvents segun sortKey.
+		// Es la forma de obtener un orden reproducible entre eventos de trabajos paralelos, por ejemplo usando como
+		// sortKey el indice del elemento que procesa el trabajo.
+		template <typename EventType>
+		void Publish(const EventType& e, uint64_t sortKey)
+		{
+			Enqueue(e, sortKey);
+		}
+
+		// Puede llamarse desde cualquier hilo sin bloquear. Los eventos encolados se entregan en orden de sortKey,
+		// y para una misma sortKey en orden de indice de productor manteniendo el orden de cada hilo. El indice de
+		// productor es 0 en el hilo principal y el de su cola en los workers del JobSystem, pero un mismo trabajo puede
+		// ejecutarse en distintos workers, por lo que solo sortKeys distintas garantizan un orden reproducible.
+		template <typename EventType>
+		void Enqueue(const EventType& e, uint64_t sortKey = 0)
+		{
+			static_assert(is_event<EventType>, "Template parameter is not an event");
+			GetThreadQueue().Push(sortKey, [e](EventManager& eventManager) {
+				eventManager.m_observerLists[EventType::eventIndex].Publish(e);
+			});
+		}
+
+		// Punto de sincronizacion: entrega en el hilo principal los eventos encolados por todos los hilos.
+		// Los eventos encolados durante la entrega quedan para la siguiente llamada.
+		void DispatchQueuedEvents() noexcept;
 		
 		void Unsubscribe(SubscriptionHandle& handle) {
 			MONA_ASSERT(handle.m_typeIndex < GetEventTypeCount(), "EventManager Error: Handle with invalid type index");
@@ -152,11 +193,25 @@ namespace Mona
 				return false;
 			return m_observerLists[handle.m_typeIndex].IsSubcriptionHandleValid(handle);
 		}
-		EventManager() = default;
-		~EventManager() = default;
+		EventManager();
+		~EventManager();
+		EventManager(const EventManager&) = delete;
+		EventManager& operator=(const EventManager&) = delete;
 		void ShutDown() noexcept;
 	private:
+		// Los hilos ajenos al JobSystem reciben indices a partir de este valor, en orden de primer uso
+		static constexpr uint32_t s_externalProducerIndexBase = 1u << 16;
+		ProducerEventQueue& GetThreadQueue() noexcept;
 		std::array<ObserverList, GetEventTypeCount()> m_observerLists;
+		// Las suscripciones y las entregas inmediatas ocurren en el hilo que creo al EventManager
+		std::thread::id m_dispatchThreadID;
+		uint64_t m_managerID;
+		// Una cola por hilo que ha encolado eventos. Las colas de hilos terminados se liberan al vaciarse.
+		// El mutex solo se toma al registrar la cola de un hilo nuevo y al consumir las colas.
+		std::mutex m_producerQueuesMutex;
+		std::vector<std::shared_ptr<ProducerEventQueue>> m_producerQueues;
+		uint32_t m_externalProducerCount = 0;
+		std::vector<QueuedEvent> m_pendingEvents;
 
 	};
 }
@@ -0,0 +1,35 @@
+#include "EventQueue.hpp"
+namespace Mona {
+
+	ProducerEventQueue::ProducerEventQueue(uint32_t producerIndex) :
+		m_head(new Block()),
+		m_producerIndex(producerIndex)
+	{
+		m_tail = m_head;
+	}
+
+	ProducerEventQueue::~ProducerEventQueue() {
+		Block* block = m_head;
+		while (block != nullptr) {
+			Block* nextBlock = block->next.load(std::memory_order_relaxed);
+			delete block;
+			block = nextBlock;
+		}
+	}
+
+	void ProducerEventQueue::Push(uint64_t sortKey, std::function<void(EventManager&)> dispatch) noexcept {
+		uint32_t published = m_tail->published.load(std::memory_order_relaxed);
+		if (published == BLOCK_SIZE) {
+			Block* newBlock = new Block();
+			m_tail->next.store(newBlock, std::memory_order_release);
+			m_tail = newBlock;
+			published = 0;
+		}
+		QueuedEvent& queuedEvent = m_tail->events[published];
+		queuedEvent.sortKey = sortKey;
+		queuedEvent.producerIndex = m_producerIndex;
+		queuedEvent.sequence = m_sequence++;
+		queuedEvent.dispatch = std::move(dispatch);
+		m_tail->published.store(published + 1, std::memory_order_release);
+	}
+}
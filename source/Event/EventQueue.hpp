@@ -0,0 +1,75 @@
+#pragma once
+#ifndef EVENTQUEUE_HPP
+#define EVENTQUEUE_HPP
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+namespace Mona {
+	class EventManager;
+
+	struct QueuedEvent {
+		// Las entregas se ordenan por (sortKey, producerIndex, sequence)
+		uint64_t sortKey = 0;
+		uint32_t producerIndex = 0;
+		uint32_t sequence = 0;
+		std::function<void(EventManager&)> dispatch;
+	};
+
+	/*
+	* Cola de eventos de un unico productor y un unico consumidor. El productor solo escribe en el ultimo bloque y
+	* publica cada evento incrementando un contador atomico, mientras que el consumidor solo lee eventos ya publicados,
+	* por lo que ninguno de los dos necesita locks.
+	*/
+	class ProducerEventQueue {
+	public:
+		explicit ProducerEventQueue(uint32_t producerIndex);
+		~ProducerEventQueue();
+		ProducerEventQueue(const ProducerEventQueue&) = delete;
+		ProducerEventQueue& operator=(const ProducerEventQueue&) = delete;
+		// Solo puede llamarse desde el hilo productor
+		void Push(uint64_t sortKey, std::function<void(EventManager&)> dispatch) noexcept;
+		// Solo puede llamarse desde el hilo consumidor
+		template <typename Function>
+		void Consume(Function&& function) noexcept;
+		uint32_t GetProducerIndex() const noexcept { return m_producerIndex; }
+		// El hilo productor termino y no volvera a escribir, la cola puede liberarse una vez vaciada
+		void Abandon() noexcept { m_abandoned.store(true, std::memory_order_release); }
+		bool IsAbandoned() const noexcept { return m_abandoned.load(std::memory_order_acquire); }
+	private:
+		static constexpr uint32_t BLOCK_SIZE = 256;
+		struct Block {
+			std::array<QueuedEvent, BLOCK_SIZE> events;
+			std::atomic<uint32_t> published = 0;
+			std::atomic<Block*> next = nullptr;
+		};
+		Block* m_head;
+		uint32_t m_readIndex = 0;
+		Block* m_tail;
+		uint32_t m_sequence = 0;
+		uint32_t m_producerIndex;
+		std::atomic<bool> m_abandoned = false;
+	};
+
+	template <typename Function>
+	void ProducerEventQueue::Consume(Function&& function) noexcept {
+		while (true) {
+			uint32_t published = m_head->published.load(std::memory_order_acquire);
+			while (m_readIndex < published) {
+				function(std::move(m_head->events[m_readIndex++]));
+			}
+			if (m_readIndex < BLOCK_SIZE) {
+				return;
+			}
+			//El productor ya no escribe en un bloque lleno, por lo que se puede liberar una vez que existe el siguiente
+			Block* nextBlock = m_head->next.load(std::memory_order_acquire);
+			if (nextBlock == nullptr) {
+				return;
+			}
+			delete m_head;
+			m_head = nextBlock;
+			m_readIndex = 0;
+		}
+	}
+}
+#endif
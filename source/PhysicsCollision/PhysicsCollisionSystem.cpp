@@ -1,6 +1,7 @@
 #include "PhysicsCollisionSystem.hpp"
 #include "RigidBodyLifetimePolicy.hpp"
 #include <algorithm>
+#include <iterator>
 #include <vector>
 #include "CollisionInformation.hpp"
 #include "../PhysicsCollision/PhysicsCollisionEvents.hpp"
@@ -55,15 +56,15 @@ namespace Mona {
 			}
 		}
 
-		CollisionSet newCollisions;
+		FrameVector<CollisionPair> newCollisions;
 		//Para encontrar las colisiones nuevas es necesario encontrar las colisiones que estan presentes en la iteracin actual
 		//pero no en la anterior.
 		std::set_difference(currentCollisionSet.begin(), currentCollisionSet.end(),
-							m_previousCollisionSet.begin(), m_previousCollisionSet.end(),
-							std::inserter(newCollisions, newCollisions.begin()));
+							m_previousCollisions.begin(), m_previousCollisions.end(),
+							std::back_inserter(newCollisions), cmp());
 
 		
-		std::vector<std::tuple<RigidBodyHandle, RigidBodyHandle, bool, CollisionInformation>> newCollisionsInformation;
+		FrameVector<std::tuple<RigidBodyHandle, RigidBodyHandle, bool, CollisionInformation>> newCollisionsInformation;
 		//A partir del conjunto de colisiones nuevas poblado con byRigidBody* se genera un conjunto 
 		// con una representacin interna RigidBodyHandle.
 		newCollisionsInformation.reserve(newCollisions.size());
@@ -97,11 +98,12 @@ namespace Mona {
 		}
 
 		//El mismo proceso es necesario para colisiones que estan terminando.
-		CollisionSet removedCollisions;
-		std::set_difference(m_previousCollisionSet.begin(), m_previousCollisionSet.end(),
+		FrameVector<CollisionPair> removedCollisions;
+		std::set_difference(m_previousCollisions.begin(), m_previousCollisions.end(),
 							currentCollisionSet.begin(), currentCollisionSet.end(),
-							std::inserter(removedCollisions, removedCollisions.begin()));
-		std::vector <std::tuple<RigidBodyHandle, RigidBodyHandle>> removedCollisionInformation;
+							std::back_inserter(removedCollisions), cmp());
+		FrameVector<std::tuple<RigidBodyHandle, RigidBodyHandle>> removedCollisionInformation;
+		removedCollisionInformation.reserve(removedCollisions.size());
 
 		for (auto& removedCollision : removedCollisions)
 		{
@@ -124,7 +126,7 @@ namespace Mona {
 			}
 			eventManager.Publish(EndCollisionEvent(rb0,rb1));
 		}
-		m_previousCollisionSet = currentCollisionSet;
+		m_previousCollisions.assign(currentCollisionSet.begin(), currentCollisionSet.end());
 
 	}
 
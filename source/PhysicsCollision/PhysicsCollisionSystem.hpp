@@ -4,7 +4,9 @@
 #include <btBulletDynamicsCommon.h>
 #include <set>
 #include <tuple>
+#include <vector>
 #include "RigidBodyComponent.hpp"
+#include "../Core/FrameAllocator.hpp"
 #include "RaycastResults.hpp"
 
 namespace Mona {
@@ -55,7 +57,7 @@ namespace Mona {
 					;
 			}
 		};
-		using CollisionSet = std::set<CollisionPair, cmp>;
+		using CollisionSet = std::set<CollisionPair, cmp, FrameStlAllocator<CollisionPair>>;
 	private:
 		btBroadphaseInterface* m_broadphasePtr;
 		btCollisionConfiguration* m_collisionConfigurationPtr;
@@ -64,7 +66,8 @@ namespace Mona {
 		btDynamicsWorld* m_worldPtr;
 
 
-		CollisionSet m_previousCollisionSet;
+		// Colisiones del paso anterior ordenadas segun cmp. Se reutiliza su capacidad entre frames.
+		std::vector<CollisionPair> m_previousCollisions;
 		
 
 
@@ -4,6 +4,7 @@
 #include <btBulletDynamicsCommon.h>
 #include "CustomMotionState.hpp"
 #include "ShapeTypes.hpp"
+#include "TerrainShape.hpp"
 #include "CollisionInformation.hpp"
 #include "../World/ComponentHandle.hpp"
 #include "../World/ComponentManager.hpp"
@@ -133,7 +134,24 @@ namespace Mona {
 			m_motionStatePtr.reset(new CustomMotionState(offset));
 		}
 
+		/*
+		* Cuerpo estatico que usa la forma de un terreno sin copiarla. El desplazamiento ubica la forma de Bullet respecto
+		* al origen de la malla, por lo que el cuerpo se alinea con el terreno dibujado.
+		*/
+		RigidBodyComponent(const TerrainShapeInformation& terrainInformation,
+			bool isTrigger = false)
+		{
+			MONA_ASSERT(terrainInformation.m_terrainShape != nullptr, "RigidBodyComponent Error: Terrain shape cannot be null.");
+			const std::shared_ptr<TerrainShape>& terrainShape = terrainInformation.m_terrainShape;
+			//El puntero comparte el conteo de referencias del terreno, que es quien destruye la forma de Bullet
+			m_collisionShapePtr = std::shared_ptr<btCollisionShape>(terrainShape, terrainShape->GetCollisionShape());
+			m_isSharedShape = true;
+			InitializeRigidBody(0.0f, RigidBodyType::StaticBody, isTrigger);
+			m_motionStatePtr.reset(new CustomMotionState(terrainShape->GetShapeOffset()));
+		}
+
 		void SetLocalScaling(const glm::vec3 &scale) {
+			MONA_ASSERT(!m_isSharedShape, "RigidBodyComponent Error: Shared terrain shapes cannot be scaled.");
 			m_collisionShapePtr->setLocalScaling(btVector3(scale.x, scale.y, scale.z));
 		}
 
@@ -305,7 +323,8 @@ namespace Mona {
 			m_rigidBodyPtr->setMotionState(m_motionStatePtr.get());
 		}
 		std::unique_ptr<CustomMotionState> m_motionStatePtr;
-		std::unique_ptr<btCollisionShape> m_collisionShapePtr;
+		std::shared_ptr<btCollisionShape> m_collisionShapePtr;
+		bool m_isSharedShape = false;
 		std::unique_ptr<btRigidBody> m_rigidBodyPtr;
 		StartCollisionCallback m_onStartCollisionCallback;
 		EndCollisionCallback m_onEndCollisionCallback;
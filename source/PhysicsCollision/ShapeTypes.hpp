@@ -2,7 +2,9 @@
 #ifndef SHAPETYPES_HPP
 #define SHAPETYPES_HPP
 #include <glm/glm.hpp>
+#include <memory>
 namespace Mona {
+	class TerrainShape;
 	/*
 	* Enumerador que representa la alineacin de una figura. Por ejemplo, un cono tiene claramente un eje prefencial
 	* este enumerador permite configurar cual es dicho eje.
@@ -50,6 +52,15 @@ namespace Mona {
 		ShapeAlignment m_alignment;
 	};
 
+	/*
+	* Terreno cuya forma de colision se comparte con quien la creo, por ejemplo Mesh::GetTerrainShape, en vez de
+	* construirse una nueva para el cuerpo rigido.
+	*/
+	struct TerrainShapeInformation {
+		TerrainShapeInformation(std::shared_ptr<TerrainShape> terrainShape) : m_terrainShape(terrainShape) {}
+		std::shared_ptr<TerrainShape> m_terrainShape;
+	};
+
 
 
 }
@@ -0,0 +1,84 @@
+#include "TerrainShape.hpp"
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <algorithm>
+#include <limits>
+#include "../Core/Log.hpp"
+
+namespace Mona {
+
+	TerrainShape::TerrainShape(const glm::vec2& minXY, const glm::vec2& maxXY, int samplesX, int samplesY, std::vector<float> heights) noexcept :
+		m_heights(std::move(heights))
+	{
+		MONA_ASSERT(samplesX > 1 && samplesY > 1, "TerrainShape Error: Heightfield needs at least two samples per side.");
+		MONA_ASSERT(m_heights.size() == static_cast<std::size_t>(samplesX) * samplesY, "TerrainShape Error: Wrong number of height samples.");
+		MONA_ASSERT(minXY[0] < maxXY[0] && minXY[1] < maxXY[1], "TerrainShape Error: Invalid heightfield boundaries.");
+		auto heightRange = std::minmax_element(m_heights.begin(), m_heights.end());
+		const float minHeight = *heightRange.first;
+		const float maxHeight = *heightRange.second;
+		//Bullet recorre la grilla con paso 1 y la escala local lleva ese paso al tamano real de cada celda
+		btHeightfieldTerrainShape* heightfield = new btHeightfieldTerrainShape(samplesX, samplesY, m_heights.data(), btScalar(1.0f),
+			btScalar(minHeight), btScalar(maxHeight), 2, PHY_FLOAT, false);
+		heightfield->setLocalScaling(btVector3((maxXY[0] - minXY[0]) / (samplesX - 1), (maxXY[1] - minXY[1]) / (samplesY - 1), 1.0f));
+		m_collisionShape.reset(heightfield);
+		m_minBounds = glm::vec3(minXY, minHeight);
+		m_maxBounds = glm::vec3(maxXY, maxHeight);
+		m_shapeOffset = 0.5f * (m_minBounds + m_maxBounds);
+		m_collisionObject.reset(new btCollisionObject());
+		m_collisionObject->setCollisionShape(m_collisionShape.get());
+		m_collisionObject->setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(m_shapeOffset.x, m_shapeOffset.y, m_shapeOffset.z)));
+	}
+
+	TerrainShape::TerrainShape(std::vector<glm::vec3> positions, std::vector<unsigned int> indices) noexcept :
+		m_positions(std::move(positions)),
+		m_indices(std::move(indices))
+	{
+		MONA_ASSERT(!m_positions.empty() && m_indices.size() >= 3 && m_indices.size() % 3 == 0,
+			"TerrainShape Error: Triangle mesh must have at least one triangle.");
+		m_minBounds = glm::vec3(std::numeric_limits<float>::max());
+		m_maxBounds = glm::vec3(std::numeric_limits<float>::lowest());
+		for (const glm::vec3& position : m_positions) {
+			m_minBounds = glm::min(m_minBounds, position);
+			m_maxBounds = glm::max(m_maxBounds, position);
+		}
+		btIndexedMesh indexedMesh;
+		indexedMesh.m_numTriangles = static_cast<int>(m_indices.size() / 3);
+		indexedMesh.m_triangleIndexBase = reinterpret_cast<const unsigned char*>(m_indices.data());
+		indexedMesh.m_triangleIndexStride = 3 * sizeof(unsigned int);
+		indexedMesh.m_numVertices = static_cast<int>(m_positions.size());
+		indexedMesh.m_vertexBase = reinterpret_cast<const unsigned char*>(m_positions.data());
+		indexedMesh.m_vertexStride = sizeof(glm::vec3);
+		indexedMesh.m_indexType = PHY_INTEGER;
+		indexedMesh.m_vertexType = PHY_FLOAT;
+		m_meshInterface.reset(new btTriangleIndexVertexArray());
+		m_meshInterface->addIndexedMesh(indexedMesh, PHY_INTEGER);
+		//La BVH cuantizada hace que cada rayo cueste O(log n) en la cantidad de triangulos
+		m_collisionShape.reset(new btBvhTriangleMeshShape(m_meshInterface.get(), true, true));
+		m_collisionObject.reset(new btCollisionObject());
+		m_collisionObject->setCollisionShape(m_collisionShape.get());
+	}
+
+	TerrainRayHit TerrainShape::RaycastDown(const glm::vec2& xyPoint) const noexcept {
+		TerrainRayHit result;
+		if (xyPoint[0] < m_minBounds[0] || m_maxBounds[0] < xyPoint[0] || xyPoint[1] < m_minBounds[1] || m_maxBounds[1] < xyPoint[1])
+			return result;
+		const btVector3 rayFrom(xyPoint[0], xyPoint[1], m_maxBounds[2] + TERRAIN_RAY_MARGIN);
+		const btVector3 rayTo(xyPoint[0], xyPoint[1], m_minBounds[2] - TERRAIN_RAY_MARGIN);
+		btCollisionWorld::ClosestRayResultCallback callback(rayFrom, rayTo);
+		btCollisionWorld::rayTestSingle(btTransform(btQuaternion::getIdentity(), rayFrom), btTransform(btQuaternion::getIdentity(), rayTo),
+			m_collisionObject.get(), m_collisionShape.get(), m_collisionObject->getWorldTransform(), callback);
+		if (!callback.hasHit())
+			return result;
+		result.hit = true;
+		result.height = callback.m_hitPointWorld.z();
+		const btVector3& normal = callback.m_hitNormalWorld;
+		//Los triangulos se aceptan por ambas caras, por lo que la normal se orienta siempre hacia arriba
+		result.normal = glm::vec3(normal.x(), normal.y(), normal.z()) * (normal.z() < 0.0f ? -1.0f : 1.0f);
+		return result;
+	}
+
+	void TerrainShape::RaycastDown(const glm::vec2* xyPoints, std::size_t count, TerrainRayHit* outHits) const noexcept {
+		for (std::size_t i = 0; i < count; i++) {
+			outHits[i] = RaycastDown(xyPoints[i]);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef TERRAINSHAPE_HPP
+#define TERRAINSHAPE_HPP
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <btBulletCollisionCommon.h>
+//Margen vertical con que los rayos hacia abajo parten por sobre el terreno y terminan por debajo
+#define TERRAIN_RAY_MARGIN 1.0f
+
+namespace Mona {
+
+	// Resultado de un rayo vertical hacia abajo sobre un terreno, en el espacio local de la malla
+	struct TerrainRayHit {
+		bool hit = false;
+		float height = 0.0f;
+		glm::vec3 normal = glm::vec3(0.0f, 0.0f, 1.0f);
+	};
+
+	/*
+	* Forma de colision de Bullet que representa un terreno con el eje z hacia arriba. Se construye como
+	* btHeightfieldTerrainShape a partir de una grilla regular de alturas, o como btBvhTriangleMeshShape a partir de los
+	* triangulos de cualquier malla. La misma forma responde las consultas de altura y normal de la navegacion de
+	* personajes y puede compartirse con PhysicsCollisionSystem mediante TerrainShapeInformation.
+	* Las consultas no modifican la forma, por lo que pueden hacerse desde varios hilos a la vez.
+	*/
+	class TerrainShape {
+	public:
+		// Grilla de samplesX x samplesY alturas repartidas uniformemente entre minXY y maxXY, con heights[y * samplesX + x]
+		TerrainShape(const glm::vec2& minXY, const glm::vec2& maxXY, int samplesX, int samplesY, std::vector<float> heights) noexcept;
+		// Triangulos arbitrarios, cada tres indices sobre positions forman uno
+		TerrainShape(std::vector<glm::vec3> positions, std::vector<unsigned int> indices) noexcept;
+		TerrainShape(const TerrainShape&) = delete;
+		TerrainShape& operator=(const TerrainShape&) = delete;
+		bool IsHeightfield() const noexcept { return m_meshInterface == nullptr; }
+		const glm::vec3& GetMinBounds() const noexcept { return m_minBounds; }
+		const glm::vec3& GetMaxBounds() const noexcept { return m_maxBounds; }
+		// Rayo vertical que baja por xyPoint. Sin interseccion hit queda en falso
+		TerrainRayHit RaycastDown(const glm::vec2& xyPoint) const noexcept;
+		void RaycastDown(const glm::vec2* xyPoints, std::size_t count, TerrainRayHit* outHits) const noexcept;
+		btCollisionShape* GetCollisionShape() const noexcept { return m_collisionShape.get(); }
+		// Posicion del origen de la forma de Bullet en el espacio local de la malla. btHeightfieldTerrainShape se centra en su caja
+		const glm::vec3& GetShapeOffset() const noexcept { return m_shapeOffset; }
+	private:
+		std::vector<float> m_heights;
+		std::vector<glm::vec3> m_positions;
+		std::vector<unsigned int> m_indices;
+		std::unique_ptr<btTriangleIndexVertexArray> m_meshInterface;
+		std::unique_ptr<btCollisionShape> m_collisionShape;
+		// rayTestSingle necesita un objeto de colision aunque no exista un mundo de Bullet
+		std::unique_ptr<btCollisionObject> m_collisionObject;
+		glm::vec3 m_shapeOffset = glm::vec3(0.0f);
+		glm::vec3 m_minBounds = glm::vec3(0.0f);
+		glm::vec3 m_maxBounds = glm::vec3(0.0f);
+	};
+}
+#endif
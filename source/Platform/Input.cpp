@@ -5,8 +5,36 @@
 #include "../Event/Events.hpp"
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
+#include <bitset>
+#include <fstream>
+#include <vector>
+#define INPUT_RECORDING_MAGIC 0x4352494Du
+#define INPUT_RECORDING_VERSION 1u
 namespace Mona
 {
+	/*
+	* Estado de input de un frame. En el archivo cada frame ocupa un tamano fijo mas dos bytes por tecla presionada:
+	* timeStep(float), posicion del mouse y offset de la rueda (4 doubles), botones del mouse (uint8), cantidad de teclas (uint16)
+	* y los keycodes presionados (uint16 cada uno). Los valores se escriben con el orden de bytes nativo.
+	*/
+	struct InputFrame {
+		float timeStep = 0.0f;
+		glm::dvec2 mousePosition = glm::dvec2(0.0);
+		glm::dvec2 mouseWheelOffset = glm::dvec2(0.0);
+		uint8_t mouseButtons = 0;
+		std::bitset<GLFW_KEY_LAST + 1> keys;
+	};
+
+	template <typename T>
+	static void WriteValue(std::ofstream& file, const T& value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	static bool ReadValue(std::ifstream& file, T& value) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
 	class Input::InputImplementation {
 	public:
 		InputImplementation():m_windowHandle(nullptr), m_mouseWheelOffset(0.0,0.0) {}
@@ -21,28 +49,139 @@ namespace Mona
 		void ShutDown(EventManager& eventManager) noexcept {
 			eventManager.Unsubscribe(m_mouseScrollSubscription);
 		}
-		void Update() noexcept {
+		void Update(float timeStep) noexcept {
 			m_mouseWheelOffset.x = 0.0;
 			m_mouseWheelOffset.y = 0.0;
-			glfwPollEvents();
+			//Aun durante una reproduccion se procesan los eventos de la ventana para que siga respondiendo
+			if (m_windowHandle != nullptr) {
+				glfwPollEvents();
+			}
+			if (m_replaying) {
+				if (m_replayIndex < m_replayFrames.size()) {
+					m_replayFrame = m_replayFrames[m_replayIndex++];
+				}
+				return;
+			}
+			if (m_recordingFile.is_open()) {
+				RecordFrame(timeStep);
+			}
+		}
+
+		bool StartRecording(const std::filesystem::path& path) noexcept {
+			MONA_ASSERT(!m_replaying, "Input Error: Cannot record while replaying");
+			StopRecording();
+			m_recordingFile.open(path, std::ios::binary | std::ios::trunc);
+			if (!m_recordingFile.is_open()) {
+				MONA_LOG_ERROR("Input Error: Failed to open recording file {0}", path.string());
+				return false;
+			}
+			WriteValue(m_recordingFile, INPUT_RECORDING_MAGIC);
+			WriteValue(m_recordingFile, INPUT_RECORDING_VERSION);
+			m_recordedFrames = 0;
+			return true;
 		}
+
+		void StopRecording() noexcept {
+			if (m_recordingFile.is_open()) {
+				m_recordingFile.close();
+				MONA_LOG_INFO("Input: Recorded {0} frames", m_recordedFrames);
+			}
+		}
+
+		bool IsRecording() const noexcept { return m_recordingFile.is_open(); }
+
+		bool StartReplay(const std::filesystem::path& path) noexcept {
+			MONA_ASSERT(!IsRecording(), "Input Error: Cannot replay while recording");
+			std::ifstream file(path, std::ios::binary);
+			uint32_t magic = 0;
+			uint32_t version = 0;
+			if (!file.is_open() || !ReadValue(file, magic) || !ReadValue(file, version) ||
+				magic != INPUT_RECORDING_MAGIC || version != INPUT_RECORDING_VERSION) {
+				MONA_LOG_ERROR("Input Error: {0} is not a valid input recording", path.string());
+				return false;
+			}
+			std::vector<InputFrame> frames;
+			InputFrame frame;
+			while (ReadValue(file, frame.timeStep)) {
+				uint16_t keyCount = 0;
+				bool valid = ReadValue(file, frame.mousePosition.x) && ReadValue(file, frame.mousePosition.y) &&
+					ReadValue(file, frame.mouseWheelOffset.x) && ReadValue(file, frame.mouseWheelOffset.y) &&
+					ReadValue(file, frame.mouseButtons) && ReadValue(file, keyCount);
+				frame.keys.reset();
+				for (uint16_t i = 0; valid && i < keyCount; i++) {
+					uint16_t keycode = 0;
+					valid = ReadValue(file, keycode) && keycode <= GLFW_KEY_LAST;
+					if (valid) {
+						frame.keys.set(keycode);
+					}
+				}
+				if (!valid) {
+					MONA_LOG_ERROR("Input Error: Recording {0} is truncated or corrupted", path.string());
+					return false;
+				}
+				frames.push_back(frame);
+			}
+			if (frames.empty()) {
+				MONA_LOG_WARNING("Input: Recording {0} has no frames", path.string());
+				return false;
+			}
+			m_replayFrames = std::move(frames);
+			m_replayIndex = 0;
+			m_replayFrame = InputFrame();
+			m_replaying = true;
+			return true;
+		}
+
+		bool IsReplaying() const noexcept { return m_replaying; }
+
+		float GetReplayTimeStep() const noexcept {
+			return m_replayFrames[m_replayIndex].timeStep;
+		}
+
+		bool ConsumeReplayFinished() noexcept {
+			if (!m_replaying || m_replayIndex < m_replayFrames.size()) {
+				return false;
+			}
+			//Se consumio el ultimo frame grabado: se vuelve al input del dispositivo
+			MONA_LOG_INFO("Input: Replay finished after {0} frames", m_replayFrames.size());
+			m_replaying = false;
+			m_replayFrames.clear();
+			m_replayIndex = 0;
+			return true;
+		}
+
 		void OnMouseScroll(const MouseScrollEvent& e)
 		{
 			m_mouseWheelOffset = glm::dvec2(e.xOffset, e.yOffset);
 		}
+		//Durante una reproduccion las consultas se responden con el frame grabado, y sin ventana (modo headless) no hay input
 		inline bool IsKeyPressed(int keycode) const noexcept
 		{
-			return glfwGetKey(m_windowHandle, keycode) == GLFW_PRESS;
+			if (m_replaying) {
+				return 0 <= keycode && keycode <= GLFW_KEY_LAST && m_replayFrame.keys.test(keycode);
+			}
+			return m_windowHandle != nullptr && glfwGetKey(m_windowHandle, keycode) == GLFW_PRESS;
 		}
 		inline bool IsMouseButtonPressed(int button) const noexcept {
-			return glfwGetMouseButton(m_windowHandle, button) == GLFW_PRESS;
+			if (m_replaying) {
+				return 0 <= button && button <= GLFW_MOUSE_BUTTON_LAST && (m_replayFrame.mouseButtons & (1u << button)) != 0;
+			}
+			return m_windowHandle != nullptr && glfwGetMouseButton(m_windowHandle, button) == GLFW_PRESS;
 		}
 		inline glm::dvec2 GetMousePosition() const noexcept {
-			double x, y;
-			glfwGetCursorPos(m_windowHandle, &x, &y);
+			if (m_replaying) {
+				return m_replayFrame.mousePosition;
+			}
+			double x = 0.0, y = 0.0;
+			if (m_windowHandle != nullptr) {
+				glfwGetCursorPos(m_windowHandle, &x, &y);
+			}
 			return glm::dvec2(x, y);
 		}
 		inline glm::dvec2 GetMouseWheelOffset() const noexcept {
+			if (m_replaying) {
+				return m_replayFrame.mouseWheelOffset;
+			}
 			return m_mouseWheelOffset;
 		}
 		void SetCursorType(CursorType type) noexcept
@@ -68,18 +207,88 @@ namespace Mona
 			}
 		}
 	private:
+		void RecordFrame(float timeStep) noexcept {
+			WriteValue(m_recordingFile, timeStep);
+			glm::dvec2 mousePosition = GetMousePosition();
+			WriteValue(m_recordingFile, mousePosition.x);
+			WriteValue(m_recordingFile, mousePosition.y);
+			WriteValue(m_recordingFile, m_mouseWheelOffset.x);
+			WriteValue(m_recordingFile, m_mouseWheelOffset.y);
+			uint8_t mouseButtons = 0;
+			for (int button = 0; button <= GLFW_MOUSE_BUTTON_LAST; button++) {
+				if (IsMouseButtonPressed(button)) {
+					mouseButtons |= static_cast<uint8_t>(1u << button);
+				}
+			}
+			WriteValue(m_recordingFile, mouseButtons);
+			m_pressedKeys.clear();
+			for (int keycode = GLFW_KEY_SPACE; keycode <= GLFW_KEY_LAST; keycode++) {
+				if (IsKeyPressed(keycode)) {
+					m_pressedKeys.push_back(static_cast<uint16_t>(keycode));
+				}
+			}
+			WriteValue(m_recordingFile, static_cast<uint16_t>(m_pressedKeys.size()));
+			for (uint16_t keycode : m_pressedKeys) {
+				WriteValue(m_recordingFile, keycode);
+			}
+			m_recordedFrames++;
+		}
+
 		GLFWwindow* m_windowHandle;
 		glm::dvec2 m_mouseWheelOffset;
 		SubscriptionHandle m_mouseScrollSubscription;
+
+		std::ofstream m_recordingFile;
+		uint32_t m_recordedFrames = 0;
+		std::vector<uint16_t> m_pressedKeys;
+		std::vector<InputFrame> m_replayFrames;
+		std::size_t m_replayIndex = 0;
+		InputFrame m_replayFrame;
+		bool m_replaying = false;
 	};
 
 	Input::Input() : p_Impl(std::make_unique<InputImplementation>()) {}
 
 	Input::~Input() = default;
 
-	void Input::Update() noexcept
+	void Input::Update(float timeStep) noexcept
+	{
+		p_Impl->Update(timeStep);
+	}
+
+	bool Input::StartRecording(const std::filesystem::path& path) noexcept
+	{
+		return p_Impl->StartRecording(path);
+	}
+
+	void Input::StopRecording() noexcept
+	{
+		p_Impl->StopRecording();
+	}
+
+	bool Input::IsRecording() const noexcept
+	{
+		return p_Impl->IsRecording();
+	}
+
+	bool Input::StartReplay(const std::filesystem::path& path) noexcept
+	{
+		return p_Impl->StartReplay(path);
+	}
+
+	bool Input::IsReplaying() const noexcept
+	{
+		return p_Impl->IsReplaying();
+	}
+
+	float Input::GetReplayTimeStep() const noexcept
+	{
+		return p_Impl->GetReplayTimeStep();
+	}
+
+	bool Input::ConsumeReplayFinished() noexcept
 	{
-		p_Impl->Update();
+		return p_Impl->ConsumeReplayFinished();
 	}
 
 	bool Input::IsKeyPressed(int keycode) const noexcept
@@ -111,6 +320,7 @@ namespace Mona
 	}
 
 	void Input::ShutDown(EventManager& eventManager) noexcept {
+		p_Impl->StopRecording();
 		p_Impl->ShutDown(eventManager);
 	}
 
@@ -3,6 +3,7 @@
 #define INPUT_HPP
 #include <glm/glm.hpp>
 #include <memory>
+#include <filesystem>
 
 namespace Mona
 {
@@ -47,12 +48,30 @@ namespace Mona
 		* Ajusta el tipo de cursor al tipo entregado
 		*/
 		void SetCursorType(CursorType type) noexcept;
+
+		/*
+		* Graba en path el estado de input y el paso de tiempo de cada frame, para luego reproducir la sesion de forma
+		* determinista con StartReplay. Retorna falso si no se pudo abrir el archivo.
+		*/
+		bool StartRecording(const std::filesystem::path& path) noexcept;
+		void StopRecording() noexcept;
+		bool IsRecording() const noexcept;
+		/*
+		* Reproduce una grabacion: mientras dure, las consultas de input responden con los valores grabados y el mundo
+		* avanza con los pasos de tiempo grabados en vez del reloj. Funciona tambien en mundos headless.
+		*/
+		bool StartReplay(const std::filesystem::path& path) noexcept;
+		bool IsReplaying() const noexcept;
 	private:
 
 		/*
 		* Funcin llamada cada iteracin del motor para actualizar el estado de los eventos de input
 		*/
-		void Update() noexcept;
+		void Update(float timeStep) noexcept;
+		// Paso de tiempo grabado para el siguiente frame, solo valido mientras IsReplaying
+		float GetReplayTimeStep() const noexcept;
+		// Termina la reproduccion si ya se consumio el ultimo frame grabado, retornando verdadero en ese caso
+		bool ConsumeReplayFinished() noexcept;
 		void StartUp(EventManager& eventManager) noexcept;
 		void ShutDown(EventManager& eventManager) noexcept;
 		class InputImplementation;
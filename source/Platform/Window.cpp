@@ -145,6 +145,11 @@ namespace Mona {
 
 	Window::~Window() = default;
 
+	bool Window::IsGraphicsContextCurrent() noexcept
+	{
+		return glfwGetCurrentContext() != nullptr;
+	}
+
 	void Window::StartUp(EventManager& eventManager) noexcept
 	{
 		p_Impl->StartUp(eventManager);
@@ -52,6 +52,12 @@ namespace Mona
 		* 
 		*/
 		void SetWindowDimensions(const glm::ivec2 &dimensions) noexcept;
+
+		/*
+		* Retorna verdadero si el hilo actual tiene un contexto de OpenGL, es decir, si puede crear recursos en GPU.
+		* Los mundos sin ventana no tienen contexto.
+		*/
+		static bool IsGraphicsContextCurrent() noexcept;
 	private:
 		void StartUp(EventManager& eventManager) noexcept;
 		void ShutDown() noexcept;
@@ -7,14 +7,18 @@ namespace Mona {
 	class DiffuseFlatMaterial : public Material {
 	public:
  
-		DiffuseFlatMaterial(const ShaderProgram& shaderProgram, bool isForSkinning) : Material(shaderProgram, isForSkinning), m_diffuseColor(glm::vec3(1.0f)) {}
-		virtual void SetMaterialUniforms(const glm::vec3& cameraPosition) {
-			glUniform3fv(ShaderProgram::DiffuseColorShaderLocation, 1, glm::value_ptr(m_diffuseColor));
-		}
-		const glm::vec3& GetDiffuseColor() const { return m_diffuseColor; }
-		void SetDiffuseColor(const glm::vec3& color) { m_diffuseColor = color; }
+		DiffuseFlatMaterial(const ShaderProgram& shaderProgram, bool isForSkinning) : Material(shaderProgram, isForSkinning, sizeof(Parameters)), m_parameters{ glm::vec3(1.0f), 0.0f } {}
+		const glm::vec3& GetDiffuseColor() const { return m_parameters.diffuseColor; }
+		void SetDiffuseColor(const glm::vec3& color) { m_parameters.diffuseColor = color; MarkParametersDirty(); }
+	protected:
+		virtual const void* GetParametersData() const override { return &m_parameters; }
 	private:
-		glm::vec3 m_diffuseColor;
+		//Layout std140 del bloque MaterialParameters de DiffuseFlat.ps
+		struct Parameters {
+			glm::vec3 diffuseColor;
+			float padding;
+		};
+		Parameters m_parameters;
 	};
 }
 #endif
\ No newline at end of file
@@ -11,23 +11,29 @@ namespace Mona {
 	class DiffuseTexturedMaterial : public Material {
 	public:
 
-		DiffuseTexturedMaterial(const ShaderProgram& shaderProgram, bool isForSkinning) : Material(shaderProgram, isForSkinning), m_diffuseTexture(nullptr), m_materialTint(glm::vec3(1.0f)) {
+		DiffuseTexturedMaterial(const ShaderProgram& shaderProgram, bool isForSkinning) : Material(shaderProgram, isForSkinning, sizeof(Parameters)), m_diffuseTexture(nullptr), m_parameters{ glm::vec3(1.0f), 0.0f } {
 			//Dado que las ubicaiones de las texturas nunca cambian solo se configura al momento de construccin
 			glUseProgram(m_shaderID);
 			glUniform1i(ShaderProgram::DiffuseTextureSamplerShaderLocation, ShaderProgram::DiffuseTextureUnit);
 		}
-		const glm::vec3& GetMaterialTint() const { return m_materialTint; }
-		void SetMaterialTint(const glm::vec3& tint) { m_materialTint = tint; }
+		const glm::vec3& GetMaterialTint() const { return m_parameters.materialTint; }
+		void SetMaterialTint(const glm::vec3& tint) { m_parameters.materialTint = tint; MarkParametersDirty(); }
 		std::shared_ptr<Texture> GetDiffuseTexture() const { return m_diffuseTexture; }
 		void SetDiffuseTexture(std::shared_ptr<Texture> diffuseTexture) { m_diffuseTexture = diffuseTexture; }
-		virtual void SetMaterialUniforms(const glm::vec3& cameraPosition) {
+	protected:
+		virtual const void* GetParametersData() const override { return &m_parameters; }
+		virtual void BindTextures() override {
 			MONA_ASSERT(m_diffuseTexture != nullptr, "Material Error: Texture must be not nullptr for rendering to be posible");
 			glBindTextureUnit(ShaderProgram::DiffuseTextureUnit, m_diffuseTexture->GetID());
-			glUniform3fv(ShaderProgram::MaterialTintShaderLocation, 1, glm::value_ptr(m_materialTint));
 		}
 	private:
+		//Layout std140 del bloque MaterialParameters de DiffuseTextured.ps
+		struct Parameters {
+			glm::vec3 materialTint;
+			float padding;
+		};
 		std::shared_ptr<Texture> m_diffuseTexture;
-		glm::vec3 m_materialTint;
+		Parameters m_parameters;
 	};
 }
 #endif
\ No newline at end of file
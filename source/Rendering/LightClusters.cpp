@@ -0,0 +1,149 @@
+#include "LightClusters.hpp"
+#include <algorithm>
+#include <cmath>
+#include "../Core/JobSystem.hpp"
+#define LIGHT_CLUSTERS_PARALLEL_THRESHOLD 64
+namespace Mona {
+
+	void LightClusters::Clear() noexcept {
+		m_clusters.clear();
+		m_lightIndices.clear();
+	}
+
+	void LightClusters::Build(const glm::mat4& projectionMatrix, const std::vector<LightBounds>& pointLights, const std::vector<LightBounds>& spotLights) noexcept {
+		if (projectionMatrix != m_projectionMatrix) {
+			UpdateClusterBounds(projectionMatrix);
+		}
+		m_clusters.resize(s_clusterCount);
+		//Cada rebanada escribe solo sus propios clusters y su propia lista de indices, asi que no se necesita sincronizacion
+		if (pointLights.size() + spotLights.size() < LIGHT_CLUSTERS_PARALLEL_THRESHOLD) {
+			for (uint32_t slice = 0; slice < LIGHT_CLUSTERS_Z; slice++) {
+				BuildSlice(slice, pointLights, spotLights);
+			}
+		}
+		else {
+			JobSystem::GetInstance().ParallelFor(LIGHT_CLUSTERS_Z, 1, [&](uint32_t begin, uint32_t end) {
+				for (uint32_t slice = begin; slice < end; slice++) {
+					BuildSlice(slice, pointLights, spotLights);
+				}
+			});
+		}
+		//Los offsets de cada rebanada son locales a su lista, se concatenan las listas y se corrigen los offsets
+		m_lightIndices.clear();
+		for (uint32_t slice = 0; slice < LIGHT_CLUSTERS_Z; slice++) {
+			const uint32_t sliceOffset = static_cast<uint32_t>(m_lightIndices.size());
+			const std::vector<uint32_t>& sliceLights = m_sliceScratch[slice].clusterLights;
+			m_lightIndices.insert(m_lightIndices.end(), sliceLights.begin(), sliceLights.end());
+			const uint32_t firstCluster = slice * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+			for (uint32_t c = firstCluster; c < firstCluster + LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y; c++) {
+				m_clusters[c].offset += sliceOffset;
+			}
+		}
+	}
+
+	uint32_t LightClusters::FindCluster(const glm::vec2& ndcPosition, float viewDepth) const noexcept {
+		const int tileX = std::clamp(static_cast<int>(std::floor((ndcPosition.x + 1.0f) * 0.5f * LIGHT_CLUSTERS_X)), 0, LIGHT_CLUSTERS_X - 1);
+		const int tileY = std::clamp(static_cast<int>(std::floor((ndcPosition.y + 1.0f) * 0.5f * LIGHT_CLUSTERS_Y)), 0, LIGHT_CLUSTERS_Y - 1);
+		return tileX + LIGHT_CLUSTERS_X * (tileY + LIGHT_CLUSTERS_Y * GetDepthSlice(viewDepth));
+	}
+
+	void LightClusters::GetClusterBounds(uint32_t cluster, glm::vec3& outMin, glm::vec3& outMax) const noexcept {
+		outMin = glm::vec3(m_minX[cluster], m_minY[cluster], m_minZ[cluster]);
+		outMax = glm::vec3(m_maxX[cluster], m_maxY[cluster], m_maxZ[cluster]);
+	}
+
+	uint32_t LightClusters::GetDepthSlice(float viewDepth) const noexcept {
+		const float slice = std::floor(std::log(std::max(viewDepth, 1e-4f)) * m_depthSliceScale + m_depthSliceBias);
+		return static_cast<uint32_t>(std::clamp(slice, 0.0f, LIGHT_CLUSTERS_Z - 1.0f));
+	}
+
+	void LightClusters::UpdateClusterBounds(const glm::mat4& projectionMatrix) noexcept {
+		//Se asume una proyeccion en perspectiva como la de glm::perspective
+		m_projectionMatrix = projectionMatrix;
+		m_near = projectionMatrix[3][2] / (projectionMatrix[2][2] - 1.0f);
+		m_far = projectionMatrix[3][2] / (projectionMatrix[2][2] + 1.0f);
+		const float logDepthRatio = std::log(m_far / m_near);
+		m_depthSliceScale = LIGHT_CLUSTERS_Z / logDepthRatio;
+		m_depthSliceBias = -LIGHT_CLUSTERS_Z * std::log(m_near) / logDepthRatio;
+		for (uint32_t z = 0; z < LIGHT_CLUSTERS_Z; z++) {
+			const float nearDepth = m_near * std::pow(m_far / m_near, static_cast<float>(z) / LIGHT_CLUSTERS_Z);
+			const float farDepth = m_near * std::pow(m_far / m_near, static_cast<float>(z + 1) / LIGHT_CLUSTERS_Z);
+			for (uint32_t y = 0; y < LIGHT_CLUSTERS_Y; y++) {
+				const float ndcMinY = -1.0f + 2.0f * y / LIGHT_CLUSTERS_Y;
+				const float ndcMaxY = -1.0f + 2.0f * (y + 1) / LIGHT_CLUSTERS_Y;
+				for (uint32_t x = 0; x < LIGHT_CLUSTERS_X; x++) {
+					const float ndcMinX = -1.0f + 2.0f * x / LIGHT_CLUSTERS_X;
+					const float ndcMaxX = -1.0f + 2.0f * (x + 1) / LIGHT_CLUSTERS_X;
+					//Un punto de ndc u a profundidad d esta en x = u * d / P[0][0]; la caja cubre ambos extremos de profundidad
+					const uint32_t c = x + LIGHT_CLUSTERS_X * (y + LIGHT_CLUSTERS_Y * z);
+					m_minX[c] = std::min(ndcMinX * nearDepth, ndcMinX * farDepth) / projectionMatrix[0][0];
+					m_maxX[c] = std::max(ndcMaxX * nearDepth, ndcMaxX * farDepth) / projectionMatrix[0][0];
+					m_minY[c] = std::min(ndcMinY * nearDepth, ndcMinY * farDepth) / projectionMatrix[1][1];
+					m_maxY[c] = std::max(ndcMaxY * nearDepth, ndcMaxY * farDepth) / projectionMatrix[1][1];
+					m_minZ[c] = -farDepth;
+					m_maxZ[c] = -nearDepth;
+				}
+			}
+		}
+	}
+
+	void LightClusters::BuildSlice(uint32_t slice, const std::vector<LightBounds>& pointLights, const std::vector<LightBounds>& spotLights) noexcept {
+		SliceScratch& scratch = m_sliceScratch[slice];
+		const uint32_t firstCluster = slice * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+		scratch.x.clear();
+		scratch.y.clear();
+		scratch.z.clear();
+		scratch.radiusSquared.clear();
+		scratch.lightIndices.clear();
+		scratch.clusterLights.clear();
+		//Las luces candidatas de la rebanada quedan con las puntuales primero, para que cada cluster las liste en ese orden
+		GatherCandidates(slice, pointLights, scratch);
+		const uint32_t spotCandidatesStart = static_cast<uint32_t>(scratch.lightIndices.size());
+		GatherCandidates(slice, spotLights, scratch);
+		const uint32_t candidateCount = static_cast<uint32_t>(scratch.lightIndices.size());
+		scratch.hits.resize(candidateCount);
+		const float* lightX = scratch.x.data();
+		const float* lightY = scratch.y.data();
+		const float* lightZ = scratch.z.data();
+		const float* radiusSquared = scratch.radiusSquared.data();
+		uint8_t* hits = scratch.hits.data();
+		for (uint32_t c = firstCluster; c < firstCluster + LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y; c++) {
+			const float minX = m_minX[c], maxX = m_maxX[c];
+			const float minY = m_minY[c], maxY = m_maxY[c];
+			const float minZ = m_minZ[c], maxZ = m_maxZ[c];
+			//Distancia al cuadrado entre el centro de cada luz y la caja del cluster, sin saltos para que el compilador vectorice
+			for (uint32_t i = 0; i < candidateCount; i++) {
+				const float dx = std::max(std::max(minX - lightX[i], lightX[i] - maxX), 0.0f);
+				const float dy = std::max(std::max(minY - lightY[i], lightY[i] - maxY), 0.0f);
+				const float dz = std::max(std::max(minZ - lightZ[i], lightZ[i] - maxZ), 0.0f);
+				hits[i] = dx * dx + dy * dy + dz * dz <= radiusSquared[i];
+			}
+			Cluster& cluster = m_clusters[c];
+			cluster.offset = static_cast<uint32_t>(scratch.clusterLights.size());
+			for (uint32_t i = 0; i < candidateCount; i++) {
+				if (hits[i]) {
+					scratch.clusterLights.push_back(scratch.lightIndices[i]);
+				}
+			}
+			const uint32_t pointEnd = cluster.offset + static_cast<uint32_t>(std::count(hits, hits + spotCandidatesStart, uint8_t(1)));
+			cluster.pointLightCount = pointEnd - cluster.offset;
+			cluster.spotLightCount = static_cast<uint32_t>(scratch.clusterLights.size()) - pointEnd;
+		}
+	}
+
+	void LightClusters::GatherCandidates(uint32_t slice, const std::vector<LightBounds>& lights, SliceScratch& scratch) noexcept {
+		const uint32_t firstCluster = slice * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+		const float sliceMinZ = m_minZ[firstCluster];
+		const float sliceMaxZ = m_maxZ[firstCluster];
+		for (uint32_t i = 0; i < lights.size(); i++) {
+			const LightBounds& light = lights[i];
+			if (light.viewPosition.z - light.radius <= sliceMaxZ && sliceMinZ <= light.viewPosition.z + light.radius) {
+				scratch.x.push_back(light.viewPosition.x);
+				scratch.y.push_back(light.viewPosition.y);
+				scratch.z.push_back(light.viewPosition.z);
+				scratch.radiusSquared.push_back(light.radius * light.radius);
+				scratch.lightIndices.push_back(i);
+			}
+		}
+	}
+}
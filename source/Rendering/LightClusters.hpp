@@ -0,0 +1,74 @@
+#pragma once
+#ifndef LIGHTCLUSTERS_HPP
+#define LIGHTCLUSTERS_HPP
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+#define LIGHT_CLUSTERS_X 16
+#define LIGHT_CLUSTERS_Y 9
+#define LIGHT_CLUSTERS_Z 24
+namespace Mona {
+	/*
+	* Asigna luces puntuales y spotlights a una grilla de clusters (froxels) en espacio de vista, para que cada fragmento
+	* solo evalue las luces de su cluster. Las rebanadas de profundidad crecen exponencialmente entre los planos near y far.
+	* No usa OpenGL, por lo que puede probarse y medirse sin ventana.
+	*/
+	class LightClusters {
+	public:
+		// Por cada cluster: offset en la lista de indices, cantidad de luces puntuales y de spotlights (en ese orden)
+		struct Cluster {
+			uint32_t offset;
+			uint32_t pointLightCount;
+			uint32_t spotLightCount;
+			uint32_t padding;
+		};
+		// Esfera de influencia de una luz en espacio de vista
+		struct LightBounds {
+			glm::vec3 viewPosition;
+			float radius;
+		};
+		static constexpr uint32_t s_clusterCount = LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z;
+
+		LightClusters() = default;
+		/*
+		* Reconstruye la grilla para una matriz de proyeccion en perspectiva. Las rebanadas de profundidad se reparten
+		* entre hilos del JobSystem cuando hay suficientes luces.
+		*/
+		void Build(const glm::mat4& projectionMatrix, const std::vector<LightBounds>& pointLights, const std::vector<LightBounds>& spotLights) noexcept;
+		void Clear() noexcept;
+		const std::vector<Cluster>& GetClusters() const noexcept { return m_clusters; }
+		const std::vector<uint32_t>& GetLightIndices() const noexcept { return m_lightIndices; }
+		// slice = floor(log(profundidad) * scale + bias), igual que en los shaders
+		float GetDepthSliceScale() const noexcept { return m_depthSliceScale; }
+		float GetDepthSliceBias() const noexcept { return m_depthSliceBias; }
+		// Cluster que contiene un punto dado en coordenadas normalizadas de pantalla ([-1, 1]) y su profundidad de vista
+		uint32_t FindCluster(const glm::vec2& ndcPosition, float viewDepth) const noexcept;
+		// Caja del cluster en espacio de vista, usada por las pruebas para comparar con una asignacion por fuerza bruta
+		void GetClusterBounds(uint32_t cluster, glm::vec3& outMin, glm::vec3& outMax) const noexcept;
+	private:
+		struct SliceScratch {
+			// Luces candidatas de la rebanada en formato SoA, para que la prueba esfera-caja se vectorice
+			std::vector<float> x, y, z, radiusSquared;
+			std::vector<uint32_t> lightIndices;
+			std::vector<uint8_t> hits;
+			std::vector<uint32_t> clusterLights;
+		};
+		void UpdateClusterBounds(const glm::mat4& projectionMatrix) noexcept;
+		uint32_t GetDepthSlice(float viewDepth) const noexcept;
+		void BuildSlice(uint32_t slice, const std::vector<LightBounds>& pointLights, const std::vector<LightBounds>& spotLights) noexcept;
+		void GatherCandidates(uint32_t slice, const std::vector<LightBounds>& lights, SliceScratch& scratch) noexcept;
+
+		glm::mat4 m_projectionMatrix = glm::mat4(0.0f);
+		float m_near = 0.1f;
+		float m_far = 100.0f;
+		float m_depthSliceScale = 0.0f;
+		float m_depthSliceBias = 0.0f;
+		// Cajas de los clusters en espacio de vista, en formato SoA
+		std::array<float, s_clusterCount> m_minX, m_minY, m_minZ, m_maxX, m_maxY, m_maxZ;
+		std::vector<Cluster> m_clusters;
+		std::vector<uint32_t> m_lightIndices;
+		std::array<SliceScratch, LIGHT_CLUSTERS_Z> m_sliceScratch;
+	};
+}
+#endif
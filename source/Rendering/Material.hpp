@@ -1,6 +1,7 @@
 #pragma once
 #ifndef MATERIAL_HPP
 #define MATERIAL_HPP
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glad/glad.h>
@@ -18,28 +19,50 @@ namespace Mona {
 
 	class Material {
 	public:
-		Material(const ShaderProgram& shaderProgram, bool isForSkinning) : m_shaderID(shaderProgram.GetProgramID()), m_isForSkinning(isForSkinning) {}
-		virtual ~Material() = default;
-		void SetUniforms(const glm::mat4& perspectiveMatrix,
-			const glm::mat4& viewMatrix,
-			const glm::mat4& modelMatrix,
-			const glm::vec3& cameraPosition) {
-
-			//Se Configura la informacin compartida por todos los materiales (Matrices y posicion camara).
+		Material(const ShaderProgram& shaderProgram, bool isForSkinning, std::size_t parametersSize = 0) :
+			m_shaderID(shaderProgram.GetProgramID()),
+			m_isForSkinning(isForSkinning),
+			m_parametersSize(parametersSize) {
+			//Cada material guarda sus parametros en su propio uniform buffer, que solo se reescribe cuando cambian.
+			//En mundos sin ventana los shaders no se compilan y no hay contexto en el que crearlo
+			if (0 < parametersSize && m_shaderID != 0) {
+				glCreateBuffers(1, &m_parametersUBO);
+				glNamedBufferData(m_parametersUBO, parametersSize, NULL, GL_DYNAMIC_DRAW);
+			}
+		}
+		Material(const Material&) = delete;
+		Material& operator=(const Material&) = delete;
+		virtual ~Material() {
+			if (m_parametersUBO)
+				glDeleteBuffers(1, &m_parametersUBO);
+		}
+		/*
+		* Activa el programa del material, sube sus parametros si cambiaron desde la ultima vez y enlaza sus texturas.
+		* Las matrices de cada objeto no pasan por el material: el renderer las escribe en el bloque DrawData.
+		*/
+		void Bind() {
 			glUseProgram(m_shaderID);
-			const glm::mat4 mvpMatrix = perspectiveMatrix * viewMatrix * modelMatrix;
-			const glm::mat4 modelInverseTransposeMatrix = glm::transpose(glm::inverse(modelMatrix));
-			glUniformMatrix4fv(ShaderProgram::MvpMatrixShaderLocation, 1, GL_FALSE, glm::value_ptr(mvpMatrix));
-			glUniformMatrix4fv(ShaderProgram::ModelMatrixShaderLocation, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-			glUniformMatrix4fv(ShaderProgram::ModelInverseTransposeMatrixShaderLocation, 1, GL_FALSE, glm::value_ptr(modelInverseTransposeMatrix));
-			//Llamado a funcin virtual que implemental los materiales.
-			SetMaterialUniforms(cameraPosition);
+			if (m_parametersUBO) {
+				if (m_parametersDirty) {
+					glNamedBufferSubData(m_parametersUBO, 0, m_parametersSize, GetParametersData());
+					m_parametersDirty = false;
+				}
+				glBindBufferBase(GL_UNIFORM_BUFFER, ShaderProgram::MaterialUniformBlockBinding, m_parametersUBO);
+			}
+			BindTextures();
 		}
-		virtual void SetMaterialUniforms(const glm::vec3& cameraPosition) = 0;
 		bool IsForSkinning() const { return m_isForSkinning; }
 	protected:
+		// Datos del bloque MaterialParameters del shader, con layout std140 y parametersSize bytes
+		virtual const void* GetParametersData() const { return nullptr; }
+		virtual void BindTextures() {}
+		void MarkParametersDirty() { m_parametersDirty = true; }
 		bool m_isForSkinning;
 		uint32_t m_shaderID;
+	private:
+		unsigned int m_parametersUBO = 0;
+		std::size_t m_parametersSize;
+		bool m_parametersDirty = true;
 	};
 }
 #endif
\ No newline at end of file
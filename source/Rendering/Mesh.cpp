@@ -1,14 +1,30 @@
 #include "Mesh.hpp"
 
 #include "../Core/Log.hpp"
+#include "../Platform/Window.hpp"
 #include "../Core/AssimpTransformations.hpp"
+#include "../Core/FrameAllocator.hpp"
+#include "../Core/JobSystem.hpp"
+#include "../Core/Config.hpp"
+#include "MeshOptimizer.hpp"
 #include <glm/glm.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <vector>
 #include <stack>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <glad/glad.h>
+#define TERRAIN_GENERATION_BATCH_SIZE 16
+#define TERRAIN_LOD_COUNT 5
+#define TERRAIN_LOD_DISTANCE 2.0f
+#define TERRAIN_STITCH_WEST 1u
+#define TERRAIN_STITCH_EAST 2u
+#define TERRAIN_STITCH_SOUTH 4u
+#define TERRAIN_STITCH_NORTH 8u
+#define TERRAIN_STITCH_VARIANTS 16u
 namespace Mona {
 
 	struct MeshVertex {
@@ -31,14 +47,40 @@ namespace Mona {
 		glDeleteBuffers(1, &m_indexBufferID);
 		glDeleteVertexArrays(1, &m_vertexArrayID);
 		m_vertexArrayID = 0;
+		m_memoryAccount.Reset();
 	}
 
-	Mesh::Mesh(const std::string& filePath, bool flipUVs) :
+	struct Mesh::FileData {
+		std::vector<MeshVertex> vertices;
+		std::vector<CompressedMeshVertex> compressedVertices;
+		std::vector<unsigned int> faces;
+		std::vector<MeshLOD> lods;
+		std::vector<glm::vec3> terrainPositions;
+		std::vector<unsigned int> terrainIndices;
+		std::string filePath;
+		bool flipUVs = false;
+		PositionQuantization positionQuantization;
+		glm::vec3 boundingSphereCenter = glm::vec3(0.0f);
+		float boundingSphereRadius = 0.0f;
+	};
+
+	Mesh::Mesh() :
 		m_vertexArrayID(0),
 		m_vertexBufferID(0),
 		m_indexBufferID(0),
 		m_indexBufferCount(0)
 	{
+	}
+
+	Mesh::Mesh(const std::string& filePath, bool flipUVs) : Mesh()
+	{
+		Upload(*ReadFile(filePath, flipUVs));
+	}
+
+	std::shared_ptr<Mesh::FileData> Mesh::ReadFile(const std::string& filePath, bool flipUVs, bool keepTerrainData) noexcept {
+		std::shared_ptr<FileData> data = std::make_shared<FileData>();
+		data->filePath = filePath;
+		data->flipUVs = flipUVs;
 		Assimp::Importer importer;
 		unsigned int postProcessFlags = flipUVs ? aiProcess_FlipUVs : 0;
 		postProcessFlags |= aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_GenUVCoords | aiProcess_CalcTangentSpace;
@@ -49,11 +91,11 @@ namespace Mona {
 		if (!scene) {
 			//En caso de fallar la carga se envia un mensaje de error.
 			MONA_LOG_ERROR("Mesh Error: Failed to open file with path {0}", filePath);
-			return;
+			return data;
 		}
 
-		std::vector<MeshVertex> vertices;
-		std::vector<unsigned int> faces;
+		std::vector<MeshVertex>& vertices = data->vertices;
+		std::vector<unsigned int>& faces = data->faces;
 		size_t numVertices = 0;
 		size_t numFaces = 0;
 		//El primer paso consiste en contar el numero de vertices y caras totales
@@ -131,17 +173,87 @@ namespace Mona {
 			}
 		}
 
+		//Se unen los vertices repetidos y se reordenan triangulos y vertices para la cache de la GPU y para reducir overdraw
+		OptimizeMesh(vertices, faces);
+		if (!vertices.empty()) {
+			//Los indices de los niveles de detalle quedan a continuacion de los del nivel 0
+			ComputeBoundingSphere(&vertices[0].position.x, sizeof(MeshVertex), vertices.size(), data->boundingSphereCenter, data->boundingSphereRadius);
+			data->lods = GenerateMeshLODChain(faces, &vertices[0].position.x, sizeof(MeshVertex), vertices.size());
+		}
+		keepTerrainData = keepTerrainData || Config::GetInstance().getValueOrDefault<int>("keep_mesh_terrain_data", 0) != 0;
+		if (keepTerrainData && !vertices.empty()) {
+			//Copia del nivel de detalle 0 para construir la forma de terreno sin leer la GPU
+			const size_t lodIndexOffset = data->lods.empty() ? 0 : data->lods[0].indexOffset;
+			const size_t lodIndexCount = data->lods.empty() ? faces.size() : data->lods[0].indexCount;
+			data->terrainPositions.resize(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++) {
+				data->terrainPositions[i] = vertices[i].position;
+			}
+			data->terrainIndices.assign(faces.begin() + lodIndexOffset, faces.begin() + lodIndexOffset + lodIndexCount);
+		}
+		const bool compressVertices = Config::GetInstance().getValueOrDefault<int>("compress_mesh_vertices", 0) != 0;
+		if (compressVertices && !vertices.empty()) {
+			data->positionQuantization = ComputePositionQuantization(&vertices[0].position.x, sizeof(MeshVertex), vertices.size());
+			data->compressedVertices.resize(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++) {
+				const MeshVertex& vertex = vertices[i];
+				CompressVertex(vertex.position, vertex.normal, vertex.uv, vertex.tangent, vertex.bitangent, data->positionQuantization, data->compressedVertices[i]);
+			}
+			vertices.clear();
+		}
+		return data;
+	}
+
+	void Mesh::Upload(FileData& data) noexcept {
+		const std::vector<unsigned int>& faces = data.faces;
+		//Un archivo que no se pudo leer deja la malla vacia
+		if (faces.empty())
+			return;
+		m_lods = data.lods;
+		m_boundingSphereCenter = data.boundingSphereCenter;
+		m_boundingSphereRadius = data.boundingSphereRadius;
+		{
+			std::lock_guard<std::mutex> lock(m_terrainShapeMutex);
+			m_filePath = data.filePath;
+			m_flipUVs = data.flipUVs;
+			m_terrainPositions = std::move(data.terrainPositions);
+			m_terrainIndices = std::move(data.terrainIndices);
+		}
+		const size_t terrainDataBytes = m_terrainPositions.size() * sizeof(glm::vec3) + m_terrainIndices.size() * sizeof(unsigned int);
+		m_memoryAccount.Set(terrainDataBytes, 0);
+
 		//Comienza el paso de los datos en CPU a GPU usando OpenGL
-		m_indexBufferCount = static_cast<uint32_t>(faces.size());
+		m_indexBufferCount = m_lods.empty() ? static_cast<uint32_t>(faces.size()) : m_lods[0].indexCount;
+		if (!Window::IsGraphicsContextCurrent())
+			return;
 		glGenVertexArrays(1, &m_vertexArrayID);
 		glBindVertexArray(m_vertexArrayID);
 
 		glGenBuffers(1, &m_vertexBufferID);
 		glGenBuffers(1, &m_indexBufferID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferID);
-		glBufferData(GL_ARRAY_BUFFER, static_cast<unsigned int>(vertices.size()) * sizeof(MeshVertex), vertices.data(), GL_STATIC_DRAW);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBufferID);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<unsigned int>(faces.size()) * sizeof(unsigned int), faces.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferID);
+		if (!data.compressedVertices.empty()) {
+			const std::vector<CompressedMeshVertex>& compressedVertices = data.compressedVertices;
+			m_compressedVertices = true;
+			m_positionQuantization = data.positionQuantization;
+			glBufferData(GL_ARRAY_BUFFER, static_cast<unsigned int>(compressedVertices.size()) * sizeof(CompressedMeshVertex), compressedVertices.data(), GL_STATIC_DRAW);
+			m_memoryAccount.Set(terrainDataBytes, compressedVertices.size() * sizeof(CompressedMeshVertex) + faces.size() * sizeof(unsigned int));
+			//La bitangente (atributo 4) la reconstruye el shader a partir de la normal y la tangente
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, sizeof(CompressedMeshVertex), (void*)offsetof(CompressedMeshVertex, position));
+			glEnableVertexAttribArray(1);
+			glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(CompressedMeshVertex), (void*)offsetof(CompressedMeshVertex, normal));
+			glEnableVertexAttribArray(2);
+			glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompressedMeshVertex), (void*)offsetof(CompressedMeshVertex, uv));
+			glEnableVertexAttribArray(3);
+			glVertexAttribPointer(3, 3, GL_SHORT, GL_TRUE, sizeof(CompressedMeshVertex), (void*)offsetof(CompressedMeshVertex, tangent));
+			return;
+		}
+		const std::vector<MeshVertex>& vertices = data.vertices;
+		glBufferData(GL_ARRAY_BUFFER, static_cast<unsigned int>(vertices.size()) * sizeof(MeshVertex), vertices.data(), GL_STATIC_DRAW);
+		m_memoryAccount.Set(terrainDataBytes, vertices.size() * sizeof(MeshVertex) + faces.size() * sizeof(unsigned int));
 		//Un vertice de la malla se ve como
 		// v = {pos_x, pos_y, pos_z, normal_x, normal_y, normal_z, uv_u, uv_v, tangent_x, tangent_y, tangent_z}
 		glEnableVertexAttribArray(0);
@@ -157,12 +269,61 @@ namespace Mona {
 
 	}
 
+	std::shared_ptr<TerrainShape> Mesh::GetTerrainShape() noexcept {
+		std::lock_guard<std::mutex> lock(m_terrainShapeMutex);
+		if (m_terrainShape != nullptr || m_terrainShapeFailed)
+			return m_terrainShape;
+		if (m_terrainPositions.empty()) {
+			//Sin datos puede que una carga asincrona aun no termine, en cuyo caso se vuelve a intentar en el siguiente pedido
+			if (m_indexBufferCount == 0)
+				return nullptr;
+			if (m_filePath.empty()) {
+				MONA_LOG_WARNING("Mesh: Mesh has no CPU data to build a terrain shape from.");
+				m_terrainShapeFailed = true;
+				return nullptr;
+			}
+			//Las mallas que no conservaron su copia en CPU vuelven a leer el archivo, lo que da los mismos vertices e indices
+			std::shared_ptr<FileData> data = ReadFile(m_filePath, m_flipUVs, true);
+			m_terrainPositions = std::move(data->terrainPositions);
+			m_terrainIndices = std::move(data->terrainIndices);
+			if (m_terrainPositions.empty()) {
+				MONA_LOG_ERROR("Mesh: Could not read {0} again to build its terrain shape.", m_filePath);
+				m_terrainShapeFailed = true;
+				return nullptr;
+			}
+		}
+		for (unsigned int index : m_terrainIndices) {
+			if (index >= m_terrainPositions.size()) {
+				MONA_LOG_ERROR("Mesh: Index buffer references missing vertices, terrain shape was not created.");
+				m_terrainShapeFailed = true;
+				return nullptr;
+			}
+		}
+		m_terrainShape = std::make_shared<TerrainShape>(std::move(m_terrainPositions), std::move(m_terrainIndices));
+		m_terrainPositions.clear();
+		m_terrainIndices.clear();
+		m_memoryAccount.Set(0, m_memoryAccount.GetGPUBytes());
+		m_heightMap = HeightMap(m_terrainShape);
+		return m_terrainShape;
+	}
+
+	void Mesh::StorePrimitiveTerrainData(const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) noexcept {
+		m_terrainPositions.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++) {
+			m_terrainPositions[i] = glm::vec3(vertices[14 * i], vertices[14 * i + 1], vertices[14 * i + 2]);
+		}
+		m_terrainIndices.assign(indices, indices + indexCount);
+	}
+
 	Mesh::Mesh(PrimitiveType type) :
 		m_vertexArrayID(0),
 		m_vertexBufferID(0),
 		m_indexBufferID(0),
 		m_indexBufferCount(0)
 	{
+		//Sin contexto grafico las primitivas no tienen datos que conservar
+		if (!Window::IsGraphicsContextCurrent())
+			return;
 		switch (type)
 		{
 		case Mona::Mesh::PrimitiveType::Plane:
@@ -228,123 +389,158 @@ namespace Mona {
 		else { return 0; }
 	}
 
+	//Indices locales (dentro del bloque de vertices de un chunk) de un nivel de detalle. stitchMask indica los lados
+	//cuyo vecino usa el nivel siguiente: en esos lados los vertices impares del nivel se mueven al vertice par anterior,
+	//de modo que el borde coincide con el del vecino y no quedan grietas. Los triangulos degenerados se descartan.
+	static void GenerateTerrainChunkIndices(uint32_t lod, uint32_t stitchMask, std::vector<unsigned int>& outIndices) {
+		const int step = 1 << lod;
+		const int quads = TERRAIN_CHUNK_QUADS;
+		auto index = [&](int i, int j) -> unsigned int {
+			if ((j == 0 && (stitchMask & TERRAIN_STITCH_SOUTH)) || (j == quads && (stitchMask & TERRAIN_STITCH_NORTH))) {
+				i -= (i / step) % 2 == 1 ? step : 0;
+			}
+			if ((i == 0 && (stitchMask & TERRAIN_STITCH_WEST)) || (i == quads && (stitchMask & TERRAIN_STITCH_EAST))) {
+				j -= (j / step) % 2 == 1 ? step : 0;
+			}
+			return static_cast<unsigned int>(i * (quads + 1) + j);
+		};
+		auto addTriangle = [&](unsigned int a, unsigned int b, unsigned int c) {
+			if (a != b && b != c && a != c) {
+				outIndices.insert(outIndices.end(), { a, b, c });
+			}
+		};
+		for (int i = 0; i < quads; i += step) {
+			for (int j = 0; j < quads; j += step) {
+				unsigned int isw = index(i, j);
+				unsigned int ise = index(i + step, j);
+				unsigned int ine = index(i + step, j + step);
+				unsigned int inw = index(i, j + step);
+				addTriangle(isw, ise, ine);
+				addTriangle(ine, inw, isw);
+			}
+		}
+	}
+
 	Mesh::Mesh(const glm::vec2& minXY, const glm::vec2& maxXY, int numInnerVerticesWidth, int numInnerVerticesHeight,
-		float (*heightFunc)(float, float)) :
+		std::shared_ptr<HeightSource> heightSource) :
 		m_vertexArrayID(0),
 		m_vertexBufferID(0),
 		m_indexBufferID(0),
 		m_indexBufferCount(0)
 	{
+		//El terreno se divide en chunks de TERRAIN_CHUNK_QUADS x TERRAIN_CHUNK_QUADS celdas, cada uno con su propio bloque de
+		//vertices. Todos los chunks comparten los mismos buffers de indices por nivel de detalle, y se dibujan con baseVertex.
+		//Los chunks del final que quedan incompletos repiten los vertices del borde del terreno (generan triangulos de area 0).
 		//Un vertice de la malla se ve como
 		// v = {pos_x, pos_y, pos_z, normal_x, normal_y, normal_z, uv_u, uv_v, tangent_x, tangent_y, tangent_z}
-		std::vector<float> vertices;
-		std::vector<unsigned int> faces;
-		size_t numVertices = 0;
-		size_t numFaces = 0;
-
-		float stepX = (maxXY[0] - minXY[0]) / (numInnerVerticesWidth + 1);
-		float stepY = (maxXY[1] - minXY[1]) / (numInnerVerticesHeight + 1);
-		for (int i = 0; i < numInnerVerticesWidth + 2; i++) {
-			float x = minXY[0] + stepX * i;
-			for (int j = 0; j < numInnerVerticesHeight + 2; j++) {
-				float y = minXY[1] + stepY * j;
-				float z = heightFunc(x, y);
-				numVertices += 1;
-				vertices.insert(vertices.end(), { x, y, z, 0, 0, 0, 0, 0, 0, 0, 0 }); // falta rellenar valores
-			}
-		}
-
-		// indexing func
-		auto index = [&](int i, int j)
-		{
-			return i * (numInnerVerticesHeight + 2) + j;
-		};
-
-		// We generate quads for each cell connecting 4 neighbor vertices
-		for (int i = 0; i < numInnerVerticesWidth + 1; i++) {
-			for (int j = 0; j < numInnerVerticesHeight + 1; j++) {
-				// Getting indices for all vertices in this quad
-				unsigned int isw = index(i, j);
-				unsigned int ise = index(i + 1, j);
-				unsigned int ine = index(i + 1, j + 1);
-				unsigned int inw = index(i, j + 1);
-
-				numFaces += 2;
-				faces.insert(faces.end(), { isw, ise, ine, ine, inw, isw }); // falta rellenar las normales
-			}
-		}
-		std::vector<glm::vec3> vertexPositions;
-		std::vector<glm::vec3> groupedFaces;
-		std::unordered_map<int, std::vector<glm::vec3>> oneFacePerVertex;
-		vertexPositions.reserve(numVertices);
-		oneFacePerVertex.reserve(numVertices);
-		groupedFaces.reserve(faces.size());
-		for (int i = 0; i < vertices.size(); i += 11) {
-			glm::vec3 v(vertices[i], vertices[i + 1], vertices[i + 2]);
-			vertexPositions.push_back(v);
+		const int quadsX = numInnerVerticesWidth + 1;
+		const int quadsY = numInnerVerticesHeight + 1;
+		const int gridHeight = quadsY + 1;
+		const float stepX = (maxXY[0] - minXY[0]) / quadsX;
+		const float stepY = (maxXY[1] - minXY[1]) / quadsY;
+		m_terrainChunksX = static_cast<uint32_t>((quadsX + TERRAIN_CHUNK_QUADS - 1) / TERRAIN_CHUNK_QUADS);
+		m_terrainChunksY = static_cast<uint32_t>((quadsY + TERRAIN_CHUNK_QUADS - 1) / TERRAIN_CHUNK_QUADS);
+		m_terrainChunkSize = TERRAIN_CHUNK_QUADS * std::max(std::abs(stepX), std::abs(stepY));
+		const uint32_t chunkCount = m_terrainChunksX * m_terrainChunksY;
+		const uint32_t chunkVertexCount = (TERRAIN_CHUNK_QUADS + 1) * (TERRAIN_CHUNK_QUADS + 1);
+
+		//La fuente se evalua desde varios hilos, una columna completa de la grilla por llamada
+		JobSystem& jobSystem = JobSystem::GetInstance();
+		std::vector<float> heights(static_cast<size_t>(quadsX + 1) * gridHeight);
+		std::vector<float> columnYs(gridHeight);
+		for (int j = 0; j < gridHeight; j++) {
+			columnYs[j] = minXY[1] + stepY * j;
 		}
-		for (int i = 0; i < faces.size(); i += 3) {
-			glm::vec3 v1 = vertexPositions[faces[i]];
-			glm::vec3 v2 = vertexPositions[faces[i + 1]];
-			glm::vec3 v3 = vertexPositions[faces[i + 2]];
-			glm::vec3 f = { faces[i], faces[i + 1], faces[i + 2] };
-			int orientation = orientationTest(v1, v2, v3, 0.00001f);
-			if (orientation == -1) {
-				f = { faces[i + 1], faces[i], faces[i + 2] };
+		jobSystem.ParallelFor(static_cast<uint32_t>(quadsX + 1), TERRAIN_GENERATION_BATCH_SIZE, [&](uint32_t begin, uint32_t end) {
+			std::vector<float> columnXs(gridHeight);
+			for (uint32_t i = begin; i < end; i++) {
+				std::fill(columnXs.begin(), columnXs.end(), minXY[0] + stepX * i);
+				heightSource->evaluateHeights(columnXs.data(), columnYs.data(), gridHeight, &heights[i * gridHeight]);
 			}
-			groupedFaces.push_back(f);
-			// Guardamos una cara por cada vertice para extraer normales y tangentes
-			if (oneFacePerVertex[faces[i]].empty()) {
-				oneFacePerVertex[faces[i]].push_back(vertexPositions[faces[i]]);
-				oneFacePerVertex[faces[i]].push_back(vertexPositions[faces[i + 1]]);
-				oneFacePerVertex[faces[i]].push_back(vertexPositions[faces[i + 2]]);
-			}
-			if (oneFacePerVertex[faces[i + 1]].empty()) {
-				oneFacePerVertex[faces[i + 1]].push_back(vertexPositions[faces[i]]);
-				oneFacePerVertex[faces[i + 1]].push_back(vertexPositions[faces[i + 1]]);
-				oneFacePerVertex[faces[i + 1]].push_back(vertexPositions[faces[i + 2]]);
+		});
+
+		//Las normales y tangentes salen de diferencias centrales sobre la grilla, asi los vertices repetidos en los bordes
+		//de chunks vecinos quedan identicos
+		std::vector<float> vertices(static_cast<size_t>(chunkCount) * chunkVertexCount * 11);
+		m_terrainChunks.resize(chunkCount);
+		jobSystem.ParallelFor(chunkCount, 1, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t chunkIndex = begin; chunkIndex < end; chunkIndex++) {
+				const int chunkX = static_cast<int>(chunkIndex / m_terrainChunksY);
+				const int chunkY = static_cast<int>(chunkIndex % m_terrainChunksY);
+				float minZ = std::numeric_limits<float>::max();
+				float maxZ = std::numeric_limits<float>::lowest();
+				float* vertex = &vertices[static_cast<size_t>(chunkIndex) * chunkVertexCount * 11];
+				for (int i = 0; i <= TERRAIN_CHUNK_QUADS; i++) {
+					const int gi = std::min(chunkX * TERRAIN_CHUNK_QUADS + i, quadsX);
+					const int left = std::max(gi - 1, 0);
+					const int right = std::min(gi + 1, quadsX);
+					for (int j = 0; j <= TERRAIN_CHUNK_QUADS; j++, vertex += 11) {
+						const int gj = std::min(chunkY * TERRAIN_CHUNK_QUADS + j, quadsY);
+						const int down = std::max(gj - 1, 0);
+						const int up = std::min(gj + 1, quadsY);
+						const float z = heights[gi * gridHeight + gj];
+						const float dzdx = (heights[right * gridHeight + gj] - heights[left * gridHeight + gj]) / (stepX * (right - left));
+						const float dzdy = (heights[gi * gridHeight + up] - heights[gi * gridHeight + down]) / (stepY * (up - down));
+						const glm::vec3 normal = glm::normalize(glm::vec3(-dzdx, -dzdy, 1.0f));
+						const glm::vec3 tangent = glm::normalize(glm::vec3(1.0f, 0.0f, dzdx));
+						vertex[0] = minXY[0] + stepX * gi;
+						vertex[1] = minXY[1] + stepY * gj;
+						vertex[2] = z;
+						vertex[3] = normal[0];
+						vertex[4] = normal[1];
+						vertex[5] = normal[2];
+						vertex[6] = 0.0f;
+						vertex[7] = 0.0f;
+						vertex[8] = tangent[0];
+						vertex[9] = tangent[1];
+						vertex[10] = tangent[2];
+						minZ = std::min(minZ, z);
+						maxZ = std::max(maxZ, z);
+					}
+				}
+				TerrainChunk& chunk = m_terrainChunks[chunkIndex];
+				const float centerI = std::min(chunkX * TERRAIN_CHUNK_QUADS + TERRAIN_CHUNK_QUADS * 0.5f, quadsX * 1.0f);
+				const float centerJ = std::min(chunkY * TERRAIN_CHUNK_QUADS + TERRAIN_CHUNK_QUADS * 0.5f, quadsY * 1.0f);
+				chunk.center = glm::vec3(minXY[0] + stepX * centerI, minXY[1] + stepY * centerJ, (minZ + maxZ) * 0.5f);
+				chunk.baseVertex = static_cast<int32_t>(chunkIndex * chunkVertexCount);
 			}
-			if (oneFacePerVertex[faces[i + 2]].empty()) {
-				oneFacePerVertex[faces[i + 2]].push_back(vertexPositions[faces[i]]);
-				oneFacePerVertex[faces[i + 2]].push_back(vertexPositions[faces[i + 1]]);
-				oneFacePerVertex[faces[i + 2]].push_back(vertexPositions[faces[i + 2]]);
+		});
+
+		std::vector<unsigned int> faces;
+		m_terrainLODRanges.resize(TERRAIN_LOD_COUNT * TERRAIN_STITCH_VARIANTS);
+		for (uint32_t lod = 0; lod < TERRAIN_LOD_COUNT; lod++) {
+			for (uint32_t stitchMask = 0; stitchMask < TERRAIN_STITCH_VARIANTS; stitchMask++) {
+				TerrainChunkDraw& range = m_terrainLODRanges[lod * TERRAIN_STITCH_VARIANTS + stitchMask];
+				range.indexOffset = static_cast<uint32_t>(faces.size());
+				GenerateTerrainChunkIndices(lod, stitchMask, faces);
+				range.indexCount = static_cast<uint32_t>(faces.size()) - range.indexOffset;
 			}
 		}
 
-		// Rellenar valores faltantes en vertices
-		for (int i = 0; i < vertices.size(); i += 11) {
-			int vertexIndex = i / 11;
-			glm::vec3 v1 = oneFacePerVertex[vertexIndex][0];
-			glm::vec3 v2 = oneFacePerVertex[vertexIndex][1];
-			glm::vec3 v3 = oneFacePerVertex[vertexIndex][2];
-			glm::vec3 normal = glm::normalize(glm::cross((v2 - v1), (v3 - v1)));
-			vertices[i + 3] = normal[0];
-			vertices[i + 4] = normal[1];
-			vertices[i + 5] = normal[2];
-			// uv
-			vertices[i + 6] = 0.0f;
-			vertices[i + 7] = 0.0f;
-			glm::vec3 tangent = glm::normalize(v2 - v1);
-			vertices[i + 8] = tangent[0];
-			vertices[i + 9] = tangent[1];
-			vertices[i + 10] = tangent[2];
+		m_heightMap = HeightMap({ minXY[0], minXY[1] }, { maxXY[0], maxXY[1] }, heightSource);
+		//El heightfield de Bullet guarda las alturas por filas de y, al reves que la grilla de generacion
+		std::vector<float> heightfield(heights.size());
+		for (int i = 0; i <= quadsX; i++) {
+			for (int j = 0; j < gridHeight; j++) {
+				heightfield[static_cast<size_t>(j) * (quadsX + 1) + i] = heights[i * gridHeight + j];
+			}
 		}
-
-		m_heightMap = HeightMap({ minXY[0], minXY[1] }, { maxXY[0], maxXY[1] }, heightFunc);
+		m_terrainShape = std::make_shared<TerrainShape>(minXY, maxXY, quadsX + 1, gridHeight, std::move(heightfield));
 
 		//Comienza el paso de los datos en CPU a GPU usando OpenGL
-		m_indexBufferCount = static_cast<uint32_t>(faces.size());
+		m_indexBufferCount = m_terrainLODRanges[0].indexCount * chunkCount;
+		if (!Window::IsGraphicsContextCurrent())
+			return;
 		glGenVertexArrays(1, &m_vertexArrayID);
 		glBindVertexArray(m_vertexArrayID);
 
 		glGenBuffers(1, &m_vertexBufferID);
 		glGenBuffers(1, &m_indexBufferID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferID);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * static_cast<unsigned int>(vertices.size()), vertices.data(), GL_STATIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBufferID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * static_cast<unsigned int>(faces.size()), faces.data(), GL_STATIC_DRAW);
-		//Un vertice de la malla se ve como
-		// v = {pos_x, pos_y, pos_z, normal_x, normal_y, normal_z, uv_u, uv_v, tangent_x, tangent_y, tangent_z}
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * faces.size(), faces.data(), GL_STATIC_DRAW);
+		m_memoryAccount.Set(0, vertices.size() * sizeof(float) + faces.size() * sizeof(unsigned int));
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)0);
 		glEnableVertexAttribArray(1);
@@ -358,6 +554,57 @@ namespace Mona {
 
 	}
 
+	void Mesh::SelectTerrainLODs(const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, std::vector<TerrainChunkDraw>& outDraws) const noexcept {
+		//El nivel sube en uno cada vez que la distancia a la camara se duplica desde TERRAIN_LOD_DISTANCE chunks
+		const float maxScale = std::max({ glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2])) });
+		const float lodDistance = TERRAIN_LOD_DISTANCE * m_terrainChunkSize * maxScale;
+		const uint32_t chunkCount = static_cast<uint32_t>(m_terrainChunks.size());
+		FrameVector<uint8_t> lods(chunkCount);
+		for (uint32_t i = 0; i < chunkCount; i++) {
+			const float distance = glm::length(glm::vec3(modelMatrix * glm::vec4(m_terrainChunks[i].center, 1.0f)) - cameraPosition);
+			int lod = distance < lodDistance ? 0 : 1 + static_cast<int>(std::log2(distance / lodDistance));
+			lods[i] = static_cast<uint8_t>(std::min(lod, TERRAIN_LOD_COUNT - 1));
+		}
+		//Los vecinos pueden diferir en a lo mas un nivel para que las variantes de borde alcancen. Solo se baja el nivel de
+		//los chunks, asi que el ciclo termina en a lo mas TERRAIN_LOD_COUNT pasadas.
+		auto neighbor = [this](uint32_t chunkIndex, int dx, int dy) -> int64_t {
+			int64_t x = chunkIndex / m_terrainChunksY + dx;
+			int64_t y = chunkIndex % m_terrainChunksY + dy;
+			if (x < 0 || y < 0 || m_terrainChunksX <= x || m_terrainChunksY <= y) {
+				return -1;
+			}
+			return x * m_terrainChunksY + y;
+		};
+		const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+		bool changed = true;
+		while (changed) {
+			changed = false;
+			for (uint32_t i = 0; i < chunkCount; i++) {
+				for (const auto& offset : offsets) {
+					int64_t n = neighbor(i, offset[0], offset[1]);
+					if (0 <= n && lods[n] + 1 < lods[i]) {
+						lods[i] = lods[n] + 1;
+						changed = true;
+					}
+				}
+			}
+		}
+		outDraws.reserve(outDraws.size() + chunkCount);
+		for (uint32_t i = 0; i < chunkCount; i++) {
+			uint32_t stitchMask = 0;
+			const uint32_t sides[4] = { TERRAIN_STITCH_WEST, TERRAIN_STITCH_EAST, TERRAIN_STITCH_SOUTH, TERRAIN_STITCH_NORTH };
+			for (int side = 0; side < 4; side++) {
+				int64_t n = neighbor(i, offsets[side][0], offsets[side][1]);
+				if (0 <= n && lods[i] < lods[n]) {
+					stitchMask |= sides[side];
+				}
+			}
+			TerrainChunkDraw draw = m_terrainLODRanges[lods[i] * TERRAIN_STITCH_VARIANTS + stitchMask];
+			draw.baseVertex = m_terrainChunks[i].baseVertex;
+			outDraws.push_back(draw);
+		}
+	}
+
 	void Mesh::CreateCube() noexcept {
 		// Cada vertice tiene la siguiente forma
 		// v = {p_x, p_y, p_z, n_x, n_y, n_z, uv_u, uv_v, t_x, t_y, t_z, b_x, b_y, b_z};
@@ -422,6 +669,7 @@ namespace Mona {
 		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeIBO);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+		m_memoryAccount.Set(0, sizeof(vertices) + sizeof(indices));
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), (void*)0);
 		glEnableVertexAttribArray(1);
@@ -436,6 +684,7 @@ namespace Mona {
 		m_vertexBufferID = cubeVBO;
 		m_indexBufferID = cubeIBO;
 		m_indexBufferCount = 36;
+		StorePrimitiveTerrainData(vertices, 36, indices, 36);
 	}
 
 	void Mesh::CreatePlane() noexcept {
@@ -465,6 +714,7 @@ namespace Mona {
 		glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, planeIBO);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(planeIndices), planeIndices, GL_STATIC_DRAW);
+		m_memoryAccount.Set(0, sizeof(planeVertices) + sizeof(planeIndices));
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), (void*)0);
 		glEnableVertexAttribArray(1);
@@ -479,6 +729,7 @@ namespace Mona {
 		m_vertexBufferID = planeVBO;
 		m_indexBufferID = planeIBO;
 		m_indexBufferCount = 6;
+		StorePrimitiveTerrainData(planeVertices, 6, planeIndices, 6);
 	}
 
 	void Mesh::CreateSphere() noexcept {
@@ -577,6 +828,7 @@ namespace Mona {
 		glBufferData(GL_ARRAY_BUFFER, static_cast<unsigned int>(vertices.size()) * sizeof(float), vertices.data(), GL_STATIC_DRAW);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereIBO);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<unsigned int>(indices.size()) * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+		m_memoryAccount.Set(0, (vertices.size() + indices.size()) * sizeof(float));
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 14 * sizeof(float), (void*)0);
 		glEnableVertexAttribArray(1);
@@ -591,6 +843,7 @@ namespace Mona {
 		m_vertexBufferID = sphereVBO;
 		m_indexBufferID = sphereIBO;
 		m_indexBufferCount = static_cast<uint32_t>(indices.size());
+		StorePrimitiveTerrainData(vertices.data(), vertices.size() / 14, indices.data(), indices.size());
 	}
 
 }
\ No newline at end of file
@@ -2,9 +2,18 @@
 #ifndef MESH_HPP
 #define MESH_HPP
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include "../CharacterNavigation/HeightMap.hpp"
+#include "../PhysicsCollision/TerrainShape.hpp"
+#include "../Core/MemoryTracker.hpp"
+#include "VertexCompression.hpp"
+#include "MeshLOD.hpp"
+//Celdas por lado de cada chunk de terreno. Debe ser potencia de dos para que todos los niveles de detalle calcen
+#define TERRAIN_CHUNK_QUADS 32
 
 namespace Mona {
 	class Mesh {
@@ -17,18 +26,57 @@ namespace Mona {
 			Sphere,
 			PrimitiveCount
 		};
+		// Rango del buffer de indices y vertice base con que se dibuja un chunk de terreno
+		struct TerrainChunkDraw {
+			uint32_t indexOffset = 0;
+			uint32_t indexCount = 0;
+			int32_t baseVertex = 0;
+		};
 		~Mesh();
 		uint32_t GetVertexArrayID() const noexcept { return m_vertexArrayID; }
+		bool IsTerrain() const noexcept { return !m_terrainChunks.empty(); }
+		uint32_t GetTerrainChunkCount() const noexcept { return static_cast<uint32_t>(m_terrainChunks.size()); }
+		/*
+		* Elige el nivel de detalle de cada chunk del terreno segun su distancia a cameraPosition y agrega a outDraws los
+		* llamados de dibujo correspondientes. Los bordes entre chunks de distinto nivel se cosen para que no queden grietas.
+		*/
+		void SelectTerrainLODs(const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, std::vector<TerrainChunkDraw>& outDraws) const noexcept;
 		uint32_t GetIndexBufferCount() const noexcept { return m_indexBufferCount; }
+		// Verdadero si los vertices usan CompressedMeshVertex, activado con compress_mesh_vertices en config.cfg
+		bool HasCompressedVertices() const noexcept { return m_compressedVertices; }
+		const PositionQuantization& GetPositionQuantization() const noexcept { return m_positionQuantization; }
+		// Niveles de detalle de mallas cargadas desde archivo, vacio para primitivas y terrenos. Todos comparten los vertices
+		const std::vector<MeshLOD>& GetLODs() const noexcept { return m_lods; }
+		// Esfera que contiene la malla en espacio local, usada para medir su tamano en pantalla
+		const glm::vec3& GetBoundingSphereCenter() const noexcept { return m_boundingSphereCenter; }
+		float GetBoundingSphereRadius() const noexcept { return m_boundingSphereRadius; }
 		HeightMap* GetHeightMap() {
 			return &m_heightMap;
 		}
+		/*
+		* Forma de colision de la malla como terreno. Los terrenos generados usan un heightfield de su grilla de alturas y el
+		* resto de las mallas una BVH de triangulos del nivel de detalle 0, construida la primera vez que se pide. Las mallas
+		* cargadas desde archivo no guardan una copia en CPU salvo con keep_mesh_terrain_data en config.cfg, por lo que el
+		* primer pedido vuelve a leer el archivo. No usa OpenGL, por lo que sirve tambien en mundos sin ventana, y puede
+		* llamarse desde varios hilos. Si la malla no tiene fuente de alturas, desde ese momento su HeightMap responde consultas
+		* usando esta forma. Devuelve nullptr mientras una carga asincrona no termina o si no hay datos para construirla.
+		*/
+		std::shared_ptr<TerrainShape> GetTerrainShape() noexcept;
 	private:
+		Mesh();
 		Mesh(const std::string& filePath, bool flipUVs = false);
 		Mesh(PrimitiveType type);
 		Mesh(const glm::vec2& minXY, const glm::vec2& maxXY, int numInnerVerticesWidth, int numInnerVerticesHeight,
-			float (*heightFunc)(float, float));
+			std::shared_ptr<HeightSource> heightSource);
 
+		// Vertices e indices leidos y optimizados en CPU, listos para subirse a la GPU
+		struct FileData;
+		// Solo usa CPU, por lo que puede llamarse desde cualquier hilo. keepTerrainData conserva la copia para GetTerrainShape
+		static std::shared_ptr<FileData> ReadFile(const std::string& filePath, bool flipUVs, bool keepTerrainData = false) noexcept;
+		// Mueve la copia en CPU para el terreno fuera de data
+		void Upload(FileData& data) noexcept;
+		// Guarda las posiciones de una primitiva, cuyos vertices tienen 14 floats con la posicion al inicio
+		void StorePrimitiveTerrainData(const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) noexcept;
 		void ClearData() noexcept;
 		void CreateSphere() noexcept;
 		void CreateCube() noexcept;
@@ -39,6 +87,34 @@ namespace Mona {
 		uint32_t m_indexBufferID;
 		uint32_t m_indexBufferCount;
 		HeightMap m_heightMap;
+		std::shared_ptr<TerrainShape> m_terrainShape;
+		// Posiciones e indices del nivel de detalle 0, que pasan a la forma de terreno cuando esta se construye
+		std::vector<glm::vec3> m_terrainPositions;
+		std::vector<unsigned int> m_terrainIndices;
+		// Archivo de origen, para leer de nuevo los vertices cuando se pide la forma de terreno
+		std::string m_filePath;
+		bool m_flipUVs = false;
+		// Evita reintentar cuando los datos de la malla no sirven para construir la forma
+		bool m_terrainShapeFailed = false;
+		// Varios mundos pueden pedir la forma de la misma malla a la vez
+		std::mutex m_terrainShapeMutex;
+		bool m_compressedVertices = false;
+		PositionQuantization m_positionQuantization;
+		std::vector<MeshLOD> m_lods;
+		glm::vec3 m_boundingSphereCenter = glm::vec3(0.0f);
+		float m_boundingSphereRadius = 0.0f;
+
+		struct TerrainChunk {
+			glm::vec3 center;
+			int32_t baseVertex;
+		};
+		std::vector<TerrainChunk> m_terrainChunks;
+		// Un rango por nivel de detalle y combinacion de lados cosidos, compartido por todos los chunks
+		std::vector<TerrainChunkDraw> m_terrainLODRanges;
+		uint32_t m_terrainChunksX = 0;
+		uint32_t m_terrainChunksY = 0;
+		float m_terrainChunkSize = 0.0f;
+		MemoryAccount m_memoryAccount{ MemoryTag::Meshes };
 	};
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "MeshLOD.hpp"
+#include "MeshOptimizer.hpp"
+#include <algorithm>
+#include <limits>
+//Triangulos minimos para que valga la pena generar otro nivel
+#define MESH_LOD_MIN_TRIANGLES 32
+//Un nivel que conserva mas que esta fraccion de los indices del anterior no se agrega
+#define MESH_LOD_MIN_REDUCTION 0.85f
+
+namespace Mona {
+
+	std::vector<MeshLOD> GenerateMeshLODChain(std::vector<unsigned int>& indices, const float* positions, std::size_t positionStride,
+		std::size_t vertexCount, const std::vector<uint32_t>& collapseGroups) noexcept {
+		std::vector<MeshLOD> lods;
+		lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.0f });
+		//Cada nivel se simplifica desde el original, asi el error de todos se mide contra la misma superficie
+		const std::vector<unsigned int> baseIndices = indices;
+		std::size_t previousIndexCount = baseIndices.size();
+		for (uint32_t level = 1; level < MESH_LOD_COUNT; level++) {
+			const std::size_t targetIndexCount = (baseIndices.size() >> level) / 3 * 3;
+			if (targetIndexCount < 3 * MESH_LOD_MIN_TRIANGLES)
+				break;
+			std::vector<unsigned int> lodIndices = baseIndices;
+			const float error = SimplifyMesh(lodIndices, positions, positionStride, vertexCount, targetIndexCount, MESH_LOD_MAX_ERROR, collapseGroups);
+			if (lodIndices.empty() || static_cast<float>(lodIndices.size()) > MESH_LOD_MIN_REDUCTION * static_cast<float>(previousIndexCount))
+				break;
+			OptimizeVertexCache(lodIndices, vertexCount);
+			lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lodIndices.size()), std::max(error, lods.back().error) });
+			indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+			previousIndexCount = lodIndices.size();
+		}
+		return lods;
+	}
+
+	float ComputeScreenSize(const glm::mat4& modelMatrix, const glm::vec3& center, float radius, const glm::mat4& viewMatrix,
+		const glm::mat4& projectionMatrix) noexcept {
+		const float scale = std::max({ glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2])) });
+		const float worldRadius = radius * scale;
+		const float distance = glm::length(glm::vec3(viewMatrix * modelMatrix * glm::vec4(center, 1.0f)));
+		//Con la camara dentro de la esfera la malla cubre toda la pantalla
+		if (distance <= worldRadius)
+			return std::numeric_limits<float>::max();
+		return worldRadius * projectionMatrix[1][1] / distance;
+	}
+
+	uint32_t SelectMeshLOD(const std::vector<MeshLOD>& lods, float screenSize, uint32_t currentLOD) noexcept {
+		if (lods.empty())
+			return 0;
+		auto fits = [&](uint32_t lod, float margin) { return lods[lod].error * screenSize <= MESH_LOD_SCREEN_ERROR * margin; };
+		uint32_t lod = std::min(currentLOD, static_cast<uint32_t>(lods.size()) - 1);
+		//Se pasa a un nivel mas fino solo al superar el umbral por el margen, y a uno mas simple solo al quedar bajo el
+		while (lod > 0 && !fits(lod, 1.0f + MESH_LOD_HYSTERESIS))
+			lod--;
+		while (lod + 1 < lods.size() && fits(lod + 1, 1.0f - MESH_LOD_HYSTERESIS))
+			lod++;
+		return lod;
+	}
+}
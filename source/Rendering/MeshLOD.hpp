@@ -0,0 +1,40 @@
+#pragma once
+#ifndef MESHLOD_HPP
+#define MESHLOD_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+//Cantidad maxima de niveles de detalle por malla, incluyendo la original. Cada nivel tiene la mitad de triangulos que el anterior
+#define MESH_LOD_COUNT 4
+//Error maximo de simplificacion, relativo al radio de la malla
+#define MESH_LOD_MAX_ERROR 0.1f
+//Error proyectado tolerado, como fraccion de la mitad de la altura de la pantalla (cerca de un pixel a 1080p)
+#define MESH_LOD_SCREEN_ERROR 0.002f
+//Margen relativo alrededor del umbral para no alternar entre niveles cuando la malla esta justo en el borde
+#define MESH_LOD_HYSTERESIS 0.2f
+
+namespace Mona {
+	// Rango del buffer de indices de un nivel de detalle y su error de simplificacion relativo al radio de la malla
+	struct MeshLOD {
+		uint32_t indexOffset = 0;
+		uint32_t indexCount = 0;
+		float error = 0.0f;
+	};
+
+	/*
+	* Genera la cadena de niveles de detalle de una malla ya optimizada. Al entrar indices contiene el nivel 0 y al salir
+	* contiene todos los niveles uno tras otro, referenciando los mismos vertices. La generacion se detiene antes de
+	* MESH_LOD_COUNT niveles si la malla ya no puede simplificarse sin superar MESH_LOD_MAX_ERROR.
+	*/
+	std::vector<MeshLOD> GenerateMeshLODChain(std::vector<unsigned int>& indices, const float* positions, std::size_t positionStride,
+		std::size_t vertexCount, const std::vector<uint32_t>& collapseGroups = {}) noexcept;
+
+	// Radio proyectado de la esfera como fraccion de la mitad de la altura de la pantalla
+	float ComputeScreenSize(const glm::mat4& modelMatrix, const glm::vec3& center, float radius, const glm::mat4& viewMatrix,
+		const glm::mat4& projectionMatrix) noexcept;
+
+	// Nivel mas simple cuyo error proyectado es tolerable, partiendo del nivel usado en el frame anterior
+	uint32_t SelectMeshLOD(const std::vector<MeshLOD>& lods, float screenSize, uint32_t currentLOD) noexcept;
+}
+#endif
@@ -1,5 +1,8 @@
 #include "MeshManager.hpp"
+#include <atomic>
 #include "../Animation/SkinnedMesh.hpp"
+#include "../Platform/Window.hpp"
+#include "../Core/Log.hpp"
 namespace Mona {
 	
 	std::string PrimitiveEnumToString(Mesh::PrimitiveType type) {
@@ -20,50 +23,97 @@ namespace Mona {
 		}
 	}
 
+	//Una malla cargada desde un mundo sin ventana no tiene datos en GPU, por lo que un hilo con contexto grafico
+	//debe volver a cargarla
+	template <typename MeshType>
+	static bool IsUsableFromCurrentThread(const MeshType& mesh) {
+		return mesh.GetVertexArrayID() != 0 || !Window::IsGraphicsContextCurrent();
+	}
+
 	std::shared_ptr<Mesh> MeshManager::GenerateTerrain(const glm::vec2& minXY, const glm::vec2& maxXY,
 		int numInnerVerticesWidth, int numInnerVerticesHeight, float (*heightFunc)(float, float)) noexcept {
-		std::srand(std::time(nullptr)); // use current time as seed for random generator
-		int random_variable = std::rand();
-		const std::string& id = std::to_string(random_variable);
-		Mesh* meshPtr = new Mesh(minXY, maxXY, numInnerVerticesWidth, numInnerVerticesHeight, heightFunc);
+		return GenerateTerrain(minXY, maxXY, numInnerVerticesWidth, numInnerVerticesHeight, std::make_shared<FunctionHeightSource>(heightFunc));
+	}
+
+	std::shared_ptr<Mesh> MeshManager::GenerateTerrain(const glm::vec2& minXY, const glm::vec2& maxXY,
+		int numInnerVerticesWidth, int numInnerVerticesHeight, std::shared_ptr<HeightSource> heightSource) noexcept {
+		MONA_ASSERT(heightSource != nullptr, "MeshManager Error: Height source cannot be null.");
+		//Cada terreno generado es unico, por lo que se identifica con un contador en vez de un numero aleatorio
+		//que puede repetirse entre mundos que generan terrenos al mismo tiempo
+		static std::atomic<uint32_t> terrainCount = 0;
+		const std::string id = "Terrain" + std::to_string(terrainCount.fetch_add(1, std::memory_order_relaxed));
+		Mesh* meshPtr = new Mesh(minXY, maxXY, numInnerVerticesWidth, numInnerVerticesHeight, heightSource);
 		std::shared_ptr<Mesh> sharedPtr = std::shared_ptr<Mesh>(meshPtr);
 		//Antes de retornar la malla recien cargada, insertamos esta al mapa para que cargas futuras sean mucho mas rapidas.
+		std::lock_guard<std::mutex> lock(m_mutex);
 		m_meshMap.insert({ id, sharedPtr });
 		return sharedPtr;
 	}
 
 	std::shared_ptr<Mesh> MeshManager::LoadMesh(Mesh::PrimitiveType type) noexcept
 	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 		const std::string primName = PrimitiveEnumToString(type);
 		auto it = m_meshMap.find(primName);
-		if (it != m_meshMap.end())
+		if (it != m_meshMap.end() && IsUsableFromCurrentThread(*it->second))
 		{
 			return it->second;
 		}
 		Mesh* meshPtr = new Mesh(type);
 		std::shared_ptr<Mesh> sharedPtr = std::shared_ptr<Mesh>(meshPtr);
 		//Antes de retornar la malla recien cargada, insertamos esta al mapa para que cargas futuras sean mucho mas rapidas.
-		m_meshMap.insert({ primName, sharedPtr });
+		m_meshMap.insert_or_assign(primName, sharedPtr);
 		return sharedPtr;
 	}
 
 	std::shared_ptr<Mesh> MeshManager::LoadMesh(const std::filesystem::path& filePath, bool flipUVs) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		const std::string& stringPath = filePath.string();
 		//En caso de que ya exista una entrada en el mapa de mallas con el mismo path, entonces se retorna inmediatamente
 		//dicha malla.
 		auto it = m_meshMap.find(stringPath);
-		if (it != m_meshMap.end()) {
+		if (it != m_meshMap.end() && IsUsableFromCurrentThread(*it->second)) {
 			return it->second;
 		}
 		Mesh* meshPtr = new Mesh(stringPath, flipUVs);
 		std::shared_ptr<Mesh> sharedPtr = std::shared_ptr<Mesh>(meshPtr);
 		//Antes de retornar la malla recien cargada, insertamos esta al mapa para que cargas futuras sean mucho mas rapidas.
-		m_meshMap.insert({ stringPath, sharedPtr });
+		m_meshMap.insert_or_assign(stringPath, sharedPtr);
 		return sharedPtr;
 
 	}
 
+	AssetFuture<Mesh> MeshManager::LoadMeshAsync(const std::filesystem::path& filePath, bool flipUVs) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const std::string stringPath = filePath.string();
+		auto it = m_meshMap.find(stringPath);
+		if (it != m_meshMap.end() && IsUsableFromCurrentThread(*it->second)) {
+			return AssetFuture<Mesh>(it->second);
+		}
+		//Una carga pendiente ya completa no se subio porque su mundo se cerro antes, por lo que se vuelve a cargar
+		auto pendingIt = m_pendingMeshes.find(stringPath);
+		if (pendingIt != m_pendingMeshes.end() && !pendingIt->second.IsReady()) {
+			return pendingIt->second;
+		}
+		//La malla vacia no se dibuja hasta que termine su subida
+		std::shared_ptr<Mesh> mesh = std::shared_ptr<Mesh>(new Mesh());
+		auto future = AssetLoader::GetInstance().Load<Mesh>([this, mesh, stringPath, flipUVs](AssetLoader::UploadTask& outUpload) {
+			std::shared_ptr<Mesh::FileData> data = Mesh::ReadFile(stringPath, flipUVs);
+			outUpload = [this, mesh, stringPath, data]() {
+				mesh->Upload(*data);
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pendingMeshes.erase(stringPath);
+				m_meshMap.insert_or_assign(stringPath, mesh);
+			};
+			return mesh;
+		});
+		AssetFuture<Mesh> result(future, mesh);
+		m_pendingMeshes.insert_or_assign(stringPath, result);
+		return result;
+	}
+
 	void MeshManager::CleanUnusedMeshes() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
 		/*
 		* Elimina todos los punteros del mapa de mallas cuyo conteo de referencias es igual a uno,
 		* es decir, que el puntero del mapa es el unico que apunta a esa memoria.
@@ -94,32 +144,38 @@ namespace Mona {
 		}
 	}
 	void MeshManager::ShutDown() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		//Las mallas creadas sin contexto grafico no tienen datos en GPU
 		for (auto& entry : m_meshMap) {
-			entry.second->ClearData();
+			if (entry.second->GetVertexArrayID())
+				entry.second->ClearData();
 		}
 
 		for (auto& entry : m_skinnedMeshMap) {
-			entry.second->ClearData();
+			if (entry.second->GetVertexArrayID())
+				entry.second->ClearData();
 		}
 
 		m_meshMap.clear();
+		m_pendingMeshes.clear();
 	}
 
 	std::shared_ptr<SkinnedMesh> MeshManager::LoadSkinnedMesh(std::shared_ptr<Skeleton> skeleton,
 		const std::filesystem::path& filePath,
 		bool flipUVs) noexcept 
 	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 		const std::string& stringPath = filePath.string();
 		//En caso de que ya exista una entrada en el mapa de mallas para animaci�n con el mismo path, 
 		// entonces se retorna inmediatamente dicha malla.
 		auto it = m_skinnedMeshMap.find(stringPath);
-		if (it != m_skinnedMeshMap.end()) {
+		if (it != m_skinnedMeshMap.end() && IsUsableFromCurrentThread(*it->second)) {
 			return it->second;
 		}
 		SkinnedMesh* meshPtr = new SkinnedMesh(skeleton, stringPath, flipUVs);
 		std::shared_ptr<SkinnedMesh> sharedPtr = std::shared_ptr<SkinnedMesh>(meshPtr);
 		//Antes de retornar la malla recien cargada, insertamos esta al mapa para que cargas futuras sean mucho mas rapidas.
-		m_skinnedMeshMap.insert({ stringPath, sharedPtr });
+		m_skinnedMeshMap.insert_or_assign(stringPath, sharedPtr);
 		return sharedPtr;
 
 	}
@@ -3,8 +3,10 @@
 #define MESHMANAGER_HPP
 #include <memory>
 #include <filesystem>
+#include <mutex>
 #include <unordered_map>
 #include "Mesh.hpp"
+#include "../Core/AssetLoader.hpp"
 namespace Mona {
 
 	class SkinnedMesh;
@@ -18,8 +20,12 @@ namespace Mona {
 		MeshManager& operator=(MeshManager const&) = delete;
 		std::shared_ptr<Mesh> LoadMesh(Mesh::PrimitiveType type) noexcept;
 		std::shared_ptr<Mesh> LoadMesh(const std::filesystem::path& filePath, bool flipUVs = false) noexcept;
+		// Igual que LoadMesh, pero el archivo se lee y optimiza en un worker y se sube a la GPU en un frame posterior
+		AssetFuture<Mesh> LoadMeshAsync(const std::filesystem::path& filePath, bool flipUVs = false) noexcept;
 		std::shared_ptr<Mesh> GenerateTerrain(const glm::vec2& minXY, const glm::vec2& maxXY, int numInnerVerticesWidth, int numInnerVerticesHeight,
 			float (*heightFunc)(float, float)) noexcept;
+		std::shared_ptr<Mesh> GenerateTerrain(const glm::vec2& minXY, const glm::vec2& maxXY, int numInnerVerticesWidth, int numInnerVerticesHeight,
+			std::shared_ptr<HeightSource> heightSource) noexcept;
 		std::shared_ptr<SkinnedMesh> LoadSkinnedMesh(std::shared_ptr<Skeleton> skeleton,
 			const std::filesystem::path& filePath,
 			bool flipUVs = false) noexcept;
@@ -31,7 +37,11 @@ namespace Mona {
 	private:
 		MeshManager() = default;
 		void ShutDown() noexcept;
+		// Las cargas y limpiezas pueden llamarse desde varios mundos en hilos distintos
+		std::mutex m_mutex;
 		MeshMap m_meshMap;
+		// Cargas asincronas en curso, para no leer dos veces el mismo archivo
+		std::unordered_map<std::string, AssetFuture<Mesh>> m_pendingMeshes;
 		SkinnedMeshMap m_skinnedMeshMap;
 
 	};
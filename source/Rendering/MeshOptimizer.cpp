@@ -0,0 +1,470 @@
+#include "MeshOptimizer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace Mona {
+
+	static constexpr uint32_t s_invalidIndex = std::numeric_limits<uint32_t>::max();
+
+	static uint64_t HashVertex(const unsigned char* vertex, std::size_t vertexSize) {
+		//FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (std::size_t i = 0; i < vertexSize; i++) {
+			hash ^= vertex[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::size_t WeldVertices(void* vertices, std::size_t vertexCount, std::size_t vertexSize, std::vector<unsigned int>& indices) noexcept {
+		if (vertexCount == 0)
+			return 0;
+		unsigned char* data = static_cast<unsigned char*>(vertices);
+		//Tabla hash con direccionamiento abierto que guarda el indice (ya compactado) del primer vertice de cada valor
+		std::size_t tableSize = 1;
+		while (tableSize < 2 * vertexCount)
+			tableSize *= 2;
+		std::vector<uint32_t> table(tableSize, s_invalidIndex);
+		std::vector<uint32_t> remap(vertexCount);
+		uint32_t uniqueCount = 0;
+		for (std::size_t v = 0; v < vertexCount; v++) {
+			const unsigned char* vertex = data + v * vertexSize;
+			std::size_t slot = HashVertex(vertex, vertexSize) & (tableSize - 1);
+			while (table[slot] != s_invalidIndex && std::memcmp(data + table[slot] * vertexSize, vertex, vertexSize) != 0)
+				slot = (slot + 1) & (tableSize - 1);
+			if (table[slot] == s_invalidIndex) {
+				//Los vertices unicos se compactan al principio del arreglo conservando su orden
+				if (uniqueCount != v)
+					std::memcpy(data + uniqueCount * vertexSize, vertex, vertexSize);
+				table[slot] = uniqueCount++;
+			}
+			remap[v] = table[slot];
+		}
+		for (auto& index : indices)
+			index = remap[index];
+		return uniqueCount;
+	}
+
+	void OptimizeVertexCache(std::vector<unsigned int>& indices, std::size_t vertexCount, uint32_t cacheSize) noexcept {
+		const std::size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0 || vertexCount == 0)
+			return;
+		//Adyacencia vertice -> triangulos en formato compacto
+		std::vector<uint32_t> liveTriangles(vertexCount, 0);
+		for (auto index : indices)
+			liveTriangles[index]++;
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (std::size_t v = 0; v < vertexCount; v++)
+			adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+		std::vector<uint32_t> adjacency(indices.size());
+		std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (std::size_t t = 0; t < triangleCount; t++) {
+			for (std::size_t k = 0; k < 3; k++)
+				adjacency[fillOffsets[indices[3 * t + k]]++] = static_cast<uint32_t>(t);
+		}
+
+		std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32_t> deadEndStack;
+		deadEndStack.reserve(indices.size());
+		std::vector<uint32_t> candidates;
+		std::vector<unsigned int> result;
+		result.reserve(indices.size());
+		uint32_t time = cacheSize + 1;
+		std::size_t cursor = 0;
+		uint32_t fanningVertex = indices[0];
+		while (fanningVertex != s_invalidIndex) {
+			//Se emiten todos los triangulos vivos alrededor del vertice actual
+			candidates.clear();
+			for (uint32_t a = adjacencyOffsets[fanningVertex]; a < adjacencyOffsets[fanningVertex + 1]; a++) {
+				const uint32_t t = adjacency[a];
+				if (emitted[t])
+					continue;
+				for (std::size_t k = 0; k < 3; k++) {
+					const uint32_t v = indices[3 * t + k];
+					result.push_back(v);
+					deadEndStack.push_back(v);
+					candidates.push_back(v);
+					liveTriangles[v]--;
+					if (time - cacheTimestamps[v] > cacheSize)
+						cacheTimestamps[v] = time++;
+				}
+				emitted[t] = true;
+			}
+
+			//El siguiente vertice es el vecino que sigue en cache y al que le quedan triangulos, preferiendo el mas antiguo
+			uint32_t nextVertex = s_invalidIndex;
+			int64_t bestPriority = -1;
+			for (auto v : candidates) {
+				if (liveTriangles[v] == 0)
+					continue;
+				int64_t priority = 0;
+				if (time - cacheTimestamps[v] + 2 * liveTriangles[v] <= cacheSize)
+					priority = time - cacheTimestamps[v];
+				if (priority > bestPriority) {
+					bestPriority = priority;
+					nextVertex = v;
+				}
+			}
+			if (nextVertex == s_invalidIndex) {
+				//Callejon sin salida: se vuelve a un vertice reciente con triangulos o, si no hay, al siguiente en orden
+				while (!deadEndStack.empty() && nextVertex == s_invalidIndex) {
+					const uint32_t v = deadEndStack.back();
+					deadEndStack.pop_back();
+					if (liveTriangles[v] > 0)
+						nextVertex = v;
+				}
+				while (cursor < vertexCount && nextVertex == s_invalidIndex) {
+					if (liveTriangles[cursor] > 0)
+						nextVertex = static_cast<uint32_t>(cursor);
+					cursor++;
+				}
+			}
+			fanningVertex = nextVertex;
+		}
+		indices.swap(result);
+	}
+
+	void OptimizeOverdraw(std::vector<unsigned int>& indices, const float* positions, std::size_t positionStride, std::size_t vertexCount,
+		float threshold, uint32_t cacheSize) noexcept {
+		const std::size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0 || vertexCount == 0)
+			return;
+		auto getPosition = [&](uint32_t v) {
+			const float* p = reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(positions) + v * positionStride);
+			return glm::vec3(p[0], p[1], p[2]);
+		};
+
+		//Simulacion de la cache FIFO. Reiniciarla equivale a adelantar el tiempo mas alla del tamano de la cache
+		std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+		uint32_t time = cacheSize + 1;
+		auto triangleMisses = [&](std::size_t t) {
+			uint32_t misses = 0;
+			for (std::size_t k = 0; k < 3; k++) {
+				const uint32_t v = indices[3 * t + k];
+				if (time - cacheTimestamps[v] > cacheSize) {
+					cacheTimestamps[v] = time++;
+					misses++;
+				}
+			}
+			return misses;
+		};
+
+		//Los cortes duros estan donde la cache se vacia por completo (triangulo con sus tres vertices fuera de cache)
+		//El primer triangulo siempre abre un grupo, aunque sea degenerado y no tenga tres vertices distintos
+		std::vector<std::size_t> hardBoundaries;
+		for (std::size_t t = 0; t < triangleCount; t++) {
+			if (triangleMisses(t) == 3 || t == 0)
+				hardBoundaries.push_back(t);
+		}
+		hardBoundaries.push_back(triangleCount);
+
+		//Cada grupo duro se corta de nuevo apenas su ACMR local alcanza threshold veces el del grupo completo
+		std::vector<std::size_t> clusterStarts;
+		for (std::size_t h = 0; h + 1 < hardBoundaries.size(); h++) {
+			const std::size_t begin = hardBoundaries[h];
+			const std::size_t end = hardBoundaries[h + 1];
+			time += cacheSize + 1;
+			uint32_t clusterMisses = 0;
+			for (std::size_t t = begin; t < end; t++)
+				clusterMisses += triangleMisses(t);
+			const float clusterACMR = static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+			time += cacheSize + 1;
+			std::size_t subBegin = begin;
+			uint32_t subMisses = 0;
+			clusterStarts.push_back(begin);
+			for (std::size_t t = begin; t < end; t++) {
+				subMisses += triangleMisses(t);
+				const float subACMR = static_cast<float>(subMisses) / static_cast<float>(t + 1 - subBegin);
+				if (t + 1 < end && subACMR <= clusterACMR * threshold) {
+					clusterStarts.push_back(t + 1);
+					subBegin = t + 1;
+					subMisses = 0;
+					time += cacheSize + 1;
+				}
+			}
+		}
+		clusterStarts.push_back(triangleCount);
+
+		//Se dibujan primero los grupos que miran hacia afuera del centro de la malla, porque suelen tapar a los otros
+		const std::size_t clusterCount = clusterStarts.size() - 1;
+		std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+		std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+		glm::vec3 meshCentroid(0.0f);
+		float meshArea = 0.0f;
+		for (std::size_t c = 0; c < clusterCount; c++) {
+			float clusterArea = 0.0f;
+			for (std::size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+				const glm::vec3 p0 = getPosition(indices[3 * t]);
+				const glm::vec3 p1 = getPosition(indices[3 * t + 1]);
+				const glm::vec3 p2 = getPosition(indices[3 * t + 2]);
+				const glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+				const float area = glm::length(areaNormal);
+				const glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+				clusterCentroids[c] += centroid * area;
+				clusterNormals[c] += areaNormal;
+				meshCentroid += centroid * area;
+				clusterArea += area;
+			}
+			meshArea += clusterArea;
+			clusterCentroids[c] = clusterArea > 0.0f ? clusterCentroids[c] / clusterArea : getPosition(indices[3 * clusterStarts[c]]);
+			const float normalLength = glm::length(clusterNormals[c]);
+			clusterNormals[c] = normalLength > 0.0f ? clusterNormals[c] / normalLength : glm::vec3(0.0f);
+		}
+		if (meshArea > 0.0f)
+			meshCentroid /= meshArea;
+
+		std::vector<float> sortKeys(clusterCount);
+		std::vector<uint32_t> clusterOrder(clusterCount);
+		for (std::size_t c = 0; c < clusterCount; c++) {
+			sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c]);
+			clusterOrder[c] = static_cast<uint32_t>(c);
+		}
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<unsigned int> result;
+		result.reserve(indices.size());
+		for (auto c : clusterOrder)
+			result.insert(result.end(), indices.begin() + 3 * clusterStarts[c], indices.begin() + 3 * clusterStarts[c + 1]);
+		indices.swap(result);
+	}
+
+	//Cuadrica de error en forma simetrica: error(p) = p^T A p + 2 b.p + c, acumulada con peso igual al area de los triangulos
+	struct Quadric {
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+		double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+		double c = 0.0;
+		double weight = 0.0;
+
+		void AddPlane(const glm::dvec3& n, double d, double w) {
+			a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+			a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+			b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+			c += w * d * d;
+			weight += w;
+		}
+
+		void Add(const Quadric& other) {
+			a00 += other.a00; a01 += other.a01; a02 += other.a02;
+			a11 += other.a11; a12 += other.a12; a22 += other.a22;
+			b0 += other.b0; b1 += other.b1; b2 += other.b2;
+			c += other.c;
+			weight += other.weight;
+		}
+
+		//Distancia cuadratica promedio de p a los planos acumulados
+		double Evaluate(const glm::dvec3& p) const {
+			const double error = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+				+ 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+				+ 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+			return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+		}
+	};
+
+	struct EdgeCollapse {
+		uint32_t from;
+		uint32_t to;
+		float error;
+	};
+
+	void ComputeBoundingSphere(const float* positions, std::size_t positionStride, std::size_t vertexCount, glm::vec3& outCenter, float& outRadius) noexcept {
+		outCenter = glm::vec3(0.0f);
+		outRadius = 0.0f;
+		if (vertexCount == 0)
+			return;
+		auto getPosition = [&](std::size_t v) {
+			const float* p = reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(positions) + v * positionStride);
+			return glm::vec3(p[0], p[1], p[2]);
+		};
+		glm::vec3 minPosition(std::numeric_limits<float>::max());
+		glm::vec3 maxPosition(std::numeric_limits<float>::lowest());
+		for (std::size_t v = 0; v < vertexCount; v++) {
+			minPosition = glm::min(minPosition, getPosition(v));
+			maxPosition = glm::max(maxPosition, getPosition(v));
+		}
+		outCenter = 0.5f * (minPosition + maxPosition);
+		for (std::size_t v = 0; v < vertexCount; v++)
+			outRadius = std::max(outRadius, glm::length(getPosition(v) - outCenter));
+	}
+
+	float SimplifyMesh(std::vector<unsigned int>& indices, const float* positions, std::size_t positionStride, std::size_t vertexCount,
+		std::size_t targetIndexCount, float targetError, const std::vector<uint32_t>& collapseGroups) noexcept {
+		if (indices.size() <= targetIndexCount || vertexCount == 0)
+			return 0.0f;
+		//Las posiciones se normalizan para que los errores sean relativos al tamano de la malla
+		glm::vec3 center;
+		float radius;
+		ComputeBoundingSphere(positions, positionStride, vertexCount, center, radius);
+		const double invRadius = radius > 0.0f ? 1.0 / radius : 1.0;
+		std::vector<glm::dvec3> points(vertexCount);
+		for (std::size_t v = 0; v < vertexCount; v++) {
+			const float* p = reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(positions) + v * positionStride);
+			points[v] = (glm::dvec3(p[0], p[1], p[2]) - glm::dvec3(center)) * invRadius;
+		}
+
+		//Los vertices en aristas con un numero de triangulos distinto de dos son bordes o costuras de uv y quedan fijos
+		std::unordered_map<uint64_t, uint32_t> edgeTriangleCounts;
+		edgeTriangleCounts.reserve(indices.size());
+		for (std::size_t i = 0; i < indices.size(); i += 3) {
+			for (std::size_t k = 0; k < 3; k++) {
+				const uint64_t a = indices[i + k];
+				const uint64_t b = indices[i + (k + 1) % 3];
+				edgeTriangleCounts[(std::min(a, b) << 32) | std::max(a, b)]++;
+			}
+		}
+		std::vector<bool> locked(vertexCount, false);
+		for (const auto& edge : edgeTriangleCounts) {
+			if (edge.second != 2) {
+				locked[edge.first >> 32] = true;
+				locked[edge.first & 0xffffffffull] = true;
+			}
+		}
+
+		std::vector<Quadric> quadrics(vertexCount);
+		for (std::size_t i = 0; i < indices.size(); i += 3) {
+			const glm::dvec3& p0 = points[indices[i]];
+			const glm::dvec3 normal = glm::cross(points[indices[i + 1]] - p0, points[indices[i + 2]] - p0);
+			const double doubleArea = glm::length(normal);
+			if (doubleArea == 0.0)
+				continue;
+			const glm::dvec3 n = normal / doubleArea;
+			for (std::size_t k = 0; k < 3; k++)
+				quadrics[indices[i + k]].AddPlane(n, -glm::dot(n, p0), 0.5 * doubleArea);
+		}
+
+		const double maxError = static_cast<double>(targetError) * static_cast<double>(targetError);
+		double reachedError = 0.0;
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<uint32_t> collapseTargets(vertexCount);
+		std::vector<bool> touched(vertexCount);
+		std::vector<EdgeCollapse> collapses;
+		//Cada pasada aplica un conjunto independiente de colapsos (ningun vertice participa en dos) de menor a mayor error
+		while (indices.size() > targetIndexCount) {
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (auto index : indices)
+				adjacencyOffsets[index + 1]++;
+			for (std::size_t v = 0; v < vertexCount; v++)
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+			adjacency.resize(indices.size());
+			std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (std::size_t i = 0; i < indices.size(); i++)
+				adjacency[fillOffsets[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+			collapses.clear();
+			for (std::size_t i = 0; i < indices.size(); i += 3) {
+				for (std::size_t k = 0; k < 3; k++) {
+					const uint32_t a = indices[i + k];
+					const uint32_t b = indices[i + (k + 1) % 3];
+					const uint32_t pair[2][2] = { { a, b }, { b, a } };
+					for (const auto& edge : pair) {
+						const uint32_t from = edge[0];
+						const uint32_t to = edge[1];
+						if (locked[from] || (!collapseGroups.empty() && collapseGroups[from] != collapseGroups[to]))
+							continue;
+						Quadric combined = quadrics[from];
+						combined.Add(quadrics[to]);
+						collapses.push_back({ from, to, static_cast<float>(combined.Evaluate(points[to])) });
+					}
+				}
+			}
+			if (collapses.empty())
+				break;
+			std::sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& a, const EdgeCollapse& b) { return a.error < b.error; });
+
+			//Cada colapso elimina en promedio dos triangulos
+			const std::size_t neededCollapses = (indices.size() - targetIndexCount) / 6 + 1;
+			std::size_t appliedCollapses = 0;
+			for (std::size_t v = 0; v < vertexCount; v++)
+				collapseTargets[v] = static_cast<uint32_t>(v);
+			std::fill(touched.begin(), touched.end(), false);
+			for (const auto& collapse : collapses) {
+				if (collapse.error > maxError || appliedCollapses >= neededCollapses)
+					break;
+				if (touched[collapse.from] || touched[collapse.to])
+					continue;
+				//Se descarta el colapso si algun triangulo que sobrevive se da vuelta
+				bool flips = false;
+				for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1] && !flips; a++) {
+					const std::size_t t = 3 * static_cast<std::size_t>(adjacency[a]);
+					if (indices[t] == collapse.to || indices[t + 1] == collapse.to || indices[t + 2] == collapse.to)
+						continue;
+					glm::dvec3 corners[3] = { points[indices[t]], points[indices[t + 1]], points[indices[t + 2]] };
+					const glm::dvec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+					for (std::size_t k = 0; k < 3; k++) {
+						if (indices[t + k] == collapse.from)
+							corners[k] = points[collapse.to];
+					}
+					const glm::dvec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+					flips = glm::dot(before, after) <= 0.0;
+				}
+				if (flips)
+					continue;
+				for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++) {
+					const std::size_t t = 3 * static_cast<std::size_t>(adjacency[a]);
+					touched[indices[t]] = true;
+					touched[indices[t + 1]] = true;
+					touched[indices[t + 2]] = true;
+				}
+				collapseTargets[collapse.from] = collapse.to;
+				quadrics[collapse.to].Add(quadrics[collapse.from]);
+				reachedError = std::max(reachedError, static_cast<double>(collapse.error));
+				appliedCollapses++;
+			}
+			if (appliedCollapses == 0)
+				break;
+
+			//Se reescriben los indices y se eliminan los triangulos que quedaron degenerados
+			std::size_t writeIndex = 0;
+			for (std::size_t i = 0; i < indices.size(); i += 3) {
+				const unsigned int a = collapseTargets[indices[i]];
+				const unsigned int b = collapseTargets[indices[i + 1]];
+				const unsigned int c = collapseTargets[indices[i + 2]];
+				if (a == b || b == c || a == c)
+					continue;
+				indices[writeIndex++] = a;
+				indices[writeIndex++] = b;
+				indices[writeIndex++] = c;
+			}
+			indices.resize(writeIndex);
+		}
+		return static_cast<float>(std::sqrt(reachedError));
+	}
+
+	std::size_t OptimizeVertexFetch(void* vertices, std::size_t vertexCount, std::size_t vertexSize, std::vector<unsigned int>& indices) noexcept {
+		std::vector<uint32_t> remap(vertexCount, s_invalidIndex);
+		uint32_t nextVertex = 0;
+		for (auto& index : indices) {
+			if (remap[index] == s_invalidIndex)
+				remap[index] = nextVertex++;
+			index = remap[index];
+		}
+		const unsigned char* data = static_cast<const unsigned char*>(vertices);
+		std::vector<unsigned char> reordered(static_cast<std::size_t>(nextVertex) * vertexSize);
+		for (std::size_t v = 0; v < vertexCount; v++) {
+			if (remap[v] != s_invalidIndex)
+				std::memcpy(reordered.data() + remap[v] * vertexSize, data + v * vertexSize, vertexSize);
+		}
+		std::memcpy(vertices, reordered.data(), reordered.size());
+		return nextVertex;
+	}
+
+	float ComputeACMR(const std::vector<unsigned int>& indices, std::size_t vertexCount, uint32_t cacheSize) noexcept {
+		if (indices.size() < 3)
+			return 0.0f;
+		std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+		uint32_t time = cacheSize + 1;
+		uint32_t misses = 0;
+		for (auto index : indices) {
+			if (time - cacheTimestamps[index] > cacheSize) {
+				cacheTimestamps[index] = time++;
+				misses++;
+			}
+		}
+		return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#ifndef MESHOPTIMIZER_HPP
+#define MESHOPTIMIZER_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+//Tamano de la cache post transformacion que se asume al reordenar triangulos
+#define MESH_VERTEX_CACHE_SIZE 16
+//Cuanto puede empeorar la cache (ACMR) al reordenar triangulos para reducir overdraw
+#define MESH_OVERDRAW_THRESHOLD 1.05f
+
+namespace Mona {
+	/*
+	* Procesamiento de mallas en CPU que se hace al cargarlas. Ninguna de estas funciones llama a OpenGL.
+	* Los vertices se tratan como bloques de vertexSize bytes, por lo que sirven para cualquier formato de vertice.
+	*/
+
+	// Une los vertices identicos byte a byte y reescribe los indices. Devuelve la cantidad de vertices que quedan
+	// al principio del arreglo.
+	std::size_t WeldVertices(void* vertices, std::size_t vertexCount, std::size_t vertexSize, std::vector<unsigned int>& indices) noexcept;
+
+	// Reordena los triangulos para aprovechar la cache post transformacion (algoritmo Tipsify de Sander et al.)
+	void OptimizeVertexCache(std::vector<unsigned int>& indices, std::size_t vertexCount, uint32_t cacheSize = MESH_VERTEX_CACHE_SIZE) noexcept;
+
+	/*
+	* Separa la lista de triangulos, ya optimizada para la cache, en grupos y los ordena de forma que los que miran hacia
+	* afuera de la malla se dibujen primero. Los grupos se cortan de forma que el ACMR no empeore mas que threshold veces.
+	* positions apunta a la posicion (3 floats) del primer vertice y positionStride es la distancia en bytes entre vertices.
+	*/
+	void OptimizeOverdraw(std::vector<unsigned int>& indices, const float* positions, std::size_t positionStride, std::size_t vertexCount,
+		float threshold = MESH_OVERDRAW_THRESHOLD, uint32_t cacheSize = MESH_VERTEX_CACHE_SIZE) noexcept;
+
+	// Ordena los vertices segun su primer uso en indices y descarta los que no se usan. Devuelve la cantidad resultante.
+	std::size_t OptimizeVertexFetch(void* vertices, std::size_t vertexCount, std::size_t vertexSize, std::vector<unsigned int>& indices) noexcept;
+
+	// Promedio de vertices transformados por triangulo con una cache FIFO de cacheSize entradas
+	float ComputeACMR(const std::vector<unsigned int>& indices, std::size_t vertexCount, uint32_t cacheSize = MESH_VERTEX_CACHE_SIZE) noexcept;
+
+	/*
+	* Simplifica la malla colapsando aristas en orden de menor error cuadrico (Garland y Heckbert) hasta dejar a lo mas
+	* targetIndexCount indices o hasta que el siguiente colapso supere targetError. Cada vertice se colapsa sobre un vertice
+	* vecino existente, por lo que el resultado sigue usando el mismo buffer de vertices. Los vertices de bordes y costuras
+	* (aristas que no tienen exactamente dos triangulos) no se mueven. Si collapseGroups no esta vacio, solo se colapsan
+	* vertices del mismo grupo, lo que permite, por ejemplo, no mezclar vertices de huesos distintos.
+	* Los errores son distancias relativas al radio de la esfera que contiene la malla. Devuelve el error alcanzado.
+	*/
+	float SimplifyMesh(std::vector<unsigned int>& indices, const float* positions, std::size_t positionStride, std::size_t vertexCount,
+		std::size_t targetIndexCount, float targetError, const std::vector<uint32_t>& collapseGroups = {}) noexcept;
+
+	// Esfera centrada en la caja que contiene los vertices
+	void ComputeBoundingSphere(const float* positions, std::size_t positionStride, std::size_t vertexCount, glm::vec3& outCenter, float& outRadius) noexcept;
+
+	// Aplica la union de vertices y los reordenamientos anteriores. VertexType debe tener un miembro glm::vec3 position.
+	template <typename VertexType>
+	void OptimizeMesh(std::vector<VertexType>& vertices, std::vector<unsigned int>& indices) noexcept {
+		if (vertices.empty() || indices.empty())
+			return;
+		vertices.resize(WeldVertices(vertices.data(), vertices.size(), sizeof(VertexType), indices));
+		OptimizeVertexCache(indices, vertices.size());
+		OptimizeOverdraw(indices, &vertices[0].position.x, sizeof(VertexType), vertices.size());
+		vertices.resize(OptimizeVertexFetch(vertices.data(), vertices.size(), sizeof(VertexType), indices));
+	}
+}
+#endif
@@ -9,33 +9,30 @@ namespace Mona {
 	class PBRFlatMaterial : public Material {
 	public:
 		PBRFlatMaterial(const ShaderProgram& shaderProgram, bool isForSkinning) : 
-			Material(shaderProgram, isForSkinning),
-			m_albedo(glm::vec3(1.0f)),
-			m_metallic(0.0f),
-			m_roughness(0.5f),
-			m_ambientOcclusion(1.0f)
+			Material(shaderProgram, isForSkinning, sizeof(Parameters)),
+			m_parameters{ glm::vec3(1.0f), 0.0f, 0.5f, 1.0f, { 0.0f, 0.0f } }
 		{}
 		
-		void SetAlbedo(const glm::vec3& albedo) { m_albedo = albedo; }
-		void SetMetallic(float metallic) { m_metallic = metallic; }
-		void SetRoughnes(float roughness) { m_roughness = roughness; }
-		void SetAmbientOcclusion(float ambientOcclusion) { m_ambientOcclusion = ambientOcclusion; }
-		const glm::vec3& GetAlbedo() const { return m_albedo; }
-		float GetMetallic() const { return m_metallic; }
-		float GetRoughness() const { return m_roughness; }
-		float GetAmbientOcclusion() const { return m_ambientOcclusion; }
-		virtual void SetMaterialUniforms(const glm::vec3& cameraPosition) {
-			glUniform3fv(ShaderProgram::AlbedoShaderLocation, 1, glm::value_ptr(m_albedo));
-			glUniform1f(ShaderProgram::MetallicShaderLocation, m_metallic);
-			glUniform1f(ShaderProgram::RoughnessShaderLocation, m_roughness);
-			glUniform1f(ShaderProgram::AmbientOcclusionShaderLocation, m_ambientOcclusion);
-			glUniform3fv(ShaderProgram::CameraPositionShaderLocation, 1, glm::value_ptr(cameraPosition));
-		}
+		void SetAlbedo(const glm::vec3& albedo) { m_parameters.albedo = albedo; MarkParametersDirty(); }
+		void SetMetallic(float metallic) { m_parameters.metallic = metallic; MarkParametersDirty(); }
+		void SetRoughnes(float roughness) { m_parameters.roughness = roughness; MarkParametersDirty(); }
+		void SetAmbientOcclusion(float ambientOcclusion) { m_parameters.ambientOcclusion = ambientOcclusion; MarkParametersDirty(); }
+		const glm::vec3& GetAlbedo() const { return m_parameters.albedo; }
+		float GetMetallic() const { return m_parameters.metallic; }
+		float GetRoughness() const { return m_parameters.roughness; }
+		float GetAmbientOcclusion() const { return m_parameters.ambientOcclusion; }
+	protected:
+		virtual const void* GetParametersData() const override { return &m_parameters; }
 	private:
-		glm::vec3 m_albedo;
-		float m_metallic;
-		float m_roughness;
-		float m_ambientOcclusion;
+		//Layout std140 del bloque MaterialParameters de PBRFlat.ps
+		struct Parameters {
+			glm::vec3 albedo;
+			float metallic;
+			float roughness;
+			float ambientOcclusion;
+			float padding[2];
+		};
+		Parameters m_parameters;
 
 	};
 }
@@ -11,13 +11,13 @@ namespace Mona {
 	class PBRTexturedMaterial : public Material {
 	public:
 		PBRTexturedMaterial(const ShaderProgram& shaderProgram, bool isForSkinning) : 
-			Material(shaderProgram, isForSkinning),
+			Material(shaderProgram, isForSkinning, sizeof(Parameters)),
 			m_albedoTexture(nullptr),
 			m_normalMapTexture(nullptr),
 			m_metallicTexture(nullptr),
 			m_roughnessTexture(nullptr),
 			m_ambientOcclusionTexture(nullptr),
-			m_materialTint(glm::vec3(1.0f)) {
+			m_parameters{ glm::vec3(1.0f), 0.0f } {
 			//Dado que las ubicaiones de las texturas nunca cambian solo se configura al momento de construccin
 			glUseProgram(m_shaderID);
 			glUniform1i(ShaderProgram::AlbedoTextureSamplerShaderLocation, ShaderProgram::AlbedoTextureUnit);
@@ -26,8 +26,8 @@ namespace Mona {
 			glUniform1i(ShaderProgram::RoughnessSamplerShaderLocation, ShaderProgram::RoughnessTextureUnit);
 			glUniform1i(ShaderProgram::AmbientOcclusionSamplerShaderLocation, ShaderProgram::AmbientOcclusionTextureUnit);
 		}
-		const glm::vec3& GetMaterialTint() const { return m_materialTint; }
-		void SetMaterialTint(const glm::vec3& tint) { m_materialTint = tint; }
+		const glm::vec3& GetMaterialTint() const { return m_parameters.materialTint; }
+		void SetMaterialTint(const glm::vec3& tint) { m_parameters.materialTint = tint; MarkParametersDirty(); }
 		std::shared_ptr<Texture> GetAlbedoTexture() const { return m_albedoTexture; }
 		std::shared_ptr<Texture> GetNormalMapTextire() const { return m_normalMapTexture; }
 		std::shared_ptr<Texture> GetMetallicTexture() const { return m_metallicTexture; }
@@ -39,7 +39,9 @@ namespace Mona {
 		void SetRoughnessTexture(std::shared_ptr<Texture> roughnessTexture) { m_roughnessTexture = roughnessTexture; }
 		void SetAmbientOcclusionTexture(std::shared_ptr<Texture> ambientOcclusionTexture) { m_ambientOcclusionTexture = ambientOcclusionTexture; }
 
-		virtual void SetMaterialUniforms(const glm::vec3& cameraPosition) {
+	protected:
+		virtual const void* GetParametersData() const override { return &m_parameters; }
+		virtual void BindTextures() override {
 			MONA_ASSERT(m_albedoTexture != nullptr, "Material Error: Texture must be not nullptr for rendering to be posible");
 			MONA_ASSERT(m_normalMapTexture != nullptr, "Material Error: Texture must be not nullptr for rendering to be posible");
 			MONA_ASSERT(m_metallicTexture != nullptr, "Material Error: Texture must be not nullptr for rendering to be posible");
@@ -50,16 +52,19 @@ namespace Mona {
 			glBindTextureUnit(ShaderProgram::MetallicTextureUnit, m_metallicTexture->GetID());
 			glBindTextureUnit(ShaderProgram::RoughnessTextureUnit, m_roughnessTexture->GetID());
 			glBindTextureUnit(ShaderProgram::AmbientOcclusionTextureUnit, m_ambientOcclusionTexture->GetID());
-			glUniform3fv(ShaderProgram::MaterialTintShaderLocation, 1, glm::value_ptr(m_materialTint));
-			glUniform3fv(ShaderProgram::CameraPositionShaderLocation, 1, glm::value_ptr(cameraPosition));
 		}
 	private:
+		//Layout std140 del bloque MaterialParameters de PBRTextured.ps
+		struct Parameters {
+			glm::vec3 materialTint;
+			float padding;
+		};
 		std::shared_ptr<Texture> m_albedoTexture;
 		std::shared_ptr<Texture> m_normalMapTexture;
 		std::shared_ptr<Texture> m_metallicTexture;
 		std::shared_ptr<Texture> m_roughnessTexture;
 		std::shared_ptr<Texture> m_ambientOcclusionTexture;
-		glm::vec3 m_materialTint;
+		Parameters m_parameters;
 	};
 }
 #endif
\ No newline at end of file
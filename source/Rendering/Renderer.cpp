@@ -6,6 +6,8 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <chrono>
+#include <cstring>
 #include "../Core/Log.hpp"
 #include "../Core/RootDirectory.hpp"
 #include "../DebugDrawing/DebugDrawingSystem.hpp"
@@ -17,8 +19,30 @@
 #include "DiffuseTexturedMaterial.hpp"
 #include "PBRFlatMaterial.hpp"
 #include "PBRTexturedMaterial.hpp"
+//Capacidad inicial en bytes de cada buffer de luces, para que esten enlazados aunque la escena no tenga luces
+#define LIGHT_BUFFER_INITIAL_CAPACITY 1024
+//Capacidad inicial en bytes del buffer de paletas de huesos, suficiente para unas pocas mallas animadas
+#define BONE_PALETTE_BUFFER_INITIAL_CAPACITY 16384
+//Cantidad de draws que caben inicialmente en cada segmento del buffer circular de DrawData
+#define DRAW_DATA_INITIAL_DRAW_COUNT 256
+//Espera maxima en nanosegundos a que la GPU libere un segmento del buffer de DrawData
+#define DRAW_DATA_FENCE_TIMEOUT 1000000000
 
 namespace Mona{
+	//Elige el nivel de detalle segun el tamano proyectado de la malla, partiendo del nivel del frame anterior
+	template <typename MeshType>
+	static MeshLOD SelectDrawLOD(const MeshType& mesh, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,
+		uint32_t& lodLevel) {
+		const std::vector<MeshLOD>& lods = mesh.GetLODs();
+		if (lods.empty()) {
+			lodLevel = 0;
+			return { 0, mesh.GetIndexBufferCount(), 0.0f };
+		}
+		const float screenSize = ComputeScreenSize(modelMatrix, mesh.GetBoundingSphereCenter(), mesh.GetBoundingSphereRadius(), viewMatrix, projectionMatrix);
+		lodLevel = SelectMeshLOD(lods, screenSize, lodLevel);
+		return lods[lodLevel];
+	}
+
 	template
 		class ComponentManager<CameraComponent>;
 
@@ -49,24 +73,169 @@ namespace Mona{
 		//del framebuffer al que OpenGL renderiza.
 		eventManager.Subscribe(m_onWindowResizeSubscription, this, &Renderer::OnWindowResizeEvent);
 		m_debugDrawingSystemPtr = debugDrawingSystemPtr;
-		m_currentMatrixPalette.resize(NUM_MAX_BONES, glm::mat4(1.0f));
 		glEnable(GL_DEPTH_TEST);
 
+		//Datos del frame y de cada draw en uniform buffers, en lugar de uniforms sueltos por draw
+		glGenBuffers(1, &m_frameUBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, ShaderProgram::FrameUniformBlockBinding, m_frameUBO);
+		//Cada DrawData se enlaza con glBindBufferRange, cuyo offset debe respetar la alineacion de la implementacion
+		GLint uniformOffsetAlignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformOffsetAlignment);
+		const std::size_t alignment = static_cast<std::size_t>(std::max(uniformOffsetAlignment, 1));
+		m_drawDataStride = (sizeof(DrawData) + alignment - 1) / alignment * alignment;
+		m_drawDataSegmentCapacity = DRAW_DATA_INITIAL_DRAW_COUNT * m_drawDataStride;
+		glGenBuffers(1, &m_drawDataBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_drawDataBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, m_drawDataSegmentCapacity * DRAW_DATA_RING_SEGMENTS, NULL, GL_STREAM_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
 		//Se genera el buffer que contendra toda la informaci�n lum�nica de la escena
 		glGenBuffers(1, &m_lightDataUBO);
 		glBindBuffer(GL_UNIFORM_BUFFER, m_lightDataUBO);
 		glBufferData(GL_UNIFORM_BUFFER, sizeof(Lights), NULL, GL_DYNAMIC_DRAW);
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 		glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_lightDataUBO);
+		//Las luces y su asignacion a clusters usan los bindings 1 a 5 de shader storage, en el orden de LightBuffer
+		glGenBuffers(static_cast<GLsizei>(m_lightBuffers.size()), m_lightBuffers.data());
+		for (uint32_t i = 0; i < m_lightBuffers.size(); i++) {
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightBuffers[i]);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, LIGHT_BUFFER_INITIAL_CAPACITY, NULL, GL_DYNAMIC_DRAW);
+			m_lightBufferCapacities[i] = LIGHT_BUFFER_INITIAL_CAPACITY;
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i + 1, m_lightBuffers[i]);
+		}
+		//Las paletas de matrices de todas las mallas animadas de un frame comparten un unico buffer
+		glGenBuffers(1, &m_bonePaletteBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bonePaletteBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, BONE_PALETTE_BUFFER_INITIAL_CAPACITY, NULL, GL_STREAM_DRAW);
+		m_bonePaletteBufferCapacity = BONE_PALETTE_BUFFER_INITIAL_CAPACITY;
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ShaderProgram::BonePalettesStorageBinding, m_bonePaletteBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		m_viewportSize = glm::vec2(std::max(viewport[2], 1), std::max(viewport[3], 1));
+	}
+
+	void Renderer::UploadLightBuffer(LightBuffer buffer, const void* data, std::size_t size) noexcept {
+		const uint32_t index = static_cast<uint32_t>(buffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightBuffers[index]);
+		if (m_lightBufferCapacities[index] < size) {
+			//Se crece al doble para no reservar memoria de GPU cada vez que aparece una luz
+			m_lightBufferCapacities[index] = std::max(size, 2 * m_lightBufferCapacities[index]);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_lightBufferCapacities[index], NULL, GL_DYNAMIC_DRAW);
+		}
+		if (0 < size) {
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+		}
+	}
+
+	void Renderer::UploadBonePalettes(const std::vector<glm::mat4>& matrixPalettes) noexcept {
+		const std::size_t size = sizeof(glm::mat4) * matrixPalettes.size();
+		if (size == 0) {
+			return;
+		}
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bonePaletteBuffer);
+		if (m_bonePaletteBufferCapacity < size) {
+			m_bonePaletteBufferCapacity = std::max(size, 2 * m_bonePaletteBufferCapacity);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_bonePaletteBufferCapacity, NULL, GL_STREAM_DRAW);
+		}
+		//Al invalidar el buffer el driver no espera a que terminen los draws del frame anterior que aun lo leen
+		void* mappedPalettes = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (mappedPalettes) {
+			std::memcpy(mappedPalettes, matrixPalettes.data(), size);
+			glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+		}
+		else {
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, matrixPalettes.data());
+		}
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	template <typename MeshType>
+	Renderer::DrawData Renderer::MakeDrawData(const MeshType& mesh, const glm::mat4& modelMatrix, const glm::mat4& viewProjectionMatrix,
+		uint32_t paletteOffset) noexcept {
+		//Los shaders siempre aplican la escala y el desplazamiento de posicion; en mallas sin comprimir son la identidad
+		const PositionQuantization& quantization = mesh.GetPositionQuantization();
+		DrawData drawData;
+		drawData.mvpMatrix = viewProjectionMatrix * modelMatrix;
+		drawData.modelMatrix = modelMatrix;
+		drawData.modelInverseTransposeMatrix = glm::transpose(glm::inverse(modelMatrix));
+		drawData.positionScale = quantization.scale;
+		drawData.compressedVertices = mesh.HasCompressedVertices() ? 1 : 0;
+		drawData.positionOffset = quantization.offset;
+		drawData.paletteOffset = paletteOffset;
+		return drawData;
 	}
+
+	std::size_t Renderer::UploadDrawData(const std::vector<DrawData>& drawData) noexcept {
+		const std::size_t size = m_drawDataStride * drawData.size();
+		glBindBuffer(GL_UNIFORM_BUFFER, m_drawDataBuffer);
+		if (m_drawDataSegmentCapacity < size) {
+			//El almacenamiento nuevo no lo lee ningun frame anterior, asi que sus fences ya no hacen falta
+			for (void*& fence : m_drawDataFences) {
+				if (fence) {
+					glDeleteSync(static_cast<GLsync>(fence));
+					fence = nullptr;
+				}
+			}
+			m_drawDataSegmentCapacity = std::max(size, 2 * m_drawDataSegmentCapacity);
+			glBufferData(GL_UNIFORM_BUFFER, m_drawDataSegmentCapacity * DRAW_DATA_RING_SEGMENTS, NULL, GL_STREAM_DRAW);
+		}
+		m_drawDataSegment = (m_drawDataSegment + 1) % DRAW_DATA_RING_SEGMENTS;
+		//Solo se espera si la GPU aun no termina el frame que uso este segmento por ultima vez
+		void*& fence = m_drawDataFences[m_drawDataSegment];
+		if (fence) {
+			glClientWaitSync(static_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, DRAW_DATA_FENCE_TIMEOUT);
+			glDeleteSync(static_cast<GLsync>(fence));
+			fence = nullptr;
+		}
+		const std::size_t segmentOffset = m_drawDataSegment * m_drawDataSegmentCapacity;
+		uint8_t* mappedDrawData = static_cast<uint8_t*>(glMapBufferRange(GL_UNIFORM_BUFFER, segmentOffset, size,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+		if (mappedDrawData) {
+			for (std::size_t i = 0; i < drawData.size(); i++) {
+				std::memcpy(mappedDrawData + i * m_drawDataStride, &drawData[i], sizeof(DrawData));
+			}
+			glUnmapBuffer(GL_UNIFORM_BUFFER);
+		}
+		else {
+			for (std::size_t i = 0; i < drawData.size(); i++) {
+				glBufferSubData(GL_UNIFORM_BUFFER, segmentOffset + i * m_drawDataStride, sizeof(DrawData), &drawData[i]);
+			}
+		}
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		return segmentOffset;
+	}
+
+	void Renderer::BindDraw(Material& material, std::size_t drawDataOffset, const Material*& boundMaterial) noexcept {
+		if (&material != boundMaterial) {
+			material.Bind();
+			boundMaterial = &material;
+		}
+		glBindBufferRange(GL_UNIFORM_BUFFER, ShaderProgram::DrawDataUniformBlockBinding, m_drawDataBuffer, drawDataOffset, sizeof(DrawData));
+	}
+
 	void Renderer::ShutDown(EventManager& eventManager) noexcept {
 		eventManager.Unsubscribe(m_onWindowResizeSubscription);
+		m_immediateSnapshot.Clear();
 		glDeleteBuffers(1, &m_lightDataUBO);
+		glDeleteBuffers(static_cast<GLsizei>(m_lightBuffers.size()), m_lightBuffers.data());
+		glDeleteBuffers(1, &m_bonePaletteBuffer);
+		glDeleteBuffers(1, &m_frameUBO);
+		glDeleteBuffers(1, &m_drawDataBuffer);
+		for (void*& fence : m_drawDataFences) {
+			if (fence) {
+				glDeleteSync(static_cast<GLsync>(fence));
+				fence = nullptr;
+			}
+		}
 	}
 	void Renderer::OnWindowResizeEvent(const WindowResizeEvent& event) {
 		if (event.width == 0 || event.height == 0)
 			return;
 		glViewport(0, 0, event.width, event.height);
+		m_viewportSize = glm::vec2(event.width, event.height);
 	}
 
 	void Renderer::Render(EventManager& eventManager,
@@ -80,20 +249,62 @@ namespace Mona{
 		ComponentManager<SpotLightComponent>& spotLightDataManager,
 		ComponentManager<PointLightComponent>& pointLightDataManager) noexcept
 	{
-		glClearColor(m_backgroundColor[0], m_backgroundColor[1], m_backgroundColor[2], m_backgroundColor[3]);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glm::mat4 viewMatrix;
-		glm::mat4 projectionMatrix;
-		glm::vec3 cameraPosition = glm::vec3(0.0f);
+		ExtractSnapshot(cameraHandle,
+			ambientLight,
+			staticMeshDataManager,
+			skeletalMeshDataManager,
+			transformDataManager,
+			cameraDataManager,
+			directionalLightDataManager,
+			spotLightDataManager,
+			pointLightDataManager,
+			m_immediateSnapshot);
+		SubmitSnapshot(m_immediateSnapshot);
+		DrawDebug(eventManager, m_immediateSnapshot);
+	}
+
+	void Renderer::RenderSnapshot::Clear() noexcept {
+		m_valid = false;
+		m_staticDraws.clear();
+		m_skinnedDraws.clear();
+		m_drawData.clear();
+		m_matrixPalettes.clear();
+		m_terrainChunkDraws.clear();
+		m_directionalLights.clear();
+		m_pointLights.clear();
+		m_spotLights.clear();
+		m_pointLightBounds.clear();
+		m_spotLightBounds.clear();
+		m_lightClusters.Clear();
+	}
+
+	void Renderer::ExtractSnapshot(const InnerComponentHandle& cameraHandle,
+		const glm::vec3& ambientLight,
+		ComponentManager<StaticMeshComponent>& staticMeshDataManager,
+		ComponentManager<SkeletalMeshComponent>& skeletalMeshDataManager,
+		ComponentManager<TransformComponent>& transformDataManager,
+		ComponentManager<CameraComponent>& cameraDataManager,
+		ComponentManager<DirectionalLightComponent>& directionalLightDataManager,
+		ComponentManager<SpotLightComponent>& spotLightDataManager,
+		ComponentManager<PointLightComponent>& pointLightDataManager,
+		RenderSnapshot& outSnapshot) noexcept
+	{
+		auto extractionStart = std::chrono::high_resolution_clock::now();
+		//Se conservan las capacidades de los vectores entre frames para no reservar memoria en cada extraccion
+		outSnapshot.Clear();
+		glm::mat4& viewMatrix = outSnapshot.m_viewMatrix;
+		glm::mat4& projectionMatrix = outSnapshot.m_projectionMatrix;
+		glm::vec3& cameraPosition = outSnapshot.m_cameraPosition;
+		cameraPosition = glm::vec3(0.0f);
 		if (cameraDataManager.IsValid(cameraHandle)) {
 			//Si el usuario configuro la camara principal configuramos apartir de esta la matriz de vista y projecci�n
 			//viewMatrix y projectionMatrix respectivamente
 			const CameraComponent* camera = cameraDataManager.GetComponentPointer(cameraHandle);
 			GameObject* cameraOwner = cameraDataManager.GetOwner(cameraHandle);
 			TransformComponent* cameraTransform = transformDataManager.GetComponentPointer(cameraOwner->GetInnerComponentHandle<TransformComponent>());
-			viewMatrix = cameraTransform->GetViewMatrixFromTransform();
+			viewMatrix = cameraTransform->GetWorldViewMatrix();
 			projectionMatrix = camera->GetProjectionMatrix();
-			cameraPosition = cameraTransform->GetLocalTranslation();
+			cameraPosition = cameraTransform->GetWorldTranslation();
 		}
 		else {
 			//En caso de que el usuario no haya configurado una cama principal usamos valores predeterminados para ambas matrices
@@ -104,90 +315,184 @@ namespace Mona{
 
 
 
-		//Comienza carga en CPU de la informaci�n lum�nica de la escena
-		Lights lights;
+		//Comienza carga en CPU de la informacion luminica de la escena. No hay un maximo de luces: las puntuales y spotlights
+		//se asignan a clusters de la vista para que cada fragmento evalue solo las que lo alcanzan
+		Lights& lights = outSnapshot.m_lights;
+		lights.viewMatrix = viewMatrix;
 		lights.ambientLight = ambientLight;
-
-		//Se pasa la informacion de a lo mas las primeras NUM_HALF_MAX_DIRECTIONAL_LIGHTS * 2 componentes de luz direccional
-		//A una instancia de Lights (informacion de la escena en CPU)
-		uint32_t directionalLightsCount = std::min(static_cast<uint32_t>(NUM_HALF_MAX_DIRECTIONAL_LIGHTS * 2), directionalLightDataManager.GetCount());
-		lights.directionalLightsCount = static_cast<int>(directionalLightsCount);
-		for (uint32_t i = 0; i < directionalLightsCount; i++) {
+		//Las luces cuyo dueno esta inactivo no iluminan la escena, igual que sus mallas no se dibujan
+		outSnapshot.m_directionalLights.clear();
+		for (uint32_t i = 0; i < directionalLightDataManager.GetCount(); i++) {
 			const DirectionalLightComponent& dirLight = directionalLightDataManager[i];
 			GameObject* dirLightOwner = directionalLightDataManager.GetOwnerByIndex(i);
+			if (dirLightOwner->GetState() == GameObject::EState::Inactive)
+				continue;
 			TransformComponent* lightTransform = transformDataManager.GetComponentPointer(dirLightOwner->GetInnerComponentHandle<TransformComponent>());
-			lights.directionalLights[i].colorIntensity = dirLight.GetLightColor();
-			lights.directionalLights[i].direction = glm::rotate(dirLight.GetLightDirection(), lightTransform->GetFrontVector());
+			DirectionalLight& light = outSnapshot.m_directionalLights.emplace_back();
+			light.colorIntensity = dirLight.GetLightColor();
+			light.direction = glm::rotate(dirLight.GetLightDirection(), lightTransform->GetWorldFrontVector());
 		}
+		lights.directionalLightsCount = static_cast<int>(outSnapshot.m_directionalLights.size());
 
-		//Lo mismo para spotlights
-		uint32_t spotLightsCount = std::min(static_cast<uint32_t>(NUM_HALF_MAX_SPOT_LIGHTS * 2), spotLightDataManager.GetCount());
-		lights.spotLightsCount = static_cast<int>(spotLightsCount);
-		for (uint32_t i = 0; i < spotLightsCount; i++) {
+		outSnapshot.m_spotLights.clear();
+		outSnapshot.m_spotLightBounds.clear();
+		for (uint32_t i = 0; i < spotLightDataManager.GetCount(); i++) {
 			const SpotLightComponent& spotLight = spotLightDataManager[i];
 			GameObject* spotLightOwner = spotLightDataManager.GetOwnerByIndex(i);
+			if (spotLightOwner->GetState() == GameObject::EState::Inactive)
+				continue;
 			TransformComponent* lightTransform = transformDataManager.GetComponentPointer(spotLightOwner->GetInnerComponentHandle<TransformComponent>());
-			lights.spotLights[i].colorIntensity = spotLight.GetLightColor();
-			lights.spotLights[i].direction = glm::rotate(spotLight.GetLightDirection(), lightTransform->GetFrontVector());
-			lights.spotLights[i].position = lightTransform->GetLocalTranslation();
-			lights.spotLights[i].cosPenumbraAngle = glm::cos(spotLight.GetPenumbraAngle());
-			lights.spotLights[i].cosUmbraAngle = glm::cos(spotLight.GetUmbraAngle());
-			lights.spotLights[i].maxRadius = spotLight.GetMaxRadius();
-		}
-
-		//Finalmente luces puntuales
-		uint32_t pointLightsCount = std::min(static_cast<uint32_t>(NUM_HALF_MAX_POINT_LIGHTS * 2), pointLightDataManager.GetCount());
-		lights.pointLightsCount = static_cast<int>(pointLightsCount);
-		for (uint32_t i = 0; i < pointLightsCount; i++) {
+			SpotLight& light = outSnapshot.m_spotLights.emplace_back();
+			light.colorIntensity = spotLight.GetLightColor();
+			light.direction = glm::rotate(spotLight.GetLightDirection(), lightTransform->GetWorldFrontVector());
+			light.position = lightTransform->GetWorldTranslation();
+			light.cosPenumbraAngle = glm::cos(spotLight.GetPenumbraAngle());
+			light.cosUmbraAngle = glm::cos(spotLight.GetUmbraAngle());
+			light.maxRadius = spotLight.GetMaxRadius();
+			//El cono se acota por la esfera de su radio maximo
+			outSnapshot.m_spotLightBounds.push_back({ glm::vec3(viewMatrix * glm::vec4(light.position, 1.0f)), light.maxRadius });
+		}
+
+		outSnapshot.m_pointLights.clear();
+		outSnapshot.m_pointLightBounds.clear();
+		for (uint32_t i = 0; i < pointLightDataManager.GetCount(); i++) {
 			const PointLightComponent& pointLight = pointLightDataManager[i];
 			GameObject* pointLightOwner = pointLightDataManager.GetOwnerByIndex(i);
+			if (pointLightOwner->GetState() == GameObject::EState::Inactive)
+				continue;
 			TransformComponent* lightTransform = transformDataManager.GetComponentPointer(pointLightOwner->GetInnerComponentHandle<TransformComponent>());
-			lights.pointLights[i].colorIntensity = pointLight.GetLightColor();
-			lights.pointLights[i].position = lightTransform->GetLocalTranslation();
-			lights.pointLights[i].maxRadius = pointLight.GetMaxRadius();
+			PointLight& light = outSnapshot.m_pointLights.emplace_back();
+			light.colorIntensity = pointLight.GetLightColor();
+			light.position = lightTransform->GetWorldTranslation();
+			light.maxRadius = pointLight.GetMaxRadius();
+			outSnapshot.m_pointLightBounds.push_back({ glm::vec3(viewMatrix * glm::vec4(light.position, 1.0f)), light.maxRadius });
 		}
+		outSnapshot.m_lightClusters.Build(projectionMatrix, outSnapshot.m_pointLightBounds, outSnapshot.m_spotLightBounds);
+		lights.clusterDepthScale = outSnapshot.m_lightClusters.GetDepthSliceScale();
+		lights.clusterDepthBias = outSnapshot.m_lightClusters.GetDepthSliceBias();
 
-		//Pasamos la informacion lum�nica a GPU con un unico llamado a OpenGL fuera de los loops de las primitivas.
-		glBindBuffer(GL_UNIFORM_BUFFER, m_lightDataUBO);
-		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Lights), &lights);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
-		//Iteraci�n sobre todas las instancias de StaticMeshComponent
+		//Las mallas se guardan por shared_ptr para que sigan vivas aunque su componente se destruya antes del envio.
+		//Las matrices de cada draw se calculan aqui, fuera del hilo que emite las llamadas a OpenGL
+		const glm::mat4 viewProjectionMatrix = projectionMatrix * viewMatrix;
+		outSnapshot.m_staticDraws.reserve(staticMeshDataManager.GetCount());
+		outSnapshot.m_drawData.reserve(staticMeshDataManager.GetCount() + skeletalMeshDataManager.GetCount());
 		for (decltype(staticMeshDataManager.GetCount()) i = 0;
 			i < staticMeshDataManager.GetCount();
 			i++)
 		{
 			StaticMeshComponent& staticMesh = staticMeshDataManager[i];
 			GameObject* owner = staticMeshDataManager.GetOwnerByIndex(i);
-			//Se obtiene la informaci�n espacial para configurar la matriz de modelo dentro del shader.
+			//Una malla sin datos en GPU todavia se esta cargando de forma asincrona
+			if (owner->GetState() == GameObject::EState::Inactive || staticMesh.m_meshPtr->GetVertexArrayID() == 0) {
+				continue;
+			}
 			TransformComponent* transform = transformDataManager.GetComponentPointer(owner->GetInnerComponentHandle<TransformComponent>());
-			//Configuraci�n de la malla a ser renderizada y las uniformes asociadas a su material.
-			glBindVertexArray(staticMesh.GetMeshVAOID());
-			staticMesh.m_materialPtr->SetUniforms(projectionMatrix, viewMatrix, transform->GetModelMatrix(), cameraPosition);
-			glDrawElements(GL_TRIANGLES, staticMesh.GetMeshIndexCount(), GL_UNSIGNED_INT, 0);
-			
+			glm::mat4 modelMatrix = transform->GetModelMatrix();
+			//Los terrenos se dibujan por chunks, con el nivel de detalle de cada uno elegido segun la distancia a la camara
+			uint32_t terrainDrawOffset = static_cast<uint32_t>(outSnapshot.m_terrainChunkDraws.size());
+			if (staticMesh.m_meshPtr->IsTerrain()) {
+				staticMesh.m_meshPtr->SelectTerrainLODs(modelMatrix, cameraPosition, outSnapshot.m_terrainChunkDraws);
+			}
+			uint32_t terrainDrawCount = static_cast<uint32_t>(outSnapshot.m_terrainChunkDraws.size()) - terrainDrawOffset;
+			const MeshLOD lod = SelectDrawLOD(*staticMesh.m_meshPtr, modelMatrix, viewMatrix, projectionMatrix, staticMesh.m_lodLevel);
+			const uint32_t drawDataIndex = static_cast<uint32_t>(outSnapshot.m_drawData.size());
+			outSnapshot.m_drawData.push_back(MakeDrawData(*staticMesh.m_meshPtr, modelMatrix, viewProjectionMatrix, 0));
+			outSnapshot.m_staticDraws.push_back({ staticMesh.m_meshPtr, staticMesh.m_materialPtr, drawDataIndex, lod.indexOffset, lod.indexCount, terrainDrawOffset, terrainDrawCount });
 		}
-		
-		//Iteracion sobre todas las instancias de SkeletalMeshComponent
+
+		//Las paletas de matrices de todas las mallas animadas se escriben de forma contigua, cada una con el tamano de su esqueleto
+		outSnapshot.m_skinnedDraws.reserve(skeletalMeshDataManager.GetCount());
 		for (decltype(skeletalMeshDataManager.GetCount()) i = 0;
 			i < skeletalMeshDataManager.GetCount();
 			i++)
 		{
 			SkeletalMeshComponent& skeletalMesh = skeletalMeshDataManager[i];
 			GameObject* owner = skeletalMeshDataManager.GetOwnerByIndex(i);
+			//Igual que las estaticas, una malla animada sin datos en GPU todavia se esta cargando
+			if (owner->GetState() == GameObject::EState::Inactive || skeletalMesh.m_skinnedMeshPtr->GetVertexArrayID() == 0) {
+				continue;
+			}
 			TransformComponent* transform = transformDataManager.GetComponentPointer(owner->GetInnerComponentHandle<TransformComponent>());
-			auto skinnedMesh = skeletalMesh.m_skinnedMeshPtr;
-			glBindVertexArray(skinnedMesh->GetVertexArrayID());
-			//A diferencias de StaticMeshes, SkeletalMeshComponent necesita configurar las paletas de matrices de animacion
-			//estas se le solicitan al animationController
-			auto &animController = skeletalMesh.GetAnimationController();
-			skeletalMesh.m_materialPtr->SetUniforms(projectionMatrix, viewMatrix, transform->GetModelMatrix(), cameraPosition);
-			animController.GetMatrixPalette(m_currentMatrixPalette);
-			glUniformMatrix4fv(ShaderProgram::BoneTransformShaderLocation, skeletalMesh.GetSkeleton()->JointCount(), GL_FALSE, (GLfloat*) m_currentMatrixPalette.data());
-			glDrawElements(GL_TRIANGLES, skinnedMesh->GetIndexBufferCount(), GL_UNSIGNED_INT, 0);
+			uint32_t jointCount = skeletalMesh.GetSkeleton()->JointCount();
+			uint32_t paletteOffset = static_cast<uint32_t>(outSnapshot.m_matrixPalettes.size());
+			outSnapshot.m_matrixPalettes.resize(paletteOffset + jointCount);
+			skeletalMesh.GetAnimationController().GetMatrixPalette(outSnapshot.m_matrixPalettes.data() + paletteOffset);
+			const glm::mat4 modelMatrix = transform->GetModelMatrix();
+			const MeshLOD lod = SelectDrawLOD(*skeletalMesh.m_skinnedMeshPtr, modelMatrix, viewMatrix, projectionMatrix, skeletalMesh.m_lodLevel);
+			const uint32_t drawDataIndex = static_cast<uint32_t>(outSnapshot.m_drawData.size());
+			outSnapshot.m_drawData.push_back(MakeDrawData(*skeletalMesh.m_skinnedMeshPtr, modelMatrix, viewProjectionMatrix, paletteOffset));
+			outSnapshot.m_skinnedDraws.push_back({ skeletalMesh.m_skinnedMeshPtr, skeletalMesh.m_materialPtr, drawDataIndex, lod.indexOffset, lod.indexCount });
 		}
+		outSnapshot.m_valid = true;
+		std::chrono::duration<float> extractionTime = std::chrono::high_resolution_clock::now() - extractionStart;
+		outSnapshot.m_extractionTime = extractionTime.count();
+		m_lastExtractionTime = outSnapshot.m_extractionTime;
+	}
+
+	void Renderer::SubmitSnapshot(const RenderSnapshot& snapshot) noexcept
+	{
+		glClearColor(m_backgroundColor[0], m_backgroundColor[1], m_backgroundColor[2], m_backgroundColor[3]);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		if (!snapshot.IsValid()) {
+			return;
+		}
+		const FrameData frameData = { snapshot.m_cameraPosition, 0.0f };
+		glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &frameData);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		//Pasamos la informacion lum�nica a GPU con un unico llamado a OpenGL fuera de los loops de las primitivas.
+		Lights lights = snapshot.m_lights;
+		lights.viewportSize = m_viewportSize;
+		glBindBuffer(GL_UNIFORM_BUFFER, m_lightDataUBO);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Lights), &lights);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		const auto& clusters = snapshot.m_lightClusters.GetClusters();
+		const auto& lightIndices = snapshot.m_lightClusters.GetLightIndices();
+		UploadLightBuffer(LightBuffer::DirectionalLights, snapshot.m_directionalLights.data(), sizeof(DirectionalLight) * snapshot.m_directionalLights.size());
+		UploadLightBuffer(LightBuffer::PointLights, snapshot.m_pointLights.data(), sizeof(PointLight) * snapshot.m_pointLights.size());
+		UploadLightBuffer(LightBuffer::SpotLights, snapshot.m_spotLights.data(), sizeof(SpotLight) * snapshot.m_spotLights.size());
+		UploadLightBuffer(LightBuffer::Clusters, clusters.data(), sizeof(LightClusters::Cluster) * clusters.size());
+		UploadLightBuffer(LightBuffer::Indices, lightIndices.data(), sizeof(uint32_t) * lightIndices.size());
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		//Todas las paletas y los datos de todos los draws se suben con una sola escritura cada uno
+		UploadBonePalettes(snapshot.m_matrixPalettes);
+		const bool hasDraws = !snapshot.m_drawData.empty();
+		const std::size_t drawDataOffset = hasDraws ? UploadDrawData(snapshot.m_drawData) : 0;
+		//Cada draw solo enlaza su rango del buffer de DrawData; el material se activa cuando cambia respecto al draw anterior
+		const Material* boundMaterial = nullptr;
+		for (const auto& draw : snapshot.m_staticDraws)
+		{
+			//Configuraci�n de la malla a ser renderizada y las uniformes asociadas a su material.
+			glBindVertexArray(draw.mesh->GetVertexArrayID());
+			BindDraw(*draw.material, drawDataOffset + draw.drawDataIndex * m_drawDataStride, boundMaterial);
+			if (draw.terrainDrawCount == 0) {
+				glDrawElements(GL_TRIANGLES, draw.indexCount, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * draw.indexOffset));
+				continue;
+			}
+			for (uint32_t i = draw.terrainDrawOffset; i < draw.terrainDrawOffset + draw.terrainDrawCount; i++) {
+				const Mesh::TerrainChunkDraw& chunkDraw = snapshot.m_terrainChunkDraws[i];
+				glDrawElementsBaseVertex(GL_TRIANGLES, chunkDraw.indexCount, GL_UNSIGNED_INT,
+					(void*)(sizeof(unsigned int) * chunkDraw.indexOffset), chunkDraw.baseVertex);
+			}
+		}
+
+		for (const auto& draw : snapshot.m_skinnedDraws)
+		{
+			glBindVertexArray(draw.mesh->GetVertexArrayID());
+			BindDraw(*draw.material, drawDataOffset + draw.drawDataIndex * m_drawDataStride, boundMaterial);
+			glDrawElements(GL_TRIANGLES, draw.indexCount, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * draw.indexOffset));
+		}
+		//El segmento de DrawData de este frame no se reescribe hasta que la GPU termine estos draws
+		if (hasDraws) {
+			m_drawDataFences[m_drawDataSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+	}
+
+	void Renderer::DrawDebug(EventManager& eventManager, const RenderSnapshot& snapshot) noexcept
+	{
 		//En no Debub build este llamado es vacio, en caso contrario se renderiza informaci�n de debug
-		m_debugDrawingSystemPtr->Draw(eventManager, viewMatrix, projectionMatrix);
-		
+		m_debugDrawingSystemPtr->Draw(eventManager, snapshot.m_viewMatrix, snapshot.m_projectionMatrix);
 	}
 
 	std::shared_ptr<Material> Renderer::CreateMaterial(MaterialType type, bool isForSkinning) {
@@ -15,8 +15,10 @@
 #include "SpotLightComponent.hpp"
 #include "PointLightComponent.hpp"
 #include "Material.hpp"
+#include "LightClusters.hpp"
 #include "../DebugDrawing/DebugDrawingSystem.hpp"
-
+//Frames que pueden estar en vuelo leyendo el buffer de DrawData antes de que se reescriba su segmento
+#define DRAW_DATA_RING_SEGMENTS 3
 
 
 namespace Mona {
@@ -24,10 +26,7 @@ namespace Mona {
 
 	class Renderer {
 	public:
-		static constexpr int NUM_HALF_MAX_DIRECTIONAL_LIGHTS = 1;
-		static constexpr int NUM_HALF_MAX_POINT_LIGHTS = 3;
-		static constexpr int NUM_HALF_MAX_SPOT_LIGHTS = 3;
-		static constexpr int NUM_MAX_BONES = 70;
+		class RenderSnapshot;
 		Renderer() = default;
 		void StartUp(EventManager& eventManager, DebugDrawingSystem* debugDrawingSystemPtr) noexcept;
 		void Render(EventManager& eventManager,
@@ -40,6 +39,21 @@ namespace Mona {
 					ComponentManager<DirectionalLightComponent> &directionalLightDataManager,
 					ComponentManager<SpotLightComponent> &spotLightDataManager,
 					ComponentManager<PointLightComponent> &pointLightDataManager) noexcept;
+		// Copia en CPU todo lo que necesita un frame, sin llamadas a OpenGL. Puede correr fuera del hilo principal.
+		void ExtractSnapshot(const InnerComponentHandle& cameraHandle,
+					const glm::vec3& ambientLight,
+					ComponentManager<StaticMeshComponent>& staticMeshDataManager,
+					ComponentManager<SkeletalMeshComponent>& skeletalMeshDataManager,
+					ComponentManager<TransformComponent>& transformDataManager,
+					ComponentManager<CameraComponent>& cameraDataManager,
+					ComponentManager<DirectionalLightComponent>& directionalLightDataManager,
+					ComponentManager<SpotLightComponent>& spotLightDataManager,
+					ComponentManager<PointLightComponent>& pointLightDataManager,
+					RenderSnapshot& outSnapshot) noexcept;
+		// Emite las llamadas a OpenGL a partir de un snapshot ya extraido. Solo en el hilo principal.
+		void SubmitSnapshot(const RenderSnapshot& snapshot) noexcept;
+		void DrawDebug(EventManager& eventManager, const RenderSnapshot& snapshot) noexcept;
+		float GetLastExtractionTime() const noexcept { return m_lastExtractionTime; }
 		void ShutDown(EventManager& eventManager) noexcept;
 		void OnWindowResizeEvent(const WindowResizeEvent& event);
 		std::shared_ptr<Material> CreateMaterial(MaterialType type, bool isForSkinning);
@@ -69,20 +83,123 @@ namespace Mona {
 			float cosUmbraAngle; //48
 		};
 
+		//Datos globales de iluminacion con layout std140. Las luces mismas van en buffers de tamano variable
 		struct Lights {
-			SpotLight spotLights[2 * NUM_HALF_MAX_SPOT_LIGHTS];
-			PointLight pointLights[2 * NUM_HALF_MAX_POINT_LIGHTS]; 
-			DirectionalLight directionalLights[2 * NUM_HALF_MAX_DIRECTIONAL_LIGHTS]; 
-			glm::vec3 ambientLight; 
-			int spotLightsCount; 
-			int pointLightsCount; 
-			int directionalLightsCount; 
+			glm::mat4 viewMatrix; //64
+			glm::vec3 ambientLight; //76
+			int directionalLightsCount; //80
+			glm::vec2 viewportSize; //88
+			float clusterDepthScale; //92
+			float clusterDepthBias; //96
 		};
+
+		//Datos por frame con layout std140 (bloque Frame)
+		struct FrameData {
+			glm::vec3 cameraPosition; //12
+			float padding; //16
+		};
+
+		//Datos de cada draw con layout std140 (bloque DrawData). Se escriben juntos en el buffer circular del frame
+		struct DrawData {
+			glm::mat4 mvpMatrix; //64
+			glm::mat4 modelMatrix; //128
+			glm::mat4 modelInverseTransposeMatrix; //192
+			glm::vec3 positionScale; //204
+			uint32_t compressedVertices; //208
+			glm::vec3 positionOffset; //220
+			uint32_t paletteOffset; //224
+		};
+
+		enum class LightBuffer : uint32_t {
+			DirectionalLights,
+			PointLights,
+			SpotLights,
+			Clusters,
+			Indices,
+			LightBufferCount
+		};
+	public:
+		class RenderSnapshot {
+		public:
+			friend class Renderer;
+			RenderSnapshot() = default;
+			bool IsValid() const noexcept { return m_valid; }
+			uint32_t GetStaticDrawCount() const noexcept { return static_cast<uint32_t>(m_staticDraws.size()); }
+			uint32_t GetSkinnedDrawCount() const noexcept { return static_cast<uint32_t>(m_skinnedDraws.size()); }
+			uint32_t GetPointLightCount() const noexcept { return static_cast<uint32_t>(m_pointLights.size()); }
+			uint32_t GetSpotLightCount() const noexcept { return static_cast<uint32_t>(m_spotLights.size()); }
+			// Matrices de todas las paletas del frame, que se suben juntas al buffer de paletas
+			uint32_t GetBonePaletteMatrixCount() const noexcept { return static_cast<uint32_t>(m_matrixPalettes.size()); }
+			const LightClusters& GetLightClusters() const noexcept { return m_lightClusters; }
+			// Tiempo en segundos que tomo la extraccion de este snapshot
+			float GetExtractionTime() const noexcept { return m_extractionTime; }
+			void Clear() noexcept;
+		private:
+			struct StaticMeshDraw {
+				std::shared_ptr<Mesh> mesh;
+				std::shared_ptr<Material> material;
+				// Indice de las matrices y datos de decodificacion de este draw en m_drawData
+				uint32_t drawDataIndex;
+				// Rango del buffer de indices del nivel de detalle elegido
+				uint32_t indexOffset;
+				uint32_t indexCount;
+				// Rango en m_terrainChunkDraws, vacio si la malla no es un terreno
+				uint32_t terrainDrawOffset;
+				uint32_t terrainDrawCount;
+			};
+			struct SkinnedMeshDraw {
+				std::shared_ptr<SkinnedMesh> mesh;
+				std::shared_ptr<Material> material;
+				// El offset de la paleta de la malla en m_matrixPalettes va en su DrawData
+				uint32_t drawDataIndex;
+				uint32_t indexOffset;
+				uint32_t indexCount;
+			};
+			bool m_valid = false;
+			float m_extractionTime = 0.0f;
+			glm::mat4 m_viewMatrix = glm::mat4(1.0f);
+			glm::mat4 m_projectionMatrix = glm::mat4(1.0f);
+			glm::vec3 m_cameraPosition = glm::vec3(0.0f);
+			Lights m_lights;
+			std::vector<StaticMeshDraw> m_staticDraws;
+			std::vector<SkinnedMeshDraw> m_skinnedDraws;
+			std::vector<DrawData> m_drawData;
+			std::vector<glm::mat4> m_matrixPalettes;
+			std::vector<Mesh::TerrainChunkDraw> m_terrainChunkDraws;
+			std::vector<DirectionalLight> m_directionalLights;
+			std::vector<PointLight> m_pointLights;
+			std::vector<SpotLight> m_spotLights;
+			std::vector<LightClusters::LightBounds> m_pointLightBounds;
+			std::vector<LightClusters::LightBounds> m_spotLightBounds;
+			LightClusters m_lightClusters;
+		};
+	private:
 		std::array<ShaderProgram, 2 * static_cast<unsigned int>(MaterialType::MaterialTypeCount)> m_shaders;
-		std::vector<glm::mat4> m_currentMatrixPalette;
+		RenderSnapshot m_immediateSnapshot;
+		float m_lastExtractionTime = 0.0f;
 		SubscriptionHandle m_onWindowResizeSubscription;
 		DebugDrawingSystem* m_debugDrawingSystemPtr = nullptr;
+		void UploadLightBuffer(LightBuffer buffer, const void* data, std::size_t size) noexcept;
+		void UploadBonePalettes(const std::vector<glm::mat4>& matrixPalettes) noexcept;
+		// Activa material si no es el del draw anterior y enlaza el DrawData que empieza en drawDataOffset
+		void BindDraw(Material& material, std::size_t drawDataOffset, const Material*& boundMaterial) noexcept;
+		template <typename MeshType>
+		static DrawData MakeDrawData(const MeshType& mesh, const glm::mat4& modelMatrix, const glm::mat4& viewProjectionMatrix, uint32_t paletteOffset) noexcept;
+		// Escribe los datos de los draws en el siguiente segmento del buffer circular y devuelve el offset de ese segmento
+		std::size_t UploadDrawData(const std::vector<DrawData>& drawData) noexcept;
 		unsigned int m_lightDataUBO = 0;
+		std::array<unsigned int, static_cast<uint32_t>(LightBuffer::LightBufferCount)> m_lightBuffers = {};
+		std::array<std::size_t, static_cast<uint32_t>(LightBuffer::LightBufferCount)> m_lightBufferCapacities = {};
+		unsigned int m_bonePaletteBuffer = 0;
+		std::size_t m_bonePaletteBufferCapacity = 0;
+		unsigned int m_frameUBO = 0;
+		//Buffer circular de DrawData con un segmento por frame en vuelo, cada uno protegido por un fence
+		unsigned int m_drawDataBuffer = 0;
+		std::size_t m_drawDataStride = 0;
+		std::size_t m_drawDataSegmentCapacity = 0;
+		uint32_t m_drawDataSegment = 0;
+		std::array<void*, DRAW_DATA_RING_SEGMENTS> m_drawDataFences = {};
+		glm::vec2 m_viewportSize = glm::vec2(1.0f);
 		glm::vec4 m_backgroundColor = { 0.0f, 0.0f, 0.0f, 0.0f };
 
 	};
@@ -132,11 +132,10 @@ namespace Mona {
 			std::string key;
 			std::string value;
 		};
-		std::array<ShaderConstant,4> constants = {{
-			{"${MAX_DIRECTIONAL_LIGHTS}", std::to_string(Renderer::NUM_HALF_MAX_DIRECTIONAL_LIGHTS * 2)},
-			{"${MAX_SPOT_LIGHTS}", std::to_string(Renderer::NUM_HALF_MAX_SPOT_LIGHTS * 2)} ,
-			{"${MAX_POINT_LIGHTS}", std::to_string(Renderer::NUM_HALF_MAX_POINT_LIGHTS * 2)},
-			{"${MAX_BONES}", std::to_string(Renderer::NUM_MAX_BONES)}} };
+		std::array<ShaderConstant,3> constants = {{
+			{"${LIGHT_CLUSTERS_X}", std::to_string(LIGHT_CLUSTERS_X)},
+			{"${LIGHT_CLUSTERS_Y}", std::to_string(LIGHT_CLUSTERS_Y)} ,
+			{"${LIGHT_CLUSTERS_Z}", std::to_string(LIGHT_CLUSTERS_Z)}} };
 		
 		for (ShaderConstant& c : constants) {
 			size_t pos = 0;
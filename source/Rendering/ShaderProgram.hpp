@@ -8,33 +8,27 @@
 namespace Mona {
 	class ShaderProgram {
 	public:
-		static constexpr int MvpMatrixShaderLocation = 0;
-		static constexpr int ModelMatrixShaderLocation = 1;
-		static constexpr int ModelInverseTransposeMatrixShaderLocation = 2;
-		static constexpr int UnlitColorShaderLocation = 3;
+		//Los samplers conservan ubicaciones fijas; el resto de los parametros se lee desde uniform buffers
 		static constexpr int UnlitColorTextureSamplerShaderLocation = 3;
 		static constexpr int UnlitColorTextureUnit = 0;
-		static constexpr int DiffuseColorShaderLocation = 3;
 		static constexpr int DiffuseTextureSamplerShaderLocation = 3;
 		static constexpr int DiffuseTextureUnit = 0;
-		static constexpr int AlbedoShaderLocation = 3;
 		static constexpr int AlbedoTextureSamplerShaderLocation = 3;
 		static constexpr int AlbedoTextureUnit = 0;
 		static constexpr int NormalMapSamplerShaderLocation = 5;
 		static constexpr int NormalMapTextureUnit = 1;
-		static constexpr int MetallicShaderLocation = 6;
 		static constexpr int MetallicSamplerShaderLocation = 6;
 		static constexpr int MetallicTextureUnit = 2;
-		static constexpr int RoughnessShaderLocation = 7;
 		static constexpr int RoughnessSamplerShaderLocation = 7;
 		static constexpr int RoughnessTextureUnit = 3;
-		static constexpr int AmbientOcclusionShaderLocation = 8;
 		static constexpr int AmbientOcclusionSamplerShaderLocation = 8;
 		static constexpr int AmbientOcclusionTextureUnit = 4;
-		static constexpr int MaterialTintShaderLocation = 4;
 		static constexpr int LightsUniformBlockBinding = 0;
-		static constexpr int CameraPositionShaderLocation = 9;
-		static constexpr int BoneTransformShaderLocation = 10;
+		static constexpr int FrameUniformBlockBinding = 1;
+		static constexpr int DrawDataUniformBlockBinding = 2;
+		static constexpr int MaterialUniformBlockBinding = 3;
+		//Las luces usan los bindings 1 a 5 de shader storage y las paletas de matrices de los huesos el siguiente
+		static constexpr int BonePalettesStorageBinding = 6;
 
 
 		ShaderProgram(const std::filesystem::path& vertexShaderPath,
@@ -4,11 +4,31 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 layout (location = 5) in vec4 aBoneIndices;
 layout (location = 6) in vec4 aBoneWeights;
-layout(location = 0) uniform mat4 mvpMatrix;
-layout(location = 1) uniform mat4 modelMatrix;
-layout(location = 2) uniform mat4 modelInverseTransposeMatrix;
+//Datos de cada draw, leidos del buffer circular del frame (ver Renderer::DrawData). Las posiciones comprimidas se
+//decodifican con positionScale y positionOffset (ver VertexCompression.hpp); en mallas sin comprimir son 1 y 0
+layout(std140, binding = 2) uniform DrawData {
+	mat4 mvpMatrix;
+	mat4 modelMatrix;
+	mat4 modelInverseTransposeMatrix;
+	vec3 positionScale;
+	uint compressedVertices;
+	vec3 positionOffset;
+	uint paletteOffset;
+};
 
-layout(location = 10) uniform mat4 boneTransforms[${MAX_BONES}];
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-v.z, 0.0);
+	v.x += v.x >= 0.0 ? -t : t;
+	v.y += v.y >= 0.0 ? -t : t;
+	return normalize(v);
+}
+
+//Paletas de matrices de todas las mallas animadas del frame, cada malla lee la suya desde paletteOffset de DrawData
+layout(std430, binding = 6) readonly buffer BonePalettes {
+	mat4 bonePalettes[];
+};
 
 out vec3 normal;
 out vec3 worldPos;
@@ -16,16 +36,18 @@ out vec2 texCoord;
 
 void main()
 {
+	vec3 position = aPos * positionScale + positionOffset;
+	vec3 vertexNormal = compressedVertices != 0u ? DecodeOctahedral(aNormal.xy) : aNormal;
 	//boneTransform representa la matriz al aplicar la piel a este vertice
 	mat4 boneTransform  =  mat4(0.0);
-	boneTransform  +=    boneTransforms[int(aBoneIndices.x)] * aBoneWeights.x;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.y)] * aBoneWeights.y;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.z)] * aBoneWeights.z;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.w)] * aBoneWeights.w;	
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.x)] * aBoneWeights.x;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.y)] * aBoneWeights.y;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.z)] * aBoneWeights.z;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.w)] * aBoneWeights.w;	
 	texCoord = aTexCoord;
 	mat4 finalModelTransform = modelMatrix * boneTransform;
-	worldPos = vec3(finalModelTransform * vec4(aPos, 1.0f));
-	normal = normalize(mat3(transpose(inverse(finalModelTransform))) * aNormal);
-	gl_Position = mvpMatrix * boneTransform * vec4(aPos,1.0);
+	worldPos = vec3(finalModelTransform * vec4(position, 1.0f));
+	normal = normalize(mat3(transpose(inverse(finalModelTransform))) * vertexNormal);
+	gl_Position = mvpMatrix * boneTransform * vec4(position,1.0);
 
 }
\ No newline at end of file
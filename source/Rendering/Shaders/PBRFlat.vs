@@ -1,9 +1,26 @@
 #version 450 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
-layout(location = 0) uniform mat4 mvpMatrix;
-layout(location = 1) uniform mat4 modelMatrix;
-layout(location = 2) uniform mat4 modelInverseTransposeMatrix;
+//Datos de cada draw, leidos del buffer circular del frame (ver Renderer::DrawData). Las posiciones comprimidas se
+//decodifican con positionScale y positionOffset (ver VertexCompression.hpp); en mallas sin comprimir son 1 y 0
+layout(std140, binding = 2) uniform DrawData {
+	mat4 mvpMatrix;
+	mat4 modelMatrix;
+	mat4 modelInverseTransposeMatrix;
+	vec3 positionScale;
+	uint compressedVertices;
+	vec3 positionOffset;
+	uint paletteOffset;
+};
+
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-v.z, 0.0);
+	v.x += v.x >= 0.0 ? -t : t;
+	v.y += v.y >= 0.0 ? -t : t;
+	return normalize(v);
+}
 
 //out vec3 normal;
 out vec3 worldPos;
@@ -11,8 +28,10 @@ out vec3 normal;
 
 void main()
 {
-	normal = normalize(mat3(modelInverseTransposeMatrix) * aNormal);
-	worldPos = vec3(modelMatrix * vec4(aPos,1.0f));
-	gl_Position = mvpMatrix * vec4(aPos,1.0f);
+	vec3 position = aPos * positionScale + positionOffset;
+	vec3 vertexNormal = compressedVertices != 0u ? DecodeOctahedral(aNormal.xy) : aNormal;
+	normal = normalize(mat3(modelInverseTransposeMatrix) * vertexNormal);
+	worldPos = vec3(modelMatrix * vec4(position,1.0f));
+	gl_Position = mvpMatrix * vec4(position,1.0f);
 
 }
\ No newline at end of file
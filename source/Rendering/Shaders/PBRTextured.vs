@@ -4,9 +4,26 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 layout (location = 3) in vec3 aTangent;
 layout (location = 4) in vec3 aBitangent;
-layout(location = 0) uniform mat4 mvpMatrix;
-layout(location = 1) uniform mat4 modelMatrix;
-layout(location = 2) uniform mat4 modelInverseTransposeMatrix;
+//Datos de cada draw, leidos del buffer circular del frame (ver Renderer::DrawData). Las posiciones comprimidas se
+//decodifican con positionScale y positionOffset (ver VertexCompression.hpp); en mallas sin comprimir son 1 y 0
+layout(std140, binding = 2) uniform DrawData {
+	mat4 mvpMatrix;
+	mat4 modelMatrix;
+	mat4 modelInverseTransposeMatrix;
+	vec3 positionScale;
+	uint compressedVertices;
+	vec3 positionOffset;
+	uint paletteOffset;
+};
+
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-v.z, 0.0);
+	v.x += v.x >= 0.0 ? -t : t;
+	v.y += v.y >= 0.0 ? -t : t;
+	return normalize(v);
+}
 
 //out vec3 normal;
 out vec3 worldPos;
@@ -17,12 +34,17 @@ out vec3 bitangent;
 
 void main()
 {
-	normal = normalize(mat3(modelInverseTransposeMatrix) * aNormal);
-	tangent = normalize(mat3(modelMatrix)* aTangent);
-	bitangent = normalize(mat3(modelMatrix)* aBitangent);
+	vec3 position = aPos * positionScale + positionOffset;
+	vec3 vertexNormal = compressedVertices != 0u ? DecodeOctahedral(aNormal.xy) : aNormal;
+	vec3 vertexTangent = compressedVertices != 0u ? DecodeOctahedral(aTangent.xy) : aTangent;
+	//En vertices comprimidos aTangent.z guarda el signo de la bitangente
+	vec3 vertexBitangent = compressedVertices != 0u ? cross(vertexNormal, vertexTangent) * aTangent.z : aBitangent;
+	normal = normalize(mat3(modelInverseTransposeMatrix) * vertexNormal);
+	tangent = normalize(mat3(modelMatrix)* vertexTangent);
+	bitangent = normalize(mat3(modelMatrix)* vertexBitangent);
 
 	texCoord = aTexCoord;
-	worldPos = vec3(modelMatrix * vec4(aPos,1.0f));
-	gl_Position = mvpMatrix * vec4(aPos,1.0f);
+	worldPos = vec3(modelMatrix * vec4(position,1.0f));
+	gl_Position = mvpMatrix * vec4(position,1.0f);
 
 }
\ No newline at end of file
@@ -7,11 +7,31 @@ layout (location = 4) in vec3 aBitangent;
 layout (location = 5) in vec4 aBoneIndices;
 layout (location = 6) in vec4 aBoneWeights;
 
-layout(location = 0) uniform mat4 mvpMatrix;
-layout(location = 1) uniform mat4 modelMatrix;
-layout(location = 2) uniform mat4 modelInverseTransposeMatrix;
+//Datos de cada draw, leidos del buffer circular del frame (ver Renderer::DrawData). Las posiciones comprimidas se
+//decodifican con positionScale y positionOffset (ver VertexCompression.hpp); en mallas sin comprimir son 1 y 0
+layout(std140, binding = 2) uniform DrawData {
+	mat4 mvpMatrix;
+	mat4 modelMatrix;
+	mat4 modelInverseTransposeMatrix;
+	vec3 positionScale;
+	uint compressedVertices;
+	vec3 positionOffset;
+	uint paletteOffset;
+};
 
-layout(location = 10) uniform mat4 boneTransforms[${MAX_BONES}];
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-v.z, 0.0);
+	v.x += v.x >= 0.0 ? -t : t;
+	v.y += v.y >= 0.0 ? -t : t;
+	return normalize(v);
+}
+
+//Paletas de matrices de todas las mallas animadas del frame, cada malla lee la suya desde paletteOffset de DrawData
+layout(std430, binding = 6) readonly buffer BonePalettes {
+	mat4 bonePalettes[];
+};
 
 out vec3 worldPos;
 out vec2 texCoord;
@@ -21,19 +41,24 @@ out vec3 bitangent;
 
 void main()
 {
+	vec3 position = aPos * positionScale + positionOffset;
+	vec3 vertexNormal = compressedVertices != 0u ? DecodeOctahedral(aNormal.xy) : aNormal;
+	vec3 vertexTangent = compressedVertices != 0u ? DecodeOctahedral(aTangent.xy) : aTangent;
+	//En vertices comprimidos aTangent.z guarda el signo de la bitangente
+	vec3 vertexBitangent = compressedVertices != 0u ? cross(vertexNormal, vertexTangent) * aTangent.z : aBitangent;
 	//boneTransform representa la matriz al aplicar la piel a este vertice
 	mat4 boneTransform  =  mat4(0.0);
-	boneTransform  +=    boneTransforms[int(aBoneIndices.x)] * aBoneWeights.x;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.y)] * aBoneWeights.y;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.z)] * aBoneWeights.z;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.w)] * aBoneWeights.w;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.x)] * aBoneWeights.x;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.y)] * aBoneWeights.y;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.z)] * aBoneWeights.z;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.w)] * aBoneWeights.w;
 	mat4 finalModelTransform = modelMatrix * boneTransform;
-	normal = normalize(mat3(transpose(inverse(finalModelTransform))) * aNormal);
-	tangent = normalize(mat3(finalModelTransform)* aTangent);
-	bitangent = normalize(mat3(finalModelTransform)* aBitangent);
+	normal = normalize(mat3(transpose(inverse(finalModelTransform))) * vertexNormal);
+	tangent = normalize(mat3(finalModelTransform)* vertexTangent);
+	bitangent = normalize(mat3(finalModelTransform)* vertexBitangent);
 
 	texCoord = aTexCoord;
-	worldPos = vec3(finalModelTransform * vec4(aPos,1.0f));
-	gl_Position = mvpMatrix * boneTransform * vec4(aPos,1.0f);
+	worldPos = vec3(finalModelTransform * vec4(position,1.0f));
+	gl_Position = mvpMatrix * boneTransform * vec4(position,1.0f);
 
 }
\ No newline at end of file
@@ -2,18 +2,30 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 5) in vec4 aBoneIndices;
 layout (location = 6) in vec4 aBoneWeights;
-layout(location = 0) uniform mat4 mvpMatrix;
-layout(location = 1) uniform mat4 modelMatrix;
-layout(location = 2) uniform mat4 modelInverseTransposeMatrix;
+//Datos de cada draw, leidos del buffer circular del frame (ver Renderer::DrawData). Las posiciones comprimidas se
+//decodifican con positionScale y positionOffset (ver VertexCompression.hpp); en mallas sin comprimir son 1 y 0
+layout(std140, binding = 2) uniform DrawData {
+	mat4 mvpMatrix;
+	mat4 modelMatrix;
+	mat4 modelInverseTransposeMatrix;
+	vec3 positionScale;
+	uint compressedVertices;
+	vec3 positionOffset;
+	uint paletteOffset;
+};
 
-layout(location = 10) uniform mat4 boneTransforms[${MAX_BONES}];
+//Paletas de matrices de todas las mallas animadas del frame, cada malla lee la suya desde paletteOffset de DrawData
+layout(std430, binding = 6) readonly buffer BonePalettes {
+	mat4 bonePalettes[];
+};
 
 void main()
 {
+	vec3 position = aPos * positionScale + positionOffset;
 	mat4 boneTransform  =  mat4(0.0);
-	boneTransform  +=    boneTransforms[int(aBoneIndices.x)] * aBoneWeights.x;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.y)] * aBoneWeights.y;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.z)] * aBoneWeights.z;
-	boneTransform  +=    boneTransforms[int(aBoneIndices.w)] * aBoneWeights.w;	
-	gl_Position = mvpMatrix * boneTransform * vec4(aPos,1.0);
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.x)] * aBoneWeights.x;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.y)] * aBoneWeights.y;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.z)] * aBoneWeights.z;
+	boneTransform  +=    bonePalettes[paletteOffset + uint(aBoneIndices.w)] * aBoneWeights.w;	
+	gl_Position = mvpMatrix * boneTransform * vec4(position,1.0);
 }
\ No newline at end of file
@@ -1,14 +1,23 @@
 #version 450 core
 layout (location = 0) in vec3 aPos;
 layout (location = 2) in vec2 aTexCoord;
-layout(location = 0) uniform mat4 mvpMatrix;
-layout(location = 1) uniform mat4 modelMatrix;
-layout(location = 2) uniform mat4 modelInverseTransposeMatrix;
+//Datos de cada draw, leidos del buffer circular del frame (ver Renderer::DrawData). Las posiciones comprimidas se
+//decodifican con positionScale y positionOffset (ver VertexCompression.hpp); en mallas sin comprimir son 1 y 0
+layout(std140, binding = 2) uniform DrawData {
+	mat4 mvpMatrix;
+	mat4 modelMatrix;
+	mat4 modelInverseTransposeMatrix;
+	vec3 positionScale;
+	uint compressedVertices;
+	vec3 positionOffset;
+	uint paletteOffset;
+};
 
 out vec2 texCoord;
 
 void main()
 {
+	vec3 position = aPos * positionScale + positionOffset;
 	texCoord = aTexCoord;
-	gl_Position = mvpMatrix * vec4(aPos,1.0f);
+	gl_Position = mvpMatrix * vec4(position,1.0f);
 }
\ No newline at end of file
@@ -38,6 +38,11 @@ namespace Mona {
 			return m_meshPtr->GetHeightMap();
 		}
 
+		// Forma de colision de la malla como terreno, ver Mesh::GetTerrainShape
+		std::shared_ptr<TerrainShape> GetTerrainShape() const noexcept {
+			return m_meshPtr->GetTerrainShape();
+		}
+
 		void SetMaterial(std::shared_ptr<Material> material) noexcept {
 			if (material != nullptr)
 			{
@@ -50,6 +55,8 @@ namespace Mona {
 	private:
 		std::shared_ptr<Mesh> m_meshPtr;
 		std::shared_ptr<Material> m_materialPtr;
+		// Nivel de detalle elegido en el ultimo frame, para la histeresis al cambiar de nivel
+		uint32_t m_lodLevel = 0;
 	};
 }
 #endif
\ No newline at end of file
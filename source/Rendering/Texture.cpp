@@ -1,8 +1,11 @@
 #include "Texture.hpp"
 
-#include <stb_image.h>
+#include "TextureCache.hpp"
 #include "../Core/Log.hpp"
 #include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 namespace Mona {
 
 	GLenum WrapEnumToOpenGLEnum(WrapMode wrapMode) {
@@ -90,6 +93,47 @@ namespace Mona {
 		MONA_ASSERT(m_ID, "Texture Error: Trying to clear data from already freed texture.");
 		glDeleteTextures(1, &m_ID);
 		m_ID = 0;
+		m_memoryAccount.Reset();
+	}
+
+	//Formatos comprimidos definidos por la extension GL_EXT_texture_compression_s3tc, que glad no incluye
+	#define MONA_GL_COMPRESSED_RGB_S3TC_DXT1 0x83F0
+	#define MONA_GL_COMPRESSED_RGBA_S3TC_DXT1 0x83F1
+	#define MONA_GL_COMPRESSED_RGBA_S3TC_DXT5 0x83F3
+
+	static GLenum BlockFormatToOpenGLEnum(TextureBlockFormat format, uint32_t channels) {
+		switch (format)
+		{
+		case Mona::TextureBlockFormat::BC1:
+			return channels == 4 ? MONA_GL_COMPRESSED_RGBA_S3TC_DXT1 : MONA_GL_COMPRESSED_RGB_S3TC_DXT1;
+		case Mona::TextureBlockFormat::BC3:
+			return MONA_GL_COMPRESSED_RGBA_S3TC_DXT5;
+		case Mona::TextureBlockFormat::BC5:
+			return GL_COMPRESSED_RG_RGTC2;
+		default:
+			return 0;
+		}
+	}
+
+	static bool IsCompressedFormatSupported(GLenum internalFormat) {
+		//La lista de formatos no cambia durante la ejecucion, por lo que se consulta una sola vez
+		static const std::vector<GLint> supportedFormats = []() {
+			GLint formatCount = 0;
+			glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &formatCount);
+			std::vector<GLint> formats(formatCount);
+			if (0 < formatCount)
+				glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+			return formats;
+		}();
+		return std::find(supportedFormats.begin(), supportedFormats.end(), static_cast<GLint>(internalFormat)) != supportedFormats.end();
+	}
+
+	Texture::Texture() :
+		m_ID(0),
+		m_width(0),
+		m_height(0),
+		m_channels(0)
+	{
 	}
 
 	Texture::Texture(const std::string& stringFilePath,
@@ -97,24 +141,51 @@ namespace Mona {
 		TextureMinificationFilter minFilter,
 		WrapMode sWrapMode,
 		WrapMode tWrapMode,
-		bool genMipmaps) :
-		m_ID(0),
-		m_width(0),
-		m_height(0),
-		m_channels(0)
+		bool genMipmaps) : Texture()
 	{
+		std::shared_ptr<TextureImage> image = ReadFile(stringFilePath);
+		if (image) {
+			Upload(*image, magFilter, minFilter, sWrapMode, tWrapMode, genMipmaps);
+		}
+	}
 
-		int width, height, channels;
-		//Se carga los datos de la imagen usando stb
-		stbi_uc* data = stbi_load(stringFilePath.c_str(), &width, &height, &channels, 0);
-		if (!data) {
-			MONA_LOG_ERROR("Texture Error: Failed to load texture from {0} file.", stringFilePath);
-			stbi_image_free(data);
+	std::shared_ptr<TextureImage> Texture::ReadFile(const std::string& stringFilePath) noexcept {
+		//Usa la version horneada de la imagen cuando existe, evitando decodificarla y generar sus mipmaps
+		return TextureCache::GetInstance().LoadTextureImage(stringFilePath);
+	}
+
+	std::shared_ptr<TextureImage> Texture::CreateSolidColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept {
+		std::shared_ptr<TextureImage> image = std::make_shared<TextureImage>();
+		image->width = 1;
+		image->height = 1;
+		image->channels = 4;
+		image->levels.push_back({ r, g, b, a });
+		return image;
+	}
+
+	void Texture::Upload(const TextureImage& image,
+		TextureMagnificationFilter magFilter,
+		TextureMinificationFilter minFilter,
+		WrapMode sWrapMode,
+		WrapMode tWrapMode,
+		bool genMipmaps) noexcept
+	{
+		if (image.levels.empty())
 			return;
-		}
 		GLenum internalFormat = 0;
 		GLenum dataFormat = 0;
-		if (channels == 1)
+		uint32_t channels = image.channels;
+		bool compressed = image.format != TextureBlockFormat::Uncompressed;
+		if (compressed && !IsCompressedFormatSupported(BlockFormatToOpenGLEnum(image.format, channels))) {
+			//Sin soporte en la GPU los niveles se suben descomprimidos como RGBA
+			compressed = false;
+			channels = 4;
+		}
+		if (compressed)
+		{
+			internalFormat = BlockFormatToOpenGLEnum(image.format, channels);
+		}
+		else if (channels == 1)
 		{
 			internalFormat = GL_R8;
 			dataFormat = GL_RED;
@@ -130,27 +201,54 @@ namespace Mona {
 			dataFormat = GL_RGB;
 		}
 
-		if (!(internalFormat & dataFormat)) {
-			MONA_LOG_ERROR("Texture Error: Texture format not supported.", stringFilePath);
-			stbi_image_free(data);
-			return;
-		}
+		//Sin mipmaps precalculados se reserva la cadena completa para que la GPU la genere
+		const bool generateMipmaps = genMipmaps && image.levels.size() == 1;
+		GLsizei levelCount = genMipmaps ? static_cast<GLsizei>(image.levels.size()) : 1;
+		if (generateMipmaps)
+			levelCount = 1 + static_cast<GLsizei>(std::floor(std::log2(std::max(image.width, image.height))));
 
 		//Se pasa los datos de CPU a GPU usando OpenGL
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_ID);
-		glTextureStorage2D(m_ID, 1, internalFormat, width, height);
+		glTextureStorage2D(m_ID, levelCount, internalFormat, image.width, image.height);
 		glTextureParameteri(m_ID, GL_TEXTURE_WRAP_S, WrapEnumToOpenGLEnum(sWrapMode));
 		glTextureParameteri(m_ID, GL_TEXTURE_WRAP_T, WrapEnumToOpenGLEnum(tWrapMode));
 		glTextureParameteri(m_ID, GL_TEXTURE_MAG_FILTER, MagnificationFilterEnumToOpenGLEnum(magFilter));
 		glTextureParameteri(m_ID, GL_TEXTURE_MIN_FILTER, MinificationFilterEnumToOpenGLEnum(minFilter));
-		glTextureSubImage2D(m_ID, 0, 0, 0, width, height, dataFormat, GL_UNSIGNED_BYTE, data);
-		if (genMipmaps) {
+		//Las filas de imagenes RGB o de un canal no siempre estan alineadas a 4 bytes
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		std::size_t uploadedBytes = 0;
+		const GLsizei uploadedLevels = generateMipmaps ? 1 : levelCount;
+		uint32_t width = image.width;
+		uint32_t height = image.height;
+		for (GLsizei level = 0; level < uploadedLevels; level++) {
+			const std::vector<uint8_t>& data = image.levels[level];
+			if (compressed) {
+				glCompressedTextureSubImage2D(m_ID, level, 0, 0, width, height, internalFormat, static_cast<GLsizei>(data.size()), data.data());
+				uploadedBytes += data.size();
+			}
+			else if (image.format != TextureBlockFormat::Uncompressed) {
+				std::vector<uint8_t> rgba = DecompressTextureLevel(data.data(), width, height, image.format);
+				glTextureSubImage2D(m_ID, level, 0, 0, width, height, dataFormat, GL_UNSIGNED_BYTE, rgba.data());
+				uploadedBytes += rgba.size();
+			}
+			else {
+				glTextureSubImage2D(m_ID, level, 0, 0, width, height, dataFormat, GL_UNSIGNED_BYTE, data.data());
+				uploadedBytes += data.size();
+			}
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		if (generateMipmaps) {
 			glGenerateTextureMipmap(m_ID);
+			//La cadena generada ocupa cerca de un tercio extra del primer nivel
+			uploadedBytes += uploadedBytes / 3;
 		}
-		m_channels = channels;
-		m_width = width;
-		m_height = height;
-		stbi_image_free(data);
+		m_channels = image.channels;
+		m_width = image.width;
+		m_height = image.height;
+		m_memoryAccount.Set(0, uploadedBytes);
+		m_placeholder.reset();
 	}
 
 }
\ No newline at end of file
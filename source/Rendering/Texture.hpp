@@ -2,8 +2,11 @@
 #ifndef TEXTURE_HPP
 #define TEXTURE_HPP
 #include <cstdint>
+#include <memory>
 #include <string>
+#include "../Core/MemoryTracker.hpp"
 namespace Mona {
+	struct TextureImage;
 	enum class TextureMagnificationFilter {
 		Nearest,
 		Linear
@@ -28,7 +31,8 @@ namespace Mona {
 		friend class TextureManager;
 		uint32_t GetWidth() const { return m_width; }
 		uint32_t GetHeight() const { return m_height; }
-		uint32_t GetID() const { return m_ID; }
+		// Mientras una carga asincrona no termina se entrega la textura placeholder
+		uint32_t GetID() const { return m_ID != 0 || !m_placeholder ? m_ID : m_placeholder->GetID(); }
 		void SetSWrapMode(WrapMode wrapMode) noexcept;
 		void SetTWrapMode(WrapMode wrapMode) noexcept;
 		void SetMagnificationFilter(TextureMagnificationFilter magFilter) noexcept;
@@ -41,11 +45,27 @@ namespace Mona {
 			WrapMode sWrapMode = WrapMode::Repeat,
 			WrapMode tWrapMode = WrapMode::Repeat,
 			bool genMipmaps = false);
+		Texture();
+		// Solo usa CPU, por lo que puede llamarse desde cualquier hilo. Devuelve nullptr si la imagen no se pudo leer
+		static std::shared_ptr<TextureImage> ReadFile(const std::string& stringFilePath) noexcept;
+		static std::shared_ptr<TextureImage> CreateSolidColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept;
+		/*
+		* Sube los niveles de image. Si genMipmaps es falso solo se usa el primero, y si la imagen no trae mipmaps se generan
+		* en la GPU. Los formatos comprimidos que la GPU no soporta se descomprimen antes en CPU.
+		*/
+		void Upload(const TextureImage& image,
+			TextureMagnificationFilter magFilter,
+			TextureMinificationFilter minFilter,
+			WrapMode sWrapMode,
+			WrapMode tWrapMode,
+			bool genMipmaps) noexcept;
 		void ClearData() noexcept;
 		uint32_t m_ID;
 		uint32_t m_width;
 		uint32_t m_height;
 		uint32_t m_channels;
+		std::shared_ptr<Texture> m_placeholder;
+		MemoryAccount m_memoryAccount{ MemoryTag::Textures };
 	};
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include "TextureCache.hpp"
+#include "../Core/Config.hpp"
+#include "../Core/Log.hpp"
+#include <stb_image.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Mona {
+
+	static const char textureCacheMagic[4] = { 'M', 'T', 'E', 'X' };
+
+	template <typename T>
+	static void WriteValue(std::ofstream& out, const T& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	static bool ReadValue(std::ifstream& in, T& value) {
+		in.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return in.good();
+	}
+
+	//Tamano y fecha de modificacion de la imagen original, para detectar archivos horneados desactualizados
+	static bool GetSourceStamp(const std::string& filePath, uint64_t& outSize, int64_t& outTime) {
+		std::error_code errorCode;
+		outSize = std::filesystem::file_size(filePath, errorCode);
+		if (errorCode)
+			return false;
+		outTime = std::filesystem::last_write_time(filePath, errorCode).time_since_epoch().count();
+		return !errorCode;
+	}
+
+	TextureCache::TextureCache() {
+		auto& config = Config::GetInstance();
+		m_enabled = config.getValueOrDefault<int>("use_texture_cache", 1) != 0;
+		m_bakeOnLoad = config.getValueOrDefault<int>("bake_texture_cache", 0) != 0;
+		m_compress = config.getValueOrDefault<int>("texture_cache_compression", 1) != 0;
+	}
+
+	std::filesystem::path TextureCache::GetBakedFilePath(const std::string& filePath) {
+		return std::filesystem::path(filePath + TEXTURE_CACHE_EXTENSION);
+	}
+
+	std::shared_ptr<TextureImage> TextureCache::LoadTextureImage(const std::string& filePath) const noexcept {
+		if (m_enabled) {
+			std::shared_ptr<TextureImage> baked = ReadBakedFile(filePath);
+			if (baked)
+				return baked;
+		}
+		std::shared_ptr<TextureImage> image = DecodeSourceImage(filePath);
+		if (!image || !m_enabled || !m_bakeOnLoad)
+			return image;
+		std::shared_ptr<TextureImage> baked = std::make_shared<TextureImage>(BakeImage(*image, GetDefaultFormat(*image)));
+		WriteBakedFile(filePath, *baked);
+		return baked;
+	}
+
+	bool TextureCache::BakeFile(const std::string& filePath, TextureBlockFormat format) const noexcept {
+		std::shared_ptr<TextureImage> image = DecodeSourceImage(filePath);
+		if (!image)
+			return false;
+		return WriteBakedFile(filePath, BakeImage(*image, format));
+	}
+
+	TextureBlockFormat TextureCache::GetDefaultFormat(const TextureImage& image) const noexcept {
+		if (!m_compress || image.channels < 3 || image.levels.empty())
+			return TextureBlockFormat::Uncompressed;
+		if (image.channels == 4) {
+			const std::vector<uint8_t>& pixels = image.levels[0];
+			for (std::size_t i = 3; i < pixels.size(); i += 4) {
+				if (pixels[i] != 255)
+					return TextureBlockFormat::BC3;
+			}
+		}
+		return TextureBlockFormat::BC1;
+	}
+
+	TextureImage TextureCache::BakeImage(const TextureImage& source, TextureBlockFormat format) noexcept {
+		TextureImage baked;
+		baked.width = source.width;
+		baked.height = source.height;
+		baked.channels = source.channels;
+		baked.format = format;
+		if (source.levels.empty())
+			return baked;
+		std::vector<uint8_t> level = source.levels[0];
+		uint32_t width = source.width;
+		uint32_t height = source.height;
+		while (true) {
+			if (format == TextureBlockFormat::Uncompressed) {
+				baked.levels.push_back(level);
+			}
+			else {
+				//Los bloques se comprimen desde RGBA, completando los canales que no tiene la imagen original
+				std::vector<uint8_t> rgba(static_cast<std::size_t>(width) * height * 4);
+				for (std::size_t i = 0; i < static_cast<std::size_t>(width) * height; i++) {
+					const uint8_t* texel = level.data() + i * source.channels;
+					rgba[i * 4 + 0] = texel[0];
+					rgba[i * 4 + 1] = source.channels > 1 ? texel[1] : texel[0];
+					rgba[i * 4 + 2] = source.channels > 2 ? texel[2] : texel[0];
+					rgba[i * 4 + 3] = source.channels > 3 ? texel[3] : 255;
+				}
+				baked.levels.push_back(CompressTextureLevel(rgba.data(), width, height, format));
+			}
+			if (width == 1 && height == 1)
+				break;
+			level = DownsampleTextureLevel(level.data(), width, height, source.channels);
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+		return baked;
+	}
+
+	std::shared_ptr<TextureImage> TextureCache::DecodeSourceImage(const std::string& filePath) noexcept {
+		int width, height, channels;
+		//Se carga los datos de la imagen usando stb
+		stbi_uc* data = stbi_load(filePath.c_str(), &width, &height, &channels, 0);
+		if (!data) {
+			MONA_LOG_ERROR("Texture Error: Failed to load texture from {0} file.", filePath);
+			stbi_image_free(data);
+			return nullptr;
+		}
+		if (channels != 1 && channels != 3 && channels != 4) {
+			MONA_LOG_ERROR("Texture Error: Texture format of {0} not supported.", filePath);
+			stbi_image_free(data);
+			return nullptr;
+		}
+		std::shared_ptr<TextureImage> image = std::make_shared<TextureImage>();
+		image->width = static_cast<uint32_t>(width);
+		image->height = static_cast<uint32_t>(height);
+		image->channels = static_cast<uint32_t>(channels);
+		image->levels.emplace_back(data, data + static_cast<std::size_t>(width) * height * channels);
+		stbi_image_free(data);
+		return image;
+	}
+
+	std::shared_ptr<TextureImage> TextureCache::ReadBakedFile(const std::string& filePath) const noexcept {
+		const std::filesystem::path bakedPath = GetBakedFilePath(filePath);
+		std::ifstream in(bakedPath, std::ios::binary);
+		if (!in.is_open()) {
+			return nullptr;
+		}
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint32_t format;
+		uint32_t levelCount;
+		std::shared_ptr<TextureImage> image = std::make_shared<TextureImage>();
+		in.read(magic, 4);
+		if (!in.good() || std::memcmp(magic, textureCacheMagic, 4) != 0 || !ReadValue(in, version) || version != TEXTURE_CACHE_VERSION ||
+			!ReadValue(in, sourceSize) || !ReadValue(in, sourceTime) || !ReadValue(in, image->width) || !ReadValue(in, image->height) ||
+			!ReadValue(in, image->channels) || !ReadValue(in, format) || !ReadValue(in, levelCount) ||
+			format > static_cast<uint32_t>(TextureBlockFormat::BC5) || levelCount == 0 || image->width == 0 || image->height == 0 ||
+			image->channels == 0 || image->channels > 4 || image->width > TEXTURE_CACHE_MAX_DIMENSION ||
+			image->height > TEXTURE_CACHE_MAX_DIMENSION) {
+			MONA_LOG_WARNING("TextureCache: Ignoring invalid or outdated baked texture {0}.", bakedPath.filename().string());
+			return nullptr;
+		}
+		//La cadena completa tiene 1 + floor(log2(max(width, height))) niveles
+		uint32_t maxLevelCount = 1;
+		for (uint32_t side = std::max(image->width, image->height); side > 1; side /= 2)
+			maxLevelCount++;
+		if (levelCount > maxLevelCount) {
+			MONA_LOG_WARNING("TextureCache: Baked texture {0} has too many mip levels.", bakedPath.filename().string());
+			return nullptr;
+		}
+		//El tamano esperado se compara con el del archivo antes de reservar memoria para los niveles
+		uint64_t expectedSize = static_cast<uint64_t>(in.tellg());
+		uint32_t width = image->width;
+		uint32_t height = image->height;
+		for (uint32_t i = 0; i < levelCount; i++) {
+			expectedSize += GetTextureLevelSize(static_cast<TextureBlockFormat>(format), width, height, image->channels);
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+		std::error_code errorCode;
+		const uint64_t fileSize = std::filesystem::file_size(bakedPath, errorCode);
+		if (errorCode || fileSize != expectedSize) {
+			MONA_LOG_WARNING("TextureCache: Baked texture {0} has the wrong size.", bakedPath.filename().string());
+			return nullptr;
+		}
+		//Si la imagen original no se distribuye el archivo horneado se usa tal cual
+		uint64_t currentSize;
+		int64_t currentTime;
+		if (GetSourceStamp(filePath, currentSize, currentTime) && (currentSize != sourceSize || currentTime != sourceTime)) {
+			MONA_LOG_INFO("TextureCache: Baked texture {0} is older than its source.", bakedPath.filename().string());
+			return nullptr;
+		}
+		image->format = static_cast<TextureBlockFormat>(format);
+		image->levels.resize(levelCount);
+		width = image->width;
+		height = image->height;
+		for (auto& level : image->levels) {
+			level.resize(GetTextureLevelSize(image->format, width, height, image->channels));
+			in.read(reinterpret_cast<char*>(level.data()), level.size());
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+		if (!in.good()) {
+			MONA_LOG_WARNING("TextureCache: Baked texture {0} is truncated.", bakedPath.filename().string());
+			return nullptr;
+		}
+		return image;
+	}
+
+	bool TextureCache::WriteBakedFile(const std::string& filePath, const TextureImage& image) const noexcept {
+		const std::filesystem::path bakedPath = GetBakedFilePath(filePath);
+		uint64_t sourceSize = 0;
+		int64_t sourceTime = 0;
+		GetSourceStamp(filePath, sourceSize, sourceTime);
+		std::ofstream out(bakedPath, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			MONA_LOG_WARNING("TextureCache: Could not write baked texture {0}.", bakedPath.string());
+			return false;
+		}
+		out.write(textureCacheMagic, 4);
+		WriteValue(out, (uint32_t)TEXTURE_CACHE_VERSION);
+		WriteValue(out, sourceSize);
+		WriteValue(out, sourceTime);
+		WriteValue(out, image.width);
+		WriteValue(out, image.height);
+		WriteValue(out, image.channels);
+		WriteValue(out, static_cast<uint32_t>(image.format));
+		WriteValue(out, static_cast<uint32_t>(image.levels.size()));
+		for (const auto& level : image.levels) {
+			out.write(reinterpret_cast<const char*>(level.data()), level.size());
+		}
+		return out.good();
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef TEXTURECACHE_HPP
+#define TEXTURECACHE_HPP
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TextureCompression.hpp"
+
+#define TEXTURE_CACHE_VERSION 1
+//Extension que se agrega a la ruta de la imagen original para obtener la de su version horneada
+#define TEXTURE_CACHE_EXTENSION ".mtex"
+//Lado maximo que se acepta al leer un archivo horneado, mantiene acotados los tamanos calculados desde su cabecera
+#define TEXTURE_CACHE_MAX_DIMENSION 65536
+
+namespace Mona {
+
+	// Imagen en CPU con su cadena de mipmaps, lista para subirse a la GPU
+	struct TextureImage {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		// Canales de la imagen original
+		uint32_t channels = 0;
+		TextureBlockFormat format = TextureBlockFormat::Uncompressed;
+		// Niveles desde el de mayor resolucion. Sin comprimir cada texel ocupa channels bytes
+		std::vector<std::vector<uint8_t>> levels;
+	};
+
+	/*
+	* Texturas horneadas: archivos binarios versionados junto a la imagen original con todos los mipmaps ya calculados y,
+	* opcionalmente, comprimidos por bloques. Cargarlas evita decodificar PNG o JPG y generar mipmaps en cada ejecucion.
+	* Un archivo horneado se ignora si la imagen original cambio despues de hornearlo.
+	*/
+	class TextureCache {
+	public:
+		TextureCache(TextureCache const&) = delete;
+		TextureCache& operator=(TextureCache const&) = delete;
+		static TextureCache& GetInstance() noexcept {
+			static TextureCache instance;
+			return instance;
+		}
+		/*
+		* Imagen de filePath, leida desde su version horneada si esta presente y al dia o si no decodificando la original,
+		* que se hornea en ese momento si bake_texture_cache esta activo. Devuelve nullptr si no se pudo leer.
+		* Solo usa CPU, por lo que puede llamarse desde cualquier hilo.
+		*/
+		std::shared_ptr<TextureImage> LoadTextureImage(const std::string& filePath) const noexcept;
+		// Hornea filePath con todos sus mipmaps en format. Permite preparar las texturas antes de distribuir la aplicacion
+		bool BakeFile(const std::string& filePath, TextureBlockFormat format) const noexcept;
+		// Calcula todos los mipmaps del primer nivel de source y los comprime en format
+		static TextureImage BakeImage(const TextureImage& source, TextureBlockFormat format) noexcept;
+		// Formato por defecto: BC1 para imagenes opacas, BC3 con alfa y sin comprimir las de un canal
+		TextureBlockFormat GetDefaultFormat(const TextureImage& image) const noexcept;
+		static std::filesystem::path GetBakedFilePath(const std::string& filePath);
+	private:
+		TextureCache();
+		static std::shared_ptr<TextureImage> DecodeSourceImage(const std::string& filePath) noexcept;
+		std::shared_ptr<TextureImage> ReadBakedFile(const std::string& filePath) const noexcept;
+		bool WriteBakedFile(const std::string& filePath, const TextureImage& image) const noexcept;
+		bool m_enabled = true;
+		bool m_bakeOnLoad = false;
+		bool m_compress = true;
+	};
+}
+#endif
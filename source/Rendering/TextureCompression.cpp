@@ -0,0 +1,291 @@
+#include "TextureCompression.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+//Iteraciones del metodo de la potencia al buscar el eje principal de los colores de un bloque
+#define BC1_AXIS_ITERATIONS 8
+
+namespace Mona {
+
+	static std::size_t BlockCount(uint32_t size) {
+		return std::max<std::size_t>(1, (static_cast<std::size_t>(size) + 3) / 4);
+	}
+
+	static std::size_t BlockSize(TextureBlockFormat format) {
+		return format == TextureBlockFormat::BC1 ? 8 : 16;
+	}
+
+	std::size_t GetTextureLevelSize(TextureBlockFormat format, uint32_t width, uint32_t height, uint32_t channels) noexcept {
+		if (format == TextureBlockFormat::Uncompressed)
+			return static_cast<std::size_t>(width) * height * channels;
+		return BlockCount(width) * BlockCount(height) * BlockSize(format);
+	}
+
+	static uint16_t PackRGB565(const glm::vec3& color) {
+		const glm::vec3 c = glm::clamp(color, glm::vec3(0.0f), glm::vec3(255.0f));
+		const uint16_t r = static_cast<uint16_t>(std::lround(c.r * 31.0f / 255.0f));
+		const uint16_t g = static_cast<uint16_t>(std::lround(c.g * 63.0f / 255.0f));
+		const uint16_t b = static_cast<uint16_t>(std::lround(c.b * 31.0f / 255.0f));
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	static glm::ivec3 UnpackRGB565(uint16_t color) {
+		const int r = (color >> 11) & 31;
+		const int g = (color >> 5) & 63;
+		const int b = color & 31;
+		return glm::ivec3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+	}
+
+	static void EncodeBC1Block(const uint8_t texels[16][4], uint8_t* out) {
+		glm::vec3 colors[16];
+		glm::vec3 mean(0.0f);
+		for (int i = 0; i < 16; i++) {
+			colors[i] = glm::vec3(texels[i][0], texels[i][1], texels[i][2]);
+			mean += colors[i];
+		}
+		mean /= 16.0f;
+		//Los extremos se buscan a lo largo del eje de mayor varianza, que es donde se distribuyen los colores del bloque
+		glm::mat3 covariance(0.0f);
+		for (int i = 0; i < 16; i++) {
+			const glm::vec3 d = colors[i] - mean;
+			covariance += glm::outerProduct(d, d);
+		}
+		glm::vec3 axis(1.0f);
+		for (int i = 0; i < BC1_AXIS_ITERATIONS; i++) {
+			const glm::vec3 next = covariance * axis;
+			const float length = glm::length(next);
+			if (length < 1e-6f)
+				break;
+			axis = next / length;
+		}
+		float minProjection = 0.0f;
+		float maxProjection = 0.0f;
+		for (int i = 0; i < 16; i++) {
+			const float projection = glm::dot(colors[i] - mean, axis);
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
+		//Se acercan un poco los extremos para que los colores intermedios de la paleta caigan sobre mas texeles
+		const float inset = (maxProjection - minProjection) / 16.0f;
+		uint16_t color0 = PackRGB565(mean + axis * (maxProjection - inset));
+		uint16_t color1 = PackRGB565(mean + axis * (minProjection + inset));
+		//color0 > color1 selecciona el modo de cuatro colores
+		if (color0 < color1)
+			std::swap(color0, color1);
+		glm::ivec3 palette[4];
+		palette[0] = UnpackRGB565(color0);
+		palette[1] = UnpackRGB565(color1);
+		palette[2] = (2 * palette[0] + palette[1]) / 3;
+		palette[3] = (palette[0] + 2 * palette[1]) / 3;
+		uint32_t indices = 0;
+		if (color0 != color1) {
+			for (int i = 0; i < 16; i++) {
+				const glm::ivec3 texel(texels[i][0], texels[i][1], texels[i][2]);
+				int bestIndex = 0;
+				int bestDistance = INT32_MAX;
+				for (int p = 0; p < 4; p++) {
+					const glm::ivec3 d = texel - palette[p];
+					const int distance = d.x * d.x + d.y * d.y + d.z * d.z;
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						bestIndex = p;
+					}
+				}
+				indices |= static_cast<uint32_t>(bestIndex) << (2 * i);
+			}
+		}
+		out[0] = static_cast<uint8_t>(color0 & 0xFF);
+		out[1] = static_cast<uint8_t>(color0 >> 8);
+		out[2] = static_cast<uint8_t>(color1 & 0xFF);
+		out[3] = static_cast<uint8_t>(color1 >> 8);
+		for (int i = 0; i < 4; i++)
+			out[4 + i] = static_cast<uint8_t>(indices >> (8 * i));
+	}
+
+	static void DecodeBC1Block(const uint8_t* block, bool alwaysFourColors, uint8_t texels[16][4]) {
+		const uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+		const uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+		glm::ivec4 palette[4];
+		palette[0] = glm::ivec4(UnpackRGB565(color0), 255);
+		palette[1] = glm::ivec4(UnpackRGB565(color1), 255);
+		if (alwaysFourColors || color0 > color1) {
+			palette[2] = (2 * palette[0] + palette[1]) / 3;
+			palette[3] = (palette[0] + 2 * palette[1]) / 3;
+		}
+		else {
+			palette[2] = (palette[0] + palette[1]) / 2;
+			palette[3] = glm::ivec4(0);
+		}
+		const uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+		for (int i = 0; i < 16; i++) {
+			const glm::ivec4& color = palette[(indices >> (2 * i)) & 3];
+			for (int c = 0; c < 4; c++)
+				texels[i][c] = static_cast<uint8_t>(color[c]);
+		}
+	}
+
+	// Un canal en 8 bytes: dos extremos y un indice de 3 bits por texel (mismo bloque que el alfa de BC3 y cada canal de BC5)
+	static void EncodeBC4Block(const uint8_t values[16], uint8_t* out) {
+		const uint8_t maxValue = *std::max_element(values, values + 16);
+		const uint8_t minValue = *std::min_element(values, values + 16);
+		out[0] = maxValue;
+		out[1] = minValue;
+		uint64_t indices = 0;
+		if (maxValue != minValue) {
+			//Con el primer extremo mayor la paleta tiene 8 valores: los extremos y 6 interpolados
+			int palette[8];
+			palette[0] = maxValue;
+			palette[1] = minValue;
+			for (int p = 1; p < 7; p++)
+				palette[p + 1] = ((7 - p) * maxValue + p * minValue) / 7;
+			for (int i = 0; i < 16; i++) {
+				int bestIndex = 0;
+				int bestDistance = 256;
+				for (int p = 0; p < 8; p++) {
+					const int distance = std::abs(values[i] - palette[p]);
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						bestIndex = p;
+					}
+				}
+				indices |= static_cast<uint64_t>(bestIndex) << (3 * i);
+			}
+		}
+		for (int i = 0; i < 6; i++)
+			out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+	}
+
+	static void DecodeBC4Block(const uint8_t* block, uint8_t values[16]) {
+		const int value0 = block[0];
+		const int value1 = block[1];
+		int palette[8];
+		palette[0] = value0;
+		palette[1] = value1;
+		if (value0 > value1) {
+			for (int p = 1; p < 7; p++)
+				palette[p + 1] = ((7 - p) * value0 + p * value1) / 7;
+		}
+		else {
+			for (int p = 1; p < 5; p++)
+				palette[p + 1] = ((5 - p) * value0 + p * value1) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+		uint64_t indices = 0;
+		for (int i = 0; i < 6; i++)
+			indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+		for (int i = 0; i < 16; i++)
+			values[i] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+	}
+
+	std::vector<uint8_t> CompressTextureLevel(const uint8_t* rgba, uint32_t width, uint32_t height, TextureBlockFormat format) noexcept {
+		if (format == TextureBlockFormat::Uncompressed)
+			return std::vector<uint8_t>(rgba, rgba + static_cast<std::size_t>(width) * height * 4);
+		const std::size_t blocksX = BlockCount(width);
+		const std::size_t blocksY = BlockCount(height);
+		const std::size_t blockSize = BlockSize(format);
+		std::vector<uint8_t> blocks(blocksX * blocksY * blockSize);
+		for (std::size_t by = 0; by < blocksY; by++) {
+			for (std::size_t bx = 0; bx < blocksX; bx++) {
+				uint8_t texels[16][4];
+				for (uint32_t i = 0; i < 16; i++) {
+					const std::size_t x = std::min<std::size_t>(bx * 4 + i % 4, width - 1);
+					const std::size_t y = std::min<std::size_t>(by * 4 + i / 4, height - 1);
+					std::copy_n(rgba + (y * width + x) * 4, 4, texels[i]);
+				}
+				uint8_t* out = blocks.data() + (by * blocksX + bx) * blockSize;
+				uint8_t channel[16];
+				switch (format)
+				{
+				case TextureBlockFormat::BC1:
+					EncodeBC1Block(texels, out);
+					break;
+				case TextureBlockFormat::BC3:
+					for (int i = 0; i < 16; i++)
+						channel[i] = texels[i][3];
+					EncodeBC4Block(channel, out);
+					EncodeBC1Block(texels, out + 8);
+					break;
+				case TextureBlockFormat::BC5:
+					for (int c = 0; c < 2; c++) {
+						for (int i = 0; i < 16; i++)
+							channel[i] = texels[i][c];
+						EncodeBC4Block(channel, out + 8 * c);
+					}
+					break;
+				default:
+					break;
+				}
+			}
+		}
+		return blocks;
+	}
+
+	std::vector<uint8_t> DecompressTextureLevel(const uint8_t* blocks, uint32_t width, uint32_t height, TextureBlockFormat format) noexcept {
+		if (format == TextureBlockFormat::Uncompressed)
+			return std::vector<uint8_t>(blocks, blocks + static_cast<std::size_t>(width) * height * 4);
+		const std::size_t blocksX = BlockCount(width);
+		const std::size_t blocksY = BlockCount(height);
+		const std::size_t blockSize = BlockSize(format);
+		std::vector<uint8_t> rgba(static_cast<std::size_t>(width) * height * 4);
+		for (std::size_t by = 0; by < blocksY; by++) {
+			for (std::size_t bx = 0; bx < blocksX; bx++) {
+				const uint8_t* block = blocks + (by * blocksX + bx) * blockSize;
+				uint8_t texels[16][4];
+				uint8_t channel[16];
+				switch (format)
+				{
+				case TextureBlockFormat::BC1:
+					DecodeBC1Block(block, false, texels);
+					break;
+				case TextureBlockFormat::BC3:
+					DecodeBC1Block(block + 8, true, texels);
+					DecodeBC4Block(block, channel);
+					for (int i = 0; i < 16; i++)
+						texels[i][3] = channel[i];
+					break;
+				case TextureBlockFormat::BC5:
+					for (int c = 0; c < 2; c++) {
+						DecodeBC4Block(block + 8 * c, channel);
+						for (int i = 0; i < 16; i++)
+							texels[i][c] = channel[i];
+					}
+					for (int i = 0; i < 16; i++) {
+						texels[i][2] = 0;
+						texels[i][3] = 255;
+					}
+					break;
+				default:
+					break;
+				}
+				for (uint32_t i = 0; i < 16; i++) {
+					const std::size_t x = bx * 4 + i % 4;
+					const std::size_t y = by * 4 + i / 4;
+					if (x < width && y < height)
+						std::copy_n(texels[i], 4, rgba.data() + (y * width + x) * 4);
+				}
+			}
+		}
+		return rgba;
+	}
+
+	std::vector<uint8_t> DownsampleTextureLevel(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels) noexcept {
+		const uint32_t nextWidth = std::max(width / 2, 1u);
+		const uint32_t nextHeight = std::max(height / 2, 1u);
+		std::vector<uint8_t> next(static_cast<std::size_t>(nextWidth) * nextHeight * channels);
+		for (uint32_t y = 0; y < nextHeight; y++) {
+			const std::size_t y0 = std::min(2 * y, height - 1);
+			const std::size_t y1 = std::min(2 * y + 1, height - 1);
+			for (uint32_t x = 0; x < nextWidth; x++) {
+				const std::size_t x0 = std::min(2 * x, width - 1);
+				const std::size_t x1 = std::min(2 * x + 1, width - 1);
+				for (uint32_t c = 0; c < channels; c++) {
+					const uint32_t sum = pixels[(y0 * width + x0) * channels + c] + pixels[(y0 * width + x1) * channels + c] +
+						pixels[(y1 * width + x0) * channels + c] + pixels[(y1 * width + x1) * channels + c];
+					next[(static_cast<std::size_t>(y) * nextWidth + x) * channels + c] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+		return next;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#ifndef TEXTURECOMPRESSION_HPP
+#define TEXTURECOMPRESSION_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Mona {
+	/*
+	* Codificacion por bloques de 4x4 texeles que las GPUs leen directamente. BC1 guarda RGB en 8 bytes por bloque, BC3 agrega
+	* alfa con otros 8 bytes y BC5 guarda dos canales independientes (por ejemplo x e y de un mapa de normales) en 16 bytes.
+	* Ninguna de estas funciones llama a OpenGL.
+	*/
+	enum class TextureBlockFormat : uint32_t {
+		Uncompressed,
+		BC1,
+		BC3,
+		BC5
+	};
+
+	// Bytes que ocupa un nivel de width x height texeles. Sin comprimir cada texel ocupa channels bytes
+	std::size_t GetTextureLevelSize(TextureBlockFormat format, uint32_t width, uint32_t height, uint32_t channels) noexcept;
+
+	// Comprime un nivel RGBA de 8 bits por canal. Los bloques que quedan fuera de la imagen repiten los texeles del borde
+	std::vector<uint8_t> CompressTextureLevel(const uint8_t* rgba, uint32_t width, uint32_t height, TextureBlockFormat format) noexcept;
+
+	// Descomprime un nivel a RGBA de 8 bits por canal, para GPUs que no soportan el formato. BC5 deja azul en 0
+	std::vector<uint8_t> DecompressTextureLevel(const uint8_t* blocks, uint32_t width, uint32_t height, TextureBlockFormat format) noexcept;
+
+	// Siguiente nivel de mipmap, promediando grupos de 2x2 texeles. En lados impares el ultimo texel se repite
+	std::vector<uint8_t> DownsampleTextureLevel(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels) noexcept;
+}
+#endif
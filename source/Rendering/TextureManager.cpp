@@ -1,4 +1,5 @@
 #include "TextureManager.hpp"
+#include "TextureCache.hpp"
 namespace Mona {
 	std::shared_ptr<Texture> TextureManager::LoadTexture(const std::filesystem::path& filePath,
 		TextureMagnificationFilter magFilter,
@@ -7,6 +8,7 @@ namespace Mona {
 		WrapMode tWrapMode,
 		bool genMipmaps) noexcept
 	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 		const std::string stringPath = filePath.string();
 		auto it = m_textureMap.find(stringPath);
 		//Solo pasar a crear la textura si no existe una entrada en el mapa con el mismo path
@@ -19,8 +21,51 @@ namespace Mona {
 		return textureSharedPtr;
 	}
 
+	AssetFuture<Texture> TextureManager::LoadTextureAsync(const std::filesystem::path& filePath,
+		TextureMagnificationFilter magFilter,
+		TextureMinificationFilter minFilter,
+		WrapMode sWrapMode,
+		WrapMode tWrapMode,
+		bool genMipmaps) noexcept
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const std::string stringPath = filePath.string();
+		auto it = m_textureMap.find(stringPath);
+		if (it != m_textureMap.end())
+			return AssetFuture<Texture>(it->second);
+		//Una carga pendiente ya completa no se subio porque su mundo se cerro antes, por lo que se vuelve a cargar
+		auto pendingIt = m_pendingTextures.find(stringPath);
+		if (pendingIt != m_pendingTextures.end() && !pendingIt->second.IsReady())
+			return pendingIt->second;
+		if (!m_placeholderTexture) {
+			m_placeholderTexture = std::shared_ptr<Texture>(new Texture());
+			m_placeholderTexture->Upload(*Texture::CreateSolidColor(255, 255, 255, 255), TextureMagnificationFilter::Nearest,
+				TextureMinificationFilter::Nearest, WrapMode::Repeat, WrapMode::Repeat, false);
+		}
+		std::shared_ptr<Texture> texture = std::shared_ptr<Texture>(new Texture());
+		texture->m_placeholder = m_placeholderTexture;
+		auto future = AssetLoader::GetInstance().Load<Texture>([this, texture, stringPath, magFilter, minFilter, sWrapMode, tWrapMode, genMipmaps]
+			(AssetLoader::UploadTask& outUpload) {
+				std::shared_ptr<TextureImage> image = Texture::ReadFile(stringPath);
+				outUpload = [this, texture, stringPath, image, magFilter, minFilter, sWrapMode, tWrapMode, genMipmaps]() {
+					//Si la imagen no se pudo leer la textura se queda con el placeholder
+					if (image) {
+						texture->Upload(*image, magFilter, minFilter, sWrapMode, tWrapMode, genMipmaps);
+					}
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_pendingTextures.erase(stringPath);
+					m_textureMap.insert({ stringPath, texture });
+				};
+				return texture;
+			});
+		AssetFuture<Texture> result(future, texture);
+		m_pendingTextures.insert_or_assign(stringPath, result);
+		return result;
+	}
+
 	void TextureManager::CleanUnusedTextures() noexcept
 	{
+		std::lock_guard<std::mutex> lock(m_mutex);
 		for (auto i = m_textureMap.begin(), last = m_textureMap.end(); i != last;) {
 			if (i->second.use_count() == 1) {
 				i = m_textureMap.erase(i);
@@ -34,10 +79,18 @@ namespace Mona {
 
 	void TextureManager::ShutDown() noexcept
 	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		//Las texturas que no se pudieron leer no tienen datos en GPU
 		for (auto& entry : m_textureMap) {
-			(entry.second)->ClearData();
+			if ((entry.second)->m_ID)
+				(entry.second)->ClearData();
 		}
 		m_textureMap.clear();
+		m_pendingTextures.clear();
+		if (m_placeholderTexture) {
+			m_placeholderTexture->ClearData();
+			m_placeholderTexture = nullptr;
+		}
 	}
 
 
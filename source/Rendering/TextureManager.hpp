@@ -2,9 +2,11 @@
 #ifndef TEXTUREMANAGER_HPP
 #define TEXTUREMANAGER_HPP
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <filesystem>
 #include "Texture.hpp"
+#include "../Core/AssetLoader.hpp"
 namespace Mona {
 	class TextureManager {
 	public:
@@ -18,6 +20,13 @@ namespace Mona {
 			WrapMode sWrapMode = WrapMode::Repeat,
 			WrapMode tWrapMode = WrapMode::Repeat,
 			bool genMipmaps = false) noexcept;
+		// Igual que LoadTexture, pero la imagen se decodifica en un worker y se sube a la GPU en un frame posterior
+		AssetFuture<Texture> LoadTextureAsync(const std::filesystem::path& filePath,
+			TextureMagnificationFilter magFilter = TextureMagnificationFilter::Linear,
+			TextureMinificationFilter minFilter = TextureMinificationFilter::LinearMipmapLinear,
+			WrapMode sWrapMode = WrapMode::Repeat,
+			WrapMode tWrapMode = WrapMode::Repeat,
+			bool genMipmaps = false) noexcept;
 		void CleanUnusedTextures() noexcept;
 		static TextureManager& GetInstance() noexcept {
 			static TextureManager instance;
@@ -26,7 +35,13 @@ namespace Mona {
 	private:
 		void ShutDown() noexcept;
 		TextureManager() = default;
+		// Las cargas y limpiezas pueden llamarse desde varios mundos en hilos distintos
+		std::mutex m_mutex;
 		TextureMap m_textureMap;
+		// Cargas asincronas en curso, para no leer dos veces el mismo archivo
+		std::unordered_map<std::string, AssetFuture<Texture>> m_pendingTextures;
+		// Textura blanca de 1x1 que muestran las texturas que aun se estan cargando
+		std::shared_ptr<Texture> m_placeholderTexture;
 	};
 }
 #endif
\ No newline at end of file
@@ -7,14 +7,18 @@ namespace Mona {
 	class UnlitFlatMaterial : public Material {
 	public:
  
-		UnlitFlatMaterial(const ShaderProgram& shaderProgram, bool isForSkinning) : Material(shaderProgram, isForSkinning), m_color(glm::vec3(1.0f)) {}
-		virtual void SetMaterialUniforms(const glm::vec3& cameraPosition) {
-			glUniform3fv(ShaderProgram::UnlitColorShaderLocation, 1, glm::value_ptr(m_color));
-		}
-		const glm::vec3& GetColor() const { return m_color; }
-		void SetColor(const glm::vec3& color) { m_color = color; }
+		UnlitFlatMaterial(const ShaderProgram& shaderProgram, bool isForSkinning) : Material(shaderProgram, isForSkinning, sizeof(Parameters)), m_parameters{ glm::vec3(1.0f), 0.0f } {}
+		const glm::vec3& GetColor() const { return m_parameters.color; }
+		void SetColor(const glm::vec3& color) { m_parameters.color = color; MarkParametersDirty(); }
+	protected:
+		virtual const void* GetParametersData() const override { return &m_parameters; }
 	private:
-		glm::vec3 m_color;
+		//Layout std140 del bloque MaterialParameters de UnlitFlat.ps
+		struct Parameters {
+			glm::vec3 color;
+			float padding;
+		};
+		Parameters m_parameters;
 	};
 }
 #endif
\ No newline at end of file
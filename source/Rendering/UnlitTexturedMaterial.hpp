@@ -14,12 +14,13 @@ namespace Mona {
 			//Dado que las ubicaiones de las texturas nunca cambian solo se configura al momento de construccin
 			glUniform1i(ShaderProgram::UnlitColorTextureSamplerShaderLocation, ShaderProgram::UnlitColorTextureUnit);
 		}
-		virtual void SetMaterialUniforms(const glm::vec3& cameraPosition) {
+		std::shared_ptr<Texture> GetUnlitColorTexture() const { return m_unlitColorTexture; }
+		void SetUnlitColorTexture(std::shared_ptr<Texture> colorTexture) { m_unlitColorTexture = colorTexture; }
+	protected:
+		virtual void BindTextures() override {
 			MONA_ASSERT(m_unlitColorTexture != nullptr, "Material Error: Texture must be not nullptr for rendering to be posible");
 			glBindTextureUnit(ShaderProgram::UnlitColorTextureUnit, m_unlitColorTexture->GetID());
 		}
-		std::shared_ptr<Texture> GetUnlitColorTexture() const { return m_unlitColorTexture; }
-		void SetUnlitColorTexture(std::shared_ptr<Texture> colorTexture) { m_unlitColorTexture = colorTexture; }
 	private:
 		std::shared_ptr<Texture> m_unlitColorTexture;
 	};
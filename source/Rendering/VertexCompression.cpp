@@ -0,0 +1,104 @@
+#include "VertexCompression.hpp"
+#include "../Core/Log.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/gtc/packing.hpp>
+
+namespace Mona {
+
+	static int16_t FloatToSnorm16(float value) {
+		return static_cast<int16_t>(glm::packSnorm1x16(value));
+	}
+
+	PositionQuantization ComputePositionQuantization(const float* positions, std::size_t positionStride, std::size_t vertexCount) noexcept {
+		PositionQuantization quantization;
+		if (vertexCount == 0)
+			return quantization;
+		glm::vec3 minPosition(std::numeric_limits<float>::max());
+		glm::vec3 maxPosition(std::numeric_limits<float>::lowest());
+		for (std::size_t v = 0; v < vertexCount; v++) {
+			const float* p = reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(positions) + v * positionStride);
+			const glm::vec3 position(p[0], p[1], p[2]);
+			minPosition = glm::min(minPosition, position);
+			maxPosition = glm::max(maxPosition, position);
+		}
+		quantization.offset = 0.5f * (minPosition + maxPosition);
+		//Se evita una escala nula en ejes donde la malla es plana
+		quantization.scale = glm::max(0.5f * (maxPosition - minPosition), glm::vec3(std::numeric_limits<float>::min()));
+		return quantization;
+	}
+
+	glm::vec2 EncodeOctahedral(const glm::vec3& direction) noexcept {
+		const float l1Norm = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+		if (l1Norm == 0.0f)
+			return glm::vec2(0.0f);
+		const glm::vec3 n = direction / l1Norm;
+		glm::vec2 encoded(n.x, n.y);
+		if (n.z < 0.0f) {
+			//El hemisferio inferior se dobla sobre las esquinas del cuadrado
+			encoded.x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+			encoded.y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+		}
+		return encoded;
+	}
+
+	glm::vec3 DecodeOctahedral(const glm::vec2& encoded) noexcept {
+		//Misma decodificacion que hacen los vertex shaders
+		glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+		const float t = std::max(-n.z, 0.0f);
+		n.x += n.x >= 0.0f ? -t : t;
+		n.y += n.y >= 0.0f ? -t : t;
+		return glm::normalize(n);
+	}
+
+	void QuantizeBoneWeights(const glm::vec4& weights, uint8_t outWeights[4]) noexcept {
+		int total = 0;
+		int largest = 0;
+		for (int i = 0; i < 4; i++) {
+			outWeights[i] = static_cast<uint8_t>(std::clamp(std::lround(weights[i] * 255.0f), 0l, 255l));
+			total += outWeights[i];
+			if (outWeights[i] > outWeights[largest])
+				largest = i;
+		}
+		//El error de redondeo se absorbe en el peso mayor para que la suma siga siendo exactamente 1
+		outWeights[largest] = static_cast<uint8_t>(std::clamp(outWeights[largest] + 255 - total, 0, 255));
+	}
+
+	void CompressVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const glm::vec3& tangent,
+		const glm::vec3& bitangent, const PositionQuantization& quantization, CompressedMeshVertex& outVertex) noexcept {
+		const glm::vec3 quantized = glm::clamp((position - quantization.offset) / quantization.scale, glm::vec3(-1.0f), glm::vec3(1.0f));
+		outVertex.position[0] = FloatToSnorm16(quantized.x);
+		outVertex.position[1] = FloatToSnorm16(quantized.y);
+		outVertex.position[2] = FloatToSnorm16(quantized.z);
+		outVertex.position[3] = 0;
+		const glm::vec2 encodedNormal = EncodeOctahedral(normal);
+		outVertex.normal[0] = FloatToSnorm16(encodedNormal.x);
+		outVertex.normal[1] = FloatToSnorm16(encodedNormal.y);
+		outVertex.uv[0] = glm::packHalf1x16(uv.x);
+		outVertex.uv[1] = glm::packHalf1x16(uv.y);
+		const glm::vec2 encodedTangent = EncodeOctahedral(tangent);
+		outVertex.tangent[0] = FloatToSnorm16(encodedTangent.x);
+		outVertex.tangent[1] = FloatToSnorm16(encodedTangent.y);
+		outVertex.tangent[2] = FloatToSnorm16(glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f);
+		outVertex.tangent[3] = 0;
+	}
+
+	bool CompressVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const glm::vec3& tangent,
+		const glm::vec3& bitangent, const glm::vec4& boneIds, const glm::vec4& boneWeights, const PositionQuantization& quantization,
+		CompressedSkinnedMeshVertex& outVertex) noexcept {
+		CompressedMeshVertex baseVertex;
+		CompressVertex(position, normal, uv, tangent, bitangent, quantization, baseVertex);
+		std::copy(std::begin(baseVertex.position), std::end(baseVertex.position), outVertex.position);
+		std::copy(std::begin(baseVertex.normal), std::end(baseVertex.normal), outVertex.normal);
+		std::copy(std::begin(baseVertex.uv), std::end(baseVertex.uv), outVertex.uv);
+		std::copy(std::begin(baseVertex.tangent), std::end(baseVertex.tangent), outVertex.tangent);
+		for (int i = 0; i < 4; i++) {
+			if (!(boneIds[i] >= 0.0f && boneIds[i] < static_cast<float>(SKINNED_COMPRESSED_MAX_JOINTS)))
+				return false;
+			outVertex.boneIds[i] = static_cast<uint8_t>(boneIds[i]);
+		}
+		QuantizeBoneWeights(boneWeights, outVertex.boneWeights);
+		return true;
+	}
+}
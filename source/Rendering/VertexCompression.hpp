@@ -0,0 +1,52 @@
+#pragma once
+#ifndef VERTEXCOMPRESSION_HPP
+#define VERTEXCOMPRESSION_HPP
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+//Cantidad de huesos que pueden indexar los vertices animados comprimidos
+#define SKINNED_COMPRESSED_MAX_JOINTS 256
+
+namespace Mona {
+	/*
+	* Formato de vertice comprimido. Las posiciones se cuantizan a enteros de 16 bits normalizados dentro de la caja que
+	* contiene la malla, normales y tangentes usan codificacion octaedrica (dos componentes de 16 bits) y las coordenadas
+	* uv son half float. La bitangente no se guarda: el shader la reconstruye con cross(normal, tangente) y el signo
+	* guardado en tangent[2]. Los vertex shaders decodifican este formato cuando compressedVertices es verdadero.
+	*/
+	struct CompressedMeshVertex {
+		int16_t position[4]; //8, la cuarta componente es relleno
+		int16_t normal[2]; //12
+		uint16_t uv[2]; //16
+		int16_t tangent[4]; //24
+	};
+
+	// Los pesos suman exactamente 255 y los indices de hueso deben ser menores a SKINNED_COMPRESSED_MAX_JOINTS
+	struct CompressedSkinnedMeshVertex {
+		int16_t position[4]; //8
+		int16_t normal[2]; //12
+		uint16_t uv[2]; //16
+		int16_t tangent[4]; //24
+		uint8_t boneIds[4]; //28
+		uint8_t boneWeights[4]; //32
+	};
+
+	// La posicion original se recupera como cuantizada * scale + offset
+	struct PositionQuantization {
+		glm::vec3 scale = glm::vec3(1.0f);
+		glm::vec3 offset = glm::vec3(0.0f);
+	};
+
+	// positions apunta a la posicion (3 floats) del primer vertice y positionStride es la distancia en bytes entre vertices
+	PositionQuantization ComputePositionQuantization(const float* positions, std::size_t positionStride, std::size_t vertexCount) noexcept;
+	glm::vec2 EncodeOctahedral(const glm::vec3& direction) noexcept;
+	glm::vec3 DecodeOctahedral(const glm::vec2& encoded) noexcept;
+	void QuantizeBoneWeights(const glm::vec4& weights, uint8_t outWeights[4]) noexcept;
+	void CompressVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const glm::vec3& tangent,
+		const glm::vec3& bitangent, const PositionQuantization& quantization, CompressedMeshVertex& outVertex) noexcept;
+	// Devuelve falso si algun indice de hueso no cabe en 8 bits, en cuyo caso la malla debe usar vertices sin comprimir
+	bool CompressVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const glm::vec3& tangent,
+		const glm::vec3& bitangent, const glm::vec4& boneIds, const glm::vec4& boneWeights, const PositionQuantization& quantization,
+		CompressedSkinnedMeshVertex& outVertex) noexcept;
+}
+#endif
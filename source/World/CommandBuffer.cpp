@@ -0,0 +1,82 @@
+#include "World.hpp"
+#include "CommandBuffer.hpp"
+#include <algorithm>
+#include <array>
+namespace Mona {
+
+	void CommandBuffer::DestroyGameObject(const BaseGameObjectHandle& handle) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_destroyedObjects.push_back(handle);
+	}
+
+	void CommandBuffer::SetGameObjectActive(const BaseGameObjectHandle& handle, bool active) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_commands.push_back([objectHandle = handle, active](World& world) mutable {
+			if (world.IsValid(objectHandle) && objectHandle->GetState() != GameObject::EState::PendingDestroy) {
+				world.SetGameObjectActive(objectHandle, active);
+			}
+		});
+	}
+
+	void CommandBuffer::Instantiate(const Prefab& prefab, GameObjectManager::size_type count) noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_commands.push_back([&prefab, count](World& world) { world.Instantiate(prefab, count); });
+	}
+
+	bool CommandBuffer::IsEmpty() const noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_destroyedObjects.empty() && m_removedComponents.empty() && m_commands.empty();
+	}
+
+	void CommandBuffer::Execute(World& world) noexcept {
+		//Los comandos registrados mientras se aplican estos (por ejemplo desde StartUp de objetos instanciados)
+		//quedan para el siguiente frame
+		std::vector<BaseGameObjectHandle> destroyedObjects;
+		std::vector<std::pair<uint8_t, InnerComponentHandle>> removedComponents;
+		std::vector<std::function<void(World&)>> commands;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			destroyedObjects.swap(m_destroyedObjects);
+			removedComponents.swap(m_removedComponents);
+			commands.swap(m_commands);
+		}
+
+		//Se agrupan las componentes por tipo, descartando las repetidas y las que ya no son validas
+		std::sort(removedComponents.begin(), removedComponents.end(), [](const auto& a, const auto& b) {
+			return a.first != b.first ? a.first < b.first : a.second < b.second;
+		});
+		std::array<std::vector<InnerComponentHandle>, GetComponentTypeCount()> removedPerType;
+		for (std::size_t i = 0; i < removedComponents.size(); i++) {
+			const auto& [componentIndex, handle] = removedComponents[i];
+			bool repeated = 0 < i && removedComponents[i - 1].first == componentIndex && removedComponents[i - 1].second == handle;
+			if (!repeated && world.m_componentManagers[componentIndex]->IsValid(handle)) {
+				removedPerType[componentIndex].push_back(handle);
+			}
+		}
+		for (uint8_t componentIndex = 0; componentIndex < GetComponentTypeCount(); componentIndex++) {
+			if (!removedPerType[componentIndex].empty()) {
+				world.RemoveComponentBatch(componentIndex, removedPerType[componentIndex]);
+			}
+		}
+
+		std::sort(destroyedObjects.begin(), destroyedObjects.end(), [](const BaseGameObjectHandle& a, const BaseGameObjectHandle& b) {
+			return a.GetInnerHandle() < b.GetInnerHandle();
+		});
+		std::vector<GameObject*> gameObjects;
+		gameObjects.reserve(destroyedObjects.size());
+		for (std::size_t i = 0; i < destroyedObjects.size(); i++) {
+			auto& handle = destroyedObjects[i];
+			bool repeated = 0 < i && destroyedObjects[i - 1].GetInnerHandle() == handle.GetInnerHandle();
+			if (!repeated && world.IsValid(handle) && handle->GetState() != GameObject::EState::PendingDestroy) {
+				gameObjects.push_back(&*handle);
+			}
+		}
+		if (!gameObjects.empty()) {
+			world.DestroyGameObjects(gameObjects);
+		}
+
+		for (auto& command : commands) {
+			command(world);
+		}
+	}
+}
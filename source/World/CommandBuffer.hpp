@@ -0,0 +1,49 @@
+#pragma once
+#ifndef COMMANDBUFFER_HPP
+#define COMMANDBUFFER_HPP
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "ComponentTypes.hpp"
+#include "ComponentHandle.hpp"
+#include "GameObjectHandle.hpp"
+#include "GameObjectManager.hpp"
+namespace Mona {
+	class World;
+	class Prefab;
+
+	/*
+	* Registra cambios estructurales (destruir objetos, agregar o remover componentes, activar objetos) que no pueden
+	* hacerse mientras se recorren los managers, por ejemplo desde sistemas que corren en paralelo. Puede usarse desde
+	* cualquier hilo, y World::Update aplica los comandos despues de ejecutar todos los sistemas del frame.
+	* Al aplicarse, primero se remueven las componentes y se destruyen los objetos en lote, y luego se ejecutan el resto
+	* de los comandos en el orden en que se registraron. Los comandos sobre objetos o componentes que ya no son validos
+	* se ignoran, por lo que destruir dos veces el mismo objeto desde sistemas distintos es seguro.
+	*/
+	class CommandBuffer {
+	public:
+		friend class World;
+		CommandBuffer() = default;
+		CommandBuffer(const CommandBuffer&) = delete;
+		CommandBuffer& operator=(const CommandBuffer&) = delete;
+		void DestroyGameObject(const BaseGameObjectHandle& handle) noexcept;
+		template <typename ComponentType>
+		void RemoveComponent(const ComponentHandle<ComponentType>& handle) noexcept;
+		// Los argumentos se copian al registrar el comando
+		template <typename ComponentType, typename ...Args>
+		void AddComponent(const BaseGameObjectHandle& handle, Args&& ... args) noexcept;
+		void SetGameObjectActive(const BaseGameObjectHandle& handle, bool active) noexcept;
+		// El prefab debe seguir existiendo hasta que se aplique el comando
+		void Instantiate(const Prefab& prefab, GameObjectManager::size_type count = 1) noexcept;
+		bool IsEmpty() const noexcept;
+	private:
+		void Execute(World& world) noexcept;
+		mutable std::mutex m_mutex;
+		std::vector<BaseGameObjectHandle> m_destroyedObjects;
+		std::vector<std::pair<uint8_t, InnerComponentHandle>> m_removedComponents;
+		std::vector<std::function<void(World&)>> m_commands;
+	};
+}
+#endif
@@ -18,7 +18,14 @@ namespace Mona {
 		virtual ~BaseComponentManager() = default;
 		virtual void StartUp(EventManager& eventManager,size_type expectedObjects = 0) noexcept = 0;
 		virtual void ShutDown(EventManager& eventManager) noexcept = 0;
+		virtual void Reserve(size_type additionalComponents) noexcept = 0;
 		virtual void RemoveComponent(const InnerComponentHandle& handle) = 0;
+		// Remueve todas las componentes en una sola pasada. Los handles no deben repetirse.
+		virtual void RemoveComponents(const std::vector<InnerComponentHandle>& handles) = 0;
+		virtual bool IsValid(const InnerComponentHandle& handle) const noexcept = 0;
+		virtual GameObject* GetOwner(const InnerComponentHandle& handle) const noexcept = 0;
+		// Bytes reservados por el manager, sin contar memoria que los componentes reserven por su cuenta
+		virtual std::size_t GetMemoryUsage() const noexcept = 0;
 		BaseComponentManager(const BaseComponentManager&) = delete;
 		BaseComponentManager& operator=(const BaseComponentManager&) = delete;
 	};
@@ -40,17 +47,23 @@ namespace Mona {
 		ComponentManager& operator=(const ComponentManager&) = delete;
 		virtual void StartUp(EventManager& eventManager, size_type expectedObjects = 0) noexcept override;
 		virtual void ShutDown(EventManager& eventManager) noexcept override;
+		virtual void Reserve(size_type additionalComponents) noexcept override;
 		template <typename ...Args>
 		InnerComponentHandle AddComponent(GameObject* gameObjectPointer, Args&& ... args) noexcept;
+		// Reserva memoria una sola vez y agrega a cada owner una componente construida con args
+		template <typename ...Args>
+		std::vector<InnerComponentHandle> AddComponents(const std::vector<GameObject*>& owners, const Args& ... args) noexcept;
 		virtual void RemoveComponent(const InnerComponentHandle& handle) noexcept override;
+		virtual void RemoveComponents(const std::vector<InnerComponentHandle>& handles) noexcept override;
 		ComponentType* GetComponentPointer(const InnerComponentHandle& handle) noexcept;
 		const ComponentType* GetComponentPointer(const InnerComponentHandle& handle) const noexcept;
 		size_type GetCount() const noexcept;
-		GameObject* GetOwner(const InnerComponentHandle& handle) const noexcept;
+		virtual std::size_t GetMemoryUsage() const noexcept override;
+		virtual GameObject* GetOwner(const InnerComponentHandle& handle) const noexcept override;
 		GameObject* GetOwnerByIndex(size_type i) noexcept;
 		ComponentType& operator[](size_type index) noexcept;
 		const ComponentType& operator[](size_type index) const noexcept;
-		bool IsValid(const InnerComponentHandle& handle) const noexcept;
+		virtual bool IsValid(const InnerComponentHandle& handle) const noexcept override;
 		void SwapComponents(size_type first, size_type second) noexcept;
 
 		void SetLifetimePolicy(const typename ComponentType::LifetimePolicyType& policy) noexcept;
@@ -0,0 +1,30 @@
+#pragma once
+#ifndef COMMANDBUFFER_IMPLEMENTATION_HPP
+#define COMMANDBUFFER_IMPLEMENTATION_HPP
+#include <tuple>
+namespace Mona {
+
+	template <typename ComponentType>
+	void CommandBuffer::RemoveComponent(const ComponentHandle<ComponentType>& handle) noexcept
+	{
+		static_assert(is_component<ComponentType>, "Template parameter is not a component");
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_removedComponents.emplace_back(ComponentType::componentIndex, handle.GetInnerHandle());
+	}
+
+	template <typename ComponentType, typename ...Args>
+	void CommandBuffer::AddComponent(const BaseGameObjectHandle& handle, Args&& ... args) noexcept
+	{
+		static_assert(is_component<ComponentType>, "Template parameter is not a component");
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_commands.push_back([objectHandle = handle, componentArgs = std::make_tuple(std::forward<Args>(args)...)](World& world) mutable {
+			if (!world.IsValid(objectHandle) || objectHandle->GetState() == GameObject::EState::PendingDestroy) {
+				return;
+			}
+			std::apply([&world, &objectHandle](const auto& ... unpackedArgs) {
+				world.AddComponent<ComponentType>(*objectHandle, unpackedArgs...);
+			}, componentArgs);
+		});
+	}
+}
+#endif
@@ -4,6 +4,7 @@
 #include "../../Core/Log.hpp"
 #include "../../Event/EventManager.hpp"
 #include "../../Event/Events.hpp"
+#include <algorithm>
 namespace Mona {
 
 	template <typename ComponentType>
@@ -22,6 +23,17 @@ namespace Mona {
 		m_handleEntries.reserve(expectedObjects);
 	}
 
+	template <typename ComponentType>
+	void ComponentManager<ComponentType>::Reserve(size_type additionalComponents) noexcept {
+		m_components.reserve(m_components.size() + additionalComponents);
+		m_componentOwners.reserve(m_componentOwners.size() + additionalComponents);
+		m_handleEntryIndices.reserve(m_handleEntryIndices.size() + additionalComponents);
+		//Solo las entradas que no se alcancen a reutilizar de la lista libre requieren espacio nuevo
+		size_type reusedEntries = m_freeIndicesCount > s_minFreeIndices ?
+			std::min<size_type>(additionalComponents, m_freeIndicesCount - s_minFreeIndices) : 0;
+		m_handleEntries.reserve(m_handleEntries.size() + additionalComponents - reusedEntries);
+	}
+
 	template <typename ComponentType>
 	void ComponentManager<ComponentType>::ShutDown(EventManager& eventManager) noexcept {
 		//Antes de limpiar las componentes es necesario llamar OnRemoveComponent por temas de liberacin de recursos por ejemplo
@@ -85,6 +97,71 @@ namespace Mona {
 		}
 	}
 
+	template <typename ComponentType>
+	template <typename ... Args>
+	std::vector<InnerComponentHandle> ComponentManager<ComponentType>::AddComponents(const std::vector<GameObject*>& owners, const Args& ... args) noexcept
+	{
+		std::vector<InnerComponentHandle> handles;
+		handles.reserve(owners.size());
+		Reserve(static_cast<size_type>(owners.size()));
+		for (GameObject* owner : owners) {
+			handles.push_back(AddComponent(owner, args...));
+		}
+		return handles;
+	}
+
+	template <typename ComponentType>
+	void ComponentManager<ComponentType>::RemoveComponents(const std::vector<InnerComponentHandle>& handles) noexcept
+	{
+		for (const auto& handle : handles) {
+			MONA_ASSERT(handle.m_index < m_handleEntries.size(), "ComponentManager Error: handle index out of bounds");
+			MONA_ASSERT(handle.m_generation == m_handleEntries[handle.m_index].generation, "ComponentManager Error: Trying to delete from invalid handle");
+			MONA_ASSERT(m_handleEntries[handle.m_index].active == true, "ComponentManager Error: Trying to delete inactive handle");
+		}
+		//Todas las polizas se llaman antes de invalidar cualquier handle, ya que pueden consultar otras componentes del lote
+		for (const auto& handle : handles) {
+			size_type componentIndex = m_handleEntries[handle.m_index].index;
+			m_lifetimePolicy.OnRemoveComponent(m_componentOwners[componentIndex], m_components[componentIndex], handle);
+		}
+		for (const auto& handle : handles) {
+			MONA_ASSERT(m_handleEntries[handle.m_index].active == true, "ComponentManager Error: Repeated handle in batch removal");
+			m_handleEntries[handle.m_index].active = false;
+		}
+		//Los huecos que quedan bajo el nuevo tamao se rellenan con las componentes que sobreviven al final del arreglo,
+		//recorriendo este una sola vez desde el final
+		const size_type newCount = static_cast<size_type>(m_components.size() - handles.size());
+		size_type source = static_cast<size_type>(m_components.size());
+		for (const auto& handle : handles) {
+			size_type hole = m_handleEntries[handle.m_index].index;
+			if (newCount <= hole) {
+				continue;
+			}
+			do {
+				--source;
+			} while (!m_handleEntries[m_handleEntryIndices[source]].active);
+			m_components[hole] = std::move(m_components[source]);
+			m_componentOwners[hole] = m_componentOwners[source];
+			m_handleEntryIndices[hole] = m_handleEntryIndices[source];
+			m_handleEntries[m_handleEntryIndices[hole]].index = hole;
+		}
+		m_components.erase(m_components.begin() + newCount, m_components.end());
+		m_componentOwners.resize(newCount);
+		m_handleEntryIndices.resize(newCount);
+
+		for (const auto& handle : handles) {
+			auto index = handle.m_index;
+			if (m_lastFreeIndex != s_maxEntries)
+				m_handleEntries[m_lastFreeIndex].index = index;
+			else
+				m_firstFreeIndex = index;
+			auto& handleEntry = m_handleEntries[index];
+			handleEntry.prevIndex = m_lastFreeIndex;
+			handleEntry.index = s_maxEntries;
+			m_lastFreeIndex = index;
+			++m_freeIndicesCount;
+		}
+	}
+
 	template <typename ComponentType>
 	void ComponentManager<ComponentType>::RemoveComponent(const InnerComponentHandle& handle) noexcept
 	{
@@ -145,6 +222,12 @@ namespace Mona {
 	template <typename ComponentType>
 	typename ComponentManager<ComponentType>::size_type ComponentManager<ComponentType>::GetCount() const noexcept { return m_components.size(); }
 
+	template <typename ComponentType>
+	std::size_t ComponentManager<ComponentType>::GetMemoryUsage() const noexcept {
+		return m_components.capacity() * sizeof(ComponentType) + m_componentOwners.capacity() * sizeof(GameObject*) +
+			m_handleEntryIndices.capacity() * sizeof(uint32_t) + m_handleEntries.capacity() * sizeof(HandleEntry);
+	}
+
 	template <typename ComponentType>
 	GameObject* ComponentManager<ComponentType>::GetOwner(const InnerComponentHandle& handle) const noexcept
 	{
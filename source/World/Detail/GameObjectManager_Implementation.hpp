@@ -7,6 +7,14 @@ namespace Mona {
 
 	template <typename ObjectType, typename ...Args>
 	ObjectType* GameObjectManager::CreateGameObject(World& world, Args&& ... args)
+	{
+		ObjectType* rawPointer = AllocateGameObject<ObjectType>(std::forward<Args>(args)...);
+		rawPointer->StartUp(world);
+		return rawPointer;
+	}
+
+	template <typename ObjectType, typename ...Args>
+	ObjectType* GameObjectManager::AllocateGameObject(Args&& ... args)
 	{
 		static_assert(std::is_base_of<GameObject, ObjectType>::value, "ObjectType must be a derived class from GameObject");
 		MONA_ASSERT(m_gameObjects.size() < s_maxEntries, "GameObjectManager Error: Cannot Add more objects, max number reached.");
@@ -32,7 +40,6 @@ namespace Mona {
 			InnerGameObjectHandle resultHandle(handleIndex, handleEntry.generation);
 			m_gameObjects.emplace_back(std::move(gameObjectPointer));
 			rawPointer->SetObjectHandle(resultHandle);
-			rawPointer->StartUp(world);
 			//m_gameObjectHandleIndices.emplace_back(handleIndex);
 			return rawPointer;
 		}
@@ -42,7 +49,6 @@ namespace Mona {
 			InnerGameObjectHandle resultHandle(static_cast<size_type>(m_handleEntries.size() - 1), 0);
 			m_gameObjects.emplace_back(std::move(gameObjectPointer));
 			rawPointer->SetObjectHandle(resultHandle);
-			rawPointer->StartUp(world);
 			//m_gameObjectHandleIndices.emplace_back(static_cast<size_type>(m_handleEntries.size() - 1));
 			return rawPointer;
 		}
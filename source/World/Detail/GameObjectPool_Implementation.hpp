@@ -0,0 +1,46 @@
+#pragma once
+#ifndef GAMEOBJECTPOOL_IMPLEMENTATION_HPP
+#define GAMEOBJECTPOOL_IMPLEMENTATION_HPP
+#include "../../Core/Log.hpp"
+namespace Mona {
+
+	template <typename ObjectType>
+	void GameObjectPool<ObjectType>::Prewarm(size_type count) noexcept
+	{
+		auto handles = m_worldPtr->Instantiate<ObjectType>(m_prefab, count);
+		m_available.reserve(m_available.size() + handles.size());
+		for (auto& handle : handles) {
+			m_worldPtr->SetGameObjectActive(handle, false);
+			m_available.push_back(handle);
+		}
+	}
+
+	template <typename ObjectType>
+	GameObjectHandle<ObjectType> GameObjectPool<ObjectType>::Acquire() noexcept
+	{
+		if (m_available.empty()) {
+			return m_worldPtr->Instantiate<ObjectType>(m_prefab, 1)[0];
+		}
+		GameObjectHandle<ObjectType> handle = m_available.back();
+		m_available.pop_back();
+		m_worldPtr->SetGameObjectActive(handle, true);
+		return handle;
+	}
+
+	template <typename ObjectType>
+	void GameObjectPool<ObjectType>::Release(GameObjectHandle<ObjectType>& handle) noexcept
+	{
+		MONA_ASSERT(m_worldPtr->IsValid(handle), "GameObjectPool Error: Trying to release an invalid object");
+		MONA_ASSERT(handle->IsActive(), "GameObjectPool Error: Trying to release an inactive object");
+		m_worldPtr->SetGameObjectActive(handle, false);
+		m_available.push_back(handle);
+	}
+
+	template <typename ObjectType>
+	void GameObjectPool<ObjectType>::Clear() noexcept
+	{
+		m_worldPtr->DestroyGameObjects(m_available);
+		m_available.clear();
+	}
+}
+#endif
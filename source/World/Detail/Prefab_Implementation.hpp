@@ -0,0 +1,32 @@
+#pragma once
+#ifndef PREFAB_IMPLEMENTATION_HPP
+#define PREFAB_IMPLEMENTATION_HPP
+#include <algorithm>
+#include <tuple>
+#include "../../Core/Log.hpp"
+namespace Mona {
+
+	template <typename ComponentType, typename ...Args>
+	Prefab& Prefab::AddComponent(Args&& ... args)
+	{
+		static_assert(is_component<ComponentType>, "Template parameter is not a component");
+		MONA_ASSERT(!HasComponent<ComponentType>(),
+			"Prefab Error: Trying to add already present component. ComponentType = {0}", ComponentType::componentName);
+		m_componentInitializers.push_back({ ComponentType::componentIndex,
+			[componentArgs = std::make_tuple(std::forward<Args>(args)...)](World& world, GameObject& gameObject) {
+				std::apply([&world, &gameObject](const auto& ... unpackedArgs) {
+					world.AddComponent<ComponentType>(gameObject, unpackedArgs...);
+				}, componentArgs);
+			} });
+		return *this;
+	}
+
+	template <typename ComponentType>
+	bool Prefab::HasComponent() const noexcept
+	{
+		static_assert(is_component<ComponentType>, "Template parameter is not a component");
+		return std::any_of(m_componentInitializers.begin(), m_componentInitializers.end(),
+			[](const ComponentInitializer& initializer) { return initializer.componentIndex == ComponentType::componentIndex; });
+	}
+}
+#endif
@@ -10,6 +10,28 @@ namespace Mona {
 		return GameObjectHandle<ObjectType>(objectPointer->GetInnerObjectHandle(), objectPointer);
 	}
 
+	template <typename ObjectType, typename ...Args>
+	std::vector<GameObjectHandle<ObjectType>> World::Instantiate(const Prefab& prefab, GameObjectManager::size_type count, const Args& ... args) noexcept
+	{
+		static_assert(std::is_base_of<GameObject, ObjectType>::value, "ObjectType must be a derived class from GameObject");
+		std::vector<GameObjectHandle<ObjectType>> handles;
+		handles.reserve(count);
+		m_objectManager.Reserve(count);
+		for (const auto& initializer : prefab.m_componentInitializers) {
+			m_componentManagers[initializer.componentIndex]->Reserve(count);
+		}
+		for (GameObjectManager::size_type i = 0; i < count; i++) {
+			ObjectType* objectPointer = m_objectManager.AllocateGameObject<ObjectType>(args...);
+			objectPointer->ReserveComponentHandles(prefab.m_componentInitializers.size());
+			for (const auto& initializer : prefab.m_componentInitializers) {
+				initializer.addComponent(*this, *objectPointer);
+			}
+			objectPointer->StartUp(*this);
+			handles.emplace_back(objectPointer->GetInnerObjectHandle(), objectPointer);
+		}
+		return handles;
+	}
+
 	template <typename ComponentType, typename ...Args>
 	ComponentHandle<ComponentType> World::AddComponent(BaseGameObjectHandle& objectHandle, Args&& ... args) noexcept {
 		return AddComponent<ComponentType>(*objectHandle, std::forward<Args>(args)...);
@@ -36,6 +58,51 @@ namespace Mona {
 		objectPtr->RemoveInnerComponentHandle(ComponentType::componentIndex);
 	}
 
+	template <typename ComponentType, typename ObjectType, typename ...Args>
+	std::vector<ComponentHandle<ComponentType>> World::AddComponents(std::vector<GameObjectHandle<ObjectType>>& objectHandles, const Args& ... args) noexcept {
+		static_assert(is_component<ComponentType>, "Template parameter is not a component");
+		std::vector<GameObject*> gameObjects;
+		gameObjects.reserve(objectHandles.size());
+		for (auto& objectHandle : objectHandles) {
+			GameObject& gameObject = *objectHandle;
+			MONA_ASSERT(m_objectManager.IsValid(gameObject.GetInnerObjectHandle()), "World Error: Trying to add component from invaled object handle");
+			MONA_ASSERT(!gameObject.HasComponent<ComponentType>(),
+				"World Error: Trying to add already present component. ComponentType = {0}", ComponentType::componentName);
+			MONA_ASSERT(CheckDependencies<ComponentType>(gameObject, typename ComponentType::dependencies()), "World Error: Trying to add component with incomplete dependencies");
+			gameObjects.push_back(&gameObject);
+		}
+		auto managerPtr = static_cast<ComponentManager<ComponentType>*>(m_componentManagers[ComponentType::componentIndex].get());
+		std::vector<InnerComponentHandle> componentHandles = managerPtr->AddComponents(gameObjects, args...);
+		std::vector<ComponentHandle<ComponentType>> handles;
+		handles.reserve(componentHandles.size());
+		for (std::size_t i = 0; i < componentHandles.size(); i++) {
+			gameObjects[i]->AddInnerComponentHandle(ComponentType::componentIndex, componentHandles[i]);
+			handles.emplace_back(componentHandles[i], managerPtr);
+		}
+		return handles;
+	}
+
+	template <typename ComponentType>
+	void World::RemoveComponents(const std::vector<ComponentHandle<ComponentType>>& handles) noexcept {
+		static_assert(is_component<ComponentType>, "Template parameter is not a component");
+		std::vector<InnerComponentHandle> innerHandles;
+		innerHandles.reserve(handles.size());
+		for (const auto& handle : handles) {
+			innerHandles.push_back(handle.GetInnerHandle());
+		}
+		RemoveComponentBatch(ComponentType::componentIndex, innerHandles);
+	}
+
+	template <typename ObjectType>
+	void World::DestroyGameObjects(std::vector<GameObjectHandle<ObjectType>>& handles) noexcept {
+		std::vector<GameObject*> gameObjects;
+		gameObjects.reserve(handles.size());
+		for (auto& handle : handles) {
+			gameObjects.push_back(&*handle);
+		}
+		DestroyGameObjects(gameObjects);
+	}
+
 	template <typename ComponentType>
 	ComponentHandle<ComponentType> World::GetComponentHandle(const GameObject& gameObject) const noexcept
 	{
@@ -12,6 +12,8 @@ namespace Mona {
 	public:
 		enum class EState {
 			Active,
+			// Desactivado por un GameObjectPool, conserva sus componentes pero no se actualiza ni se dibuja
+			Inactive,
 			PendingDestroy
 		};
 		
@@ -24,7 +26,7 @@ namespace Mona {
 		};
 
 		void Update(World& world, float timeStep) noexcept {
-			if (m_state == EState::PendingDestroy)
+			if (m_state != EState::Active)
 				return;
 			UserUpdate(world, timeStep);
 		}
@@ -33,6 +35,7 @@ namespace Mona {
 		virtual void UserStartUp(World& world) noexcept {};
 
 		const EState GetState() const { return m_state; }
+		bool IsActive() const { return m_state == EState::Active; }
 		template <typename ComponentType>
 		bool HasComponent() const {
 			static_assert(is_component<ComponentType>, "Template parameter is not a component");
@@ -69,6 +72,10 @@ namespace Mona {
 			m_componentHandles.erase(componentIndex);
 		}
 
+		void ReserveComponentHandles(std::size_t count) {
+			m_componentHandles.reserve(count);
+		}
+
 		void AddInnerComponentHandle(decltype(GetComponentTypeCount()) componentIndex, InnerComponentHandle componentHandle) {
 			m_componentHandles[componentIndex] = componentHandle;
 		}
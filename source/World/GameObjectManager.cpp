@@ -1,6 +1,7 @@
 #include "GameObjectManager.hpp"
 #include "../Event/EventManager.hpp"
 #include "../Core/Log.hpp"
+#include <algorithm>
 namespace Mona {
 
 	GameObjectManager::GameObjectManager() :
@@ -16,6 +17,15 @@ namespace Mona {
 		m_pendingDestroyObjectHandles.reserve(expectedObjects);
 	}
 
+	void GameObjectManager::Reserve(size_type additionalObjects) noexcept
+	{
+		m_gameObjects.reserve(m_gameObjects.size() + additionalObjects);
+		//Solo las entradas que no se alcancen a reutilizar de la lista libre requieren espacio nuevo
+		size_type reusedEntries = m_freeIndicesCount > s_minFreeIndices ?
+			std::min<size_type>(additionalObjects, m_freeIndicesCount - s_minFreeIndices) : 0;
+		m_handleEntries.reserve(m_handleEntries.size() + additionalObjects - reusedEntries);
+	}
+
 	void GameObjectManager::ShutDown(World& world) noexcept
 	{
 		m_handleEntries.clear();
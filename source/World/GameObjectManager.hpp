@@ -20,6 +20,10 @@ namespace Mona {
 		void ShutDown(World &world) noexcept;
 		template <typename ObjectType,typename ...Args>
 		ObjectType* CreateGameObject(World &world, Args&& ... args);
+		// Igual que CreateGameObject pero sin llamar StartUp, para agregar componentes antes de UserStartUp
+		template <typename ObjectType, typename ...Args>
+		ObjectType* AllocateGameObject(Args&& ... args);
+		void Reserve(size_type additionalObjects) noexcept;
 		void DestroyGameObject(const InnerGameObjectHandle& handle) noexcept;
 		GameObject* GetGameObjectPointer(const InnerGameObjectHandle& handle) noexcept;
 		size_type GetCount() const noexcept;
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef GAMEOBJECTPOOL_HPP
+#define GAMEOBJECTPOOL_HPP
+#include <vector>
+#include "GameObjectHandle.hpp"
+#include "GameObjectManager.hpp"
+#include "Prefab.hpp"
+namespace Mona {
+	class World;
+
+	/*
+	* Pool de GameObjects creados a partir de un prefab. Release desactiva el objeto en vez de destruirlo, conservando
+	* sus componentes, y Acquire lo reactiva, por lo que el costo de crear y destruir se paga solo cuando el pool crece.
+	* Al reutilizar un objeto sus componentes mantienen los valores que tenian al liberarlo.
+	* ObjectType debe poder construirse sin argumentos.
+	*/
+	template <typename ObjectType = GameObject>
+	class GameObjectPool {
+	public:
+		using size_type = GameObjectManager::size_type;
+		GameObjectPool(World& world, const Prefab& prefab) : m_worldPtr(&world), m_prefab(prefab) {}
+		GameObjectPool(const GameObjectPool&) = delete;
+		GameObjectPool& operator=(const GameObjectPool&) = delete;
+		// Crea count instancias inactivas en una sola pasada
+		void Prewarm(size_type count) noexcept;
+		GameObjectHandle<ObjectType> Acquire() noexcept;
+		void Release(GameObjectHandle<ObjectType>& handle) noexcept;
+		// Destruye las instancias inactivas
+		void Clear() noexcept;
+		size_type GetAvailableCount() const noexcept { return static_cast<size_type>(m_available.size()); }
+	private:
+		World* m_worldPtr;
+		Prefab m_prefab;
+		std::vector<GameObjectHandle<ObjectType>> m_available;
+	};
+}
+#endif
@@ -15,6 +15,13 @@ namespace Mona {
 			m_generation(generation) {};
 		size_type m_index;
 		size_type m_generation;
+		// Dos handles son iguales solo si tambien coincide la generacion, un indice reutilizado es otro objeto
+		bool operator==(const InnerComponentHandle& other) const noexcept {
+			return m_index == other.m_index && m_generation == other.m_generation;
+		}
+		bool operator<(const InnerComponentHandle& other) const noexcept {
+			return m_index != other.m_index ? m_index < other.m_index : m_generation < other.m_generation;
+		}
 	};
 
 	struct InnerGameObjectHandle
@@ -26,6 +33,12 @@ namespace Mona {
 			m_generation(generation) {};
 		size_type m_index;
 		size_type m_generation;
+		bool operator==(const InnerGameObjectHandle& other) const noexcept {
+			return m_index == other.m_index && m_generation == other.m_generation;
+		}
+		bool operator<(const InnerGameObjectHandle& other) const noexcept {
+			return m_index != other.m_index ? m_index < other.m_index : m_generation < other.m_generation;
+		}
 	};
 
 }
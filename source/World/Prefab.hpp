@@ -0,0 +1,34 @@
+#pragma once
+#ifndef PREFAB_HPP
+#define PREFAB_HPP
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "ComponentTypes.hpp"
+namespace Mona {
+	class World;
+	class GameObject;
+
+	/*
+	* Descripcion de un arquetipo de GameObject: el conjunto de componentes que tendra junto a sus valores iniciales.
+	* Los argumentos de cada componente se copian al agregarlos al prefab, y se usan para construir la componente en
+	* cada instancia creada con World::Instantiate. Las componentes deben agregarse respetando sus dependencias.
+	*/
+	class Prefab {
+	public:
+		friend class World;
+		Prefab() = default;
+		template <typename ComponentType, typename ...Args>
+		Prefab& AddComponent(Args&& ... args);
+		template <typename ComponentType>
+		bool HasComponent() const noexcept;
+		std::size_t GetComponentCount() const noexcept { return m_componentInitializers.size(); }
+	private:
+		struct ComponentInitializer {
+			uint8_t componentIndex;
+			std::function<void(World&, GameObject&)> addComponent;
+		};
+		std::vector<ComponentInitializer> m_componentInitializers;
+	};
+}
+#endif
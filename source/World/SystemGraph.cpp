@@ -0,0 +1,85 @@
+#include "SystemGraph.hpp"
+#include <algorithm>
+#include <thread>
+namespace Mona {
+
+	void SystemGraph::AddSystem(const std::string& name, const SystemAccess& access, SystemFunction function, bool mainThreadOnly) noexcept {
+		uint32_t newIndex = static_cast<uint32_t>(m_systems.size());
+		SystemNode node;
+		node.name = name;
+		node.access = access;
+		node.function = std::move(function);
+		node.mainThreadOnly = mainThreadOnly;
+		//Los sistemas que acceden a los mismos datos conservan el orden en que fueron agregados
+		for (uint32_t i = 0; i < newIndex; i++) {
+			if (m_systems[i].access.ConflictsWith(access)) {
+				m_systems[i].dependents.push_back(newIndex);
+				node.dependencyCount++;
+			}
+		}
+		m_systems.push_back(std::move(node));
+		m_pendingDependencies.reset(new std::atomic<uint32_t>[m_systems.size()]);
+	}
+
+	void SystemGraph::Clear() noexcept {
+		m_systems.clear();
+		m_pendingDependencies.reset();
+	}
+
+	void SystemGraph::Execute(float timeStep) noexcept {
+		uint32_t systemCount = static_cast<uint32_t>(m_systems.size());
+		if (systemCount == 0) {
+			return;
+		}
+		JobSystem& jobSystem = JobSystem::GetInstance();
+		ExecutionState state;
+		state.timeStep = timeStep;
+		state.remainingSystems = systemCount;
+		for (uint32_t i = 0; i < systemCount; i++) {
+			m_pendingDependencies[i].store(m_systems[i].dependencyCount, std::memory_order_relaxed);
+		}
+		for (uint32_t i = 0; i < systemCount; i++) {
+			if (m_systems[i].dependencyCount == 0) {
+				Schedule(i, state);
+			}
+		}
+		while (0 < state.remainingSystems.load(std::memory_order_acquire)) {
+			uint32_t nextSystem = systemCount;
+			{
+				std::lock_guard<std::mutex> lock(state.mainThreadMutex);
+				auto it = std::min_element(state.mainThreadReady.begin(), state.mainThreadReady.end());
+				if (it != state.mainThreadReady.end()) {
+					nextSystem = *it;
+					state.mainThreadReady.erase(it);
+				}
+			}
+			if (nextSystem < systemCount) {
+				Run(nextSystem, state);
+			}
+			else if (!jobSystem.RunPendingJob()) {
+				std::this_thread::yield();
+			}
+		}
+		jobSystem.Wait(state.workerCounter);
+	}
+
+	void SystemGraph::Schedule(uint32_t index, ExecutionState& state) noexcept {
+		if (m_systems[index].mainThreadOnly) {
+			std::lock_guard<std::mutex> lock(state.mainThreadMutex);
+			state.mainThreadReady.push_back(index);
+			return;
+		}
+		JobSystem::GetInstance().Submit([this, index, &state]() { Run(index, state); }, &state.workerCounter);
+	}
+
+	void SystemGraph::Run(uint32_t index, ExecutionState& state) noexcept {
+		SystemNode& system = m_systems[index];
+		system.function(state.timeStep);
+		for (uint32_t dependent : system.dependents) {
+			if (m_pendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				Schedule(dependent, state);
+			}
+		}
+		state.remainingSystems.fetch_sub(1, std::memory_order_acq_rel);
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+#ifndef SYSTEMGRAPH_HPP
+#define SYSTEMGRAPH_HPP
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ComponentTypes.hpp"
+#include "../Core/JobSystem.hpp"
+namespace Mona {
+
+	enum class EngineResource : uint8_t {
+		Input,
+		Window,
+		Events,
+		GameObjects,
+		Physics,
+		Audio,
+		Rendering,
+		RenderSnapshot,
+		ResourceCount
+	};
+
+	class SystemAccess {
+	public:
+		template <typename ...ComponentTypes>
+		SystemAccess& Reads() noexcept {
+			((m_reads |= ComponentBit<ComponentTypes>()), ...);
+			return *this;
+		}
+		template <typename ...ComponentTypes>
+		SystemAccess& Writes() noexcept {
+			((m_writes |= ComponentBit<ComponentTypes>()), ...);
+			return *this;
+		}
+		SystemAccess& ReadsResource(EngineResource resource) noexcept {
+			m_reads |= ResourceBit(resource);
+			return *this;
+		}
+		SystemAccess& WritesResource(EngineResource resource) noexcept {
+			m_writes |= ResourceBit(resource);
+			return *this;
+		}
+		SystemAccess& ReadsAll() noexcept {
+			m_reads = ~uint64_t(0);
+			return *this;
+		}
+		SystemAccess& WritesAll() noexcept {
+			m_writes = ~uint64_t(0);
+			return *this;
+		}
+		bool ConflictsWith(const SystemAccess& other) const noexcept {
+			return (m_writes & (other.m_writes | other.m_reads)) != 0 || (m_reads & other.m_writes) != 0;
+		}
+	private:
+		template <typename ComponentType>
+		static constexpr uint64_t ComponentBit() {
+			static_assert(is_component<ComponentType>, "Template parameter is not a component");
+			return uint64_t(1) << ComponentType::componentIndex;
+		}
+		static constexpr uint64_t ResourceBit(EngineResource resource) {
+			return uint64_t(1) << (GetComponentTypeCount() + static_cast<uint8_t>(resource));
+		}
+		uint64_t m_reads = 0;
+		uint64_t m_writes = 0;
+	};
+
+	class SystemGraph {
+	public:
+		using SystemFunction = std::function<void(float)>;
+		SystemGraph() = default;
+		SystemGraph(const SystemGraph&) = delete;
+		SystemGraph& operator=(const SystemGraph&) = delete;
+		void AddSystem(const std::string& name, const SystemAccess& access, SystemFunction function, bool mainThreadOnly) noexcept;
+		void Clear() noexcept;
+		void Execute(float timeStep) noexcept;
+		uint32_t GetSystemCount() const noexcept { return static_cast<uint32_t>(m_systems.size()); }
+		const std::string& GetSystemName(uint32_t index) const noexcept { return m_systems[index].name; }
+		const std::vector<uint32_t>& GetDependents(uint32_t index) const noexcept { return m_systems[index].dependents; }
+	private:
+		struct SystemNode {
+			std::string name;
+			SystemAccess access;
+			SystemFunction function;
+			bool mainThreadOnly;
+			uint32_t dependencyCount = 0;
+			std::vector<uint32_t> dependents;
+		};
+		struct ExecutionState {
+			float timeStep;
+			std::mutex mainThreadMutex;
+			std::vector<uint32_t> mainThreadReady;
+			std::atomic<uint32_t> remainingSystems;
+			JobCounter workerCounter;
+		};
+		void Schedule(uint32_t index, ExecutionState& state) noexcept;
+		void Run(uint32_t index, ExecutionState& state) noexcept;
+		std::vector<SystemNode> m_systems;
+		std::unique_ptr<std::atomic<uint32_t>[]> m_pendingDependencies;
+	};
+}
+#endif
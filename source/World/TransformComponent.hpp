@@ -6,9 +6,25 @@
 #include <glm/gtx/quaternion.hpp>
 #include "ComponentTypes.hpp"
 namespace Mona {
+	class GameObject;
+	struct InnerComponentHandle;
+	class TransformComponent;
+	class TransformHierarchy;
+
+	class TransformLifetimePolicy {
+	public:
+		TransformLifetimePolicy() = default;
+		TransformLifetimePolicy(TransformHierarchy* hierarchyPtr) : m_hierarchyPtr(hierarchyPtr) {}
+		void OnAddComponent(GameObject* gameObjectPtr, TransformComponent& transform, const InnerComponentHandle& handle) noexcept {}
+		void OnRemoveComponent(GameObject* gameObjectPtr, TransformComponent& transform, const InnerComponentHandle& handle) noexcept;
+	private:
+		TransformHierarchy* m_hierarchyPtr = nullptr;
+	};
+
 	class TransformComponent {
 	public:
-		using LifetimePolicyType = DefaultLifetimePolicy<TransformComponent>;
+		friend class TransformHierarchy;
+		using LifetimePolicyType = TransformLifetimePolicy;
 		using dependencies = DependencyList<>;
 		static constexpr std::string_view componentName = "TransformComponent";
 		static constexpr uint8_t componentIndex = GetComponentIndex(EComponentType::TransformComponent);
@@ -18,7 +34,10 @@ namespace Mona {
 			const glm::vec3& scale = glm::vec3(1.0f)) :
 			localTranslation(translation),
 			localRotation(rotation),
-			localScale(scale) {}
+			localScale(scale),
+			m_localMatrix(ComputeLocalMatrix()),
+			m_worldMatrix(m_localMatrix),
+			m_parentMatrix(1.0f) {}
 
 		const glm::vec3& GetLocalTranslation() const {
 			return localTranslation;
@@ -29,40 +48,68 @@ namespace Mona {
 		const glm::vec3& GetLocalScale() const {
 			return localScale;
 		}
+		// Matriz de mundo. Se guarda en cache y solo se recalcula aqui si la transformacion cambio desde
+		// el ultimo pase de la jerarquia, sin escribir la cache para poder leerse desde varios hilos.
+		// Es exacta despues del sistema TransformHierarchy. Antes de el, un hijo que no cambio pero cuyo padre
+		// se movio en este frame devuelve todavia su pose de mundo del frame anterior.
 		glm::mat4 GetModelMatrix() const {
-			const glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), localTranslation);
-			const glm::mat4 rotationMatrix = glm::toMat4(localRotation);
-			const glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), localScale);
-
-			return translationMatrix * rotationMatrix * scaleMatrix;
+			if (!m_dirty) {
+				return m_worldMatrix;
+			}
+			return m_parentMatrix * ComputeLocalMatrix();
+		}
+		glm::mat4 GetLocalModelMatrix() const {
+			return m_dirty ? ComputeLocalMatrix() : m_localMatrix;
+		}
+		glm::vec3 GetWorldTranslation() const {
+			return glm::vec3(GetModelMatrix()[3]);
+		}
+		bool HasParent() const noexcept {
+			return m_hasParent;
 		}
+		// Matriz de vista construida con los valores locales, igual a la de mundo solo si no hay padre
 		glm::mat4 GetViewMatrixFromTransform() const {
 			const glm::vec3 up = GetUpVector();
 			const glm::vec3 front = GetFrontVector();
 			return glm::lookAt(localTranslation, localTranslation + front, up);
 		}
+		// Matriz de vista en espacio de mundo, valida bajo las mismas condiciones que GetModelMatrix
+		glm::mat4 GetWorldViewMatrix() const {
+			if (!m_hasParent) {
+				return GetViewMatrixFromTransform();
+			}
+			const glm::mat4 modelMatrix = GetModelMatrix();
+			const glm::vec3 position = glm::vec3(modelMatrix[3]);
+			return glm::lookAt(position, position + glm::normalize(glm::vec3(modelMatrix[1])), glm::normalize(glm::vec3(modelMatrix[2])));
+		}
 		void Translate(glm::vec3 translation) {
 			localTranslation += translation;
+			m_dirty = true;
 		}
 
 		void SetTranslation(const glm::vec3 translation) {
 			localTranslation = translation;
+			m_dirty = true;
 		}
 
 		void Scale(glm::vec3 scale){
 			localScale *= scale;
+			m_dirty = true;
 		}
 
 		void SetScale(const glm::vec3& scale) {
 			localScale = scale;
+			m_dirty = true;
 		}
 		
 		void Rotate(glm::vec3 axis, float angle){
 			localRotation = glm::rotate(localRotation, angle, axis);
+			m_dirty = true;
 		}
 
 		void SetRotation(const glm::fquat& rotation) {
 			localRotation = rotation;
+			m_dirty = true;
 		}
 
 		glm::vec3 GetUpVector() const {
@@ -77,10 +124,36 @@ namespace Mona {
 			return glm::rotate(localRotation, glm::vec3(0.0f, 1.0f, 0.0f));
 		}
 
+		// Ejes de la transformacion en espacio de mundo. Sin padre coinciden con los locales
+		glm::vec3 GetWorldUpVector() const {
+			return m_hasParent ? glm::normalize(glm::vec3(GetModelMatrix()[2])) : GetUpVector();
+		}
+
+		glm::vec3 GetWorldRightVector() const {
+			return m_hasParent ? glm::normalize(glm::vec3(GetModelMatrix()[0])) : GetRightVector();
+		}
+
+		glm::vec3 GetWorldFrontVector() const {
+			return m_hasParent ? glm::normalize(glm::vec3(GetModelMatrix()[1])) : GetFrontVector();
+		}
+
 	private:
+		glm::mat4 ComputeLocalMatrix() const {
+			const glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), localTranslation);
+			const glm::mat4 rotationMatrix = glm::toMat4(localRotation);
+			const glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), localScale);
+
+			return translationMatrix * rotationMatrix * scaleMatrix;
+		}
 		glm::vec3 localTranslation;
 		glm::fquat localRotation;
 		glm::vec3 localScale;
+		glm::mat4 m_localMatrix;
+		glm::mat4 m_worldMatrix;
+		// Matriz de mundo del padre usada en el ultimo pase, identidad si no tiene padre
+		glm::mat4 m_parentMatrix;
+		bool m_dirty = false;
+		bool m_hasParent = false;
 	};
 
 
@@ -0,0 +1,263 @@
+#include "TransformHierarchy.hpp"
+#include <algorithm>
+#include <numeric>
+#include <glm/gtx/matrix_decompose.hpp>
+#include "ComponentManager.hpp"
+#include "../Core/JobSystem.hpp"
+#include "../Core/Log.hpp"
+
+#define TRANSFORM_UPDATE_BATCH_SIZE 256
+
+namespace Mona {
+
+	void TransformLifetimePolicy::OnRemoveComponent(GameObject* gameObjectPtr, TransformComponent& transform, const InnerComponentHandle& handle) noexcept {
+		if (m_hierarchyPtr != nullptr) {
+			m_hierarchyPtr->OnTransformRemoved(handle);
+		}
+	}
+
+	void TransformHierarchy::StartUp(ComponentManager<TransformComponent>* transformManagerPtr) noexcept {
+		m_transformManagerPtr = transformManagerPtr;
+	}
+
+	void TransformHierarchy::ShutDown() noexcept {
+		m_handles.clear();
+		m_parents.clear();
+		m_childCounts.clear();
+		m_depths.clear();
+		m_changed.clear();
+		m_nodeIndices.clear();
+		m_orderDirty = false;
+	}
+
+	bool TransformHierarchy::SetParent(const InnerComponentHandle& childHandle, const InnerComponentHandle& parentHandle) noexcept {
+		auto& transformManager = *m_transformManagerPtr;
+		if (!transformManager.IsValid(childHandle) || !transformManager.IsValid(parentHandle)) {
+			MONA_LOG_ERROR("TransformHierarchy Error: Invalid transform handle.");
+			return false;
+		}
+		if (childHandle.m_index == parentHandle.m_index) {
+			MONA_LOG_ERROR("TransformHierarchy Error: A transform cannot be its own parent.");
+			return false;
+		}
+		//No se permiten ciclos: el hijo no puede ser ancestro del nuevo padre
+		uint32_t childNode = FindNode(childHandle);
+		for (uint32_t ancestor = FindNode(parentHandle); ancestor != INVALID_NODE; ancestor = m_parents[ancestor]) {
+			if (ancestor == childNode) {
+				MONA_LOG_ERROR("TransformHierarchy Error: Cannot parent a transform to one of its descendants.");
+				return false;
+			}
+		}
+		InnerComponentHandle previousParentHandle;
+		if (childNode != INVALID_NODE && m_parents[childNode] != INVALID_NODE) {
+			uint32_t previousParent = m_parents[childNode];
+			previousParentHandle = m_handles[previousParent];
+			m_childCounts[previousParent]--;
+		}
+		childNode = GetOrAddNode(childHandle);
+		uint32_t parentNode = GetOrAddNode(parentHandle);
+		m_parents[childNode] = parentNode;
+		m_childCounts[parentNode]++;
+		TransformComponent* childTransform = transformManager.GetComponentPointer(childHandle);
+		childTransform->m_hasParent = true;
+		childTransform->m_parentMatrix = transformManager.GetComponentPointer(parentHandle)->GetModelMatrix();
+		childTransform->m_dirty = true;
+		m_orderDirty = true;
+		if (previousParentHandle.m_index != INVALID_INDEX) {
+			RemoveNodeIfIsolated(previousParentHandle);
+		}
+		return true;
+	}
+
+	void TransformHierarchy::RemoveParent(const InnerComponentHandle& childHandle) noexcept {
+		uint32_t childNode = FindNode(childHandle);
+		if (childNode == INVALID_NODE || m_parents[childNode] == INVALID_NODE) {
+			return;
+		}
+		DetachNode(childNode);
+	}
+
+	InnerComponentHandle TransformHierarchy::GetParent(const InnerComponentHandle& childHandle) const noexcept {
+		uint32_t childNode = FindNode(childHandle);
+		if (childNode == INVALID_NODE || m_parents[childNode] == INVALID_NODE) {
+			return InnerComponentHandle();
+		}
+		return m_handles[m_parents[childNode]];
+	}
+
+	void TransformHierarchy::UpdateWorldMatrices() noexcept {
+		auto& transformManager = *m_transformManagerPtr;
+		if (m_orderDirty) {
+			SortByDepth();
+		}
+		//Los padres se visitan antes que sus hijos, por lo que basta un recorrido lineal.
+		//Solo se recalculan los subarboles cuya raiz cambio.
+		uint32_t nodeCount = static_cast<uint32_t>(m_handles.size());
+		m_changed.resize(nodeCount);
+		for (uint32_t i = 0; i < nodeCount; i++) {
+			TransformComponent* transform = transformManager.GetComponentPointer(m_handles[i]);
+			uint32_t parent = m_parents[i];
+			bool changed = transform->m_dirty || (parent != INVALID_NODE && m_changed[parent]);
+			m_changed[i] = changed;
+			if (!changed) {
+				continue;
+			}
+			if (transform->m_dirty) {
+				transform->m_localMatrix = transform->ComputeLocalMatrix();
+			}
+			transform->m_parentMatrix = parent != INVALID_NODE ?
+				transformManager.GetComponentPointer(m_handles[parent])->m_worldMatrix : glm::mat4(1.0f);
+			transform->m_worldMatrix = transform->m_parentMatrix * transform->m_localMatrix;
+			transform->m_dirty = false;
+		}
+		//El resto de las transformaciones no tiene padre ni hijos, su matriz de mundo es la local
+		JobSystem::GetInstance().ParallelFor(transformManager.GetCount(), TRANSFORM_UPDATE_BATCH_SIZE,
+			[&transformManager](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; i++) {
+					TransformComponent& transform = transformManager[i];
+					if (!transform.m_dirty) {
+						continue;
+					}
+					transform.m_localMatrix = transform.ComputeLocalMatrix();
+					transform.m_worldMatrix = transform.m_parentMatrix * transform.m_localMatrix;
+					transform.m_dirty = false;
+				}
+			});
+	}
+
+	uint32_t TransformHierarchy::FindNode(const InnerComponentHandle& handle) const noexcept {
+		auto it = m_nodeIndices.find(handle.m_index);
+		if (it == m_nodeIndices.end() || m_handles[it->second].m_generation != handle.m_generation) {
+			return INVALID_NODE;
+		}
+		return it->second;
+	}
+
+	uint32_t TransformHierarchy::GetOrAddNode(const InnerComponentHandle& handle) noexcept {
+		uint32_t node = FindNode(handle);
+		if (node != INVALID_NODE) {
+			return node;
+		}
+		node = static_cast<uint32_t>(m_handles.size());
+		m_handles.push_back(handle);
+		m_parents.push_back(INVALID_NODE);
+		m_childCounts.push_back(0);
+		m_depths.push_back(0);
+		m_nodeIndices[handle.m_index] = node;
+		m_orderDirty = true;
+		return node;
+	}
+
+	void TransformHierarchy::DetachNode(uint32_t node) noexcept {
+		//El nodo conserva su pose de mundo, que pasa a ser su transformacion local
+		TransformComponent* transform = m_transformManagerPtr->GetComponentPointer(m_handles[node]);
+		glm::vec3 scale;
+		glm::fquat rotation;
+		glm::vec3 translation;
+		glm::vec3 skew;
+		glm::vec4 perspective;
+		glm::decompose(transform->GetModelMatrix(), scale, rotation, translation, skew, perspective);
+		transform->SetTranslation(translation);
+		transform->SetRotation(rotation);
+		transform->SetScale(scale);
+		transform->m_hasParent = false;
+		transform->m_parentMatrix = glm::mat4(1.0f);
+		InnerComponentHandle nodeHandle = m_handles[node];
+		InnerComponentHandle parentHandle = m_handles[m_parents[node]];
+		m_childCounts[m_parents[node]]--;
+		m_parents[node] = INVALID_NODE;
+		m_orderDirty = true;
+		RemoveNodeIfIsolated(nodeHandle);
+		RemoveNodeIfIsolated(parentHandle);
+	}
+
+	void TransformHierarchy::RemoveNodeIfIsolated(const InnerComponentHandle& handle) noexcept {
+		uint32_t node = FindNode(handle);
+		if (node == INVALID_NODE || m_parents[node] != INVALID_NODE || 0 < m_childCounts[node]) {
+			return;
+		}
+		//Se intercambia con el ultimo nodo, el orden por profundidad se recalcula en el siguiente pase
+		uint32_t last = static_cast<uint32_t>(m_handles.size() - 1);
+		m_nodeIndices.erase(handle.m_index);
+		if (node != last) {
+			m_handles[node] = m_handles[last];
+			m_parents[node] = m_parents[last];
+			m_childCounts[node] = m_childCounts[last];
+			m_nodeIndices[m_handles[node].m_index] = node;
+			for (auto& parent : m_parents) {
+				if (parent == last) {
+					parent = node;
+				}
+			}
+		}
+		m_handles.pop_back();
+		m_parents.pop_back();
+		m_childCounts.pop_back();
+		m_depths.pop_back();
+		m_orderDirty = true;
+	}
+
+	void TransformHierarchy::OnTransformRemoved(const InnerComponentHandle& handle) noexcept {
+		uint32_t node = FindNode(handle);
+		if (node == INVALID_NODE) {
+			return;
+		}
+		//Los hijos de una transformacion eliminada quedan sin padre conservando su pose de mundo
+		std::vector<InnerComponentHandle> children;
+		for (uint32_t i = 0; i < m_handles.size(); i++) {
+			if (m_parents[i] == node) {
+				children.push_back(m_handles[i]);
+			}
+		}
+		for (const auto& child : children) {
+			DetachNode(FindNode(child));
+		}
+		node = FindNode(handle);
+		if (node != INVALID_NODE && m_parents[node] != INVALID_NODE) {
+			DetachNode(node);
+		}
+	}
+
+	void TransformHierarchy::SortByDepth() noexcept {
+		uint32_t nodeCount = static_cast<uint32_t>(m_handles.size());
+		constexpr uint32_t unknownDepth = std::numeric_limits<uint32_t>::max();
+		std::fill(m_depths.begin(), m_depths.end(), unknownDepth);
+		std::vector<uint32_t> chain;
+		for (uint32_t i = 0; i < nodeCount; i++) {
+			uint32_t node = i;
+			while (node != INVALID_NODE && m_depths[node] == unknownDepth) {
+				chain.push_back(node);
+				node = m_parents[node];
+			}
+			uint32_t depth = node == INVALID_NODE ? 0 : m_depths[node] + 1;
+			for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+				m_depths[*it] = depth++;
+			}
+			chain.clear();
+		}
+		std::vector<uint32_t> order(nodeCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return m_depths[a] < m_depths[b]; });
+		std::vector<uint32_t> newIndices(nodeCount);
+		for (uint32_t i = 0; i < nodeCount; i++) {
+			newIndices[order[i]] = i;
+		}
+		std::vector<InnerComponentHandle> handles(nodeCount);
+		std::vector<uint32_t> parents(nodeCount);
+		std::vector<uint32_t> childCounts(nodeCount);
+		std::vector<uint32_t> depths(nodeCount);
+		for (uint32_t i = 0; i < nodeCount; i++) {
+			uint32_t oldNode = order[i];
+			handles[i] = m_handles[oldNode];
+			parents[i] = m_parents[oldNode] == INVALID_NODE ? INVALID_NODE : newIndices[m_parents[oldNode]];
+			childCounts[i] = m_childCounts[oldNode];
+			depths[i] = m_depths[oldNode];
+			m_nodeIndices[handles[i].m_index] = i;
+		}
+		m_handles = std::move(handles);
+		m_parents = std::move(parents);
+		m_childCounts = std::move(childCounts);
+		m_depths = std::move(depths);
+		m_orderDirty = false;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef TRANSFORMHIERARCHY_HPP
+#define TRANSFORMHIERARCHY_HPP
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "GameObjectTypes.hpp"
+#include "TransformComponent.hpp"
+namespace Mona {
+	template <typename ComponentType>
+	class ComponentManager;
+
+	/*
+	* Relaciones padre-hijo entre TransformComponents. Solo las transformaciones que tienen padre o hijos
+	* forman parte de la jerarquia, y se guardan en arreglos contiguos ordenados por profundidad, de modo que
+	* un unico recorrido lineal actualiza las matrices de mundo visitando cada padre antes que sus hijos.
+	*/
+	class TransformHierarchy {
+	public:
+		friend class TransformLifetimePolicy;
+		TransformHierarchy() = default;
+		void StartUp(ComponentManager<TransformComponent>* transformManagerPtr) noexcept;
+		void ShutDown() noexcept;
+		// El hijo conserva sus valores locales, que pasan a ser relativos al nuevo padre
+		bool SetParent(const InnerComponentHandle& childHandle, const InnerComponentHandle& parentHandle) noexcept;
+		// El hijo conserva su pose de mundo actual
+		void RemoveParent(const InnerComponentHandle& childHandle) noexcept;
+		InnerComponentHandle GetParent(const InnerComponentHandle& childHandle) const noexcept;
+		uint32_t GetNodeCount() const noexcept { return static_cast<uint32_t>(m_handles.size()); }
+		// Actualiza las matrices locales y de mundo de todas las transformaciones modificadas y de sus descendientes
+		void UpdateWorldMatrices() noexcept;
+	private:
+		static constexpr uint32_t INVALID_NODE = std::numeric_limits<uint32_t>::max();
+		uint32_t FindNode(const InnerComponentHandle& handle) const noexcept;
+		uint32_t GetOrAddNode(const InnerComponentHandle& handle) noexcept;
+		void DetachNode(uint32_t node) noexcept;
+		void RemoveNodeIfIsolated(const InnerComponentHandle& handle) noexcept;
+		void OnTransformRemoved(const InnerComponentHandle& handle) noexcept;
+		void SortByDepth() noexcept;
+
+		ComponentManager<TransformComponent>* m_transformManagerPtr = nullptr;
+		// Arreglos paralelos indexados por nodo. Tras SortByDepth todo padre precede a sus hijos.
+		std::vector<InnerComponentHandle> m_handles;
+		std::vector<uint32_t> m_parents;
+		std::vector<uint32_t> m_childCounts;
+		std::vector<uint32_t> m_depths;
+		std::vector<uint8_t> m_changed;
+		// Indice de la entrada del handle -> nodo
+		std::unordered_map<InnerComponentHandle::size_type, uint32_t> m_nodeIndices;
+		bool m_orderDirty = false;
+	};
+}
+#endif
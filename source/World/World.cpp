@@ -1,6 +1,9 @@
 #include "World.hpp"
 #include "../Core/Config.hpp"
+#include "../Core/FrameAllocator.hpp"
+#include "../Core/MemoryTracker.hpp"
 #include "../Core/RootDirectory.hpp"
+#include "../Core/JobSystem.hpp"
 #include "../Event/Events.hpp"
 #include "../DebugDrawing/DebugDrawingSystem.hpp"
 #include "../Audio/AudioClipManager.hpp"
@@ -11,21 +14,48 @@
 #include "../Animation/SkeletonManager.hpp"
 #include "../Animation/AnimationClipManager.hpp"
 #include "../Animation/AnimationController.hpp"
+#include <algorithm>
+#include <limits>
 #include <chrono>
+#include <glm/gtx/matrix_decompose.hpp>
+#include <mutex>
+
+#define MEMORY_ACCOUNTING_INTERVAL 60
+
 namespace Mona {
+
+	//Los servicios compartidos (configuracion, JobSystem y caches de assets) se inician con el primer mundo y se
+	//cierran con el ultimo. Los assets con recursos de GPU o de OpenAL se liberan con el ultimo mundo con ventana.
+	static std::mutex s_sharedServicesMutex;
+	static uint32_t s_worldCount = 0;
+	static uint32_t s_windowedWorldCount = 0;
 	
-	World::World(Application& app) : 
+	World::World(Application& app, WorldMode mode) : 
 		m_objectManager(),
 		m_eventManager(), 
 		m_window(), 
 		m_input(), 
 		m_application(app),
 		m_shouldClose(false),
+		m_mode(mode),
 		m_physicsCollisionSystem(),
 		m_ambientLight(glm::vec3(0.1f))
 	{
 		auto& config = Config::GetInstance();
-		config.readFile(SourceDirectoryData::SourcePath("config.cfg").string());
+		{
+			std::lock_guard<std::mutex> lock(s_sharedServicesMutex);
+			if (s_worldCount++ == 0) {
+				config.readFile(SourceDirectoryData::SourcePath("config.cfg").string());
+				MemoryTracker::GetInstance().StartUp();
+				JobSystem::GetInstance().StartUp(config.getValueOrDefault<int>("job_system_worker_threads", -1));
+			}
+			if (!IsHeadless()) {
+				s_windowedWorldCount++;
+			}
+		}
+		m_frameAllocator.StartUp(config.getValueOrDefault<int>("frame_allocator_arena_size", 1 << 20));
+		m_pipelinedRendering = config.getValueOrDefault<int>("pipelined_rendering", 0) != 0;
+		m_assetUploadsPerFrame = static_cast<uint32_t>(std::max(1, config.getValueOrDefault<int>("asset_uploads_per_frame", ASSET_UPLOAD_DEFAULT_COUNT)));
 
 		m_componentManagers[TransformComponent::componentIndex].reset(new ComponentManager<TransformComponent>());
 		m_componentManagers[CameraComponent::componentIndex].reset(new ComponentManager<CameraComponent>());
@@ -48,20 +78,42 @@ namespace Mona {
 		auto& ikNavigationDataManager = GetComponentManager<IKNavigationComponent>();
 
 		const GameObjectID expectedObjects = config.getValueOrDefault<int>("expected_number_of_gameobjects", 1000);
+		transformDataManager.SetLifetimePolicy(TransformLifetimePolicy(&m_transformHierarchy));
+		m_transformHierarchy.StartUp(&transformDataManager);
 		rigidBodyDataManager.SetLifetimePolicy(RigidBodyLifetimePolicy(&transformDataManager, &m_physicsCollisionSystem));
 		audioSourceDataManager.SetLifetimePolicy(AudioSourceComponentLifetimePolicy(&m_audioSystem));
 		ikNavigationDataManager.SetLifetimePolicy(IKNavigationLifetimePolicy(&transformDataManager, 
 			&skeletalMeshDataManager,&ikNavigationDataManager));
-		m_window.StartUp(m_eventManager);
-		m_input.StartUp(m_eventManager);
+		m_ikNavigationSystyem.EnableLOD(config.getValueOrDefault<int>("enable_ik_navigation_lod", 0) != 0);
+		if (!IsHeadless()) {
+			m_window.StartUp(m_eventManager);
+			m_input.StartUp(m_eventManager);
+		}
+		//Grabacion o reproduccion de input para corridas reproducibles (por ejemplo para comparar rendimiento entre versiones)
+		const std::string inputReplayFile = config.getValueOrDefault<std::string>("input_replay_file", "");
+		const std::string inputRecordFile = config.getValueOrDefault<std::string>("input_record_file", "");
+		if (!inputReplayFile.empty()) {
+			if (m_input.StartReplay(inputReplayFile)) {
+				const std::string reportFile = config.getValueOrDefault<std::string>("input_replay_report_file", "");
+				if (!reportFile.empty()) {
+					m_replayReport.open(reportFile, std::ios::trunc);
+					m_replayReport << "frame,time_step,cpu_ms,checksum\n";
+				}
+			}
+		}
+		else if (!inputRecordFile.empty()) {
+			m_input.StartRecording(inputRecordFile);
+		}
 		m_objectManager.StartUp(expectedObjects);
 		for (auto& componentManager : m_componentManagers)
 			componentManager->StartUp(m_eventManager, expectedObjects);
 		m_application = std::move(app);
-		m_renderer.StartUp(m_eventManager, m_debugDrawingSystemIKNav.get());
-		//m_renderer.StartUp(m_eventManager, m_debugDrawingSystemPhysics.get());
-		m_audioSystem.StartUp();
-		m_debugDrawingSystemIKNav->StartUp(&m_ikNavigationSystyem);
+		if (!IsHeadless()) {
+			m_renderer.StartUp(m_eventManager, m_debugDrawingSystemIKNav.get());
+			//m_renderer.StartUp(m_eventManager, m_debugDrawingSystemPhysics.get());
+			m_audioSystem.StartUp();
+			m_debugDrawingSystemIKNav->StartUp(&m_ikNavigationSystyem);
+		}
 		//m_debugDrawingSystemPhysics->StartUp(&m_physicsCollisionSystem);
 		m_application.StartUp(*this);
 	
@@ -72,20 +124,41 @@ namespace Mona {
 		m_objectManager.ShutDown(*this);
 		for (auto& componentManager : m_componentManagers)
 			componentManager->ShutDown(m_eventManager);
-		m_audioSystem.ClearSources();
-		AudioClipManager::GetInstance().ShutDown();
-		m_audioSystem.ShutDown();
+		m_transformHierarchy.ShutDown();
+		for (auto& snapshot : m_renderSnapshots)
+			snapshot.Clear();
+		//Las subidas pendientes de este hilo ya no tienen contexto donde ejecutarse
+		AssetLoader::GetInstance().DiscardUploads();
+		std::lock_guard<std::mutex> lock(s_sharedServicesMutex);
+		bool lastWorld = --s_worldCount == 0;
+		bool lastWindowedWorld = !IsHeadless() && --s_windowedWorldCount == 0;
+		if (!IsHeadless()) {
+			m_audioSystem.ClearSources();
+			if (lastWindowedWorld) {
+				AudioClipManager::GetInstance().ShutDown();
+			}
+			m_audioSystem.ShutDown();
+		}
 		m_physicsCollisionSystem.ShutDown();
-		MeshManager::GetInstance().ShutDown();
-		TextureManager::GetInstance().ShutDown();
-		SkeletonManager::GetInstance().ShutDown();
-		AnimationClipManager::GetInstance().ShutDown();
-		m_renderer.ShutDown(m_eventManager);
-		m_debugDrawingSystemIKNav->ShutDown();
-		//m_debugDrawingSystemPhysics->ShutDown();
-		m_window.ShutDown();
-		m_input.ShutDown(m_eventManager);
+		if (lastWindowedWorld) {
+			MeshManager::GetInstance().ShutDown();
+			TextureManager::GetInstance().ShutDown();
+		}
+		if (lastWorld) {
+			SkeletonManager::GetInstance().ShutDown();
+			AnimationClipManager::GetInstance().ShutDown();
+		}
+		if (!IsHeadless()) {
+			m_renderer.ShutDown(m_eventManager);
+			m_debugDrawingSystemIKNav->ShutDown();
+			//m_debugDrawingSystemPhysics->ShutDown();
+			m_window.ShutDown();
+			m_input.ShutDown(m_eventManager);
+		}
 		m_eventManager.ShutDown();
+		if (lastWorld) {
+			JobSystem::GetInstance().ShutDown();
+		}
 
 	}
 
@@ -103,8 +176,78 @@ namespace Mona {
 		m_objectManager.DestroyGameObject(gameObject.GetInnerObjectHandle());
 	}
 
+	void World::DestroyGameObjects(const std::vector<GameObject*>& gameObjects) noexcept {
+		//Un mismo objeto puede aparecer varias veces. Se compara el handle completo, incluida la generacion,
+		//y el orden por handle hace que la destruccion no dependa del orden de la lista
+		std::vector<GameObject*> uniqueObjects(gameObjects);
+		std::sort(uniqueObjects.begin(), uniqueObjects.end(), [](const GameObject* a, const GameObject* b) {
+			return a->GetInnerObjectHandle() < b->GetInnerObjectHandle();
+		});
+		uniqueObjects.erase(std::unique(uniqueObjects.begin(), uniqueObjects.end(), [](const GameObject* a, const GameObject* b) {
+			return a->GetInnerObjectHandle() == b->GetInnerObjectHandle();
+		}), uniqueObjects.end());
+		std::array<std::vector<InnerComponentHandle>, GetComponentTypeCount()> componentHandles;
+		for (GameObject* gameObject : uniqueObjects) {
+			MONA_ASSERT(m_objectManager.IsValid(gameObject->GetInnerObjectHandle()), "World Error: Trying to destroy invalid object");
+			MONA_ASSERT(gameObject->GetState() != GameObject::EState::PendingDestroy, "World Error: Trying to destroy object already pending to destroy");
+			for (auto& it : gameObject->m_componentHandles) {
+				componentHandles[it.first].push_back(it.second);
+			}
+		}
+		//Los tipos con indice mayor pueden depender de los menores (ej: todos dependen de Transform), asi que se remueven primero
+		for (int componentIndex = GetComponentTypeCount() - 1; 0 <= componentIndex; componentIndex--) {
+			if (!componentHandles[componentIndex].empty()) {
+				m_componentManagers[componentIndex]->RemoveComponents(componentHandles[componentIndex]);
+			}
+		}
+		for (GameObject* gameObject : uniqueObjects) {
+			gameObject->m_componentHandles.clear();
+			m_objectManager.DestroyGameObject(gameObject->GetInnerObjectHandle());
+		}
+	}
+
+	void World::RemoveComponentBatch(uint8_t componentIndex, const std::vector<InnerComponentHandle>& handles) noexcept {
+		std::vector<GameObject*> owners;
+		owners.reserve(handles.size());
+		for (const auto& handle : handles) {
+			MONA_ASSERT(m_componentManagers[componentIndex]->IsValid(handle), "World Error: Trying to remove invalid component");
+			owners.push_back(m_componentManagers[componentIndex]->GetOwner(handle));
+		}
+		m_componentManagers[componentIndex]->RemoveComponents(handles);
+		for (GameObject* owner : owners) {
+			owner->RemoveInnerComponentHandle(componentIndex);
+		}
+	}
+
+	void World::SetGameObjectActive(BaseGameObjectHandle& handle, bool active) noexcept {
+		SetGameObjectActive(*handle, active);
+	}
+
+	void World::SetGameObjectActive(GameObject& gameObject, bool active) noexcept {
+		MONA_ASSERT(m_objectManager.IsValid(gameObject.GetInnerObjectHandle()), "World Error: Trying to change activation of invalid object");
+		MONA_ASSERT(gameObject.GetState() != GameObject::EState::PendingDestroy, "World Error: Trying to change activation of object pending to destroy");
+		if (gameObject.IsActive() == active) {
+			return;
+		}
+		gameObject.m_state = active ? GameObject::EState::Active : GameObject::EState::Inactive;
+		//Los cuerpos rigidos de objetos inactivos se sacan del mundo de bullet para que no colisionen
+		if (gameObject.HasComponent<RigidBodyComponent>()) {
+			auto& rigidBody = *GetComponentManager<RigidBodyComponent>().GetComponentPointer(gameObject.GetInnerComponentHandle<RigidBodyComponent>());
+			if (active) {
+				m_physicsCollisionSystem.AddRigidBody(rigidBody);
+			}
+			else {
+				m_physicsCollisionSystem.RemoveRigidBody(rigidBody);
+			}
+		}
+		if (!active && gameObject.HasComponent<AudioSourceComponent>()) {
+			GetComponentManager<AudioSourceComponent>().GetComponentPointer(gameObject.GetInnerComponentHandle<AudioSourceComponent>())->Stop();
+		}
+	}
+
 	bool World::IsValid(const BaseGameObjectHandle& handle) const noexcept {
-		return m_objectManager.IsValid(handle->GetInnerObjectHandle());
+		//No se desreferencia el handle porque el objeto pudo haber sido destruido
+		return m_objectManager.IsValid(handle.GetInnerHandle());
 	}
 	GameObjectManager::size_type World::GetGameObjectCount() const noexcept
 	{
@@ -129,7 +272,7 @@ namespace Mona {
 	void World::StartMainLoop() noexcept {
 		std::chrono::time_point<std::chrono::steady_clock> startTime = std::chrono::steady_clock::now();
 		float averageTimeStep = 1.0f/20.0f;
-		while (!m_window.ShouldClose() && !m_shouldClose)
+		while ((IsHeadless() || !m_window.ShouldClose()) && !m_shouldClose)
 		{
 			std::chrono::time_point<std::chrono::steady_clock> newTime = std::chrono::steady_clock::now();
 			const auto frameTime = newTime - startTime;
@@ -150,6 +293,137 @@ namespace Mona {
 	}
 
 	void World::Update(float timeStep) noexcept
+	{
+		//Durante una reproduccion el paso de tiempo grabado reemplaza al entregado, para que la simulacion sea identica
+		const bool replayingInput = m_input.IsReplaying();
+		std::chrono::steady_clock::time_point frameStart;
+		if (replayingInput) {
+			timeStep = m_input.GetReplayTimeStep();
+			frameStart = std::chrono::steady_clock::now();
+		}
+		//Ningun sistema de este mundo esta corriendo entre frames, por lo que se puede recuperar la memoria temporal del anterior
+		FrameAllocator::Scope frameAllocatorScope(&m_frameAllocator);
+		m_frameAllocator.ResetFrame();
+		//Los assets cargados en segundo plano se suben entre frames, cuando el renderer no esta usando el contexto. Al grabar o
+		//reproducir input se sube todo lo pedido, para que los assets aparezcan en el mismo frame en ambas ejecuciones
+		if (replayingInput || m_input.IsRecording()) {
+			AssetLoader::GetInstance().ProcessUploads(std::numeric_limits<uint32_t>::max(), true);
+		}
+		else {
+			AssetLoader::GetInstance().ProcessUploads(m_assetUploadsPerFrame);
+		}
+		if (MEMORY_ACCOUNTING_INTERVAL <= ++m_framesSinceMemoryAccounting) {
+			UpdateMemoryAccounting();
+		}
+		if (m_systemGraphDirty) {
+			BuildSystemGraph();
+		}
+		m_systemGraph.Execute(timeStep);
+		//Los cambios estructurales registrados por los sistemas se aplican cuando ninguno esta corriendo
+		m_commandBuffer.Execute(*this);
+		//Los eventos publicados por los hilos de trabajo durante el frame se entregan en el hilo principal
+		m_eventManager.DispatchQueuedEvents();
+		if (replayingInput) {
+			UpdateReplayStatistics(timeStep, frameStart);
+		}
+	}
+
+	void World::UpdateReplayStatistics(float timeStep, std::chrono::steady_clock::time_point frameStart) noexcept {
+		const double frameSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count();
+		m_replayCpuSeconds += frameSeconds;
+		m_replayFrameCount++;
+		if (m_replayReport.is_open()) {
+			//El checksum se calcula fuera del tiempo medido
+			m_replayReport << m_replayFrameCount << ',' << timeStep << ',' << frameSeconds * 1000.0 << ','
+				<< ComputeSimulationChecksum() << '\n';
+		}
+		if (m_input.ConsumeReplayFinished()) {
+			MONA_LOG_INFO("World: Replay of {0} frames took {1} ms of CPU time ({2} ms per frame). Simulation checksum: {3}",
+				m_replayFrameCount, m_replayCpuSeconds * 1000.0, m_replayCpuSeconds * 1000.0 / m_replayFrameCount, ComputeSimulationChecksum());
+			m_replayReport.close();
+			m_replayFrameCount = 0;
+			m_replayCpuSeconds = 0.0;
+			EndApplication();
+		}
+	}
+
+	uint64_t World::ComputeSimulationChecksum() const noexcept {
+		//FNV-1a sobre la traslacion, rotacion y escala locales de cada transform, en el orden de su manager
+		uint64_t hash = 14695981039346656037ull;
+		auto hashBytes = [&hash](const void* data, std::size_t size) {
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (std::size_t i = 0; i < size; i++) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+		};
+		const auto& transformDataManager = *static_cast<const ComponentManager<TransformComponent>*>(m_componentManagers[TransformComponent::componentIndex].get());
+		const auto count = transformDataManager.GetCount();
+		hashBytes(&count, sizeof(count));
+		for (decltype(transformDataManager.GetCount()) i = 0; i < count; i++) {
+			const TransformComponent& transform = transformDataManager[i];
+			hashBytes(&transform.GetLocalTranslation(), sizeof(glm::vec3));
+			hashBytes(&transform.GetLocalRotation(), sizeof(glm::fquat));
+			hashBytes(&transform.GetLocalScale(), sizeof(glm::vec3));
+		}
+		return hash;
+	}
+
+	void World::UpdateMemoryAccounting() noexcept {
+		m_framesSinceMemoryAccounting = 0;
+		std::size_t componentBytes = 0;
+		for (const auto& componentManager : m_componentManagers) {
+			componentBytes += componentManager->GetMemoryUsage();
+		}
+		m_componentMemory.Set(componentBytes, 0);
+		auto& ikNavigationManager = GetComponentManager<IKNavigationComponent>();
+		//La cache de animaciones ik es del proceso y contabiliza su memoria por su cuenta, una sola vez para todos los mundos
+		std::size_t ikNavigationBytes = 0;
+		for (decltype(ikNavigationManager.GetCount()) i = 0; i < ikNavigationManager.GetCount(); i++) {
+			ikNavigationBytes += ikNavigationManager[i].GetMemoryUsage();
+		}
+		m_ikNavigationMemory.Set(ikNavigationBytes, 0);
+		m_frameScratchMemory.Set(m_frameAllocator.GetStatistics().capacity, 0);
+	}
+
+	MemoryTracker::Snapshot World::GetMemorySnapshot() noexcept {
+		UpdateMemoryAccounting();
+		return MemoryTracker::GetInstance().GetSnapshot();
+	}
+
+	void World::AddSystem(const std::string& name, const SystemAccess& access, SystemGraph::SystemFunction function,
+		bool mainThreadOnly) noexcept {
+		m_userSystems.push_back(UserSystem{ name, access, std::move(function), mainThreadOnly });
+		m_systemGraphDirty = true;
+	}
+
+	bool World::SetParent(const ComponentHandle<TransformComponent>& child, const ComponentHandle<TransformComponent>& parent) noexcept {
+		return m_transformHierarchy.SetParent(child.GetInnerHandle(), parent.GetInnerHandle());
+	}
+
+	void World::RemoveParent(const ComponentHandle<TransformComponent>& child) noexcept {
+		m_transformHierarchy.RemoveParent(child.GetInnerHandle());
+	}
+
+	ComponentHandle<TransformComponent> World::GetParent(const ComponentHandle<TransformComponent>& child) noexcept {
+		InnerComponentHandle parentHandle = m_transformHierarchy.GetParent(child.GetInnerHandle());
+		auto& transformDataManager = GetComponentManager<TransformComponent>();
+		if (!transformDataManager.IsValid(parentHandle)) {
+			return ComponentHandle<TransformComponent>();
+		}
+		return ComponentHandle<TransformComponent>(parentHandle, &transformDataManager);
+	}
+
+	void World::EnablePipelinedRendering(bool enablePipelining) noexcept {
+		if (m_pipelinedRendering == enablePipelining) {
+			return;
+		}
+		m_pipelinedRendering = enablePipelining;
+		for (auto& snapshot : m_renderSnapshots)
+			snapshot.Clear();
+		m_systemGraphDirty = true;
+	}
+
+	void World::BuildSystemGraph() noexcept
 	{
 		auto &transformDataManager = GetComponentManager<TransformComponent>();
 		auto &staticMeshDataManager = GetComponentManager<StaticMeshComponent>();
@@ -161,33 +435,116 @@ namespace Mona {
 		auto& pointLightDataManager = GetComponentManager<PointLightComponent>();
 		auto& skeletalMeshDataManager = GetComponentManager<SkeletalMeshComponent>();
 		auto& ikNavigationDataManager = GetComponentManager<IKNavigationComponent>();
-		m_input.Update();
-		m_physicsCollisionSystem.StepSimulation(timeStep);
-		m_physicsCollisionSystem.SubmitCollisionEvents(*this, m_eventManager, rigidBodyDataManager);
-		m_ikNavigationSystyem.UpdateAllRigs(ikNavigationDataManager, 
-			transformDataManager, 
-			staticMeshDataManager, 
-			skeletalMeshDataManager, 
-			timeStep);
-		m_animationSystem.UpdateAllPoses(skeletalMeshDataManager, timeStep);
-		m_objectManager.UpdateGameObjects(*this, m_eventManager, timeStep);
-		m_application.UserUpdate(*this, timeStep);
-		m_audioSystem.Update(m_audoListenerTransformHandle,
-			m_audioListenerOffsetRotation,
-			timeStep,
-			transformDataManager,
-			audioSourceDataManager);
-		m_renderer.Render(m_eventManager,
-			m_cameraHandle,
-			m_ambientLight,
-			staticMeshDataManager,
-			skeletalMeshDataManager,
-			transformDataManager,
-			cameraDataManager,
-			directionalLightDataManager,
-			spotLightDataManager,
-			pointLightDataManager);
-		m_window.Update();
+		m_systemGraph.Clear();
+		//Sin ventana el sistema de input solo avanza las grabaciones y reproducciones
+		m_systemGraph.AddSystem("Input",
+			SystemAccess().WritesResource(EngineResource::Input),
+			[this](float timeStep) { m_input.Update(timeStep); }, true);
+		m_systemGraph.AddSystem("PhysicsCollision",
+			SystemAccess().WritesAll(),
+			[this, &rigidBodyDataManager](float timeStep) {
+				m_physicsCollisionSystem.StepSimulation(timeStep);
+				m_physicsCollisionSystem.SubmitCollisionEvents(*this, m_eventManager, rigidBodyDataManager);
+			}, true);
+		if (m_pipelinedRendering && !IsHeadless()) {
+			//El snapshot del frame anterior se envia en el hilo principal mientras los workers actualizan IK y animacion
+			m_systemGraph.AddSystem("RenderSubmit",
+				SystemAccess().ReadsResource(EngineResource::RenderSnapshot).WritesResource(EngineResource::Rendering),
+				[this](float timeStep) { m_renderer.SubmitSnapshot(m_renderSnapshots[m_frontRenderSnapshot]); }, true);
+		}
+		m_systemGraph.AddSystem("IKNavigation",
+			SystemAccess().Reads<StaticMeshComponent, CameraComponent>()
+				.Writes<TransformComponent, SkeletalMeshComponent, IKNavigationComponent>(),
+			[this, &ikNavigationDataManager, &transformDataManager, &staticMeshDataManager, &skeletalMeshDataManager, &cameraDataManager](float timeStep) {
+				m_ikNavigationSystyem.UpdateAllRigs(ikNavigationDataManager,
+					transformDataManager,
+					staticMeshDataManager,
+					skeletalMeshDataManager,
+					cameraDataManager,
+					m_cameraHandle,
+					timeStep);
+			}, false);
+		m_systemGraph.AddSystem("Animation",
+			SystemAccess().Writes<SkeletalMeshComponent>(),
+			[this, &skeletalMeshDataManager](float timeStep) { m_animationSystem.UpdateAllPoses(skeletalMeshDataManager, timeStep); }, false);
+		m_systemGraph.AddSystem("GameObjects",
+			SystemAccess().WritesAll(),
+			[this](float timeStep) { m_objectManager.UpdateGameObjects(*this, m_eventManager, timeStep); }, true);
+		m_systemGraph.AddSystem("UserUpdate",
+			SystemAccess().WritesAll(),
+			[this](float timeStep) { m_application.UserUpdate(*this, timeStep); }, true);
+		for (auto& userSystem : m_userSystems) {
+			m_systemGraph.AddSystem(userSystem.name, userSystem.access, userSystem.function, userSystem.mainThreadOnly);
+		}
+		//Unico pase por frame que actualiza las matrices de mundo de las transformaciones modificadas
+		m_systemGraph.AddSystem("TransformHierarchy",
+			SystemAccess().Writes<TransformComponent>(),
+			[this](float timeStep) { m_transformHierarchy.UpdateWorldMatrices(); }, false);
+		if (IsHeadless()) {
+			//Sin ventana no hay audio, render ni eventos de ventana que procesar
+			m_systemGraphDirty = false;
+			return;
+		}
+		m_systemGraph.AddSystem("Audio",
+			SystemAccess().Reads<TransformComponent>().Writes<AudioSourceComponent>().WritesResource(EngineResource::Audio),
+			[this, &transformDataManager, &audioSourceDataManager](float timeStep) {
+				m_audioSystem.Update(m_audoListenerTransformHandle,
+					m_audioListenerOffsetRotation,
+					timeStep,
+					transformDataManager,
+					audioSourceDataManager);
+			}, false);
+		if (m_pipelinedRendering) {
+			m_systemGraph.AddSystem("RenderExtract",
+				SystemAccess().Reads<TransformComponent, CameraComponent, StaticMeshComponent, SkeletalMeshComponent,
+					DirectionalLightComponent, SpotLightComponent, PointLightComponent>()
+					.WritesResource(EngineResource::RenderSnapshot),
+				[this, &staticMeshDataManager, &skeletalMeshDataManager, &transformDataManager, &cameraDataManager,
+					&directionalLightDataManager, &spotLightDataManager, &pointLightDataManager](float timeStep) {
+					uint32_t backRenderSnapshot = 1 - m_frontRenderSnapshot;
+					m_renderer.ExtractSnapshot(m_cameraHandle,
+						m_ambientLight,
+						staticMeshDataManager,
+						skeletalMeshDataManager,
+						transformDataManager,
+						cameraDataManager,
+						directionalLightDataManager,
+						spotLightDataManager,
+						pointLightDataManager,
+						m_renderSnapshots[backRenderSnapshot]);
+					m_frontRenderSnapshot = backRenderSnapshot;
+				}, false);
+			//La informacion de debug se dibuja con el estado actual sobre la imagen del frame anterior
+			m_systemGraph.AddSystem("DebugDraw",
+				SystemAccess().Reads<TransformComponent, SkeletalMeshComponent, IKNavigationComponent>()
+					.ReadsResource(EngineResource::RenderSnapshot)
+					.WritesResource(EngineResource::Rendering).WritesResource(EngineResource::Events),
+				[this](float timeStep) { m_renderer.DrawDebug(m_eventManager, m_renderSnapshots[m_frontRenderSnapshot]); }, true);
+		}
+		else {
+			m_systemGraph.AddSystem("Render",
+				SystemAccess().Reads<TransformComponent, CameraComponent, StaticMeshComponent, SkeletalMeshComponent,
+					DirectionalLightComponent, SpotLightComponent, PointLightComponent, IKNavigationComponent>()
+					.WritesResource(EngineResource::Rendering).WritesResource(EngineResource::Events),
+				[this, &staticMeshDataManager, &skeletalMeshDataManager, &transformDataManager, &cameraDataManager,
+					&directionalLightDataManager, &spotLightDataManager, &pointLightDataManager](float timeStep) {
+					m_renderer.Render(m_eventManager,
+						m_cameraHandle,
+						m_ambientLight,
+						staticMeshDataManager,
+						skeletalMeshDataManager,
+						transformDataManager,
+						cameraDataManager,
+						directionalLightDataManager,
+						spotLightDataManager,
+						pointLightDataManager);
+				}, true);
+		}
+		m_systemGraph.AddSystem("Window",
+			SystemAccess().WritesResource(EngineResource::Window).WritesResource(EngineResource::Input)
+				.WritesResource(EngineResource::Events).WritesResource(EngineResource::Rendering),
+			[this](float timeStep) { m_window.Update(); }, true);
+		m_systemGraphDirty = false;
 	}
 
 	void World::SetMainCamera(const ComponentHandle<CameraComponent>& cameraHandle) noexcept {
@@ -202,10 +559,10 @@ namespace Mona {
 		const CameraComponent* camera = cameraDataManager.GetComponentPointer(m_cameraHandle);
 		GameObject* cameraOwner = cameraDataManager.GetOwner(m_cameraHandle);
 		TransformComponent* cameraTransform = transformDataManager.GetComponentPointer(cameraOwner->GetInnerComponentHandle<TransformComponent>());
-		glm::vec3 upVector = cameraTransform->GetUpVector();
-		glm::vec3 rightVector = cameraTransform->GetRightVector();
-		glm::vec3 frontVector = cameraTransform->GetFrontVector();
-		const glm::vec3& cameraPosition = cameraTransform->GetLocalTranslation();
+		glm::vec3 upVector = cameraTransform->GetWorldUpVector();
+		glm::vec3 rightVector = cameraTransform->GetWorldRightVector();
+		glm::vec3 frontVector = cameraTransform->GetWorldFrontVector();
+		const glm::vec3 cameraPosition = cameraTransform->GetWorldTranslation();
 		const glm::ivec2 screenResolution = m_window.GetWindowFrameBufferSize();
 		glm::vec2 screenPercentage = glm::vec2((float)screenPos.x / (float)screenResolution.x, (float)screenPos.y / (float)screenResolution.y);
 		screenPercentage = glm::vec2(-1.0f) + 2.0f * screenPercentage;
@@ -224,6 +581,7 @@ namespace Mona {
 	}
 	
 	std::shared_ptr<Material> World::CreateMaterial(MaterialType type, bool isForSkinning) noexcept {
+		MONA_ASSERT(!IsHeadless(), "World Error: Headless worlds cannot create materials");
 		return m_renderer.CreateMaterial(type, isForSkinning);
 	}
 
@@ -262,6 +620,7 @@ namespace Mona {
 		float radius /* = 1000.0f */,
 		AudioSourcePriority priority /* = AudioSourcePriority::SoundPriorityMedium */)
 	{
+		MONA_ASSERT(!IsHeadless(), "World Error: Headless worlds cannot play audio");
 		m_audioSystem.PlayAudioClip3D(audioClip, position, volume, pitch, radius, priority);
 	}
 
@@ -270,6 +629,7 @@ namespace Mona {
 		float pitch /* = 1.0f */,
 		AudioSourcePriority priority /* = AudioSourcePriority::SoundPriorityMedium */)
 	{
+		MONA_ASSERT(!IsHeadless(), "World Error: Headless worlds cannot play audio");
 		m_audioSystem.PlayAudioClip2D(audioClip, volume, pitch, priority);
 	}
 
@@ -284,11 +644,18 @@ namespace Mona {
 	JointPose World::GetJointWorldPose(const ComponentHandle<SkeletalMeshComponent>& skeletalMeshHandle, uint32_t jointIndex) noexcept {
 		auto transform = GetSiblingComponentHandle<TransformComponent>(skeletalMeshHandle);
 		JointPose worldPose(transform->GetLocalRotation(), transform->GetLocalTranslation(), transform->GetLocalScale());
+		if (transform->HasParent()) {
+			//Con padre la pose de mundo se obtiene de la matriz de mundo de la transformacion
+			glm::vec3 skew;
+			glm::vec4 perspective;
+			glm::decompose(transform->GetModelMatrix(), worldPose.m_scale, worldPose.m_rotation, worldPose.m_translation, skew, perspective);
+		}
 		const AnimationController& animController = skeletalMeshHandle->GetAnimationController();
 		return worldPose * animController.GetJointModelPose(jointIndex);
 	}
 
 	void World::SetBackgroundColor(float r, float g, float b, float alpha) {
+		MONA_ASSERT(!IsHeadless(), "World Error: Headless worlds cannot render");
 		m_renderer.SetBackgroundColor(r, g, b, alpha);
 	}
 
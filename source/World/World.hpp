@@ -9,6 +9,14 @@
 #include "ComponentManager.hpp"
 #include "ComponentHandle.hpp"
 #include "GameObjectHandle.hpp"
+#include "SystemGraph.hpp"
+#include "TransformHierarchy.hpp"
+#include "Prefab.hpp"
+#include "GameObjectPool.hpp"
+#include "CommandBuffer.hpp"
+#include "../Core/FrameAllocator.hpp"
+#include "../Core/MemoryTracker.hpp"
+#include "../Core/AssetLoader.hpp"
 #include "../Event/EventManager.hpp"
 #include "../Platform/Window.hpp"
 #include "../Platform/Input.hpp"
@@ -36,14 +44,29 @@
 #include <array>
 #include <filesystem>
 #include <string>
+#include <fstream>
+#include <chrono>
 
 namespace Mona {
 
 	class Material;
+
+	/*
+	* Un mundo Headless no crea ventana, contexto grafico, renderer ni dispositivo de audio, por lo que puede
+	* actualizarse desde cualquier hilo. Varios mundos headless pueden simularse en paralelo compartiendo los assets
+	* ya cargados. Sus mallas solo conservan los datos de CPU (esqueletos, mapas de altura) y no pueden dibujarse.
+	* Cada mundo debe crearse y actualizarse en el mismo hilo.
+	*/
+	enum class WorldMode : uint8_t {
+		Windowed,
+		Headless
+	};
+
 	class World {
 	public:
 		friend class Engine;
 		friend class MonaTest;
+		friend class CommandBuffer;
 		
 		World(const World& world) = delete;
 		World& operator=(const World& world) = delete;
@@ -54,6 +77,17 @@ namespace Mona {
 		GameObjectHandle<ObjectType> CreateGameObject(Args&& ... args) noexcept;
 		void DestroyGameObject(BaseGameObjectHandle& handle) noexcept;
 		void DestroyGameObject(GameObject& gameObject) noexcept;
+		// Remueve las componentes de todos los objetos agrupadas por tipo, con una sola pasada por manager
+		void DestroyGameObjects(const std::vector<GameObject*>& gameObjects) noexcept;
+		template <typename ObjectType>
+		void DestroyGameObjects(std::vector<GameObjectHandle<ObjectType>>& handles) noexcept;
+		// Crea count objetos con las componentes del prefab reservando memoria una sola vez por manager.
+		// Las componentes se agregan antes de llamar UserStartUp de cada objeto.
+		template <typename ObjectType = GameObject, typename ...Args>
+		std::vector<GameObjectHandle<ObjectType>> Instantiate(const Prefab& prefab, GameObjectManager::size_type count, const Args& ... args) noexcept;
+		// Un objeto inactivo conserva sus componentes pero no se actualiza, no se dibuja ni participa de la simulacion fisica
+		void SetGameObjectActive(BaseGameObjectHandle& handle, bool active) noexcept;
+		void SetGameObjectActive(GameObject& gameObject, bool active) noexcept;
 
 		template <typename ComponentType, typename ...Args>
 		ComponentHandle<ComponentType> AddComponent(BaseGameObjectHandle& objectHandle, Args&& ... args) noexcept;
@@ -61,6 +95,13 @@ namespace Mona {
 		ComponentHandle<ComponentType> AddComponent(GameObject& gameObject, Args&& ... args) noexcept;
 		template <typename ComponentType>
 		void RemoveComponent(const ComponentHandle<ComponentType>& handle) noexcept;
+		// Versiones en lote de AddComponent y RemoveComponent: el manager reserva memoria y compacta su arreglo una sola vez
+		template <typename ComponentType, typename ObjectType, typename ...Args>
+		std::vector<ComponentHandle<ComponentType>> AddComponents(std::vector<GameObjectHandle<ObjectType>>& objectHandles, const Args& ... args) noexcept;
+		template <typename ComponentType>
+		void RemoveComponents(const std::vector<ComponentHandle<ComponentType>>& handles) noexcept;
+		// Cambios estructurales diferidos hasta el final del frame, seguros de registrar desde cualquier sistema
+		CommandBuffer& GetCommandBuffer() noexcept { return m_commandBuffer; }
 		template <typename ComponentType>
 		ComponentHandle<ComponentType> GetComponentHandle(const BaseGameObjectHandle& objectHandle) const noexcept;
 		template <typename ComponentType>
@@ -112,11 +153,35 @@ namespace Mona {
 
 		void SetBackgroundColor(float r, float g, float b, float alpha = 0.0f);
 
+		void AddSystem(const std::string& name, const SystemAccess& access, SystemGraph::SystemFunction function,
+			bool mainThreadOnly = true) noexcept;
+
+		void SetIKNavigationLODTiers(const std::vector<IKNavigationLODTier>& lodTiers) { m_ikNavigationSystyem.SetLODTiers(lodTiers); }
+		void EnableIKNavigationLOD(bool enableLOD) { m_ikNavigationSystyem.EnableLOD(enableLOD); }
+		bool SetParent(const ComponentHandle<TransformComponent>& child, const ComponentHandle<TransformComponent>& parent) noexcept;
+		void RemoveParent(const ComponentHandle<TransformComponent>& child) noexcept;
+		ComponentHandle<TransformComponent> GetParent(const ComponentHandle<TransformComponent>& child) noexcept;
+
+		void EnablePipelinedRendering(bool enablePipelining) noexcept;
+		bool IsPipelinedRenderingEnabled() const noexcept { return m_pipelinedRendering; }
+		FrameAllocator::Statistics GetFrameAllocatorStatistics() const noexcept { return m_frameAllocator.GetStatistics(); }
+		float GetRenderSnapshotExtractionTime() const noexcept { return m_renderer.GetLastExtractionTime(); }
+		// Actualiza las cuentas de este mundo que se calculan por sondeo (componentes, ik, memoria temporal) antes de retornar.
+		// El snapshot es del proceso: los assets y la cache de animaciones ik, compartidos entre mundos, se cuentan una sola vez
+		MemoryTracker::Snapshot GetMemorySnapshot() noexcept;
+		bool IsHeadless() const noexcept { return m_mode == WorldMode::Headless; }
+		// Hash de las transformaciones de todos los objetos, para comparar la simulacion de dos ejecuciones de una misma grabacion
+		uint64_t ComputeSimulationChecksum() const noexcept;
+
 	private:
-		World(Application& app);
+		World(Application& app, WorldMode mode = WorldMode::Windowed);
 		~World();
 		void StartMainLoop() noexcept;
 		void Update(float timeStep) noexcept;
+		void BuildSystemGraph() noexcept;
+		void UpdateMemoryAccounting() noexcept;
+		void UpdateReplayStatistics(float timeStep, std::chrono::steady_clock::time_point frameStart) noexcept;
+		void RemoveComponentBatch(uint8_t componentIndex, const std::vector<InnerComponentHandle>& handles) noexcept;
 
 		template <typename ComponentType>
 		auto& GetComponentManager() noexcept;
@@ -129,11 +194,22 @@ namespace Mona {
 		Window m_window;
 		Application& m_application;
 		bool m_shouldClose;
+		WorldMode m_mode;
+		// Memoria temporal propia del mundo, para que mundos en hilos distintos no reinicien la memoria del otro
+		FrameAllocator m_frameAllocator;
 
 		GameObjectManager m_objectManager;
 		std::array<std::unique_ptr<BaseComponentManager>, GetComponentTypeCount()> m_componentManagers;
+		CommandBuffer m_commandBuffer;
+		TransformHierarchy m_transformHierarchy;
 
 		Renderer m_renderer;
+		// En modo pipelined el envio a GPU del frame anterior se superpone con la simulacion del frame actual
+		std::array<Renderer::RenderSnapshot, 2> m_renderSnapshots;
+		uint32_t m_frontRenderSnapshot = 0;
+		bool m_pipelinedRendering = false;
+		// Tiempo por frame para subir assets cargados con las variantes Async de los managers
+		uint32_t m_assetUploadsPerFrame = ASSET_UPLOAD_DEFAULT_COUNT;
 		InnerComponentHandle m_cameraHandle;
 		glm::vec3 m_ambientLight;
 
@@ -149,6 +225,26 @@ namespace Mona {
 
 		IKNavigationSystem m_ikNavigationSystyem;
 
+		struct UserSystem {
+			std::string name;
+			SystemAccess access;
+			SystemGraph::SystemFunction function;
+			bool mainThreadOnly;
+		};
+		std::vector<UserSystem> m_userSystems;
+		SystemGraph m_systemGraph;
+		bool m_systemGraphDirty = true;
+
+		MemoryAccount m_componentMemory{ MemoryTag::Components };
+		MemoryAccount m_ikNavigationMemory{ MemoryTag::IKNavigation };
+		MemoryAccount m_frameScratchMemory{ MemoryTag::FrameScratch };
+		uint32_t m_framesSinceMemoryAccounting = 0;
+
+		// Estadisticas de la reproduccion de input en curso, opcionalmente escritas frame a frame en m_replayReport
+		std::ofstream m_replayReport;
+		uint32_t m_replayFrameCount = 0;
+		double m_replayCpuSeconds = 0.0;
+
 		
 	};
 
@@ -156,4 +252,7 @@ namespace Mona {
 
 }
 #include "Detail/World_Implementation.hpp"
+#include "Detail/Prefab_Implementation.hpp"
+#include "Detail/GameObjectPool_Implementation.hpp"
+#include "Detail/CommandBuffer_Implementation.hpp"
 #endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "UnitTest.hpp"
+#include "CharacterNavigation/HeightSource.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using Gaussian = Mona::GaussianMixtureHeightSource::Gaussian;
+
+//Suma directa de todas las gaussianas en doble precision, sin grilla ni recorte
+double ReferenceHeight(const std::vector<Gaussian>& gaussians, double x, double y, double& absoluteSum) {
+	double height = 0;
+	absoluteSum = 0;
+	for (const Gaussian& gaussian : gaussians) {
+		const double sigma = gaussian.sigma;
+		const double dx = x - gaussian.center[0];
+		const double dy = y - gaussian.center[1];
+		const double term = gaussian.weight / (sigma * std::sqrt(2 * std::numbers::pi)) * std::exp(-(dx * dx + dy * dy) / (2 * sigma * sigma));
+		height += term;
+		absoluteSum += std::abs(term);
+	}
+	return height;
+}
+
+std::vector<Gaussian> RandomGaussians(std::mt19937& generator, int count) {
+	std::uniform_real_distribution<float> center(-20.0f, 20.0f);
+	std::uniform_real_distribution<float> weight(-30.0f, 60.0f);
+	std::uniform_real_distribution<float> sigma(0.3f, 6.0f);
+	std::vector<Gaussian> gaussians(count);
+	for (Gaussian& gaussian : gaussians) {
+		gaussian.center = glm::vec2(center(generator), center(generator));
+		gaussian.weight = weight(generator);
+		gaussian.sigma = sigma(generator);
+	}
+	return gaussians;
+}
+
+//Puntos de prueba: aleatorios, sobre los bordes de las celdas y sobre los radios de recorte de cada gaussiana
+std::vector<glm::vec2> TestPoints(std::mt19937& generator, const std::vector<Gaussian>& gaussians) {
+	std::vector<glm::vec2> points;
+	std::uniform_real_distribution<float> coordinate(-45.0f, 45.0f);
+	for (int i = 0; i < 2000; i++) {
+		points.emplace_back(coordinate(generator), coordinate(generator));
+	}
+	//Misma grilla que arma el constructor, para caer justo sobre sus bordes
+	glm::vec2 minBound(std::numeric_limits<float>::max());
+	glm::vec2 maxBound(std::numeric_limits<float>::lowest());
+	std::vector<float> radii;
+	float radiusSum = 0;
+	for (const Gaussian& gaussian : gaussians) {
+		const float coefficient = gaussian.weight / (gaussian.sigma * std::sqrt(2 * std::numbers::pi_v<float>));
+		if (std::abs(coefficient) <= GAUSSIAN_HEIGHT_EPSILON) {
+			continue;
+		}
+		const float radius = gaussian.sigma * std::sqrt(2 * std::log(std::abs(coefficient) / GAUSSIAN_HEIGHT_EPSILON));
+		minBound = glm::min(minBound, gaussian.center - radius);
+		maxBound = glm::max(maxBound, gaussian.center + radius);
+		radiusSum += radius;
+		for (int a = 0; a < 8; a++) {
+			const float angle = a * std::numbers::pi_v<float> / 4;
+			for (float scale : { 0.999f, 1.0f, 1.001f }) {
+				points.push_back(gaussian.center + scale * radius * glm::vec2(std::cos(angle), std::sin(angle)));
+			}
+		}
+	}
+	if (radiusSum == 0) {
+		return points;
+	}
+	const float cellSize = radiusSum / std::count_if(gaussians.begin(), gaussians.end(), [](const Gaussian& gaussian) {
+		return GAUSSIAN_HEIGHT_EPSILON < std::abs(gaussian.weight / (gaussian.sigma * std::sqrt(2 * std::numbers::pi_v<float>))); });
+	const glm::vec2 extent = maxBound - minBound;
+	const int cellsX = std::clamp(static_cast<int>(std::ceil(extent[0] / cellSize)), 1, GAUSSIAN_GRID_MAX_CELLS);
+	const int cellsY = std::clamp(static_cast<int>(std::ceil(extent[1] / cellSize)), 1, GAUSSIAN_GRID_MAX_CELLS);
+	const glm::vec2 cellDimensions = extent / glm::vec2(cellsX, cellsY);
+	std::uniform_real_distribution<float> along(0.0f, 1.0f);
+	for (int cx = 0; cx <= cellsX; cx++) {
+		const float x = minBound[0] + cx * cellDimensions[0];
+		for (float offset : { -1e-3f, 0.0f, 1e-3f }) {
+			points.emplace_back(x + offset, minBound[1] + along(generator) * extent[1]);
+		}
+	}
+	for (int cy = 0; cy <= cellsY; cy++) {
+		const float y = minBound[1] + cy * cellDimensions[1];
+		for (float offset : { -1e-3f, 0.0f, 1e-3f }) {
+			points.emplace_back(minBound[0] + along(generator) * extent[0], y + offset);
+		}
+	}
+	return points;
+}
+
+void CheckGaussianMixture(std::mt19937& generator, int gaussianCount) {
+	std::vector<Gaussian> gaussians = RandomGaussians(generator, gaussianCount);
+	if (1 < gaussianCount) {
+		//Una gaussiana tan baja que el constructor la descarta entera
+		gaussians[0].weight = 1e-5f;
+	}
+	const Mona::GaussianMixtureHeightSource source(gaussians);
+	const std::vector<glm::vec2> points = TestPoints(generator, gaussians);
+	std::vector<float> xs(points.size()), ys(points.size()), heights(points.size());
+	for (size_t i = 0; i < points.size(); i++) {
+		xs[i] = points[i][0];
+		ys[i] = points[i][1];
+	}
+	source.evaluateHeights(xs.data(), ys.data(), points.size(), heights.data());
+	for (size_t i = 0; i < points.size(); i++) {
+		double absoluteSum;
+		const double expected = ReferenceHeight(gaussians, xs[i], ys[i], absoluteSum);
+		//Cada gaussiana recortada aporta a lo sumo GAUSSIAN_HEIGHT_EPSILON, mas el error relativo de la exponencial y de float
+		const double bound = gaussianCount * double(GAUSSIAN_HEIGHT_EPSILON) * 1.01 + 1e-5 * absoluteSum + 1e-6;
+		MONA_CHECK(std::abs(heights[i] - expected) <= bound, "%d gaussianas, punto (%f, %f): esperado %f, obtenido %f, cota %g",
+			gaussianCount, xs[i], ys[i], expected, heights[i], bound);
+		const float single = source.evaluateHeight(xs[i], ys[i]);
+		MONA_CHECK(single == heights[i], "%d gaussianas, punto %zu: evaluateHeight %f distinto de evaluateHeights %f",
+			gaussianCount, i, single, heights[i]);
+	}
+}
+
+int main() {
+	std::mt19937 generator(1234);
+
+	//Cantidades que no son multiplo de cuatro dejan el ultimo bloque de cada celda incompleto
+	for (int gaussianCount : { 1, 2, 3, 4, 5, 7, 13, 64, 101 }) {
+		CheckGaussianMixture(generator, gaussianCount);
+	}
+	{
+		const Mona::GaussianMixtureHeightSource empty(std::vector<Gaussian>{});
+		MONA_CHECK(empty.evaluateHeight(1.0f, -2.0f) == 0.0f, "una mezcla vacia debe dar altura 0");
+	}
+
+	//El ruido debe quedar dentro de baseHeight +- amplitude y cubrir buena parte de ese rango
+	for (int octaves : { 1, 3, 6 }) {
+		const float amplitude = 2.5f;
+		const float baseHeight = -1.0f;
+		const Mona::NoiseHeightSource noise(77u + octaves, amplitude, 0.37f, octaves, 2.0f, 0.5f, baseHeight);
+		std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f);
+		const size_t count = 4099;
+		std::vector<float> xs(count), ys(count), heights(count);
+		for (size_t i = 0; i < count; i++) {
+			xs[i] = coordinate(generator);
+			ys[i] = coordinate(generator);
+		}
+		noise.evaluateHeights(xs.data(), ys.data(), count, heights.data());
+		float minHeight = heights[0];
+		float maxHeight = heights[0];
+		for (size_t i = 0; i < count; i++) {
+			MONA_CHECK(baseHeight - amplitude * 1.0001f <= heights[i] && heights[i] <= baseHeight + amplitude * 1.0001f,
+				"%d octavas, punto (%f, %f): altura %f fuera de rango", octaves, xs[i], ys[i], heights[i]);
+			MONA_CHECK(noise.evaluateHeight(xs[i], ys[i]) == heights[i], "%d octavas, punto %zu: evaluateHeight distinto", octaves, i);
+			minHeight = std::min(minHeight, heights[i]);
+			maxHeight = std::max(maxHeight, heights[i]);
+		}
+		MONA_CHECK(amplitude < maxHeight - minHeight, "%d octavas: rango observado %f demasiado chico", octaves, maxHeight - minHeight);
+	}
+	return MONA_TEST_RESULT();
+}
@@ -0,0 +1,76 @@
+#include "UnitTest.hpp"
+#include "CharacterNavigation/Kinematics.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+// Entradas de un rig de dos piernas con tres angulos variables, como las que arma InverseKinematics::solveIKChains
+Mona::IKSolveInputs MakeInputs() {
+	Mona::IKSolveInputs inputs;
+	inputs.eeTargets = { glm::vec3(0.2f, 0.1f, 0.0f), glm::vec3(-0.2f, -0.1f, 0.05f) };
+	inputs.baseAngles.resize(3);
+	inputs.previousAngles.resize(3);
+	for (int i = 0; i < 3; i++) {
+		inputs.baseAngles[i] = 0.3f * i;
+		inputs.previousAngles[i] = 0.3f * i + 0.02f;
+	}
+	inputs.rotationAxes = { glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(1, 0, 0) };
+	//Ambas piernas cuelgan de la cadera, con la escala en centimetros de un fbx
+	const glm::mat4 hip = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0.9f)) * glm::scale(glm::mat4(1.0f), glm::vec3(100.0f));
+	inputs.chainBaseTransforms = { hip, hip };
+	inputs.targetGlobalTransform = glm::translate(glm::mat4(1.0f), glm::vec3(4, 5, 0)) * glm::scale(glm::mat4(1.0f), glm::vec3(2.0f));
+	return inputs;
+}
+
+int main()
+{
+	const float positionTolerance = 0.001f;
+	const float angleTolerance = 0.001f;
+	const Mona::IKSolveInputs cached = MakeInputs();
+
+	//Una pose que se mantiene entre frames reutiliza la resolucion, sin importar el indice del frame
+	Mona::IKSolveInputs current = MakeInputs();
+	MONA_CHECK(Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "entradas identicas");
+	current.eeTargets[0].x += 0.5f * positionTolerance;
+	current.baseAngles[1] += 0.5f * angleTolerance;
+	MONA_CHECK(Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "diferencias bajo la tolerancia");
+
+	//Cualquier entrada que cambie mas que la tolerancia obliga a resolver de nuevo
+	current = MakeInputs();
+	current.eeTargets[1].z += 2.0f * positionTolerance;
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "objetivo de ee movido");
+	current = MakeInputs();
+	current.baseAngles[2] += 2.0f * angleTolerance;
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "pose base distinta");
+	current = MakeInputs();
+	current.previousAngles[0] -= 2.0f * angleTolerance;
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "angulos previos distintos");
+	current = MakeInputs();
+	current.rotationAxes[1] = glm::normalize(glm::vec3(0.0f, 1.0f, 0.01f));
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "eje de rotacion distinto");
+	current = MakeInputs();
+	current.eeTargets.pop_back();
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "cantidad de cadenas distinta");
+
+	//Si solo se mueve la raiz del rig, con los objetivos y los angulos iguales, la resolucion guardada ya no sirve
+	current = MakeInputs();
+	for (glm::mat4& chainBase : current.chainBaseTransforms)
+		chainBase[3] += glm::vec4(0, 0, -2.0f * positionTolerance, 0);
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "raiz desplazada");
+	current = MakeInputs();
+	current.chainBaseTransforms[1][3] += glm::vec4(0.5f * positionTolerance, 0, 0, 0);
+	MONA_CHECK(Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "raiz desplazada bajo la tolerancia");
+	current = MakeInputs();
+	for (glm::mat4& chainBase : current.chainBaseTransforms)
+		chainBase = glm::rotate(chainBase, 2.0f * angleTolerance, glm::vec3(0, 1, 0));
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "cadera rotada");
+
+	//La transformacion global se compara con la tolerancia escalada al tamano del rig
+	current = MakeInputs();
+	current.targetGlobalTransform[3] += glm::vec4(1.5f * positionTolerance, 0, 0, 0);
+	MONA_CHECK(Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "traslacion menor que la tolerancia escalada");
+	current.targetGlobalTransform[3] += glm::vec4(1.0f * positionTolerance, 0, 0, 0);
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "traslacion mayor que la tolerancia escalada");
+	current = MakeInputs();
+	current.targetGlobalTransform = glm::rotate(cached.targetGlobalTransform, 0.01f, glm::vec3(0, 0, 1));
+	MONA_CHECK(!Mona::IKSolveInputsMatch(cached, current, positionTolerance, angleTolerance), "rig rotado");
+	return MONA_TEST_RESULT();
+}
@@ -0,0 +1,144 @@
+#include "UnitTest.hpp"
+#include "Rendering/LightClusters.hpp"
+#include "Core/JobSystem.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+//Caja de referencia de un froxel, calculada en doble precision a partir de la definicion de las rebanadas
+struct ReferenceBox {
+	glm::dvec3 min;
+	glm::dvec3 max;
+};
+
+ReferenceBox ComputeReferenceBox(const glm::mat4& projection, double nearPlane, double farPlane, uint32_t x, uint32_t y, uint32_t z) {
+	const double nearDepth = nearPlane * std::pow(farPlane / nearPlane, double(z) / LIGHT_CLUSTERS_Z);
+	const double farDepth = nearPlane * std::pow(farPlane / nearPlane, double(z + 1) / LIGHT_CLUSTERS_Z);
+	const double ndcMinX = -1.0 + 2.0 * x / LIGHT_CLUSTERS_X, ndcMaxX = -1.0 + 2.0 * (x + 1) / LIGHT_CLUSTERS_X;
+	const double ndcMinY = -1.0 + 2.0 * y / LIGHT_CLUSTERS_Y, ndcMaxY = -1.0 + 2.0 * (y + 1) / LIGHT_CLUSTERS_Y;
+	ReferenceBox box;
+	box.min = glm::dvec3(std::min(ndcMinX * nearDepth, ndcMinX * farDepth) / projection[0][0],
+		std::min(ndcMinY * nearDepth, ndcMinY * farDepth) / projection[1][1], -farDepth);
+	box.max = glm::dvec3(std::max(ndcMaxX * nearDepth, ndcMaxX * farDepth) / projection[0][0],
+		std::max(ndcMaxY * nearDepth, ndcMaxY * farDepth) / projection[1][1], -nearDepth);
+	return box;
+}
+
+double SquaredDistance(const ReferenceBox& box, const glm::vec3& point) {
+	const glm::dvec3 p(point);
+	const glm::dvec3 d = glm::max(glm::max(box.min - p, p - box.max), glm::dvec3(0.0));
+	return glm::dot(d, d);
+}
+
+std::vector<Mona::LightClusters::LightBounds> RandomLights(std::mt19937& generator, int count, float farPlane) {
+	std::uniform_real_distribution<float> ndc(-1.2f, 1.2f);
+	std::uniform_real_distribution<float> logDepth(std::log(0.05f), std::log(farPlane * 1.1f));
+	std::uniform_real_distribution<float> radius(0.05f, 8.0f);
+	std::vector<Mona::LightClusters::LightBounds> lights(count);
+	for (auto& light : lights) {
+		const float depth = std::exp(logDepth(generator));
+		light.viewPosition = glm::vec3(ndc(generator) * depth, ndc(generator) * depth * 0.6f, -depth);
+		light.radius = radius(generator);
+	}
+	return lights;
+}
+
+int main()
+{
+	const float nearPlane = 0.1f;
+	const float farPlane = 100.0f;
+	const glm::mat4 projection = glm::perspective(glm::radians(50.0f), 16.0f / 9.0f, nearPlane, farPlane);
+	std::mt19937 generator(1234);
+	Mona::LightClusters clusters;
+	clusters.Build(projection, {}, {});
+
+	//Formula de las rebanadas: slice = floor(log(d) * scale + bias) debe coincidir con la definicion exponencial
+	const double logRatio = std::log(double(farPlane) / nearPlane);
+	MONA_CHECK(std::abs(clusters.GetDepthSliceScale() - LIGHT_CLUSTERS_Z / logRatio) < 1e-3, "scale %f", clusters.GetDepthSliceScale());
+	MONA_CHECK(std::abs(clusters.GetDepthSliceBias() + LIGHT_CLUSTERS_Z * std::log(double(nearPlane)) / logRatio) < 1e-3,
+		"bias %f", clusters.GetDepthSliceBias());
+	for (uint32_t z = 0; z < LIGHT_CLUSTERS_Z; z++) {
+		//Profundidades en el interior de la rebanada, lejos de los bordes donde el redondeo puede cambiar el resultado
+		for (double t : { 0.05, 0.5, 0.95 }) {
+			const double depth = nearPlane * std::pow(double(farPlane) / nearPlane, (z + t) / LIGHT_CLUSTERS_Z);
+			const uint32_t cluster = clusters.FindCluster(glm::vec2(0.0f), static_cast<float>(depth));
+			MONA_CHECK(cluster / (LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y) == z, "profundidad %f cae en la rebanada %u y no en %u", depth,
+				cluster / (LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y), z);
+		}
+	}
+
+	//Cajas de los froxels contra la referencia, y todo punto visible debe quedar dentro de la caja de su cluster
+	for (uint32_t z = 0; z < LIGHT_CLUSTERS_Z; z++) {
+		for (uint32_t y = 0; y < LIGHT_CLUSTERS_Y; y++) {
+			for (uint32_t x = 0; x < LIGHT_CLUSTERS_X; x++) {
+				const uint32_t c = x + LIGHT_CLUSTERS_X * (y + LIGHT_CLUSTERS_Y * z);
+				glm::vec3 boxMin, boxMax;
+				clusters.GetClusterBounds(c, boxMin, boxMax);
+				const ReferenceBox reference = ComputeReferenceBox(projection, nearPlane, farPlane, x, y, z);
+				const double tolerance = 1e-4 * (1.0 + std::abs(reference.min.z));
+				MONA_CHECK(glm::all(glm::lessThan(glm::abs(glm::dvec3(boxMin) - reference.min), glm::dvec3(tolerance))) &&
+					glm::all(glm::lessThan(glm::abs(glm::dvec3(boxMax) - reference.max), glm::dvec3(tolerance))), "caja del cluster %u", c);
+			}
+		}
+	}
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	for (int i = 0; i < 20000; i++) {
+		const glm::vec2 ndc(2.0f * unit(generator) - 1.0f, 2.0f * unit(generator) - 1.0f);
+		const float depth = nearPlane * std::pow(farPlane / nearPlane, unit(generator));
+		const glm::vec3 viewPoint(ndc.x * depth / projection[0][0], ndc.y * depth / projection[1][1], -depth);
+		glm::vec3 boxMin, boxMax;
+		clusters.GetClusterBounds(clusters.FindCluster(ndc, depth), boxMin, boxMax);
+		const glm::vec3 tolerance(1e-4f * (1.0f + depth));
+		MONA_CHECK(glm::all(glm::lessThanEqual(boxMin - tolerance, viewPoint)) && glm::all(glm::lessThanEqual(viewPoint, boxMax + tolerance)),
+			"punto (%f, %f, %f) fuera de la caja de su cluster", viewPoint.x, viewPoint.y, viewPoint.z);
+	}
+
+	//Asignacion de luces contra una busqueda por fuerza bruta, por el camino secuencial y por el paralelo
+	Mona::JobSystem::GetInstance().StartUp(3);
+	for (int lightCount : { 20, 300 }) {
+		const auto pointLights = RandomLights(generator, lightCount, farPlane);
+		const auto spotLights = RandomLights(generator, lightCount / 2, farPlane);
+		clusters.Build(projection, pointLights, spotLights);
+		const auto& clusterData = clusters.GetClusters();
+		const auto& indices = clusters.GetLightIndices();
+		MONA_CHECK(clusterData.size() == Mona::LightClusters::s_clusterCount, "cantidad de clusters %zu", clusterData.size());
+		int ambiguous = 0;
+		for (uint32_t z = 0; z < LIGHT_CLUSTERS_Z; z++) {
+			for (uint32_t y = 0; y < LIGHT_CLUSTERS_Y; y++) {
+				for (uint32_t x = 0; x < LIGHT_CLUSTERS_X; x++) {
+					const uint32_t c = x + LIGHT_CLUSTERS_X * (y + LIGHT_CLUSTERS_Y * z);
+					const ReferenceBox reference = ComputeReferenceBox(projection, nearPlane, farPlane, x, y, z);
+					const Mona::LightClusters::Cluster& cluster = clusterData[c];
+					MONA_CHECK(cluster.offset + cluster.pointLightCount + cluster.spotLightCount <= indices.size(), "cluster %u fuera de la lista", c);
+					if (cluster.offset + cluster.pointLightCount + cluster.spotLightCount > indices.size())
+						continue;
+					const auto pointBegin = indices.begin() + cluster.offset;
+					const auto spotBegin = pointBegin + cluster.pointLightCount;
+					const auto spotEnd = spotBegin + cluster.spotLightCount;
+					auto checkLights = [&](const std::vector<Mona::LightClusters::LightBounds>& lights, auto begin, auto end, const char* kind) {
+						for (uint32_t i = 0; i < lights.size(); i++) {
+							const double distance = SquaredDistance(reference, lights[i].viewPosition);
+							const double radiusSquared = double(lights[i].radius) * lights[i].radius;
+							//Las luces que apenas tocan la caja pueden quedar de cualquier lado por el redondeo en float
+							if (std::abs(distance - radiusSquared) < 1e-3 * (1.0 + radiusSquared)) {
+								ambiguous++;
+								continue;
+							}
+							const bool expected = distance < radiusSquared;
+							const bool assigned = std::find(begin, end, i) != end;
+							MONA_CHECK(expected == assigned, "luz %s %u en el cluster %u: esperado %d, obtenido %d", kind, i, c, expected, assigned);
+						}
+					};
+					checkLights(pointLights, pointBegin, spotBegin, "puntual");
+					checkLights(spotLights, spotBegin, spotEnd, "spot");
+				}
+			}
+		}
+		MONA_CHECK(ambiguous < lightCount * 4, "demasiados casos ambiguos: %d", ambiguous);
+	}
+
+	Mona::JobSystem::GetInstance().ShutDown();
+	return MONA_TEST_RESULT();
+}
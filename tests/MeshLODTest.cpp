@@ -0,0 +1,174 @@
+#include "UnitTest.hpp"
+#include "TestGrids.hpp"
+#include "Rendering/MeshLOD.hpp"
+#include "Rendering/MeshOptimizer.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+std::vector<bool> ReferencedVertices(const std::vector<unsigned int>& indices, std::size_t begin, std::size_t end, std::size_t vertexCount) {
+	std::vector<bool> referenced(vertexCount, false);
+	for (std::size_t i = begin; i < end; i++)
+		referenced[indices[i]] = true;
+	return referenced;
+}
+
+void TestLODChainReduction() {
+	std::mt19937 random(1);
+	const unsigned int side = 64;
+	const std::vector<glm::vec3> positions = MonaTest::MakeGridPositions(side, 0.2f, 0.0f, random);
+	std::vector<unsigned int> indices = MonaTest::MakeGridIndices(side);
+	const std::size_t baseIndexCount = indices.size();
+	const std::vector<Mona::MeshLOD> lods = Mona::GenerateMeshLODChain(indices, &positions[0].x, sizeof(glm::vec3), positions.size());
+	MONA_CHECK(lods.size() >= 3, "solo se generaron %zu niveles", lods.size());
+	MONA_CHECK(lods[0].indexOffset == 0 && lods[0].indexCount == baseIndexCount && lods[0].error == 0.0f, "el nivel 0 cambio");
+	std::size_t expectedOffset = 0;
+	for (std::size_t l = 0; l < lods.size(); l++) {
+		MONA_CHECK(lods[l].indexOffset == expectedOffset, "nivel %zu no es contiguo", l);
+		MONA_CHECK(lods[l].indexCount % 3 == 0, "nivel %zu con triangulos incompletos", l);
+		expectedOffset += lods[l].indexCount;
+		if (l == 0)
+			continue;
+		//Cada nivel debe reducir los triangulos del anterior al menos en la fraccion exigida por GenerateMeshLODChain
+		MONA_CHECK(lods[l].indexCount <= 0.85f * lods[l - 1].indexCount, "nivel %zu no reduce: %u -> %u", l, lods[l - 1].indexCount, lods[l].indexCount);
+		MONA_CHECK(lods[l].error >= lods[l - 1].error, "el error del nivel %zu disminuye", l);
+		MONA_CHECK(lods[l].error <= MESH_LOD_MAX_ERROR, "error del nivel %zu sobre el maximo: %f", l, lods[l].error);
+	}
+	MONA_CHECK(expectedOffset == indices.size(), "los niveles no cubren el buffer de indices");
+	MONA_CHECK(std::all_of(indices.begin(), indices.end(), [&](unsigned int index) { return index < positions.size(); }), "indice fuera del buffer");
+}
+
+void TestBorderAndSeamLock() {
+	std::mt19937 random(2);
+	const unsigned int side = 32;
+	//Dos mitades que comparten la columna central por posicion pero no por indice, como una costura de uv
+	std::vector<glm::vec3> positions = MonaTest::MakeGridPositions(side, 0.2f, 0.0f, random);
+	const std::size_t halfVertexCount = positions.size();
+	for (std::size_t v = 0; v < halfVertexCount; v++)
+		positions.push_back(positions[v] + glm::vec3(1.0f, 0.0f, 0.0f));
+	std::vector<unsigned int> indices = MonaTest::MakeGridIndices(side);
+	const std::size_t halfIndexCount = indices.size();
+	for (std::size_t i = 0; i < halfIndexCount; i++)
+		indices.push_back(indices[i] + static_cast<unsigned int>(halfVertexCount));
+
+	std::vector<bool> locked(positions.size(), false);
+	for (std::size_t v = 0; v < halfVertexCount; v++) {
+		const std::size_t x = v % (side + 1);
+		const std::size_t y = v / (side + 1);
+		const bool border = x == 0 || x == side || y == 0 || y == side;
+		locked[v] = border;
+		locked[v + halfVertexCount] = border;
+	}
+	std::vector<unsigned int> simplified = indices;
+	Mona::SimplifyMesh(simplified, &positions[0].x, sizeof(glm::vec3), positions.size(), indices.size() / 10, 1.0f);
+	MONA_CHECK(simplified.size() < indices.size() / 2, "la simplificacion casi no redujo la malla: %zu", simplified.size());
+	const std::vector<bool> referenced = ReferencedVertices(simplified, 0, simplified.size(), positions.size());
+	std::size_t missingLocked = 0;
+	for (std::size_t v = 0; v < positions.size(); v++) {
+		if (locked[v] && !referenced[v])
+			missingLocked++;
+	}
+	MONA_CHECK(missingLocked == 0, "%zu vertices de borde o costura fueron colapsados", missingLocked);
+	//Las aristas de la costura siguen existiendo en ambas mitades, por lo que no se abren agujeros
+	for (std::size_t y = 0; y < side; y++) {
+		const unsigned int seamLeft = static_cast<unsigned int>(y * (side + 1) + side);
+		const unsigned int seamRight = static_cast<unsigned int>(halfVertexCount + y * (side + 1));
+		bool leftEdge = false;
+		bool rightEdge = false;
+		for (std::size_t i = 0; i < simplified.size(); i += 3) {
+			for (std::size_t k = 0; k < 3; k++) {
+				const unsigned int a = simplified[i + k];
+				const unsigned int b = simplified[i + (k + 1) % 3];
+				leftEdge = leftEdge || (std::min(a, b) == seamLeft && std::max(a, b) == seamLeft + side + 1);
+				rightEdge = rightEdge || (std::min(a, b) == seamRight && std::max(a, b) == seamRight + side + 1);
+			}
+		}
+		MONA_CHECK(leftEdge && rightEdge, "se perdio la arista de costura %zu", y);
+	}
+}
+
+void TestFlipRejection() {
+	//Plano con vertices desplazados: todos los colapsos tienen error cero, por lo que solo el rechazo de inversiones
+	//impide que las vecindades no convexas den vuelta triangulos
+	std::mt19937 random(3);
+	const unsigned int side = 40;
+	//Con desplazamientos de hasta 0.2 celdas por eje ningun triangulo de la grilla original queda invertido
+	const std::vector<glm::vec3> positions = MonaTest::MakeGridPositions(side, 0.0f, 0.2f, random);
+	auto countFlipped = [&](const std::vector<unsigned int>& indices) {
+		std::size_t flipped = 0;
+		for (std::size_t i = 0; i < indices.size(); i += 3) {
+			const glm::vec3 normal = glm::cross(positions[indices[i + 1]] - positions[indices[i]], positions[indices[i + 2]] - positions[indices[i]]);
+			if (!(normal.z > 0.0f))
+				flipped++;
+		}
+		return flipped;
+	};
+	std::vector<unsigned int> indices = MonaTest::MakeGridIndices(side);
+	MONA_CHECK(countFlipped(indices) == 0, "la grilla de prueba ya tiene triangulos invertidos");
+	Mona::SimplifyMesh(indices, &positions[0].x, sizeof(glm::vec3), positions.size(), 0, 1.0f);
+	MONA_CHECK(indices.size() < MonaTest::MakeGridIndices(side).size() / 4, "la simplificacion casi no redujo el plano: %zu", indices.size());
+	const std::size_t flipped = countFlipped(indices);
+	MONA_CHECK(flipped == 0, "%zu triangulos invertidos o degenerados", flipped);
+}
+
+void TestSelectionHysteresis() {
+	const std::vector<Mona::MeshLOD> lods = { { 0, 300, 0.0f }, { 300, 150, 0.01f }, { 450, 75, 0.02f }, { 525, 36, 0.04f } };
+	//El nivel 1 es tolerable mientras error * screenSize <= MESH_LOD_SCREEN_ERROR
+	const float threshold = MESH_LOD_SCREEN_ERROR / lods[1].error;
+	const float inside = 0.5f * MESH_LOD_HYSTERESIS;
+	MONA_CHECK(Mona::SelectMeshLOD(lods, threshold * 2.0f, 0) == 0, "malla grande no usa el nivel 0");
+	MONA_CHECK(Mona::SelectMeshLOD(lods, threshold * 0.01f, 0) == 3, "malla lejana no usa el ultimo nivel");
+	MONA_CHECK(Mona::SelectMeshLOD({}, threshold, 2) == 0, "sin niveles debe usarse el 0");
+
+	//Oscilar alrededor del umbral, dentro del margen, no cambia el nivel en ninguna de las dos direcciones
+	uint32_t lod = 0;
+	uint32_t switches = 0;
+	for (int frame = 0; frame < 100; frame++) {
+		const float screenSize = threshold * (frame % 2 == 0 ? 1.0f - inside : 1.0f + inside);
+		const uint32_t next = Mona::SelectMeshLOD(lods, screenSize, lod);
+		switches += next != lod;
+		lod = next;
+	}
+	MONA_CHECK(lod == 0 && switches == 0, "desde el nivel 0 hubo %u cambios", switches);
+	lod = 1;
+	switches = 0;
+	for (int frame = 0; frame < 100; frame++) {
+		const float screenSize = threshold * (frame % 2 == 0 ? 1.0f - inside : 1.0f + inside);
+		const uint32_t next = Mona::SelectMeshLOD(lods, screenSize, lod);
+		switches += next != lod;
+		lod = next;
+	}
+	MONA_CHECK(lod == 1 && switches == 0, "desde el nivel 1 hubo %u cambios", switches);
+
+	//Al cruzar el margen completo el nivel cambia una sola vez en cada sentido
+	lod = 0;
+	switches = 0;
+	for (int step = 0; step <= 40; step++) {
+		const float screenSize = threshold * (1.5f - step * 0.025f);
+		const uint32_t next = Mona::SelectMeshLOD(lods, screenSize, lod);
+		switches += next != lod;
+		if (next != lod)
+			MONA_CHECK(screenSize <= threshold * (1.0f - MESH_LOD_HYSTERESIS), "paso al nivel %u antes del margen: %f", next, screenSize / threshold);
+		lod = next;
+	}
+	MONA_CHECK(lod == 1 && switches == 1, "al alejarse: nivel %u con %u cambios", lod, switches);
+	switches = 0;
+	for (int step = 40; step >= 0; step--) {
+		const float screenSize = threshold * (1.5f - step * 0.025f);
+		const uint32_t next = Mona::SelectMeshLOD(lods, screenSize, lod);
+		switches += next != lod;
+		if (next != lod)
+			MONA_CHECK(screenSize > threshold * (1.0f + MESH_LOD_HYSTERESIS), "volvio al nivel %u antes del margen: %f", next, screenSize / threshold);
+		lod = next;
+	}
+	MONA_CHECK(lod == 0 && switches == 1, "al acercarse: nivel %u con %u cambios", lod, switches);
+}
+
+int main()
+{
+	TestLODChainReduction();
+	TestBorderAndSeamLock();
+	TestFlipRejection();
+	TestSelectionHysteresis();
+	return MONA_TEST_RESULT();
+}
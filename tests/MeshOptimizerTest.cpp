@@ -0,0 +1,159 @@
+#include "UnitTest.hpp"
+#include "TestGrids.hpp"
+#include "Rendering/MeshOptimizer.hpp"
+#include "Rendering/VertexCompression.hpp"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+struct TestVertex {
+	glm::vec3 position;
+	uint32_t id;
+};
+
+void ShuffleTriangles(std::vector<unsigned int>& indices, std::mt19937& random) {
+	std::vector<std::array<unsigned int, 3>> triangles(indices.size() / 3);
+	for (std::size_t t = 0; t < triangles.size(); t++)
+		triangles[t] = { indices[3 * t], indices[3 * t + 1], indices[3 * t + 2] };
+	std::shuffle(triangles.begin(), triangles.end(), random);
+	for (std::size_t t = 0; t < triangles.size(); t++)
+		std::copy(triangles[t].begin(), triangles[t].end(), indices.begin() + 3 * t);
+}
+
+// Triangulos rotados para empezar por su menor valor, conservando la orientacion, y ordenados
+template <typename T>
+std::vector<std::array<T, 3>> CanonicalTriangles(const std::vector<T>& corners) {
+	std::vector<std::array<T, 3>> triangles(corners.size() / 3);
+	for (std::size_t t = 0; t < triangles.size(); t++) {
+		std::array<T, 3> triangle = { corners[3 * t], corners[3 * t + 1], corners[3 * t + 2] };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles[t] = triangle;
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+void TestVertexCache() {
+	std::mt19937 random(7);
+	const unsigned int side = 48;
+	const std::size_t vertexCount = (side + 1) * (side + 1);
+	std::vector<unsigned int> indices = MonaTest::MakeGridIndices(side);
+	ShuffleTriangles(indices, random);
+	const std::vector<std::array<unsigned int, 3>> originalTriangles = CanonicalTriangles(indices);
+	const float shuffledACMR = Mona::ComputeACMR(indices, vertexCount);
+	Mona::OptimizeVertexCache(indices, vertexCount);
+	const float optimizedACMR = Mona::ComputeACMR(indices, vertexCount);
+	//Una grilla regular tiene ACMR optimo cercano a 0.5, y en desorden cada triangulo transforma casi tres vertices
+	MONA_CHECK(optimizedACMR < 0.5f * shuffledACMR, "Tipsify no mejora el ACMR: %f -> %f", shuffledACMR, optimizedACMR);
+	MONA_CHECK(optimizedACMR < 0.85f, "ACMR despues de Tipsify demasiado alto: %f", optimizedACMR);
+	MONA_CHECK(CanonicalTriangles(indices) == originalTriangles, "Tipsify cambio el conjunto de triangulos");
+}
+
+void TestVertexFetch() {
+	std::mt19937 random(11);
+	const unsigned int side = 20;
+	const std::vector<glm::vec3> positions = MonaTest::MakeGridPositions(side, 0.0f, 0.0f, random);
+	std::vector<TestVertex> vertices(positions.size());
+	for (std::size_t v = 0; v < vertices.size(); v++)
+		vertices[v] = { positions[v], static_cast<uint32_t>(v) };
+	//Vertices extra que ningun triangulo usa
+	vertices.push_back({ glm::vec3(-1.0f), 100000 });
+	vertices.push_back({ glm::vec3(-2.0f), 100001 });
+	std::vector<unsigned int> indices = MonaTest::MakeGridIndices(side);
+	ShuffleTriangles(indices, random);
+	std::vector<uint32_t> originalCorners(indices.size());
+	for (std::size_t i = 0; i < indices.size(); i++)
+		originalCorners[i] = vertices[indices[i]].id;
+
+	const std::size_t fetchedCount = Mona::OptimizeVertexFetch(vertices.data(), vertices.size(), sizeof(TestVertex), indices);
+	MONA_CHECK(fetchedCount == (side + 1) * (side + 1), "cantidad de vertices despues de OptimizeVertexFetch: %zu", fetchedCount);
+	vertices.resize(fetchedCount);
+	std::vector<uint32_t> fetchedCorners(indices.size());
+	unsigned int nextFirstUse = 0;
+	bool firstUseOrder = true;
+	for (std::size_t i = 0; i < indices.size(); i++) {
+		MONA_CHECK(indices[i] < fetchedCount, "indice %u fuera del buffer", indices[i]);
+		if (indices[i] >= fetchedCount)
+			return;
+		fetchedCorners[i] = vertices[indices[i]].id;
+		if (indices[i] == nextFirstUse)
+			nextFirstUse++;
+		else if (indices[i] > nextFirstUse)
+			firstUseOrder = false;
+	}
+	MONA_CHECK(firstUseOrder, "los vertices no quedaron en orden de primer uso");
+	MONA_CHECK(CanonicalTriangles(fetchedCorners) == CanonicalTriangles(originalCorners), "OptimizeVertexFetch cambio el conjunto de triangulos");
+}
+
+void TestOctahedral() {
+	std::mt19937 random(3);
+	std::normal_distribution<float> gaussian(0.0f, 1.0f);
+	//Error de redondeo a snorm16: medio paso de 1/32767 por componente codificada
+	const float maxAngleError = 1.0e-4f;
+	float worstAngle = 0.0f;
+	std::vector<glm::vec3> directions = { glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(1, 0, 0), glm::vec3(0, -1, 0),
+		glm::normalize(glm::vec3(1, 1, -1)), glm::normalize(glm::vec3(-1, 1, -0.001f)) };
+	for (int i = 0; i < 20000; i++) {
+		glm::vec3 direction(gaussian(random), gaussian(random), gaussian(random));
+		if (glm::length(direction) > 1.0e-3f)
+			directions.push_back(glm::normalize(direction));
+	}
+	for (const glm::vec3& direction : directions) {
+		const glm::vec2 encoded = Mona::EncodeOctahedral(direction);
+		const glm::vec2 quantized(glm::unpackSnorm1x16(glm::packSnorm1x16(encoded.x)), glm::unpackSnorm1x16(glm::packSnorm1x16(encoded.y)));
+		const glm::vec3 decoded = Mona::DecodeOctahedral(quantized);
+		//atan2 conserva la precision en angulos pequenos, a diferencia de acos del producto punto
+		const float angle = std::atan2(glm::length(glm::cross(decoded, direction)), glm::dot(decoded, direction));
+		worstAngle = std::max(worstAngle, angle);
+	}
+	MONA_CHECK(worstAngle < maxAngleError, "error angular %g", worstAngle);
+}
+
+void TestPositionQuantization() {
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> coordinate(-37.0f, 120.0f);
+	std::vector<glm::vec3> positions(5000);
+	for (auto& position : positions)
+		position = glm::vec3(coordinate(random), 0.25f * coordinate(random), 3.0f);
+	const Mona::PositionQuantization quantization = Mona::ComputePositionQuantization(&positions[0].x, sizeof(glm::vec3), positions.size());
+	//Medio paso de la cuantizacion en cada eje, mas el error de redondeo de float
+	const glm::vec3 bound = quantization.scale * (0.5f / 32767.0f) + glm::vec3(1.0e-5f) * glm::abs(quantization.offset) + glm::vec3(1.0e-6f);
+	bool withinBound = true;
+	for (const glm::vec3& position : positions) {
+		Mona::CompressedMeshVertex vertex;
+		Mona::CompressVertex(position, glm::vec3(0, 0, 1), glm::vec2(0.0f), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), quantization, vertex);
+		glm::vec3 decoded;
+		for (int c = 0; c < 3; c++)
+			decoded[c] = glm::unpackSnorm1x16(static_cast<uint16_t>(vertex.position[c])) * quantization.scale[c] + quantization.offset[c];
+		withinBound = withinBound && glm::all(glm::lessThanEqual(glm::abs(decoded - position), bound));
+	}
+	MONA_CHECK(withinBound, "posicion snorm16 fuera de la cota");
+}
+
+void TestSkinnedBoneIndices() {
+	Mona::PositionQuantization quantization;
+	Mona::CompressedSkinnedMeshVertex vertex;
+	const glm::vec4 weights(0.5f, 0.3f, 0.2f, 0.0f);
+	MONA_CHECK(Mona::CompressVertex(glm::vec3(0.0f), glm::vec3(0, 0, 1), glm::vec2(0.0f), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0),
+		glm::vec4(0, 17, 255, 3), weights, quantization, vertex), "indices de hueso validos rechazados");
+	MONA_CHECK(vertex.boneIds[2] == 255, "indice de hueso %u", vertex.boneIds[2]);
+	MONA_CHECK(vertex.boneWeights[0] + vertex.boneWeights[1] + vertex.boneWeights[2] + vertex.boneWeights[3] == 255, "los pesos no suman 255");
+	//Un indice que no cabe en 8 bits obliga a usar vertices sin comprimir
+	MONA_CHECK(!Mona::CompressVertex(glm::vec3(0.0f), glm::vec3(0, 0, 1), glm::vec2(0.0f), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0),
+		glm::vec4(0, 300, 1, 2), weights, quantization, vertex), "indice de hueso 300 aceptado");
+	MONA_CHECK(!Mona::CompressVertex(glm::vec3(0.0f), glm::vec3(0, 0, 1), glm::vec2(0.0f), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0),
+		glm::vec4(-1, 0, 1, 2), weights, quantization, vertex), "indice de hueso negativo aceptado");
+}
+
+int main()
+{
+	TestVertexCache();
+	TestVertexFetch();
+	TestOctahedral();
+	TestPositionQuantization();
+	TestSkinnedBoneIndices();
+	return MONA_TEST_RESULT();
+}
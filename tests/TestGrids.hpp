@@ -0,0 +1,40 @@
+#pragma once
+#ifndef TESTGRIDS_HPP
+#define TESTGRIDS_HPP
+#include <cmath>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+/*
+* Grillas de triangulos compartidas por las pruebas de mallas. Los vertices se numeran por filas, (side + 1) por fila.
+*/
+namespace MonaTest {
+	// (side + 1) x (side + 1) vertices sobre [0, 1]^2 con alturas suaves. jitter desplaza los vertices interiores en xy
+	inline std::vector<glm::vec3> MakeGridPositions(unsigned int side, float heightScale, float jitter, std::mt19937& random) {
+		std::uniform_real_distribution<float> offset(-jitter, jitter);
+		std::vector<glm::vec3> positions;
+		for (unsigned int y = 0; y <= side; y++) {
+			for (unsigned int x = 0; x <= side; x++) {
+				glm::vec2 p(float(x) / side, float(y) / side);
+				if (0 < x && x < side && 0 < y && y < side)
+					p += glm::vec2(offset(random), offset(random)) / float(side);
+				positions.push_back(glm::vec3(p, heightScale * std::sin(3.0f * p.x) * std::cos(2.0f * p.y)));
+			}
+		}
+		return positions;
+	}
+
+	// dos triangulos por celda, en sentido antihorario visto desde +z
+	inline std::vector<unsigned int> MakeGridIndices(unsigned int side) {
+		std::vector<unsigned int> indices;
+		for (unsigned int y = 0; y < side; y++) {
+			for (unsigned int x = 0; x < side; x++) {
+				unsigned int v = y * (side + 1) + x;
+				indices.insert(indices.end(), { v, v + 1, v + side + 2, v, v + side + 2, v + side + 1 });
+			}
+		}
+		return indices;
+	}
+}
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+#ifndef UNITTEST_HPP
+#define UNITTEST_HPP
+#include <cstdio>
+#include <cstdlib>
+/*
+* Pruebas de CPU sin ventana. Cada verificacion fallida se imprime y el ejecutable termina con EXIT_FAILURE,
+* de modo que ctest las reporta.
+*/
+namespace MonaTest {
+	inline int& FailureCount() {
+		static int failures = 0;
+		return failures;
+	}
+}
+
+#define MONA_CHECK(condition, ...) do { \
+	if (!(condition)) { \
+		std::printf("%s:%d: Fallo %s: ", __FILE__, __LINE__, #condition); \
+		std::printf(__VA_ARGS__); \
+		std::printf("\n"); \
+		MonaTest::FailureCount()++; \
+	} \
+} while (0)
+
+#define MONA_TEST_RESULT() (MonaTest::FailureCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif